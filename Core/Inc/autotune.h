@@ -0,0 +1,89 @@
+#ifndef __AUTOTUNE_H
+#define __AUTOTUNE_H
+
+#include "stm32g0xx_hal.h"
+#include "pid.h"
+
+// Auto-sintonia por realimentação a relé (Åström–Hägglund). A saída
+// alterna entre bias + d e bias - d sempre que a medida cruza o setpoint
+// (com histerese eps); a planta entra num ciclo-limite cuja amplitude a e
+// período Pu dão o ganho último pela função descritiva:
+//     Ku = 4 d / (pi * sqrt(a^2 - eps^2))
+// Ku e Pu viram ganhos de PID pela regra escolhida. É uma máquina de
+// estados sem espera: uma chamada a Autotune_Step() por amostra, no mesmo
+// período do PID. Tudo em inteiros.
+
+typedef enum
+{
+    AUTOTUNE_IDLE = 0,
+    AUTOTUNE_RUNNING,
+    AUTOTUNE_DONE,
+    AUTOTUNE_FAILED
+} Autotune_State;
+
+typedef enum
+{
+    AUTOTUNE_RULE_ZN_PID = 0,      // Ziegler–Nichols: 0.6 Ku, Pu/2, Pu/8
+    AUTOTUNE_RULE_NO_OVERSHOOT,    // 0.2 Ku, Pu/2, Pu/3
+    AUTOTUNE_RULE_TL_PI            // Tyreus–Luyben: Ku/3.2, 2.2 Pu, sem D
+} Autotune_Rule;
+
+typedef enum
+{
+    AUTOTUNE_ERR_NONE = 0,
+    AUTOTUNE_ERR_TIMEOUT,          // Sem ciclos consistentes a tempo
+    AUTOTUNE_ERR_DEVIATION,        // Medida saiu da faixa permitida
+    AUTOTUNE_ERR_AMPLITUDE         // Oscilação menor que a histerese
+} Autotune_Error;
+
+typedef struct
+{
+    int32_t amplitude;       // d, unidades de saída
+    int32_t hysteresis;      // eps, unidades de medida
+    int32_t out_min;
+    int32_t out_max;
+    int32_t max_deviation;   // Aborta se |pv - setpoint| passar disso
+    uint32_t timeout_ms;
+    uint8_t cycles;          // Períodos seguidos que precisam concordar (>= 2)
+    uint8_t tolerance_pct;   // Concordância de período e amplitude
+    uint8_t rule;            // Autotune_Rule
+} Autotune_Config;
+
+typedef struct
+{
+    Autotune_Config cfg;
+    int32_t setpoint;
+    int32_t bias;
+    int32_t d;               // Amplitude efetiva do relé (limitada pela faixa)
+    uint32_t period_ms;
+
+    uint8_t state;           // Autotune_State
+    uint8_t error;           // Autotune_Error
+    uint8_t high;            // Relé em bias + d
+    uint8_t armed;           // Já houve uma comutação para cima
+    uint8_t cycles;          // Ciclos completos medidos
+    uint8_t agreed;          // Ciclos seguidos dentro da tolerância
+    uint32_t elapsed_ms;
+    uint32_t cycle_start_ms; // Última comutação para cima
+    int32_t pv_max;
+    int32_t pv_min;
+    uint32_t last_pu_ms;
+    int32_t last_a;
+
+    // Resultado (médias dos ciclos concordantes)
+    uint32_t pu_ms;
+    int32_t a;
+    int32_t ku;              // Q16: saída por unidade de medida
+    uint32_t sum_pu_ms;
+    int32_t sum_a;
+} Autotune;
+
+// Funções públicas
+HAL_StatusTypeDef Autotune_Start(Autotune *at, const Autotune_Config *cfg, int32_t setpoint,
+                                 int32_t pv, int32_t bias, uint32_t period_ms);
+int32_t Autotune_Step(Autotune *at, int32_t pv);
+void Autotune_Abort(Autotune *at);
+uint8_t Autotune_GetState(const Autotune *at);
+HAL_StatusTypeDef Autotune_GetGains(const Autotune *at, Pid_Config *pid);
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef __BUTTONS_H
+#define __BUTTONS_H
+
+#include "stm32g0xx_hal.h"
+#include "main.h"
+
+// Botões por interrupção: cada borda (EXTI) reinicia a janela de debounce,
+// e um tick de 1 ms, ligado só enquanto algum botão está instável ou
+// pressionado, confirma o nível e gera os eventos. A fila é de um produtor
+// (a ISR do tick) e um consumidor (a aplicação), sem trava e sem espera.
+
+#define BUTTON_DEBOUNCE_MS      20   // Nível estável exigido após a última borda
+#define BUTTON_LONG_MS          1000 // Pressão longa
+#define BUTTON_REPEAT_DELAY_MS  500  // Primeira repetição ao segurar
+#define BUTTON_REPEAT_MS        250  // Cadência da repetição
+#define BUTTON_QUEUE_LEN        16   // Potência de 2
+
+typedef enum
+{
+    BUTTON_ID_UP = 0,
+    BUTTON_ID_DOWN,
+    BUTTON_ID_SCREEN,
+    BUTTON_COUNT
+} Button_Id;
+
+typedef enum
+{
+    BUTTON_EV_PRESS = 0,
+    BUTTON_EV_RELEASE,
+    BUTTON_EV_LONG,    // Uma vez, BUTTON_LONG_MS depois do PRESS
+    BUTTON_EV_REPEAT   // Enquanto segurado, a cada BUTTON_REPEAT_MS
+} Button_EventType;
+
+typedef struct
+{
+    uint8_t button; // Button_Id
+    uint8_t type;   // Button_EventType
+} Button_Event;
+
+// Funções públicas
+void Buttons_Init(TIM_HandleTypeDef *htim);
+uint8_t Buttons_GetEvent(Button_Event *ev);
+uint32_t Buttons_Dropped(void);
+uint8_t Buttons_IsIdle(void);
+
+// Tick de debounce (chamado no update do timer)
+void Buttons_TimerCallback(TIM_HandleTypeDef *htim);
+
+#endif
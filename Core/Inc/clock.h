@@ -0,0 +1,58 @@
+#ifndef __CLOCK_H
+#define __CLOCK_H
+
+#include "stm32g0xx_hal.h"
+
+// Perfis de clock em tempo de execução. O SYSCLK sai sempre do HSI16:
+// pelo PLL (64 MHz), direto ou pelo divisor HSIDIV. HCLK = PCLK = SYSCLK,
+// então os timers contam no próprio SYSCLK. Uma troca de perfil:
+//  - ordena regulador, wait states da flash e PLL: a tensão sobe antes do
+//    clock e desce depois dele;
+//  - refaz o SysTick (HAL_RCC_ClockConfig chama HAL_InitTick);
+//  - reescreve o PSC dos timers registrados, que mantêm a frequência de
+//    contagem pedida; os que estão em um pulso param (contagem e update)
+//    durante a troca e seguem com o que faltava do passo no PSC novo;
+//  - avisa a aplicação em Clock_ProfileChangedCallback(), para o que não
+//    cabe numa frequência de contagem fixa (PWM e dead time do TIM1).
+// Depois de um STOP, Clock_Resume() refaz o SYSCLK do perfil atual.
+// O ADC usa o HSI16 como clock assíncrono (CLOCK_ADC_HZ), que não muda
+// com o perfil: tempos de conversão e do oversampler ficam iguais.
+
+typedef enum
+{
+    CLOCK_PROFILE_FULL = 0,    // PLL: 64 MHz, faixa 1, 2 wait states
+    CLOCK_PROFILE_LOW_POWER,   // HSI16: 16 MHz, faixa 2, 1 wait state
+    CLOCK_PROFILE_ULTRA_LOW,   // HSI16 / 8: 2 MHz, low-power run
+    CLOCK_PROFILE_COUNT
+} Clock_ProfileId;
+
+typedef struct
+{
+    const char *name;
+    uint32_t sysclk_hz;
+    uint8_t use_pll;          // HSI16 / M1 * N8 / R2
+    uint32_t hsi_div;         // RCC_HSI_DIVx, sem PLL
+    uint32_t flash_latency;   // FLASH_LATENCY_x
+    uint32_t voltage_range;   // PWR_REGULATOR_VOLTAGE_SCALEx
+    uint8_t low_power_run;    // Regulador em baixo consumo (SYSCLK <= 2 MHz)
+} Clock_Profile;
+
+#define CLOCK_MIN_HZ       2000000U  // Menor SYSCLK: teto da contagem dos timers registrados
+#define CLOCK_ADC_HZ       4000000U  // HSI16 / 4, em qualquer perfil
+#define CLOCK_MAX_TIMERS   6
+
+extern const Clock_Profile Clock_Profiles[CLOCK_PROFILE_COUNT];
+
+// Funções públicas
+HAL_StatusTypeDef Clock_Init(void);
+HAL_StatusTypeDef Clock_SetProfile(uint8_t profile);
+HAL_StatusTypeDef Clock_Resume(void);
+uint8_t Clock_GetProfile(void);
+uint32_t Clock_TimerHz(void);
+uint32_t Clock_Prescaler(uint32_t count_hz);
+HAL_StatusTypeDef Clock_RegisterTimer(TIM_HandleTypeDef *htim, uint32_t count_hz);
+
+// Perfil novo já aplicado, timers registrados já reescalados
+void Clock_ProfileChangedCallback(uint8_t profile);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef __CRC32_H
+#define __CRC32_H
+
+#include <stdint.h>
+
+// CRC-32 IEEE 802.3 (refletido, o mesmo do zlib), em software com tabela
+// de 16 entradas: 64 bytes de flash, cerca de 20 ciclos por byte. Para
+// dados em pedaços: Crc32_Update() a partir de CRC32_INIT e o resultado
+// final invertido (~crc).
+
+#define CRC32_INIT  0xFFFFFFFFU
+
+// Funções públicas
+uint32_t Crc32_Update(uint32_t crc, const void *data, uint32_t len);
+uint32_t Crc32(const void *data, uint32_t len);
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef __DATALOG_H
+#define __DATALOG_H
+
+#include "stm32g0xx_hal.h"
+#include "settings.h"
+
+// Registro de campo: amostras de temperatura, duty e flags juntadas em RAM
+// em blocos de DATALOG_BLOCK_SIZE e gravadas num anel de páginas da flash,
+// logo abaixo das de settings.c. Cada bloco começa com a primeira amostra
+// completa; as seguintes são deltas:
+//  - 0x00..0x7F: um byte, no período nominal, duty e flags iguais e
+//    temperatura variando de -64 a +63 centésimos (7 bits com sinal);
+//  - 0x80 | campos: seguem, nesta ordem, o intervalo em ms (varint),
+//    o delta de temperatura (zigzag varint), o duty e as flags.
+// Um bloco fica pronto quando o próximo delta não cabe; ele é gravado
+// por DataLog_Poll() uma palavra dupla por chamada (85 us de CPU parada),
+// com o cabeçalho antes, enquanto o outro buffer recebe as amostras.
+// Entrar numa página já usada exige apagá-la: 22 ms parada, uma vez a
+// cada DATALOG_BLOCKS_PER_PAGE blocos, só com
+// DataLog_EraseAllowedCallback() de acordo.
+// DataLog_Init() procura o bloco mais novo lendo só os cabeçalhos; como
+// Settings_Init(), tem de rodar antes do ECCL (Protect_Init()).
+
+#define DATALOG_PAGES           12U
+#define DATALOG_FIRST_PAGE      (SETTINGS_FIRST_PAGE - DATALOG_PAGES)
+#define DATALOG_ADDR            (FLASH_BASE + DATALOG_FIRST_PAGE * FLASH_PAGE_SIZE)
+#define DATALOG_SIZE            (DATALOG_PAGES * FLASH_PAGE_SIZE)
+#define DATALOG_BLOCK_SIZE      256U
+#define DATALOG_BLOCKS_PER_PAGE (FLASH_PAGE_SIZE / DATALOG_BLOCK_SIZE)
+#define DATALOG_BLOCKS          (DATALOG_PAGES * DATALOG_BLOCKS_PER_PAGE)
+#define DATALOG_MAGIC           0x4C47U   // "GL"
+
+// Formato dos deltas
+#define DATALOG_TAG_FULL        0x80U
+#define DATALOG_TAG_TIME        0x01U
+#define DATALOG_TAG_TEMP        0x02U
+#define DATALOG_TAG_DUTY        0x04U
+#define DATALOG_TAG_FLAGS       0x08U
+#define DATALOG_MAX_DELTA       13U       // Tag + 2 varints de 5 bytes + duty + flags
+
+// Flags gravadas pela aplicação
+#define DATALOG_FLAG_ALARM      0x01U     // Alarme de temperatura ativo
+#define DATALOG_FLAG_TRIP       0x02U     // Saída cortada pela proteção
+#define DATALOG_FLAG_STANDBY    0x04U
+#define DATALOG_FLAG_MODE_Pos   4U        // Control_Mode nos bits 4-5
+#define DATALOG_FLAG_MODE       (3U << DATALOG_FLAG_MODE_Pos)
+
+// Cabeçalho do bloco na flash (little-endian, 3 palavras duplas). A
+// primeira, gravada antes das outras, basta para DataLog_Init(). O CRC-32
+// cobre os 'used' bytes de deltas e depois o cabeçalho, com o próprio
+// campo em zero: os deltas entram no CRC conforme chegam.
+typedef struct
+{
+    uint16_t magic;
+    uint16_t boot;        // Contagem de boots: t0_ms recomeça em cada um
+    uint32_t seq;         // Número do bloco, crescente entre boots
+    uint32_t t0_ms;       // HAL_GetTick() da primeira amostra
+    uint32_t crc;
+    int16_t temp0;        // Centésimos de °C
+    uint8_t duty0;
+    uint8_t flags0;
+    uint16_t used;        // Bytes de deltas depois do cabeçalho
+    uint16_t period_ms;   // Intervalo dos deltas de um byte
+} DataLog_Header;
+
+#define DATALOG_PAYLOAD         (DATALOG_BLOCK_SIZE - sizeof(DataLog_Header))
+
+typedef struct
+{
+    uint32_t samples;
+    uint32_t dropped;       // Amostras perdidas com os dois buffers cheios
+    uint32_t blocks;        // Blocos gravados desde o boot
+    uint32_t bytes;         // Bytes de flash gravados (cabeçalhos inclusos)
+    uint32_t erases;
+    uint32_t prog_errors;   // Blocos pulados por falha de gravação
+    uint32_t seq;           // Próximo número de bloco
+    uint16_t boot;
+} DataLog_Stats;
+
+// Funções públicas
+HAL_StatusTypeDef DataLog_Init(uint16_t period_ms);
+void DataLog_Sample(uint32_t time_ms, int32_t temp_cdeg, uint16_t duty, uint8_t flags);
+void DataLog_Flush(void);
+void DataLog_Poll(void);
+uint8_t DataLog_Busy(void);
+const DataLog_Stats *DataLog_GetStats(void);
+
+// Fraca: 1 se a CPU pode parar os 22 ms de um apagamento agora (padrão: sempre)
+uint8_t DataLog_EraseAllowedCallback(void);
+
+// Erro duplo de ECC no anel (chamado no NMI_Handler): 1 se era deste módulo
+uint8_t DataLog_EccNmiHandler(void);
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef __GPIO_BUS_H
+#define __GPIO_BUS_H
+
+#include "stm32g0xx_hal.h"
+#include "port.h"
+
+// Barramentos paralelos espalhados por vários ports (LCD): cada valor
+// vira uma escrita em BSRR por port, com os pinos agrupados pelo
+// compilador. As macros recebem port e pino das definições do main.h,
+// que são constantes; com otimização as comparações de port e os bits que
+// não são do port somem, e sobra só a montagem da palavra e o STR.
+// Nenhuma chamada, nenhuma busca de pino, sem leitura-modificação-escrita.
+
+// Palavra de BSRR que leva os pinos 'mask' ao estado de 'set': a metade
+// alta desliga, a baixa liga
+#define GPIO_BUS_BSRR(set, mask) \
+    ((((uint32_t)(mask) & ~(uint32_t)(set)) << 16) | ((uint32_t)(set) & (uint32_t)(mask)))
+
+// O pino, se ele for do port 'port'; 0 se não
+#define GPIO_BUS_PIN(port, pin_port, pin) \
+    (((pin_port) == (port)) ? (uint32_t)(pin) : 0U)
+
+// O pino, se ele for do port 'port' e o bit 'bit' de 'value' estiver em 1
+#define GPIO_BUS_BIT(port, pin_port, pin, value, bit) \
+    ((((pin_port) == (port)) && (((value) >> (bit)) & 1U)) ? (uint32_t)(pin) : 0U)
+
+// Uma escrita no port, só se algum pino do barramento for dele
+static inline void GPIO_BusWrite(GPIO_TypeDef *port, uint32_t set, uint32_t mask)
+{
+    if (mask != 0U)
+    {
+        port->BSRR = GPIO_BUS_BSRR(set, mask);
+        PORT_GPIO_SYNC(port);
+    }
+}
+
+// Campo de 2 bits do MODER de cada pino de 'mask'
+#define GPIO_BUS_MODER_BIT(mask, i) ((((uint32_t)(mask) >> (i)) & 1U) * (3UL << (2U * (i))))
+#define GPIO_BUS_MODER(mask) \
+    (GPIO_BUS_MODER_BIT(mask, 0) | GPIO_BUS_MODER_BIT(mask, 1) | GPIO_BUS_MODER_BIT(mask, 2) | \
+     GPIO_BUS_MODER_BIT(mask, 3) | GPIO_BUS_MODER_BIT(mask, 4) | GPIO_BUS_MODER_BIT(mask, 5) | \
+     GPIO_BUS_MODER_BIT(mask, 6) | GPIO_BUS_MODER_BIT(mask, 7) | GPIO_BUS_MODER_BIT(mask, 8) | \
+     GPIO_BUS_MODER_BIT(mask, 9) | GPIO_BUS_MODER_BIT(mask, 10) | GPIO_BUS_MODER_BIT(mask, 11) | \
+     GPIO_BUS_MODER_BIT(mask, 12) | GPIO_BUS_MODER_BIT(mask, 13) | GPIO_BUS_MODER_BIT(mask, 14) | \
+     GPIO_BUS_MODER_BIT(mask, 15))
+
+// Pinos do barramento como entrada ou saída push-pull. Leitura-modificação-
+// escrita do MODER: quem mais mexe no MODER do port não pode interromper.
+static inline void GPIO_BusDirection(GPIO_TypeDef *port, uint32_t mask, uint8_t input)
+{
+    if (mask != 0U)
+    {
+        uint32_t moder = port->MODER & ~GPIO_BUS_MODER(mask);
+
+        port->MODER = input ? moder : (moder | (GPIO_BUS_MODER(mask) & 0x55555555UL));
+        PORT_GPIO_SYNC(port);
+    }
+}
+
+// Pino isolado (EN, RS): BSRR para ligar, BRR para desligar
+static inline void GPIO_PinSet(GPIO_TypeDef *port, uint32_t pin)
+{
+    port->BSRR = pin;
+    PORT_GPIO_SYNC(port);
+}
+
+static inline void GPIO_PinReset(GPIO_TypeDef *port, uint32_t pin)
+{
+    port->BRR = pin;
+    PORT_GPIO_SYNC(port);
+}
+
+#endif
@@ -4,12 +4,44 @@
 #include "stm32g0xx_hal.h"
 #include "main.h"
 
+// Geometria do display 16x2
+#define LCD_COLS       16
+#define LCD_ROWS       2
+// Maior lacuna de células iguais que LCD_Flush() reenvia para não
+// reposicionar o cursor
+#define LCD_MERGE_GAP  1
+
+typedef struct
+{
+    uint32_t bytes;        // Comandos e dados enviados
+    uint32_t bf_polls;     // Leituras do busy flag
+    uint32_t bf_timeouts;  // Bytes em que o flag não caiu no pior caso
+} LCD_Stats;
 
 // Funções públicas
-void LCD_Init(void);
+void LCD_Init(TIM_HandleTypeDef *htim);
+void LCD_EnableBusyFlag(GPIO_TypeDef *port, uint16_t pin);
 void LCD_Clear(void);
 void LCD_SetCursor(uint8_t col, uint8_t row);
 void LCD_Print(char *str);
 void LCD_DisplayWelcome(void);
 
+// Framebuffer: a aplicação escreve em RAM e LCD_Flush() envia só o que mudou
+void LCD_BufferClear(void);
+uint8_t LCD_BufferPrint(uint8_t col, uint8_t row, const char *str);
+void LCD_Flush(void);
+
+// Campos formatados direto no framebuffer, sem printf e sem ponto
+// flutuante. Todas retornam a coluna seguinte ao campo.
+uint8_t LCD_BufferPutUInt(uint8_t col, uint8_t row, uint32_t value, uint8_t width, char pad);
+uint8_t LCD_BufferPutFixed(uint8_t col, uint8_t row, int32_t value, uint8_t frac, uint8_t width);
+uint8_t LCD_BufferPutField(uint8_t col, uint8_t row, const char *str, uint8_t width);
+const char *LCD_BufferRow(uint8_t row);
+
+// Motor de transmissão assíncrono
+uint8_t LCD_IsBusy(void);
+const LCD_Stats *LCD_GetStats(void);
+void LCD_TimerCallback(TIM_HandleTypeDef *htim);
+void LCD_TxCpltCallback(void);
+
 #endif
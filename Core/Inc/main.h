@@ -43,6 +43,14 @@ extern "C" {
 #define PWM_OUTPUT       GPIO_PIN_8   // TIM1_CH1 (PA8)
 #define PWM_COMPLEMENTAR GPIO_PIN_7   // TIM1_CH1N (PA7)
 
+// --- Modos da saída de potência ---
+typedef enum
+{
+    CONTROL_MANUAL = 0,  // Duty cycle pelos botões
+    CONTROL_AUTO,        // PID de temperatura
+    CONTROL_TUNE         // Relé da auto-sintonia
+} Control_Mode;
+
 // --- Pinos do LCD 16x2 (modo 4 bits) ---
 #define LCD_EN_Pin       GPIO_PIN_4
 #define LCD_EN_GPIO_Port GPIOC
@@ -56,6 +64,16 @@ extern "C" {
 #define LCD_D6_GPIO_Port GPIOB
 #define LCD_D7_Pin       GPIO_PIN_4
 #define LCD_D7_GPIO_Port GPIOB
+// R/W do LCD: nesta placa vai aterrado (só escrita, tempos fixos). Numa
+// placa com o R/W num pino, definir LCD_RW_Pin e LCD_RW_GPIO_Port aqui
+// liga a leitura do busy flag.
+
+// --- Telemetria (USART2_TX, AF0) ---
+// PA2 e PA3, os pinos do VCP do ST-LINK na Nucleo, são o LM35 e o
+// buzzer: o TX sai no PD5, ligado por fio ao RX do VCP
+#define TELEMETRY_TX_Pin       GPIO_PIN_5
+#define TELEMETRY_TX_GPIO_Port GPIOD
+#define TELEMETRY_TX_AF        GPIO_AF0_USART2
 
 // --- Pinos SWD ---
 #define TMS_Pin          GPIO_PIN_13
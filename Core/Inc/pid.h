@@ -0,0 +1,54 @@
+#ifndef __PID_H
+#define __PID_H
+
+#include "stm32g0xx_hal.h"
+
+// PID em ponto fixo (Q16), sem float em tempo de execução. Erro e medida
+// nas unidades do sensor (centésimos de °C), saída nas unidades do
+// atuador (por mil do PWM em main.c). O período de amostragem é fixo e
+// entra nos ganhos uma vez, em Pid_Init():
+//  - derivada sobre a medida (sem chute na troca de setpoint), com filtro
+//    de primeira ordem;
+//  - anti-windup por integração condicional: saturada a saída, o
+//    integrador não anda no sentido do erro e fica limitado à faixa.
+
+#define PID_Q16_ONE  65536L
+
+// Ganho real -> Q16, só para constantes (o compilador resolve o float)
+#define PID_Q16(x)   ((int32_t)((x) * 65536.0 + (((x) >= 0) ? 0.5 : -0.5)))
+
+typedef struct
+{
+    int32_t kp;            // Q16: saída por unidade de erro
+    int32_t ki;            // Q16: saída por unidade de erro por segundo
+    int32_t kd;            // Q16: saída por (unidade de erro / s)
+    uint32_t d_filter_ms;  // Constante de tempo do filtro da derivada (0 = sem filtro)
+    int32_t out_min;
+    int32_t out_max;
+} Pid_Config;
+
+typedef struct
+{
+    // Ganhos já discretizados no período
+    int32_t kp;            // Q16
+    int32_t ki_ts;         // Q16: ki * Ts
+    int32_t kd_ts;         // Q16: kd / Ts
+    int32_t d_alpha;       // Q16: Tf / (Tf + Ts)
+    int32_t out_min;
+    int32_t out_max;
+    uint32_t period_ms;
+
+    // Estado
+    int64_t integ;         // Q16, já em unidades de saída
+    int64_t deriv;         // Q16, filtrada
+    int32_t pv_prev;
+    int32_t out;
+    uint8_t primed;
+} Pid_Controller;
+
+// Funções públicas
+HAL_StatusTypeDef Pid_Init(Pid_Controller *pid, const Pid_Config *cfg, uint32_t period_ms);
+void Pid_Reset(Pid_Controller *pid, int32_t setpoint, int32_t pv, int32_t out);
+int32_t Pid_Update(Pid_Controller *pid, int32_t setpoint, int32_t pv);
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef __PORT_H
+#define __PORT_H
+
+// Ganchos de portabilidade entre o alvo e o build de host (Host/).
+// No alvo todas as macros somem; no host elas alimentam o relógio virtual
+// do simulador com o custo de trechos que não passam pela HAL.
+
+#ifdef HOST_BUILD
+#include "host_sim.h"
+
+// Cobra 'n' ciclos de CPU no relógio virtual
+#define PORT_CYCLES(n)          Sim_Consume(n)
+// Leitura de uma palavra dupla da flash (ECC inclusa)
+#define PORT_FLASH_READ64(addr) Sim_FlashRead64(addr)
+// Escrita direta em BSRR/BRR do port: o modelo aplica no ODR
+#define PORT_GPIO_SYNC(gpio)    Sim_GpioSync(gpio)
+// DMA memória -> periférico: os ponteiros do host não cabem nos
+// endereços de 32 bits do HAL_DMA_Start_IT
+#define PORT_DMA_TX(hdma, periph, mem, len) SimDma_Start((hdma), (periph), (mem), (len))
+#else
+#define PORT_CYCLES(n)          ((void)0)
+#define PORT_FLASH_READ64(addr) (*(const volatile uint64_t *)(addr))
+#define PORT_GPIO_SYNC(gpio)    ((void)0)
+#define PORT_DMA_TX(hdma, periph, mem, len) \
+    HAL_DMA_Start_IT((hdma), (uint32_t)(mem), (uint32_t)(periph), (len))
+#endif
+
+#endif /* __PORT_H */
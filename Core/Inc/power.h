@@ -0,0 +1,53 @@
+#ifndef __POWER_H
+#define __POWER_H
+
+#include "stm32g0xx_hal.h"
+
+// Baixo consumo entre as tarefas. O escalonador chama Power_Idle() com as
+// IRQs mascaradas e o tempo até a próxima liberação:
+//  - SLEEP: só o núcleo para; SysTick, TIM1 (PWM), TIM3 + ADC + DMA e o
+//    motor do LCD seguem rodando. Sempre permitido.
+//  - STOP 1: HCLK e clocks de APB parados, regulador em baixo consumo.
+//    Acorda pelo wakeup timer do RTC (LSI) antes da próxima liberação ou
+//    por qualquer EXTI (botões). Só com janela de POWER_STOP_MIN_MS e com
+//    Power_StopAllowedCallback() de acordo: timers, ADC e PWM congelariam.
+// O SysTick não conta em STOP: o tempo dormido sai do SSR do RTC e entra
+// em uwTick, com a fração de ms levada para a próxima vez, e na base de
+// us (timebase.c), cujo timer fica parado durante o STOP. Na saída, o
+// perfil de clock é refeito (Clock_Resume()).
+// O G070 não tem LPTIM nem LSE no projeto: o RTC no LSI é o único relógio
+// que atravessa o STOP.
+
+#define POWER_STOP_MIN_MS   3U     // Janela mínima: abaixo disso, SLEEP
+#define POWER_STOP_MAX_MS   900U   // Um STOP nunca passa de uma volta do SSR (1 s)
+#define POWER_RTC_HZ        16000U // LSI / 2: resolução do SSR e do wakeup timer
+
+typedef enum
+{
+    POWER_MODE_RUN = 0,
+    POWER_MODE_SLEEP,
+    POWER_MODE_STOP,
+    POWER_MODE_COUNT
+} Power_Mode;
+
+typedef struct
+{
+    uint32_t entries[POWER_MODE_COUNT]; // Entradas em SLEEP e STOP
+    uint64_t us[POWER_MODE_COUNT];      // Residência; RUN é o restante
+    uint32_t rtc_wakeups;               // STOP encerrado pelo wakeup timer
+    uint32_t early_wakeups;             // STOP encerrado por outra interrupção
+} Power_Stats;
+
+// Funções públicas
+HAL_StatusTypeDef Power_Init(void);
+Power_Mode Power_Idle(uint32_t next_ms);
+const Power_Stats *Power_GetStats(void);
+void Power_ResetStats(void);
+
+// Fraca: 1 se nada em andamento impede o STOP (padrão: nunca)
+uint8_t Power_StopAllowedCallback(void);
+
+// Interrupção do RTC (wakeup timer, linha 19 do EXTI)
+void Power_RtcIRQHandler(void);
+
+#endif
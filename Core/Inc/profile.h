@@ -0,0 +1,39 @@
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+// Marcadores de perfil das tarefas do laço principal.
+// No alvo as macros somem; no build de host (Host/) elas alimentam o
+// perfilador do simulador, que atribui ciclos a cada tarefa.
+
+// --- Tarefas instrumentadas ---
+#define PROF_TASK_LIST(X)              \
+    X(PROF_READ_TEMPERATURE, "ReadTemperature") \
+    X(PROF_UPDATE_DISPLAY,   "UpdateDisplay")   \
+    X(PROF_BUTTONS,          "Botoes")          \
+    X(PROF_BUZZER_BEEP,      "Buzzer_Beep")     \
+    X(PROF_ALARM,            "Alarme")          \
+    X(PROF_COUNTDOWN,        "Countdown")
+
+#define PROF_TASK_ENUM(id, name) id,
+typedef enum
+{
+    PROF_TASK_LIST(PROF_TASK_ENUM)
+    PROF_TASK_COUNT
+} Prof_Task;
+#undef PROF_TASK_ENUM
+
+#ifdef HOST_BUILD
+void Prof_Begin(Prof_Task task);
+void Prof_End(Prof_Task task);
+void Prof_Loop(void);
+
+#define PROF_BEGIN(task)   Prof_Begin(task)
+#define PROF_END(task)     Prof_End(task)
+#define PROF_LOOP()        Prof_Loop()
+#else
+#define PROF_BEGIN(task)   ((void)0)
+#define PROF_END(task)     ((void)0)
+#define PROF_LOOP()        ((void)0)
+#endif
+
+#endif /* __PROFILE_H */
@@ -0,0 +1,62 @@
+#ifndef __PROTECT_H
+#define __PROTECT_H
+
+#include "stm32g0xx_hal.h"
+
+// Proteção do estágio de potência pelo break do TIM1. Um disparo zera MOE
+// no próprio timer: CHx e CHxN vão para o nível de repouso (OISx/OISxN,
+// com OSSI/OSSR) sem depender do laço nem do CCR. Fontes:
+//  - sobretemperatura: a ISR do watchdog do ADC gera o break por software
+//    (EGR.BG); o G070 não tem comparador para ligar ao BKIN;
+//  - falhas do sistema: lockup do Cortex, paridade da SRAM e ECC da flash
+//    ligados ao break em hardware (SYSCFG_CFGR2).
+// O religamento segue a política: travado até Protect_Clear() ou
+// automático depois que a falha some e o tempo de espera passa.
+
+#define PROTECT_POLL_MS   100  // Período de Protect_Poll()
+
+typedef enum
+{
+    PROTECT_FAULT_OVERTEMP = 0,
+    PROTECT_FAULT_SYSTEM,     // Break em hardware (lockup, paridade, ECC)
+    PROTECT_FAULT_COUNT
+} Protect_Fault;
+
+typedef enum
+{
+    PROTECT_LATCHED = 0,  // Só Protect_Clear() religa
+    PROTECT_AUTO_REARM    // Religa sozinho após cooldown_ms sem falha ativa
+} Protect_Mode;
+
+typedef struct
+{
+    uint8_t mode;           // Protect_Mode
+    uint8_t max_rearms;     // Religamentos automáticos antes de travar (0 = sem limite)
+    uint16_t cooldown_ms;   // Mínimo desligado depois que a falha some
+} Protect_Policy;
+
+typedef struct
+{
+    uint32_t trips[PROTECT_FAULT_COUNT];
+    uint32_t auto_rearms;
+    uint32_t manual_clears;
+    uint32_t last_trip_ms;  // HAL_GetTick() do último disparo
+    uint8_t last_fault;     // Protect_Fault
+} Protect_Stats;
+
+// Funções públicas
+HAL_StatusTypeDef Protect_Init(TIM_HandleTypeDef *htim, const Protect_Policy *policy);
+void Protect_SetPolicy(const Protect_Policy *policy);
+void Protect_Trip(Protect_Fault fault);
+void Protect_Release(Protect_Fault fault);
+HAL_StatusTypeDef Protect_Clear(void);
+void Protect_Poll(void);
+uint8_t Protect_IsTripped(void);
+uint8_t Protect_IsLatched(void);
+uint32_t Protect_ActiveFaults(void);
+const Protect_Stats *Protect_GetStats(void);
+
+// Break do timer (chamado no HAL_TIMEx_BreakCallback)
+void Protect_BreakCallback(TIM_HandleTypeDef *htim);
+
+#endif
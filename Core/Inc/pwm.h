@@ -0,0 +1,59 @@
+#ifndef __PWM_H
+#define __PWM_H
+
+#include "stm32g0xx_hal.h"
+
+// Saída PWM complementar (CHx + CHxN) com preload de ARR e CCR: todo novo
+// duty entra inteiro no próximo evento de update, nunca no meio do período.
+// Rampas são tabelas de CCR escritas pelo DMA em burst (DMAR) a cada
+// update, espaçados pelo contador de repetição: a CPU só participa no
+// início e no fim.
+//
+// Frequência e dead time são pedidos em Hz e ns; Pwm_Calculate() acha
+// PSC, ARR, CKD e DTG para um clock de timer e devolve o que foi obtido.
+// Entre as combinações de mesma ordem de PSC, fica a de menor erro de
+// frequência, com o maior ARR (mais resolução) no empate. O dead time
+// nunca sai menor que o pedido: é o menor valor codificável >= o pedido
+// nas quatro faixas do DTG, com CKD 1, 2 ou 4.
+
+#define PWM_SOFT_MS          500  // Partida e parada suaves
+#define PWM_RAMP_MAX_STEPS   64
+#define PWM_PSC_SEARCH       16   // PSCs testados a partir do menor possível
+
+typedef struct
+{
+    uint32_t freq_hz;        // Frequência pedida
+    uint16_t min_steps;      // Resolução mínima do duty: ARR + 1 >= min_steps (>= 2)
+    uint32_t deadtime_ns;    // Dead time mínimo entre CHx e CHxN
+} Pwm_Config;
+
+typedef struct
+{
+    uint32_t timer_hz;       // Clock do timer usado no cálculo
+    uint16_t psc;
+    uint16_t arr;
+    uint32_t ckd;            // TIM_CLOCKDIVISION_DIVx (tDTS do dead time)
+    uint8_t dtg;
+    uint32_t steps;          // Passos de duty: ARR + 1
+    uint32_t freq_hz;        // Frequência obtida, arredondada
+    int32_t freq_error_ppm;  // (obtida - pedida) / pedida
+    uint32_t deadtime_ns;    // Dead time obtido, arredondado (>= pedido)
+} Pwm_Timing;
+
+// Funções públicas
+HAL_StatusTypeDef Pwm_Init(TIM_HandleTypeDef *htim, uint32_t channel);
+HAL_StatusTypeDef Pwm_Start(void);
+void Pwm_SetDuty(uint8_t percent);
+void Pwm_SetDutyPermille(uint16_t permille);
+HAL_StatusTypeDef Pwm_Calculate(const Pwm_Config *cfg, uint32_t timer_hz, Pwm_Timing *timing);
+HAL_StatusTypeDef Pwm_Configure(const Pwm_Config *cfg, Pwm_Timing *timing);
+const Pwm_Timing *Pwm_GetTiming(void);
+uint32_t Pwm_DeadTimeTicks(uint8_t dtg);
+HAL_StatusTypeDef Pwm_RampTo(uint8_t percent, uint32_t duration_ms);
+uint8_t Pwm_IsRamping(void);
+uint16_t Pwm_GetDutyPermille(void);
+
+// Fim da rampa (chamado no HAL_TIM_PeriodElapsedCallback do timer)
+void Pwm_RampCpltCallback(TIM_HandleTypeDef *htim);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef __SCHEDULER_H
+#define __SCHEDULER_H
+
+#include "stm32g0xx_hal.h"
+
+// Escalonador cooperativo: tarefas periódicas e de disparo único,
+// escolhidas por prioridade e, no empate, pela liberação mais antiga.
+// Sem tarefa pronta a CPU dorme (Power_Idle(): SLEEP ou STOP) até a
+// próxima interrupção ou liberação.
+// Cada tarefa roda até o fim: nenhuma pode bloquear (HAL_Delay).
+
+#define SCHED_MAX_TASKS   16
+
+typedef void (*Sched_TaskFn)(void);
+
+typedef struct
+{
+    const char *name;
+    Sched_TaskFn fn;
+    uint32_t period_ms;    // 0 = disparo único (Sched_Trigger)
+    uint32_t deadline_ms;  // Atraso máximo de início; 0 = sem prazo
+    uint32_t release;      // Tick (ms) em que a tarefa fica pronta
+    uint8_t priority;      // 0 = mais alta
+    uint8_t armed;
+
+    // Contabilidade (ciclos de CPU, incluindo ISRs que interromperam a tarefa)
+    uint32_t runs;
+    uint32_t misses;       // Inícios além do prazo
+    uint32_t max_late_ms;  // Maior atraso de início
+    uint32_t max_cycles;   // Pior execução
+    uint64_t cycles;       // Tempo total de execução
+} Sched_Task;
+
+// Funções públicas
+int8_t Sched_AddPeriodic(const char *name, Sched_TaskFn fn, uint32_t period_ms, uint8_t priority);
+int8_t Sched_AddOneShot(const char *name, Sched_TaskFn fn, uint8_t priority);
+void Sched_SetDeadline(int8_t id, uint32_t deadline_ms);
+void Sched_Trigger(int8_t id, uint32_t delay_ms);
+void Sched_Cancel(int8_t id);
+__NO_RETURN void Sched_Run(void);
+
+// Estatísticas
+uint8_t Sched_TaskCount(void);
+const Sched_Task *Sched_GetTask(uint8_t id);
+uint64_t Sched_Cycles(void);
+uint64_t Sched_IdleCycles(void);
+uint64_t Sched_ElapsedCycles(void);
+void Sched_ResetStats(void);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef __SETTINGS_H
+#define __SETTINGS_H
+
+#include "stm32g0xx_hal.h"
+
+// Chave/valor persistente nas últimas páginas da flash, em log: cada
+// gravação acrescenta um registro (cabeçalho com chave, tamanho e CRC-32,
+// mais os dados em palavras duplas) na página ativa, e o registro mais
+// novo de cada chave vale. As páginas formam um anel com número de
+// sequência no cabeçalho; com a página ativa cheia, a próxima livre é
+// aberta e, se não sobrar outra livre, os registros ainda válidos da mais
+// antiga são copiados e ela é apagada. O apagamento gira pelo anel.
+//
+// Corte de energia no meio de uma gravação deixa um registro com CRC
+// errado (ou erro duplo de ECC na leitura): no boot ele é pulado, a página
+// continua depois da área já gravada e o valor anterior da chave vale.
+// Settings_Init() monta o índice em RAM em O(registros) e tem de rodar
+// antes do Protect_Init(): com ECCL ligado, um erro de ECC na leitura de
+// um registro interrompido dispararia o break do TIM1.
+//
+// Gravar ou apagar para a CPU (o código roda da mesma flash): 85 us por
+// palavra dupla e 22 ms por página apagada, uma vez a cada página cheia.
+
+#define SETTINGS_FLASH_PAGES  64U    // G070RB: 128 KB em páginas de 2 KB
+#define SETTINGS_PAGES        4U
+#define SETTINGS_FIRST_PAGE   (SETTINGS_FLASH_PAGES - SETTINGS_PAGES)
+#define SETTINGS_PAGE_SIZE    FLASH_PAGE_SIZE
+#define SETTINGS_ADDR         (FLASH_BASE + SETTINGS_FIRST_PAGE * SETTINGS_PAGE_SIZE)
+#define SETTINGS_MAX_KEYS     16U    // Chaves de 1 a SETTINGS_MAX_KEYS - 1
+#define SETTINGS_MAX_LEN      32U    // Bytes por valor
+
+// Chaves da aplicação: nunca renumerar, os valores já gravados ficam
+typedef enum
+{
+    SETTINGS_KEY_DUTY = 1,   // uint16_t, duty do modo manual (%)
+    SETTINGS_KEY_COUNTDOWN,  // uint16_t, timer regressivo (s)
+    SETTINGS_KEY_ALARM,      // int32_t, limite do alarme (centésimos de °C)
+    SETTINGS_KEY_SCREEN,     // uint8_t, tela atual
+} Settings_Key;
+
+typedef struct
+{
+    uint32_t records;       // Registros lidos no boot
+    uint32_t corrupt;       // Registros interrompidos pulados no boot
+    uint32_t writes;        // Registros gravados desde o boot (cópias incluídas)
+    uint32_t compactions;
+    uint32_t erases;        // Páginas apagadas desde o boot
+    uint16_t page_erases[SETTINGS_PAGES]; // Apagamentos de cada página (cabeçalho)
+    uint16_t free_bytes;    // Livre na página ativa
+} Settings_Stats;
+
+// Funções públicas
+HAL_StatusTypeDef Settings_Init(void);
+HAL_StatusTypeDef Settings_Read(uint16_t key, void *data, uint16_t len);
+HAL_StatusTypeDef Settings_Write(uint16_t key, const void *data, uint16_t len);
+const Settings_Stats *Settings_GetStats(void);
+
+// Erro duplo de ECC nas páginas do log (chamado no NMI_Handler): 1 se
+// era uma leitura deste módulo, que a descarta
+uint8_t Settings_EccNmiHandler(void);
+
+#endif
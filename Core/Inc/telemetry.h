@@ -0,0 +1,70 @@
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#include "stm32g0xx_hal.h"
+
+// Telemetria binária na USART2 (8N1, só transmissão) pelo DMA, sem o
+// módulo UART da HAL: registradores da USART e HAL_DMA. Cada pacote é
+// tipo, sequência e corpo, seguidos do CRC-32 (crc32.h) e codificados em
+// COBS: o byte 0x00 só aparece como fim de quadro, e o receptor se
+// realinha no próximo zero depois de um byte perdido.
+// Buffer duplo: o DMA envia uma metade enquanto os quadros novos entram
+// na outra; no fim da transferência as metades trocam. A CPU nunca
+// espera a linha: com a metade de preenchimento cheia, o quadro é
+// descartado e o buraco aparece na sequência.
+// A USART conta no PCLK: Telemetry_ClockChanged() refaz o BRR depois de
+// uma troca de perfil, e o quadro que estava na linha se perde.
+
+#define TELEMETRY_BAUD          115200U
+#define TELEMETRY_PERIOD_MS     100U      // Amostra na taxa cheia; 0 desliga
+#define TELEMETRY_BUF_SIZE      128U      // Cada metade do buffer duplo
+#define TELEMETRY_TEXT_MAX      48U       // Linha de texto (__io_putchar)
+#define TELEMETRY_HEADER        2U        // Tipo e sequência
+#define TELEMETRY_CRC           4U
+#define TELEMETRY_PAYLOAD_MAX   (TELEMETRY_HEADER + TELEMETRY_TEXT_MAX + TELEMETRY_CRC)
+#define TELEMETRY_FRAME_MAX     (TELEMETRY_PAYLOAD_MAX + TELEMETRY_PAYLOAD_MAX / 254U + 2U)
+
+typedef enum
+{
+    TELEMETRY_PKT_SAMPLE = 1,  // Telemetry_Sample
+    TELEMETRY_PKT_TEXT,        // Texto sem terminador
+} Telemetry_PacketType;
+
+// Corpo do TELEMETRY_PKT_SAMPLE (little-endian, 11 bytes):
+//  0  tempo (HAL_GetTick, 4 bytes)
+//  4  temperatura em centésimos de °C (int16)
+//  6  duty em por mil (uint16)
+//  8  timer regressivo em s (uint16)
+// 10  flags: DATALOG_FLAG_* (alarme, proteção, espera e modo)
+#define TELEMETRY_SAMPLE_SIZE   11U
+
+typedef struct
+{
+    uint32_t time_ms;
+    int32_t temp_cdeg;       // Saturada na faixa do int16
+    uint16_t duty_permille;
+    uint16_t countdown_s;
+    uint8_t flags;
+} Telemetry_Sample;
+
+typedef struct
+{
+    uint32_t frames;        // Quadros aceitos no buffer duplo
+    uint32_t bytes;         // Entregues ao DMA
+    uint32_t dropped;       // Quadros descartados com a metade cheia
+    uint32_t dma_errors;
+    uint16_t max_fill;      // Maior ocupação da metade de preenchimento
+} Telemetry_Stats;
+
+// Funções públicas
+HAL_StatusTypeDef Telemetry_Init(DMA_HandleTypeDef *hdma, uint32_t baud);
+HAL_StatusTypeDef Telemetry_SetBaud(uint32_t baud);
+void Telemetry_SetPeriod(uint32_t period_ms);
+uint32_t Telemetry_GetPeriod(void);
+HAL_StatusTypeDef Telemetry_SendSample(const Telemetry_Sample *s);
+HAL_StatusTypeDef Telemetry_SendText(const char *text, uint16_t len);
+uint8_t Telemetry_IsBusy(void);
+void Telemetry_ClockChanged(void);
+const Telemetry_Stats *Telemetry_GetStats(void);
+
+#endif
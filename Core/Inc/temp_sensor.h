@@ -0,0 +1,69 @@
+#ifndef __TEMP_SENSOR_H
+#define __TEMP_SENSOR_H
+
+#include "stm32g0xx_hal.h"
+
+// Aquisição do LM35 sem espera: o TRGO do TIM3 dispara o ADC1 a uma taxa
+// fixa e o DMA grava as conversões num buffer circular. Cada metade do
+// buffer cheia vira uma média pronta para o laço principal consumir.
+#define TEMP_SAMPLE_RATE_HZ   1000U   // Taxa de amostragem (TIM3 a 1 kHz)
+#define TEMP_HALF_LEN         100U    // Amostras por média: uma a cada 100 ms
+#define TEMP_BUFFER_LEN       (2U * TEMP_HALF_LEN)
+#define TEMP_CAL_PERIOD_MS    600000U // Recalibração do ADC a cada 10 min
+
+// Perfil de aquisição. O oversampler do ADC soma 2^ratio_log2 conversões
+// por gatilho e desloca o total 'shift' bits à direita, sem a CPU: cada
+// resultado tem 12 + ratio_log2 - shift bits. O software ainda soma
+// 'block_len' resultados por leitura; rate_hz / block_len leituras por
+// segundo. A rajada inteira precisa caber no período do gatilho.
+typedef struct
+{
+    uint8_t ratio_log2;  // 0 (oversampler desligado) a 8 (256 conversões)
+    uint8_t shift;       // 0 a 8
+    uint16_t rate_hz;    // Gatilhos por segundo: 16 Hz a 1 kHz (TIM3 em 1 us)
+    uint16_t block_len;  // Resultados por leitura, até TEMP_HALF_LEN
+} TempSensor_Profile;
+
+extern const TempSensor_Profile TempSensor_Profile12Bit; // Média só em software
+extern const TempSensor_Profile TempSensor_Profile14Bit;
+extern const TempSensor_Profile TempSensor_Profile16Bit;
+
+// Conversão em ponto fixo, sem float: a soma das TEMP_HALF_LEN amostras de
+// uma média vira centésimos de °C com uma multiplicação por uma constante
+// Q16 calculada pelo pré-processador e um deslocamento. Usar a soma em vez
+// da média arredondada preserva a resolução abaixo de 1 LSB. Outros
+// perfis recalculam a escala: fundo de escala vezes escala é sempre
+// ~33000 << 16, então o produto cabe em 32 bits em qualquer perfil.
+#define TEMP_VREF_MV          3300U   // Referência do ADC
+#define TEMP_ADC_FULL_SCALE   4095U   // Código máximo (12 bits)
+#define TEMP_CDEG_PER_MV      10U     // LM35: 10 mV/°C = 10 centésimos/mV
+#define TEMP_SCALE_SHIFT      16U
+#define TEMP_SCALE_DIV        ((uint64_t)TEMP_ADC_FULL_SCALE * TEMP_HALF_LEN)
+#define TEMP_SCALE_Q16        ((uint32_t)(((((uint64_t)TEMP_VREF_MV * TEMP_CDEG_PER_MV) << TEMP_SCALE_SHIFT) \
+                                           + TEMP_SCALE_DIV / 2U) / TEMP_SCALE_DIV))
+
+// Funções públicas
+HAL_StatusTypeDef TempSensor_Start(ADC_HandleTypeDef *hadc, TIM_HandleTypeDef *htim,
+                                   const TempSensor_Profile *profile);
+HAL_StatusTypeDef TempSensor_SetProfile(const TempSensor_Profile *profile);
+HAL_StatusTypeDef TempSensor_Calibrate(void);
+void TempSensor_Suspend(void);
+HAL_StatusTypeDef TempSensor_Resume(void);
+uint8_t TempSensor_IsRunning(void);
+uint8_t TempSensor_GetCentiCelsius(int32_t *cdeg);
+int32_t TempSensor_SumToCentiCelsius(uint32_t sum);
+uint16_t TempSensor_LastCode(void);
+uint8_t TempSensor_Bits(void);
+uint32_t TempSensor_PeriodMs(void);
+uint32_t TempSensor_CalibrationFactor(void);
+
+// Alarme de sobretemperatura no watchdog analógico 1 do ADC, avaliado pelo
+// hardware a cada resultado. A histerese vem de reprogramar a janela a
+// cada transição: fora do alarme só um resultado >= on_cdeg sai dela; em
+// alarme, só um < off_cdeg. A interrupção chama TempSensor_AlarmCallback()
+// com o novo estado.
+HAL_StatusTypeDef TempSensor_SetAlarm(int32_t on_cdeg, int32_t off_cdeg);
+uint8_t TempSensor_AlarmActive(void);
+void TempSensor_AlarmCallback(uint8_t active); // Fraca; contexto de interrupção
+
+#endif
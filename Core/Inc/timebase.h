@@ -0,0 +1,56 @@
+#ifndef __TIMEBASE_H
+#define __TIMEBASE_H
+
+#include "stm32g0xx_hal.h"
+
+// Base de tempo em microssegundos: um timer básico de 16 bits (TIM7)
+// contando livre a 1 MHz, estendido a 64 bits pelas voltas contadas na
+// interrupção de update (uma a cada 65,536 ms). Sem espera nem custo fora
+// das leituras, e com a mesma escala em qualquer perfil de clock:
+//  - toda troca do SYSCLK passa por HAL_InitTick(), sobrescrita aqui: o
+//    contador é somado à base e o timer recomeça com o PSC novo (UG com
+//    URS). Até lá ele contou poucos ciclos no ritmo errado, e o resto do
+//    prescaler se perde: menos de 1 us por troca;
+//  - em STOP o timer para com o APB: power.c o desliga antes e devolve o
+//    tempo dormido medido pelo RTC (Timebase_Resume()); a fração de us
+//    que o contador tinha e os ciclos entre a borda do RTC e o Resume se
+//    perdem (1 a 2 us por STOP).
+// As leituras mascaram as IRQs por poucos ciclos e tratam a volta ainda
+// não contada (UIF pendente). Com as IRQs mascaradas por mais de uma
+// volta (65 ms), voltas se perdem.
+
+#define TIMEBASE_HZ        1000000U // Contagem dos timers de 1 us (TIM3, TIM6, TIM7, TIM14)
+#define TIMEBASE_PERIOD    0x10000U // Uma volta do contador de 16 bits, em us
+
+// Funções públicas
+HAL_StatusTypeDef Timebase_Init(TIM_HandleTypeDef *htim);
+uint32_t Timebase_Micros(void);
+uint64_t Timebase_Micros64(void);
+uint32_t Timebase_MicrosMasked(void);
+void Timebase_DelayUs(uint32_t us);
+
+// Troca do SYSCLK (chamada por HAL_InitTick)
+void Timebase_ClockChanged(void);
+
+// STOP: o timer para em Suspend; Resume leva a base a 'start_us' (lido
+// antes, no início do intervalo medido) mais 'elapsed_ns'
+void Timebase_Suspend(void);
+void Timebase_Resume(uint64_t start_us, uint32_t elapsed_ns);
+
+// Interrupção de update do timer (uma volta)
+void Timebase_IRQHandler(void);
+
+// Microssegundos desde 'since' (de Timebase_Micros()), certo através da
+// volta dos 32 bits (71 min)
+static inline uint32_t Timebase_ElapsedUs(uint32_t since)
+{
+    return Timebase_Micros() - since;
+}
+
+// 1 se já passaram 'us' desde 'since'
+static inline uint8_t Timebase_Expired(uint32_t since, uint32_t us)
+{
+    return Timebase_ElapsedUs(since) >= us;
+}
+
+#endif
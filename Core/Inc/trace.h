@@ -0,0 +1,82 @@
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#include "stm32g0xx_hal.h"
+#include "scheduler.h"
+
+// Rastro de execução: eventos binários de 8 bytes com o instante em us
+// (timebase.c, 32 bits) gravados num anel em RAM que sobrescreve os mais
+// antigos. Cada evento custa uma chamada com as IRQs mascaradas por
+// poucos ciclos; tipos fora de Trace_SetMask() custam só o teste.
+// O anel é lido fora do alvo: um dump da RAM (o cabeçalho é achado pela
+// assinatura) ou o host_sim -r, e o trace_export o converte em JSON do
+// Chrome/Perfetto. Com TRACE_ENABLE em 0 as macros somem.
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE       1
+#endif
+
+#define TRACE_MAGIC        0x31435254U  // "TRC1"
+#define TRACE_VERSION      1U
+#define TRACE_CAPACITY     512U         // Eventos, potência de 2 (4 KB)
+#define TRACE_NAME_LEN     12U          // Nome de tarefa com terminador
+
+typedef enum
+{
+    TRACE_TASK_BEGIN = 0,  // id: tarefa do escalonador; arg: atraso de início (ms)
+    TRACE_TASK_END,
+    TRACE_ISR_ENTER,       // id: número da exceção (IRQn + 16)
+    TRACE_ISR_EXIT,
+    TRACE_IDLE_BEGIN,      // Sched_Idle: CPU dormindo até uma IRQ ou liberação
+    TRACE_IDLE_END,        // arg: Power_Mode
+    TRACE_ADC_READY,       // arg: média do bloco do DMA (código do ADC)
+    TRACE_PWM_UPDATE,      // arg: CCR novo; id 1 para o início de uma rampa
+    TRACE_LCD_FLUSH,       // arg: bytes na fila do motor
+    TRACE_LCD_DONE,        // Fila do motor vazia
+    TRACE_BUTTON,          // id: botão; arg: Button_EventType
+    TRACE_TYPE_COUNT
+} Trace_Type;
+
+#define TRACE_MASK_ALL     ((1UL << TRACE_TYPE_COUNT) - 1U)
+
+// Evento no anel (little-endian)
+typedef struct
+{
+    uint32_t time_us;      // Timebase_Micros()
+    uint8_t type;          // Trace_Type
+    uint8_t id;
+    uint16_t arg;
+} Trace_Event;
+
+// Imagem lida pelo host. 'head' conta todos os eventos gravados: o
+// próximo vai em events[head % TRACE_CAPACITY].
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t capacity;
+    volatile uint32_t head;
+    uint32_t mask;         // Bit (1 << Trace_Type) gravado
+    char names[SCHED_MAX_TASKS][TRACE_NAME_LEN];
+    Trace_Event events[TRACE_CAPACITY];
+} Trace_Buffer;
+
+extern Trace_Buffer trace_buffer;
+
+// Funções públicas
+void Trace_Init(void);
+void Trace_SetMask(uint32_t mask);
+void Trace_SetTaskName(uint8_t id, const char *name);
+void Trace_Record(uint8_t type, uint8_t id, uint16_t arg);
+
+#if TRACE_ENABLE
+#define TRACE(type, id, arg)   Trace_Record((type), (uint8_t)(id), (uint16_t)(arg))
+#define TRACE_ISR_IN(irqn)     Trace_Record(TRACE_ISR_ENTER, (uint8_t)((irqn) + 16), 0U)
+#define TRACE_ISR_OUT(irqn)    Trace_Record(TRACE_ISR_EXIT, (uint8_t)((irqn) + 16), 0U)
+#else
+#define TRACE(type, id, arg)   ((void)0)
+#define TRACE_ISR_IN(irqn)     ((void)0)
+#define TRACE_ISR_OUT(irqn)    ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,232 @@
+#include "autotune.h"
+#include "port.h"
+
+// pi ~ 355/113 (erro de 8e-8)
+#define AUTOTUNE_PI_NUM  355U
+#define AUTOTUNE_PI_DEN  113U
+
+static uint32_t Autotune_Isqrt(uint32_t x)
+{
+    uint32_t root = 0, bit = 1UL << 30;
+
+    while (bit > x)
+        bit >>= 2;
+    while (bit != 0U)
+    {
+        if (x >= root + bit)
+        {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+            root >>= 1;
+        bit >>= 2;
+    }
+    return root;
+}
+
+static uint8_t Autotune_Agrees(uint32_t value, uint32_t ref, uint8_t tolerance_pct)
+{
+    uint32_t diff = (value > ref) ? value - ref : ref - value;
+
+    return (uint64_t)diff * 100U <= (uint64_t)ref * tolerance_pct;
+}
+
+static void Autotune_Fail(Autotune *at, Autotune_Error error)
+{
+    at->state = AUTOTUNE_FAILED;
+    at->error = error;
+}
+
+// Ciclos concordantes suficientes: médias e ganho último
+static void Autotune_Finish(Autotune *at)
+{
+    uint32_t a_eff;
+
+    at->pu_ms = at->sum_pu_ms / at->agreed;
+    at->a = at->sum_a / at->agreed;
+    if (at->a <= at->cfg.hysteresis)
+    {
+        Autotune_Fail(at, AUTOTUNE_ERR_AMPLITUDE);
+        return;
+    }
+    a_eff = Autotune_Isqrt((uint32_t)(at->a * at->a - at->cfg.hysteresis * at->cfg.hysteresis));
+    if (a_eff == 0U)
+        a_eff = 1U;
+    at->ku = (int32_t)((((uint64_t)4U * (uint32_t)at->d * AUTOTUNE_PI_DEN) << 16)
+                       / ((uint64_t)AUTOTUNE_PI_NUM * a_eff));
+    at->state = AUTOTUNE_DONE;
+}
+
+// Comutação para cima: fecha o ciclo anterior (período e amplitude pico a
+// pico / 2) e compara com o anterior
+static void Autotune_CycleEnd(Autotune *at)
+{
+    if (at->armed)
+    {
+        uint32_t pu = at->elapsed_ms - at->cycle_start_ms;
+        int32_t a = (at->pv_max - at->pv_min) / 2;
+
+        at->cycles++;
+        if (at->cycles >= 2U && a > 0
+            && Autotune_Agrees(pu, at->last_pu_ms, at->cfg.tolerance_pct)
+            && Autotune_Agrees((uint32_t)a, (uint32_t)at->last_a, at->cfg.tolerance_pct))
+        {
+            at->agreed++;
+            at->sum_pu_ms += pu;
+            at->sum_a += a;
+        }
+        else
+        {
+            at->agreed = 1;
+            at->sum_pu_ms = pu;
+            at->sum_a = a;
+        }
+        at->last_pu_ms = pu;
+        at->last_a = a;
+        if (at->agreed >= at->cfg.cycles)
+        {
+            Autotune_Finish(at);
+            return;
+        }
+    }
+    at->armed = 1;
+    at->cycle_start_ms = at->elapsed_ms;
+    at->pv_max = INT32_MIN;
+    at->pv_min = INT32_MAX;
+}
+
+// Inicia o relé em torno de 'bias' (a saída que mantinha a planta perto do
+// setpoint). A amplitude é reduzida para caber na faixa da saída.
+HAL_StatusTypeDef Autotune_Start(Autotune *at, const Autotune_Config *cfg, int32_t setpoint,
+                                 int32_t pv, int32_t bias, uint32_t period_ms)
+{
+    int32_t d;
+
+    if (at == NULL || cfg == NULL || period_ms == 0U || cfg->cycles < 2U
+        || cfg->amplitude <= 0 || cfg->hysteresis < 0 || cfg->out_min >= cfg->out_max
+        || bias < cfg->out_min || bias > cfg->out_max)
+        return HAL_ERROR;
+
+    d = cfg->amplitude;
+    if (bias - d < cfg->out_min)
+        d = bias - cfg->out_min;
+    if (bias + d > cfg->out_max)
+        d = cfg->out_max - bias;
+    if (d <= 0)
+        return HAL_ERROR; // Na borda da faixa não há relé simétrico
+
+    at->cfg = *cfg;
+    at->setpoint = setpoint;
+    at->bias = bias;
+    at->d = d;
+    at->period_ms = period_ms;
+    at->state = AUTOTUNE_RUNNING;
+    at->error = AUTOTUNE_ERR_NONE;
+    at->high = (pv < setpoint);
+    at->armed = 0;
+    at->cycles = 0;
+    at->agreed = 0;
+    at->elapsed_ms = 0;
+    at->cycle_start_ms = 0;
+    at->pv_max = pv;
+    at->pv_min = pv;
+    at->last_pu_ms = 0;
+    at->last_a = 0;
+    at->pu_ms = 0;
+    at->a = 0;
+    at->ku = 0;
+    at->sum_pu_ms = 0;
+    at->sum_a = 0;
+    return HAL_OK;
+}
+
+// Uma amostra: devolve a saída do relé. Fora de AUTOTUNE_RUNNING devolve
+// o bias, para a planta ficar onde estava.
+int32_t Autotune_Step(Autotune *at, int32_t pv)
+{
+    int32_t dev = pv - at->setpoint;
+
+    if (at->state != AUTOTUNE_RUNNING)
+        return at->bias;
+
+    PORT_CYCLES(30);
+    at->elapsed_ms += at->period_ms;
+    if (dev > at->cfg.max_deviation || -dev > at->cfg.max_deviation)
+    {
+        Autotune_Fail(at, AUTOTUNE_ERR_DEVIATION);
+        return at->bias;
+    }
+    if (at->elapsed_ms > at->cfg.timeout_ms)
+    {
+        Autotune_Fail(at, AUTOTUNE_ERR_TIMEOUT);
+        return at->bias;
+    }
+
+    if (pv > at->pv_max)
+        at->pv_max = pv;
+    if (pv < at->pv_min)
+        at->pv_min = pv;
+
+    if (at->high && dev > at->cfg.hysteresis)
+        at->high = 0;
+    else if (!at->high && -dev > at->cfg.hysteresis)
+    {
+        at->high = 1;
+        Autotune_CycleEnd(at);
+        if (at->state != AUTOTUNE_RUNNING)
+            return at->bias;
+    }
+    return at->high ? at->bias + at->d : at->bias - at->d;
+}
+
+void Autotune_Abort(Autotune *at)
+{
+    if (at->state == AUTOTUNE_RUNNING)
+        at->state = AUTOTUNE_IDLE;
+}
+
+uint8_t Autotune_GetState(const Autotune *at)
+{
+    return at->state;
+}
+
+// Ganhos de PID pela regra da configuração, nas unidades de Pid_Config
+HAL_StatusTypeDef Autotune_GetGains(const Autotune *at, Pid_Config *pid)
+{
+    int64_t kp;
+    uint32_t ti_ms, td_ms;
+
+    if (at->state != AUTOTUNE_DONE || pid == NULL)
+        return HAL_ERROR;
+
+    switch (at->cfg.rule)
+    {
+    case AUTOTUNE_RULE_NO_OVERSHOOT:
+        kp = (int64_t)at->ku / 5;
+        ti_ms = at->pu_ms / 2U;
+        td_ms = at->pu_ms / 3U;
+        break;
+    case AUTOTUNE_RULE_TL_PI:
+        kp = ((int64_t)at->ku * 10) / 32;
+        ti_ms = (at->pu_ms * 22U) / 10U;
+        td_ms = 0;
+        break;
+    case AUTOTUNE_RULE_ZN_PID:
+    default:
+        kp = ((int64_t)at->ku * 3) / 5;
+        ti_ms = at->pu_ms / 2U;
+        td_ms = at->pu_ms / 8U;
+        break;
+    }
+    if (ti_ms == 0U)
+        return HAL_ERROR;
+
+    pid->kp = (int32_t)kp;
+    pid->ki = (int32_t)((kp * 1000) / ti_ms);
+    pid->kd = (int32_t)((kp * td_ms) / 1000);
+    pid->d_filter_ms = td_ms / 10U; // N = 10
+    pid->out_min = at->cfg.out_min;
+    pid->out_max = at->cfg.out_max;
+    return HAL_OK;
+}
@@ -0,0 +1,178 @@
+#include "buttons.h"
+#include "port.h"
+#include "trace.h"
+
+// Estado de cada botão. EXTI e timer têm a mesma prioridade no NVIC e
+// não se interrompem, então só a fila precisa de cuidado com concorrência.
+typedef struct
+{
+    uint16_t pin;
+    uint8_t settling;    // Houve borda: aguardando o nível assentar
+    uint8_t quiet_ms;    // Tempo desde a última borda
+    uint8_t pressed;     // Nível confirmado (ativo em nível baixo)
+    uint16_t held_ms;    // Tempo pressionado, saturado em BUTTON_LONG_MS
+    uint16_t repeat_ms;  // Tempo até a próxima repetição
+} Button_State;
+
+static TIM_HandleTypeDef *tick_htim;
+
+static Button_State buttons[BUTTON_COUNT] =
+{
+    [BUTTON_ID_UP]     = { .pin = BUTTON_UP },
+    [BUTTON_ID_DOWN]   = { .pin = BUTTON_DOWN },
+    [BUTTON_ID_SCREEN] = { .pin = BUTTON_SCREEN },
+};
+
+// Fila SPSC: índices de 8 bits são lidos e escritos de forma atômica
+static Button_Event queue[BUTTON_QUEUE_LEN];
+static volatile uint8_t q_head = 0;  // Escrito só pela ISR
+static volatile uint8_t q_tail = 0;  // Escrito só pela aplicação
+static volatile uint32_t dropped = 0;
+
+// --- Fila ---
+
+static void Buttons_Emit(uint8_t button, uint8_t type)
+{
+    uint8_t head = q_head;
+    uint8_t next = (uint8_t)((head + 1U) & (BUTTON_QUEUE_LEN - 1U));
+
+    // Fila cheia: descarta o evento novo, os antigos já são do consumidor
+    if (next == q_tail)
+    {
+        dropped++;
+        return;
+    }
+    TRACE(TRACE_BUTTON, button, type);
+    queue[head].button = button;
+    queue[head].type = type;
+    __DMB(); // Evento escrito antes de publicar o índice
+    q_head = next;
+}
+
+// Retira um evento, se houver. Nunca bloqueia.
+uint8_t Buttons_GetEvent(Button_Event *ev)
+{
+    uint8_t tail = q_tail;
+
+    if (tail == q_head)
+        return 0;
+    __DMB(); // Índice lido antes do evento
+    *ev = queue[tail];
+    __DMB(); // Evento copiado antes de liberar a posição
+    q_tail = (uint8_t)((tail + 1U) & (BUTTON_QUEUE_LEN - 1U));
+    return 1;
+}
+
+uint32_t Buttons_Dropped(void)
+{
+    return dropped;
+}
+
+// Todos soltos e estáveis: o tick de debounce está parado
+uint8_t Buttons_IsIdle(void)
+{
+    return tick_htim == NULL || (tick_htim->Instance->CR1 & TIM_CR1_CEN) == 0U;
+}
+
+// --- Bordas e tick ---
+
+void Buttons_Init(TIM_HandleTypeDef *htim)
+{
+    tick_htim = htim;
+    q_head = 0;
+    q_tail = 0;
+    dropped = 0;
+
+    // Botão já pressionado no reset não gera PRESS
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++)
+    {
+        buttons[i].settling = 0;
+        buttons[i].pressed = (HAL_GPIO_ReadPin(BUTTON_GPIO_PORT, buttons[i].pin) == GPIO_PIN_RESET);
+        buttons[i].held_ms = BUTTON_LONG_MS;
+        buttons[i].repeat_ms = 0;
+    }
+}
+
+static void Buttons_Edge(uint16_t pin)
+{
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++)
+    {
+        if (buttons[i].pin == pin)
+        {
+            // Cada repique reinicia a janela
+            buttons[i].settling = 1;
+            buttons[i].quiet_ms = 0;
+        }
+    }
+
+    // Liga o tick se estava parado; o primeiro update vem 1 ms depois
+    if (tick_htim != NULL && (tick_htim->Instance->CR1 & TIM_CR1_CEN) == 0U)
+    {
+        __HAL_TIM_SET_COUNTER(tick_htim, 0);
+        __HAL_TIM_ENABLE(tick_htim);
+    }
+    PORT_CYCLES(30);
+}
+
+void HAL_GPIO_EXTI_Rising_Callback(uint16_t GPIO_Pin)
+{
+    Buttons_Edge(GPIO_Pin);
+}
+
+void HAL_GPIO_EXTI_Falling_Callback(uint16_t GPIO_Pin)
+{
+    Buttons_Edge(GPIO_Pin);
+}
+
+static void Buttons_Step(uint8_t id)
+{
+    Button_State *b = &buttons[id];
+
+    if (b->settling)
+    {
+        if (++b->quiet_ms < BUTTON_DEBOUNCE_MS)
+            return;
+        b->settling = 0;
+
+        uint8_t level = (HAL_GPIO_ReadPin(BUTTON_GPIO_PORT, b->pin) == GPIO_PIN_RESET);
+        if (level == b->pressed)
+            return; // Só ruído: voltou ao nível anterior
+        b->pressed = level;
+        if (level)
+        {
+            b->held_ms = 0;
+            b->repeat_ms = BUTTON_REPEAT_DELAY_MS;
+            Buttons_Emit(id, BUTTON_EV_PRESS);
+        }
+        else
+        {
+            Buttons_Emit(id, BUTTON_EV_RELEASE);
+        }
+    }
+    else if (b->pressed)
+    {
+        if (b->held_ms < BUTTON_LONG_MS && ++b->held_ms == BUTTON_LONG_MS)
+            Buttons_Emit(id, BUTTON_EV_LONG);
+        if (b->repeat_ms != 0U && --b->repeat_ms == 0U)
+        {
+            b->repeat_ms = BUTTON_REPEAT_MS;
+            Buttons_Emit(id, BUTTON_EV_REPEAT);
+        }
+    }
+}
+
+// Tick de 1 ms: avança o debounce e a contagem de cada botão. Para o
+// timer quando todos estão soltos e estáveis; a próxima borda o religa.
+void Buttons_TimerCallback(TIM_HandleTypeDef *htim)
+{
+    uint8_t active = 0;
+
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++)
+    {
+        Buttons_Step(i);
+        active |= buttons[i].settling | buttons[i].pressed;
+    }
+    if (!active)
+        __HAL_TIM_DISABLE(htim);
+    PORT_CYCLES(20U + 12U * BUTTON_COUNT);
+}
@@ -0,0 +1,265 @@
+#include "clock.h"
+
+// Limites do RM0444 (faixa 1: 0/1/2 WS até 24/48/64 MHz; faixa 2: 0/1 WS
+// até 8/16 MHz; low-power run até 2 MHz) já resolvidos por perfil
+const Clock_Profile Clock_Profiles[CLOCK_PROFILE_COUNT] =
+{
+    [CLOCK_PROFILE_FULL]      = { "Pleno",    64000000U, 1, RCC_HSI_DIV1, FLASH_LATENCY_2,
+                                  PWR_REGULATOR_VOLTAGE_SCALE1, 0 },
+    [CLOCK_PROFILE_LOW_POWER] = { "Economia", 16000000U, 0, RCC_HSI_DIV1, FLASH_LATENCY_1,
+                                  PWR_REGULATOR_VOLTAGE_SCALE2, 0 },
+    [CLOCK_PROFILE_ULTRA_LOW] = { "Minimo",    2000000U, 0, RCC_HSI_DIV8, FLASH_LATENCY_0,
+                                  PWR_REGULATOR_VOLTAGE_SCALE2, 1 },
+};
+
+typedef struct
+{
+    TIM_HandleTypeDef *htim;
+    uint32_t count_hz;
+    uint8_t frozen;           // Um pulso parado no meio do passo pela troca
+    uint8_t held;             // UIE desligado pela troca
+} Clock_Timer;
+
+static Clock_Timer timers[CLOCK_MAX_TIMERS];
+static uint8_t timer_count = 0;
+static uint8_t current = CLOCK_PROFILE_COUNT; // Reset: HSI16 na faixa 1, fora da tabela
+
+// Timers em um pulso no meio de um passo param antes da troca: o PSC
+// velho no clock novo encurtaria (ou esticaria) o que falta do passo.
+// O passo só fica mais longo pelo tempo da troca. O update deles também
+// sai (UIE): a ISR não começa um passo novo com o PSC velho enquanto a
+// troca roda com as interrupções ligadas; um UIF que chegou antes fica
+// pendente até o UIE voltar.
+static void Clock_HoldTimers(void)
+{
+    for (uint8_t i = 0; i < timer_count; i++)
+    {
+        TIM_TypeDef *tim = timers[i].htim->Instance;
+
+        if ((tim->CR1 & TIM_CR1_OPM) == 0U)
+            continue;
+        if (tim->DIER & TIM_DIER_UIE)
+        {
+            CLEAR_BIT(tim->DIER, TIM_DIER_UIE);
+            timers[i].held = 1;
+        }
+        if (tim->CR1 & TIM_CR1_CEN)
+        {
+            CLEAR_BIT(tim->CR1, TIM_CR1_CEN);
+            timers[i].frozen = 1;
+        }
+    }
+}
+
+// PSC novo para a frequência de contagem do timer. O PSC tem preload:
+// com o timer rodando, vale a partir do próximo update. Parado, um UG
+// com URS carrega o valor já, sem UIF nem pedido de DMA. Um pulso
+// congelado volta com o que faltava do passo no ARR (a frequência de
+// contagem é a mesma, então as contagens que faltam também), e o UIE
+// desligado pela troca volta depois.
+static void Clock_RescaleTimer(Clock_Timer *t)
+{
+    TIM_TypeDef *tim = t->htim->Instance;
+    uint32_t psc = Clock_Prescaler(t->count_hz);
+
+    t->htim->Init.Prescaler = psc;
+    __HAL_TIM_SET_PRESCALER(t->htim, psc);
+    if (t->frozen)
+    {
+        uint32_t left = tim->ARR - tim->CNT;
+
+        __HAL_TIM_SET_AUTORELOAD(t->htim, (left != 0U) ? left : 1U);
+    }
+    if ((tim->CR1 & TIM_CR1_CEN) == 0U)
+    {
+        SET_BIT(tim->CR1, TIM_CR1_URS);
+        tim->EGR = TIM_EGR_UG;
+        CLEAR_BIT(tim->CR1, TIM_CR1_URS);
+    }
+    if (t->frozen)
+    {
+        t->frozen = 0;
+        SET_BIT(tim->CR1, TIM_CR1_CEN);
+    }
+    if (t->held)
+    {
+        t->held = 0;
+        SET_BIT(tim->DIER, TIM_DIER_UIE);
+    }
+}
+
+// Perfil pleno a partir do reset (chamada em SystemClock_Config)
+HAL_StatusTypeDef Clock_Init(void)
+{
+    RCC_PeriphCLKInitTypeDef periph = {0};
+
+    // ADC no HSI16: o clock de conversão não depende do perfil
+    periph.PeriphClockSelection = RCC_PERIPHCLK_ADC;
+    periph.AdcClockSelection = RCC_ADCCLKSOURCE_HSI;
+    if (HAL_RCCEx_PeriphCLKConfig(&periph) != HAL_OK)
+        return HAL_ERROR;
+    return Clock_SetProfile(CLOCK_PROFILE_FULL);
+}
+
+// Oscilador e SYSCLK do perfil. A HAL_RCC_ClockConfig baixa os wait
+// states só depois da troca e refaz SystemCoreClock e SysTick; a
+// OscConfig faz o mesmo quando muda o HSIDIV com o HSI16 no SYSCLK.
+static HAL_StatusTypeDef Clock_Switch(const Clock_Profile *p)
+{
+    RCC_OscInitTypeDef osc = {0};
+    RCC_ClkInitTypeDef clk = {0};
+
+    osc.HSIState = RCC_HSI_ON;
+    osc.HSIDiv = p->hsi_div;
+    osc.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
+    clk.ClockType = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1;
+    clk.AHBCLKDivider = RCC_SYSCLK_DIV1;
+    clk.APB1CLKDivider = RCC_HCLK_DIV1;
+
+    if (p->use_pll)
+    {
+        // PLL: HSI16 / 1 * 8 / 2. Nunca é o SYSCLK aqui (só este perfil o usa).
+        osc.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+        osc.PLL.PLLState = RCC_PLL_ON;
+        osc.PLL.PLLSource = RCC_PLLSOURCE_HSI;
+        osc.PLL.PLLM = RCC_PLLM_DIV1;
+        osc.PLL.PLLN = 8;
+        osc.PLL.PLLP = RCC_PLLP_DIV2;
+        osc.PLL.PLLR = RCC_PLLR_DIV2;
+        clk.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+        if (HAL_RCC_OscConfig(&osc) != HAL_OK)
+            return HAL_ERROR;
+        return HAL_RCC_ClockConfig(&clk, p->flash_latency);
+    }
+
+    // O HSIDIV só vale com o HSI16 já no SYSCLK: primeiro a troca (com
+    // o divisor antigo, até 16 MHz, então sem baixar os wait states),
+    // depois divisor e PLL desligado
+    clk.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+    if (HAL_RCC_ClockConfig(&clk, __HAL_FLASH_GET_LATENCY()) != HAL_OK)
+        return HAL_ERROR;
+    osc.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+    osc.PLL.PLLState = RCC_PLL_OFF;
+    return HAL_RCC_OscConfig(&osc);
+}
+
+// Regulador, wait states e clock do perfil, na ordem do RM0444
+static HAL_StatusTypeDef Clock_Apply(const Clock_Profile *p)
+{
+    // Subida: regulador principal, faixa e wait states antes do clock
+    if ((PWR->CR1 & PWR_CR1_LPR) && !p->low_power_run
+        && HAL_PWREx_DisableLowPowerRunMode() != HAL_OK)
+        return HAL_ERROR;
+    if (p->voltage_range == PWR_REGULATOR_VOLTAGE_SCALE1
+        && HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE1) != HAL_OK)
+        return HAL_ERROR;
+    if (p->flash_latency > __HAL_FLASH_GET_LATENCY())
+    {
+        __HAL_FLASH_SET_LATENCY(p->flash_latency);
+        if (__HAL_FLASH_GET_LATENCY() != p->flash_latency)
+            return HAL_ERROR;
+    }
+
+    if (Clock_Switch(p) != HAL_OK)
+        return HAL_ERROR;
+
+    // Descida: wait states, faixa 2 e low-power run depois do clock
+    if (p->flash_latency < __HAL_FLASH_GET_LATENCY())
+        __HAL_FLASH_SET_LATENCY(p->flash_latency);
+    if (p->voltage_range == PWR_REGULATOR_VOLTAGE_SCALE2
+        && HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE2) != HAL_OK)
+        return HAL_ERROR;
+    if (p->low_power_run)
+        HAL_PWREx_EnableLowPowerRunMode();
+    return HAL_OK;
+}
+
+// A troca em si roda com as interrupções ligadas: os timeouts da HAL
+// dependem do SysTick, e o watchdog do ADC (proteção) não pode esperar.
+// Só a parada dos timers em um pulso e a volta deles com o PSC novo são
+// mascaradas; chamar com elas ligadas. Em erro, os PSCs seguem o clock em
+// que a troca parou.
+HAL_StatusTypeDef Clock_SetProfile(uint8_t profile)
+{
+    HAL_StatusTypeDef status;
+    uint32_t primask;
+
+    if (profile >= CLOCK_PROFILE_COUNT)
+        return HAL_ERROR;
+    if (profile == current)
+        return HAL_OK;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    Clock_HoldTimers();
+    __set_PRIMASK(primask);
+
+    status = Clock_Apply(&Clock_Profiles[profile]);
+    if (status == HAL_OK)
+        current = profile;
+
+    __disable_irq();
+    for (uint8_t i = 0; i < timer_count; i++)
+        Clock_RescaleTimer(&timers[i]);
+    __set_PRIMASK(primask);
+
+    if (status == HAL_OK)
+        Clock_ProfileChangedCallback(profile);
+    return status;
+}
+
+// Volta do STOP: o SYSCLK acorda no HSISYS com o PLL desligado. Regulador,
+// wait states, HSIDIV e PSCs são mantidos; só o perfil pleno religa o PLL.
+// Sem callback: nada muda para a aplicação.
+HAL_StatusTypeDef Clock_Resume(void)
+{
+    if (current >= CLOCK_PROFILE_COUNT || !Clock_Profiles[current].use_pll)
+        return HAL_OK;
+    return Clock_Switch(&Clock_Profiles[current]);
+}
+
+uint8_t Clock_GetProfile(void)
+{
+    return current;
+}
+
+// Clock dos timers: PCLK, dobrado quando o APB divide o HCLK
+uint32_t Clock_TimerHz(void)
+{
+    uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+
+    return ((RCC->CFGR & RCC_CFGR_PPRE) == RCC_HCLK_DIV1) ? pclk : 2U * pclk;
+}
+
+// PSC que leva o clock dos timers a 'count_hz', arredondado
+uint32_t Clock_Prescaler(uint32_t count_hz)
+{
+    return (Clock_TimerHz() + count_hz / 2U) / count_hz - 1U;
+}
+
+// Timer cuja frequência de contagem acompanha as trocas de perfil. Só
+// frequências exatas em todos os perfis são aceitas.
+HAL_StatusTypeDef Clock_RegisterTimer(TIM_HandleTypeDef *htim, uint32_t count_hz)
+{
+    if (htim == NULL || count_hz == 0U || count_hz > CLOCK_MIN_HZ
+        || timer_count >= CLOCK_MAX_TIMERS)
+        return HAL_ERROR;
+    for (uint8_t i = 0; i < CLOCK_PROFILE_COUNT; i++)
+    {
+        if (Clock_Profiles[i].sysclk_hz % count_hz != 0U)
+            return HAL_ERROR;
+    }
+
+    timers[timer_count].htim = htim;
+    timers[timer_count].count_hz = count_hz;
+    timers[timer_count].frozen = 0;
+    timers[timer_count].held = 0;
+    Clock_RescaleTimer(&timers[timer_count]);
+    timer_count++;
+    return HAL_OK;
+}
+
+__weak void Clock_ProfileChangedCallback(uint8_t profile)
+{
+    (void)profile;
+}
@@ -0,0 +1,27 @@
+#include "crc32.h"
+#include "port.h"
+
+static const uint32_t crc_nibble[16] =
+{
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU,
+};
+
+uint32_t Crc32_Update(uint32_t crc, const void *data, uint32_t len)
+{
+    const uint8_t *p = data;
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc ^= p[i];
+        crc = (crc >> 4) ^ crc_nibble[crc & 0x0FU];
+        crc = (crc >> 4) ^ crc_nibble[crc & 0x0FU];
+    }
+    PORT_CYCLES(20U * len);
+    return crc;
+}
+
+uint32_t Crc32(const void *data, uint32_t len)
+{
+    return ~Crc32_Update(CRC32_INIT, data, len);
+}
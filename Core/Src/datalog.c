@@ -0,0 +1,349 @@
+#include <string.h>
+#include "datalog.h"
+#include "crc32.h"
+#include "port.h"
+
+#define DATALOG_DWORD        8U
+#define DATALOG_BLANK        0xFFFFFFFFFFFFFFFFULL
+#define DATALOG_TEMP_MIN     -32768
+#define DATALOG_TEMP_MAX     32767
+
+// Buffer de bloco: cabeçalho e deltas, alinhado para a gravação
+typedef union
+{
+    struct
+    {
+        DataLog_Header head;
+        uint8_t data[DATALOG_PAYLOAD];
+    } b;
+    uint64_t dwords[DATALOG_BLOCK_SIZE / DATALOG_DWORD];
+} DataLog_Block;
+
+static DataLog_Stats stats;
+static DataLog_Block blocks[2];
+static uint32_t payload_crc[2];       // CRC parcial dos deltas de cada buffer
+static uint8_t filling = 0;           // Buffer que recebe as amostras
+static uint8_t pending = 0;           // O outro buffer está pronto para gravar
+static uint8_t writing = 0;           // Palavras duplas do pendente já gravadas
+static uint16_t slot = 0;             // Posição do próximo bloco no anel
+static uint16_t period_ms = 1000;
+static uint8_t page_dirty[DATALOG_PAGES];
+static uint8_t ready = 0;
+static volatile uint8_t ecc_fault = 0;
+
+// Última amostra do bloco em montagem (base dos deltas)
+static uint32_t last_ms;
+static int16_t last_temp;
+static uint8_t last_duty;
+static uint8_t last_flags;
+
+static uint32_t DataLog_SlotAddr(uint16_t s)
+{
+    return DATALOG_ADDR + (uint32_t)s * DATALOG_BLOCK_SIZE;
+}
+
+// Leitura de palavra dupla com erro de ECC descartado pelo NMI
+static uint8_t DataLog_Load(uint32_t addr, uint64_t *value)
+{
+    ecc_fault = 0;
+    *value = PORT_FLASH_READ64(addr);
+    PORT_CYCLES(6);
+    if (ecc_fault)
+    {
+        ecc_fault = 0;
+        return 0;
+    }
+    return 1;
+}
+
+// Bloco mais novo pelo número no cabeçalho: só a primeira palavra dupla
+// de cada posição é lida (magic, boot e número). Uma página com algum cabeçalho gravado (ou
+// estragado) precisa de apagamento antes de receber blocos de novo.
+HAL_StatusTypeDef DataLog_Init(uint16_t period)
+{
+    uint64_t dword;
+    uint8_t found = 0;
+    uint32_t newest_seq = 0;
+    uint16_t newest = 0, newest_boot = 0;
+
+    if (period == 0U)
+        return HAL_ERROR;
+    memset(&stats, 0, sizeof(stats));
+    memset(page_dirty, 0, sizeof(page_dirty));
+    period_ms = period;
+    filling = 0;
+    pending = 0;
+    writing = 0;
+    blocks[0].b.head.magic = 0;
+    blocks[1].b.head.magic = 0;
+
+    for (uint16_t s = 0; s < DATALOG_BLOCKS; s++)
+    {
+        uint8_t ok = DataLog_Load(DataLog_SlotAddr(s), &dword);
+
+        if (ok && dword == DATALOG_BLANK)
+            continue;
+        page_dirty[s / DATALOG_BLOCKS_PER_PAGE] = 1;
+        if (ok && (uint16_t)dword == DATALOG_MAGIC
+            && (!found || (int32_t)((uint32_t)(dword >> 32) - newest_seq) > 0))
+        {
+            found = 1;
+            newest_seq = (uint32_t)(dword >> 32);
+            newest_boot = (uint16_t)(dword >> 16);
+            newest = s;
+        }
+    }
+
+    if (found)
+    {
+        stats.seq = newest_seq + 1U;
+        stats.boot = (uint16_t)(newest_boot + 1U);
+        slot = (uint16_t)((newest + 1U) % DATALOG_BLOCKS);
+    }
+    else
+    {
+        stats.seq = 0;
+        stats.boot = 0;
+        slot = 0;
+    }
+    ready = 1;
+    return HAL_OK;
+}
+
+static uint8_t DataLog_PutVarint(uint8_t *out, uint32_t v)
+{
+    uint8_t n = 0;
+
+    while (v >= 0x80U)
+    {
+        out[n++] = (uint8_t)(v | 0x80U);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+// Fecha o bloco em montagem; o outro buffer passa a receber amostras.
+// Com o anterior ainda na flash, não há para onde ir: 0.
+static uint8_t DataLog_Close(void)
+{
+    if (pending)
+        return 0;
+    if (blocks[filling].b.head.magic != DATALOG_MAGIC)
+        return 1;
+    pending = 1;
+    writing = 0;
+    filling ^= 1U;
+    blocks[filling].b.head.magic = 0;
+    blocks[filling].b.head.used = 0;
+    return 1;
+}
+
+static void DataLog_Open(uint32_t time_ms, int16_t temp, uint8_t duty, uint8_t flags)
+{
+    DataLog_Block *blk = &blocks[filling];
+
+    memset(blk, 0xFF, sizeof(*blk));
+    blk->b.head.magic = DATALOG_MAGIC;
+    blk->b.head.used = 0;
+    blk->b.head.t0_ms = time_ms;
+    blk->b.head.temp0 = temp;
+    blk->b.head.duty0 = duty;
+    blk->b.head.flags0 = flags;
+    blk->b.head.boot = stats.boot;
+    blk->b.head.period_ms = period_ms;
+    payload_crc[filling] = CRC32_INIT;
+}
+
+// Uma amostra: a primeira do bloco vai inteira no cabeçalho, as demais
+// como delta da anterior
+void DataLog_Sample(uint32_t time_ms, int32_t temp_cdeg, uint16_t duty, uint8_t flags)
+{
+    DataLog_Block *blk;
+    uint8_t delta[DATALOG_MAX_DELTA];
+    uint8_t n = 0;
+    int16_t temp;
+    int32_t dtemp;
+    uint8_t tag = DATALOG_TAG_FULL;
+
+    if (!ready)
+        return;
+    if (temp_cdeg < DATALOG_TEMP_MIN)
+        temp_cdeg = DATALOG_TEMP_MIN;
+    else if (temp_cdeg > DATALOG_TEMP_MAX)
+        temp_cdeg = DATALOG_TEMP_MAX;
+    temp = (int16_t)temp_cdeg;
+    if (duty > 0xFFU)
+        duty = 0xFFU;
+
+    blk = &blocks[filling];
+    if (blk->b.head.magic != DATALOG_MAGIC)
+    {
+        DataLog_Open(time_ms, temp, (uint8_t)duty, flags);
+    }
+    else
+    {
+        dtemp = temp - last_temp;
+        if (time_ms - last_ms == period_ms && (uint8_t)duty == last_duty && flags == last_flags
+            && dtemp >= -64 && dtemp <= 63)
+        {
+            delta[n++] = (uint8_t)dtemp & 0x7FU;
+        }
+        else
+        {
+            n = 1;
+            if (time_ms - last_ms != period_ms)
+            {
+                tag |= DATALOG_TAG_TIME;
+                n += DataLog_PutVarint(&delta[n], time_ms - last_ms);
+            }
+            if (dtemp != 0)
+            {
+                tag |= DATALOG_TAG_TEMP;
+                n += DataLog_PutVarint(&delta[n], ((uint32_t)dtemp << 1) ^ (uint32_t)(dtemp >> 31));
+            }
+            if ((uint8_t)duty != last_duty)
+            {
+                tag |= DATALOG_TAG_DUTY;
+                delta[n++] = (uint8_t)duty;
+            }
+            if (flags != last_flags)
+            {
+                tag |= DATALOG_TAG_FLAGS;
+                delta[n++] = flags;
+            }
+            delta[0] = tag;
+        }
+        PORT_CYCLES(60);
+
+        if (blk->b.head.used + n > DATALOG_PAYLOAD)
+        {
+            // Bloco cheio: a amostra abre o próximo
+            if (!DataLog_Close())
+            {
+                stats.dropped++;
+                return;
+            }
+            DataLog_Open(time_ms, temp, (uint8_t)duty, flags);
+        }
+        else
+        {
+            memcpy(&blk->b.data[blk->b.head.used], delta, n);
+            payload_crc[filling] = Crc32_Update(payload_crc[filling], delta, n);
+            blk->b.head.used = (uint16_t)(blk->b.head.used + n);
+        }
+    }
+
+    last_ms = time_ms;
+    last_temp = temp;
+    last_duty = (uint8_t)duty;
+    last_flags = flags;
+    stats.samples++;
+}
+
+// Manda gravar o bloco em montagem mesmo incompleto (entrar em espera,
+// desligamento previsto)
+void DataLog_Flush(void)
+{
+    if (ready && blocks[filling].b.head.magic == DATALOG_MAGIC)
+        (void)DataLog_Close();
+}
+
+static void DataLog_NextSlot(void)
+{
+    slot = (uint16_t)((slot + 1U) % DATALOG_BLOCKS);
+    writing = 0;
+}
+
+// Uma etapa da gravação do bloco pendente: o apagamento da página, se for
+// a vez dela, ou uma palavra dupla. O cabeçalho vai primeiro e o número
+// do bloco e o CRC são fechados nessa hora; o CRC dos deltas já vem
+// acumulado de DataLog_Sample(), só falta passar o cabeçalho.
+void DataLog_Poll(void)
+{
+    DataLog_Block *blk = &blocks[filling ^ 1U];
+    uint16_t page = slot / DATALOG_BLOCKS_PER_PAGE;
+    uint16_t dwords;
+    HAL_StatusTypeDef status;
+
+    if (!ready || !pending)
+        return;
+
+    if (writing == 0U)
+    {
+        if (page_dirty[page] && slot % DATALOG_BLOCKS_PER_PAGE == 0U)
+        {
+            FLASH_EraseInitTypeDef erase = { 0 };
+            uint32_t page_error;
+
+            if (!DataLog_EraseAllowedCallback())
+                return;
+            erase.TypeErase = FLASH_TYPEERASE_PAGES;
+            erase.Banks = FLASH_BANK_1;
+            erase.Page = DATALOG_FIRST_PAGE + page;
+            erase.NbPages = 1;
+            HAL_FLASH_Unlock();
+            status = HAL_FLASHEx_Erase(&erase, &page_error);
+            HAL_FLASH_Lock();
+            stats.erases++;
+            if (status == HAL_OK)
+                page_dirty[page] = 0;
+            else
+                DataLog_NextSlot();
+            return;
+        }
+        blk->b.head.seq = stats.seq;
+        blk->b.head.crc = 0;
+        blk->b.head.crc = ~Crc32_Update(payload_crc[filling ^ 1U], &blk->b.head, sizeof(DataLog_Header));
+    }
+
+    dwords = (uint16_t)((sizeof(DataLog_Header) + blk->b.head.used + DATALOG_DWORD - 1U) / DATALOG_DWORD);
+    HAL_FLASH_Unlock();
+    status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD,
+                               DataLog_SlotAddr(slot) + (uint32_t)writing * DATALOG_DWORD, blk->dwords[writing]);
+    HAL_FLASH_Lock();
+    page_dirty[page] = 1;
+
+    if (status != HAL_OK)
+    {
+        // Posição estragada (corte anterior): o bloco vai inteiro para a próxima
+        stats.prog_errors++;
+        DataLog_NextSlot();
+        return;
+    }
+    if (++writing < dwords)
+        return;
+
+    stats.blocks++;
+    stats.bytes += (uint32_t)dwords * DATALOG_DWORD;
+    stats.seq++;
+    DataLog_NextSlot();
+    pending = 0;
+}
+
+uint8_t DataLog_Busy(void)
+{
+    return pending;
+}
+
+const DataLog_Stats *DataLog_GetStats(void)
+{
+    return &stats;
+}
+
+__weak uint8_t DataLog_EraseAllowedCallback(void)
+{
+    return 1;
+}
+
+uint8_t DataLog_EccNmiHandler(void)
+{
+    uint32_t eccr = FLASH->ECCR;
+    uint32_t addr = FLASH_BASE + (eccr & FLASH_ECCR_ADDR_ECC) * DATALOG_DWORD;
+
+    if ((eccr & FLASH_ECCR_ECCD) == 0U || addr < DATALOG_ADDR || addr >= DATALOG_ADDR + DATALOG_SIZE)
+        return 0;
+    FLASH->ECCR = (eccr & FLASH_ECCR_ECCCIE) | FLASH_ECCR_ECCD;
+    ecc_fault = 1;
+    return 1;
+}
@@ -3,73 +3,375 @@
 #include "stdint.h"
 #include "stm32g0xx_hal.h"
 #include "main.h"
+#include "port.h"
+#include "gpio_bus.h"
+#include "trace.h"
 
-static void LCD_EnablePulse(void);
-static void LCD_Send4Bits(uint8_t data);
+// --- Motor de transmissão ---
+// Cada operação da fila é um byte para o HD44780 mais flags. A ISR do
+// timer de um pulso percorre os passos de cada byte (nibble alto, nibble
+// baixo, tempo de execução) e reprograma o próximo disparo com o mínimo
+// exigido pelo datasheet, sem nenhuma espera ativa na CPU.
+#define LCD_OP_RS        0x0100U  // Dado (RS=1); sem a flag é comando
+#define LCD_OP_NIBBLE    0x0200U  // Só o nibble baixo do byte (init em 8 bits)
+#define LCD_OP_WAIT_Pos  10U      // Classe do tempo de execução (lcd_exec_us)
+#define LCD_OP_WAIT(n)   ((uint16_t)((n) << LCD_OP_WAIT_Pos))
+
+#define LCD_WAIT_EXEC    0U       // Maioria dos comandos e dados: 37 us
+#define LCD_WAIT_CLEAR   1U       // Clear / return home: 1.52 ms
+#define LCD_WAIT_INIT1   2U       // Após o 1º 0x3 da inicialização: 4.1 ms
+#define LCD_WAIT_INIT2   3U       // Após o 2º 0x3 da inicialização: 100 us
+
+#define LCD_QUEUE_LEN    64U      // Potência de 2; tela cheia = 34 operações
+
+// Tempos mínimos do HD44780 em us (datasheet, Vcc = 5 V)
+#define LCD_T_PW_US      1U       // Largura do pulso de EN (mín. 450 ns)
+#define LCD_T_CYCLE_US   1U       // EN baixo entre nibbles (ciclo mín. 1 us)
+
+// Os tempos de execução do datasheet valem para fosc = 270 kHz; o
+// oscilador RC do HD44780 vai de 190 a 350 kHz (Rf = 91k). Sem o R/W
+// o motor espera o do oscilador mais lento; com o busy flag, só começa a
+// ler depois do mais rápido e segue assim que o flag cai. Os dois da
+// inicialização são absolutos.
+#define LCD_FOSC_TYP_KHZ 270U
+#define LCD_FOSC_MIN_KHZ 190U
+#define LCD_FOSC_MAX_KHZ 350U
+#define LCD_EXEC_SLOW(us) (((us) * LCD_FOSC_TYP_KHZ + LCD_FOSC_MIN_KHZ - 1U) / LCD_FOSC_MIN_KHZ)
+#define LCD_EXEC_FAST(us) (((us) * LCD_FOSC_TYP_KHZ) / LCD_FOSC_MAX_KHZ)
+static const uint16_t lcd_exec_us[4] = { LCD_EXEC_SLOW(37U), LCD_EXEC_SLOW(1520U), 4100, 100 };
+static const uint16_t lcd_exec_fast_us[2] = { LCD_EXEC_FAST(37U), LCD_EXEC_FAST(1520U) };
+#define LCD_T_POLL_US    2U       // EN baixo entre duas leituras do busy flag
+
+typedef enum
+{
+    LCD_STEP_IDLE = 0,
+    LCD_STEP_SETUP,       // RS e nibble alto no barramento, EN ainda em 0
+    LCD_STEP_HIGH,        // EN = 1
+    LCD_STEP_HIGH_LATCH,  // EN = 0: HD44780 captura o nibble alto
+    LCD_STEP_LOW,         // Nibble baixo no barramento, EN = 1
+    LCD_STEP_LOW_LATCH,   // EN = 0: byte completo, aguarda execução
+    LCD_STEP_BF_HIGH,     // Busy flag (D4-D7 entrada, R/W = 1): EN = 1, BF em D7
+    LCD_STEP_BF_HIGH_LATCH, // Lê D7, EN = 0
+    LCD_STEP_BF_LOW,      // EN = 1: nibble baixo do contador (descartado)
+    LCD_STEP_BF_LOW_LATCH, // EN = 0: de novo se ocupado, senão volta a escrever
+    LCD_STEP_DONE         // Tempo de execução cumprido
+} LCD_Step;
+
+static TIM_HandleTypeDef *lcd_tim;
+static volatile uint16_t queue[LCD_QUEUE_LEN];
+static volatile uint8_t q_head = 0;  // Escrito só pelo laço principal
+static volatile uint8_t q_tail = 0;  // Escrito só pela ISR
+static volatile LCD_Step step = LCD_STEP_IDLE;
+static LCD_Stats stats;
+
+// R/W ligado a um pino: o motor lê o busy flag (LCD_EnableBusyFlag)
+static GPIO_TypeDef *rw_port = NULL;
+static uint16_t rw_pin = 0;
+static uint8_t bf_busy = 0;
+static uint16_t bf_waited_us = 0;     // Mínimo já esperado pelo byte em execução
+
+static void LCD_Push(uint16_t op);
 static void LCD_SendCommand(uint8_t cmd);
 static void LCD_SendData(uint8_t data);
 
-void LCD_EnablePulse(void)
+// Framebuffer: 'frame' é o que a aplicação quer mostrar, 'shadow' é o que
+// já está na DDRAM do display. LCD_Flush() envia só a diferença.
+static char frame[LCD_ROWS][LCD_COLS];
+static char shadow[LCD_ROWS][LCD_COLS];
+
+// Posição do cursor do HD44780, acompanhada para manter 'shadow' coerente
+// também com as escritas diretas de LCD_Print(). Reflete a fila, não o
+// que o display já executou.
+static uint8_t cursor_col = 0;
+static uint8_t cursor_row = 0;
+
+// Barramento D4-D7 (bits 0-3) e RS (bit 4, só com 'rs' em 1) agrupado
+// por port em tempo de compilação: no pinout do main.h, um nibble é uma
+// escrita em GPIOB (D5-D7) e outra em GPIOA (D4); o RS vai junto no GPIOC
+#define LCD_BUS_MASK(port, rs) \
+    (GPIO_BUS_PIN(port, LCD_D4_GPIO_Port, LCD_D4_Pin) | GPIO_BUS_PIN(port, LCD_D5_GPIO_Port, LCD_D5_Pin) | \
+     GPIO_BUS_PIN(port, LCD_D6_GPIO_Port, LCD_D6_Pin) | GPIO_BUS_PIN(port, LCD_D7_GPIO_Port, LCD_D7_Pin) | \
+     ((rs) ? GPIO_BUS_PIN(port, LCD_RS_GPIO_Port, LCD_RS_Pin) : 0U))
+#define LCD_BUS_SET(port, v) \
+    (GPIO_BUS_BIT(port, LCD_D4_GPIO_Port, LCD_D4_Pin, v, 0) | GPIO_BUS_BIT(port, LCD_D5_GPIO_Port, LCD_D5_Pin, v, 1) | \
+     GPIO_BUS_BIT(port, LCD_D6_GPIO_Port, LCD_D6_Pin, v, 2) | GPIO_BUS_BIT(port, LCD_D7_GPIO_Port, LCD_D7_Pin, v, 3) | \
+     GPIO_BUS_BIT(port, LCD_RS_GPIO_Port, LCD_RS_Pin, v, 4))
+#define LCD_BUS_WRITE(port, v, rs) GPIO_BusWrite(port, LCD_BUS_SET(port, v), LCD_BUS_MASK(port, rs))
+
+// 'bits': nibble nos bits 0-3 e RS no bit 4. Ports sem pino do barramento
+// não geram código.
+static inline void LCD_WriteBus(uint32_t bits, uint8_t rs)
 {
-    HAL_GPIO_WritePin(LCD_EN_GPIO_Port, LCD_EN_Pin, GPIO_PIN_SET);
-    for(volatile int i=0; i<1000; i++); // pequeno delay
-    HAL_GPIO_WritePin(LCD_EN_GPIO_Port, LCD_EN_Pin, GPIO_PIN_RESET);
-    for(volatile int i=0; i<1000; i++);
+    LCD_BUS_WRITE(GPIOA, bits, rs);
+    LCD_BUS_WRITE(GPIOB, bits, rs);
+    LCD_BUS_WRITE(GPIOC, bits, rs);
+    LCD_BUS_WRITE(GPIOD, bits, rs);
+    LCD_BUS_WRITE(GPIOF, bits, rs);
 }
 
+// D4-D7 como entrada (leitura do busy flag) ou de volta a saída
+static inline void LCD_BusInput(uint8_t input)
+{
+    GPIO_BusDirection(GPIOA, LCD_BUS_MASK(GPIOA, 0), input);
+    GPIO_BusDirection(GPIOB, LCD_BUS_MASK(GPIOB, 0), input);
+    GPIO_BusDirection(GPIOC, LCD_BUS_MASK(GPIOC, 0), input);
+    GPIO_BusDirection(GPIOD, LCD_BUS_MASK(GPIOD, 0), input);
+    GPIO_BusDirection(GPIOF, LCD_BUS_MASK(GPIOF, 0), input);
+}
 
-static void LCD_Send4Bits(uint8_t data)
+// Próximo passo do motor daqui a 'us' microssegundos (timer em um pulso;
+// ARR = us garante pelo menos 'us' completos, ARR = 0 travaria o contador)
+static void LCD_Schedule(uint32_t us)
 {
-    HAL_GPIO_WritePin(LCD_D4_GPIO_Port, LCD_D4_Pin, (data >> 0) & 0x01);
-    HAL_GPIO_WritePin(LCD_D5_GPIO_Port, LCD_D5_Pin, (data >> 1) & 0x01);
-    HAL_GPIO_WritePin(LCD_D6_GPIO_Port, LCD_D6_Pin, (data >> 2) & 0x01);
-    HAL_GPIO_WritePin(LCD_D7_GPIO_Port, LCD_D7_Pin, (data >> 3) & 0x01);
-    LCD_EnablePulse();
+    __HAL_TIM_SET_AUTORELOAD(lcd_tim, us);
+    __HAL_TIM_ENABLE(lcd_tim);
+}
+
+// RS e nibble alto no barramento; o EN só sobe no passo seguinte. Na
+// mesma ISR os dois ficariam a 1-2 ciclos de distância (RS e EN estão no
+// GPIOC), abaixo do tAS de 40-60 ns já a 64 MHz.
+static void LCD_StepSetup(uint16_t op)
+{
+    LCD_WriteBus(((op & LCD_OP_RS) ? 0x10U : 0U) | ((op & LCD_OP_NIBBLE) ? (op & 0x0FU) : ((op >> 4) & 0x0FU)), 1);
+    step = LCD_STEP_HIGH;
+    LCD_Schedule(LCD_T_CYCLE_US);
+}
+
+// Byte executado: o próximo da fila começa nesta mesma ISR
+static void LCD_StepDone(void)
+{
+    q_tail = (uint8_t)((q_tail + 1U) & (LCD_QUEUE_LEN - 1U));
+    if (q_tail == q_head)
+    {
+        step = LCD_STEP_IDLE;
+        TRACE(TRACE_LCD_DONE, 0U, 0U);
+        LCD_TxCpltCallback();
+    }
+    else
+        LCD_StepSetup(queue[q_tail]);
+}
+
+// Máquina de estados do motor, chamada a cada update do timer
+void LCD_TimerCallback(TIM_HandleTypeDef *htim)
+{
+    uint16_t op;
+
+    if (htim != lcd_tim || step == LCD_STEP_IDLE)
+        return;
+
+    op = queue[q_tail];
+    switch (step)
+    {
+    case LCD_STEP_SETUP:
+        LCD_StepSetup(op);
+        break;
+
+    case LCD_STEP_HIGH:
+        GPIO_PinSet(LCD_EN_GPIO_Port, LCD_EN_Pin);
+        step = LCD_STEP_HIGH_LATCH;
+        LCD_Schedule(LCD_T_PW_US);
+        break;
+
+    case LCD_STEP_HIGH_LATCH:
+        GPIO_PinReset(LCD_EN_GPIO_Port, LCD_EN_Pin);
+        if (op & LCD_OP_NIBBLE)
+        {
+            step = LCD_STEP_DONE;
+            LCD_Schedule(lcd_exec_us[(op >> LCD_OP_WAIT_Pos) & 0x3U]);
+        }
+        else
+        {
+            step = LCD_STEP_LOW;
+            LCD_Schedule(LCD_T_CYCLE_US);
+        }
+        break;
+
+    case LCD_STEP_LOW:
+        LCD_WriteBus(op & 0x0FU, 0);
+        GPIO_PinSet(LCD_EN_GPIO_Port, LCD_EN_Pin);
+        step = LCD_STEP_LOW_LATCH;
+        LCD_Schedule(LCD_T_PW_US);
+        break;
+
+    case LCD_STEP_LOW_LATCH:
+        GPIO_PinReset(LCD_EN_GPIO_Port, LCD_EN_Pin);
+        stats.bytes++;
+        if (rw_port != NULL && ((op >> LCD_OP_WAIT_Pos) & 0x3U) <= LCD_WAIT_CLEAR)
+        {
+            // Barramento já virado para leitura (RS e R/W depois do EN
+            // descer, tAH); nenhum HD44780 termina antes do tempo do
+            // oscilador mais rápido: a primeira leitura é aí
+            LCD_BusInput(1);
+            GPIO_PinReset(LCD_RS_GPIO_Port, LCD_RS_Pin);
+            GPIO_PinSet(rw_port, rw_pin);
+            bf_waited_us = lcd_exec_fast_us[(op >> LCD_OP_WAIT_Pos) & 0x1U];
+            step = LCD_STEP_BF_HIGH;
+            LCD_Schedule(bf_waited_us);
+            break;
+        }
+        step = LCD_STEP_DONE;
+        LCD_Schedule(lcd_exec_us[(op >> LCD_OP_WAIT_Pos) & 0x3U]);
+        break;
+
+    case LCD_STEP_BF_HIGH:
+        GPIO_PinSet(LCD_EN_GPIO_Port, LCD_EN_Pin);
+        step = LCD_STEP_BF_HIGH_LATCH;
+        LCD_Schedule(LCD_T_PW_US);
+        break;
+
+    case LCD_STEP_BF_HIGH_LATCH:
+        // tDDR (360 ns) já passou: D7 é o busy flag
+        bf_busy = (LCD_D7_GPIO_Port->IDR & LCD_D7_Pin) ? 1U : 0U;
+        GPIO_PinReset(LCD_EN_GPIO_Port, LCD_EN_Pin);
+        step = LCD_STEP_BF_LOW;
+        LCD_Schedule(LCD_T_CYCLE_US);
+        break;
+
+    case LCD_STEP_BF_LOW:
+        GPIO_PinSet(LCD_EN_GPIO_Port, LCD_EN_Pin);
+        step = LCD_STEP_BF_LOW_LATCH;
+        LCD_Schedule(LCD_T_PW_US);
+        break;
+
+    case LCD_STEP_BF_LOW_LATCH:
+        GPIO_PinReset(LCD_EN_GPIO_Port, LCD_EN_Pin);
+        stats.bf_polls++;
+        bf_waited_us = (uint16_t)(bf_waited_us + 2U * (LCD_T_CYCLE_US + LCD_T_PW_US));
+        if (bf_busy && bf_waited_us < lcd_exec_us[(op >> LCD_OP_WAIT_Pos) & 0x1U])
+        {
+            bf_waited_us = (uint16_t)(bf_waited_us + LCD_T_POLL_US);
+            step = LCD_STEP_BF_HIGH;
+            LCD_Schedule(LCD_T_POLL_US);
+            break;
+        }
+        // Livre, ou já esperou o pior caso do modo sem R/W (flag preso:
+        // display ausente ou R/W não ligado de fato)
+        if (bf_busy)
+            stats.bf_timeouts++;
+        // R/W e D4-D7 de volta à escrita; o próximo byte começa pelo
+        // LCD_STEP_SETUP, e o EN só sobe LCD_T_CYCLE_US depois (tAS do R/W)
+        GPIO_PinReset(rw_port, rw_pin);
+        LCD_BusInput(0);
+        LCD_StepDone();
+        break;
+
+    default: // LCD_STEP_DONE
+        LCD_StepDone();
+        break;
+    }
+}
+
+// Fila cheia é raro (só se a aplicação escreve mais de uma tela por
+// flush): dorme até a ISR liberar uma posição
+static void LCD_Push(uint16_t op)
+{
+    uint8_t next = (uint8_t)((q_head + 1U) & (LCD_QUEUE_LEN - 1U));
+    uint32_t primask;
+
+    while (next == q_tail)
+    {
+        __WFI();
+    }
+    queue[q_head] = op;
+    q_head = next;
+
+    // Motor parado: dispara o primeiro passo
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (step == LCD_STEP_IDLE)
+    {
+        step = LCD_STEP_SETUP;
+        LCD_Schedule(LCD_T_CYCLE_US);
+    }
+    __set_PRIMASK(primask);
 }
 
 static void LCD_SendCommand(uint8_t cmd)
 {
-    HAL_GPIO_WritePin(LCD_RS_GPIO_Port, LCD_RS_Pin, GPIO_PIN_RESET);
-    LCD_Send4Bits(cmd >> 4);
-    LCD_Send4Bits(cmd & 0x0F);
-    HAL_Delay(2);
+    uint16_t wait = (cmd <= 0x03) ? LCD_OP_WAIT(LCD_WAIT_CLEAR) : LCD_OP_WAIT(LCD_WAIT_EXEC);
+
+    LCD_Push(wait | cmd);
 }
 
 static void LCD_SendData(uint8_t data)
 {
-    HAL_GPIO_WritePin(LCD_RS_GPIO_Port, LCD_RS_Pin, GPIO_PIN_SET);
-    LCD_Send4Bits(data >> 4);
-    LCD_Send4Bits(data & 0x0F);
-    HAL_Delay(1);
+    LCD_Push(LCD_OP_RS | LCD_OP_WAIT(LCD_WAIT_EXEC) | data);
+
+    // Colunas além da 16ª caem na DDRAM invisível
+    if (cursor_col < LCD_COLS)
+        shadow[cursor_row][cursor_col] = (char)data;
+    cursor_col++;
+}
+
+// Retorna 1 enquanto houver operações na fila ou um byte em andamento
+uint8_t LCD_IsBusy(void)
+{
+    return step != LCD_STEP_IDLE;
+}
+
+// Liga a leitura do busy flag: 'port'/'pin' é o R/W do display,
+// configurado como saída. Pode ser chamada logo depois de LCD_Init(): os
+// nibbles da inicialização em 8 bits seguem com os tempos fixos (o flag
+// não pode ser lido antes do modo 4 bits). Sem chamá-la, o R/W fica
+// aterrado e valem os tempos do oscilador mais lento.
+void LCD_EnableBusyFlag(GPIO_TypeDef *port, uint16_t pin)
+{
+    uint32_t primask;
+
+    GPIO_PinReset(port, pin);
+    primask = __get_PRIMASK();
+    __disable_irq();
+    rw_port = port;
+    rw_pin = pin;
+    __set_PRIMASK(primask);
+}
+
+const LCD_Stats *LCD_GetStats(void)
+{
+    return &stats;
 }
 
-void LCD_Init(void)
+// Chamada pela ISR quando a fila esvazia; a aplicação pode redefinir
+__weak void LCD_TxCpltCallback(void)
 {
+}
+
+// 'htim': timer básico em um pulso a 1 MHz com interrupção de update
+// habilitada. LCD_TimerCallback() deve ser chamada no seu update.
+void LCD_Init(TIM_HandleTypeDef *htim)
+{
+    lcd_tim = htim;
+    q_head = 0;
+    q_tail = 0;
+    step = LCD_STEP_IDLE;
+    rw_port = NULL;
+    memset(&stats, 0, sizeof(stats));
+
     HAL_Delay(50); // Espera após power-up
     HAL_GPIO_WritePin(LCD_RS_GPIO_Port, LCD_RS_Pin, GPIO_PIN_RESET);
     HAL_GPIO_WritePin(LCD_EN_GPIO_Port, LCD_EN_Pin, GPIO_PIN_RESET);
 
-    // Inicialização modo 4 bits
-    LCD_Send4Bits(0x03);
-    HAL_Delay(5);
-    LCD_Send4Bits(0x03);
-    HAL_Delay(5);
-    LCD_Send4Bits(0x03);
-    HAL_Delay(5);
-    LCD_Send4Bits(0x02); // 4 bits
-    HAL_Delay(1);
+    // Inicialização modo 4 bits (sequência por instrução do datasheet)
+    LCD_Push(LCD_OP_NIBBLE | LCD_OP_WAIT(LCD_WAIT_INIT1) | 0x03);
+    LCD_Push(LCD_OP_NIBBLE | LCD_OP_WAIT(LCD_WAIT_INIT2) | 0x03);
+    LCD_Push(LCD_OP_NIBBLE | LCD_OP_WAIT(LCD_WAIT_EXEC) | 0x03);
+    LCD_Push(LCD_OP_NIBBLE | LCD_OP_WAIT(LCD_WAIT_EXEC) | 0x02); // 4 bits
 
     LCD_SendCommand(0x28); // 2 linhas, 4 bits, 5x8 dots
     LCD_SendCommand(0x0C); // Display ON, cursor OFF
     LCD_SendCommand(0x06); // Incremento automático
-    LCD_SendCommand(0x01); // Clear
-    HAL_Delay(2);
+    LCD_Clear();
 }
 
 void LCD_Clear(void)
 {
     LCD_SendCommand(0x01);
-    HAL_Delay(2);
+
+    // O clear apaga a DDRAM e volta o cursor para (0, 0)
+    memset(shadow, ' ', sizeof(shadow));
+    memset(frame, ' ', sizeof(frame));
+    cursor_col = 0;
+    cursor_row = 0;
 }
 
 void LCD_SetCursor(uint8_t col, uint8_t row)
@@ -77,6 +379,8 @@ void LCD_SetCursor(uint8_t col, uint8_t row)
     uint8_t addr = (row == 0) ? 0x00 : 0x40;
     addr += col;
     LCD_SendCommand(0x80 | addr);
+    cursor_col = col;
+    cursor_row = (row == 0) ? 0 : 1;
 }
 
 void LCD_Print(char* str)
@@ -95,3 +399,195 @@ void LCD_DisplayWelcome(void)
     LCD_SetCursor(0, 1);
     LCD_Print("   STM32 + LCD   ");
 }
+
+// --- Framebuffer ---
+
+// Limpa o framebuffer (só RAM; o display muda no próximo LCD_Flush)
+void LCD_BufferClear(void)
+{
+    memset(frame, ' ', sizeof(frame));
+}
+
+// Escreve um texto no framebuffer a partir de (col, row), cortado na
+// borda direita. Não gera tráfego no barramento do LCD. Retorna a coluna
+// seguinte ao texto, para encadear campos.
+uint8_t LCD_BufferPrint(uint8_t col, uint8_t row, const char *str)
+{
+    uint8_t start = col;
+
+    if (row >= LCD_ROWS)
+        return col;
+    while (*str && col < LCD_COLS)
+    {
+        frame[row][col++] = *str++;
+    }
+    PORT_CYCLES(10U + 6U * (col - start));
+    return col;
+}
+
+// --- Formatação sem printf ---
+// O Cortex-M0+ não divide em hardware: cada '/ 10' seria uma chamada a
+// __aeabi_uidiv. Os dígitos saem por subtração de potências de 10.
+
+static const uint32_t pow10[] = {
+    1000000000U, 100000000U, 10000000U, 1000000U, 100000U,
+    10000U, 1000U, 100U, 10U, 1U
+};
+
+// Dígitos decimais de 'value' em 'out' (sem terminador); retorna quantos
+static uint8_t LCD_UIntToDigits(uint32_t value, char *out)
+{
+    uint8_t i = 0;
+    uint8_t n = 0;
+
+    while (i < 9U && value < pow10[i])
+        i++;
+    for (; i < 10U; i++)
+    {
+        char d = '0';
+        while (value >= pow10[i])
+        {
+            value -= pow10[i];
+            d++;
+        }
+        out[n++] = d;
+    }
+    PORT_CYCLES(12U + 14U * n);
+    return n;
+}
+
+// Grava 'len' caracteres alinhados à direita num campo de 'width' células
+// preenchido com 'pad' (width menor que len: o campo cresce)
+static uint8_t LCD_PutRight(uint8_t col, uint8_t row, const char *text, uint8_t len,
+                            uint8_t width, char pad)
+{
+    uint8_t start = col;
+
+    if (row >= LCD_ROWS)
+        return col;
+    while (width > len && col < LCD_COLS)
+    {
+        frame[row][col++] = pad;
+        width--;
+    }
+    for (uint8_t i = 0; i < len && col < LCD_COLS; i++)
+        frame[row][col++] = text[i];
+    PORT_CYCLES(10U + 6U * (col - start));
+    return col;
+}
+
+// Inteiro sem sinal alinhado à direita em 'width' células ('0' ou ' ' à
+// esquerda). width = 0 usa só os dígitos necessários.
+uint8_t LCD_BufferPutUInt(uint8_t col, uint8_t row, uint32_t value, uint8_t width, char pad)
+{
+    char digits[10];
+    uint8_t n = LCD_UIntToDigits(value, digits);
+
+    return LCD_PutRight(col, row, digits, n, width, pad);
+}
+
+// Ponto fixo decimal: 'value' em unidades de 10^-frac, impresso com 'frac'
+// casas (ex.: 2734 com frac = 2 vira "27.34"). Alinhado à direita em
+// 'width' células com espaços; o sinal fica colado ao número.
+uint8_t LCD_BufferPutFixed(uint8_t col, uint8_t row, int32_t value, uint8_t frac, uint8_t width)
+{
+    char text[13];
+    char digits[10];
+    uint32_t mag = (value < 0) ? 0U - (uint32_t)value : (uint32_t)value;
+    uint8_t n = LCD_UIntToDigits(mag, digits);
+    uint8_t len = 0;
+    uint8_t lead;
+
+    if (frac > 9U)
+        frac = 9U;
+    if (value < 0)
+        text[len++] = '-';
+
+    // Parte inteira: pelo menos um dígito
+    lead = (n > frac) ? (uint8_t)(n - frac) : 0U;
+    if (lead == 0U)
+        text[len++] = '0';
+    for (uint8_t i = 0; i < lead; i++)
+        text[len++] = digits[i];
+
+    // Parte fracionária com zeros à esquerda
+    if (frac > 0U)
+    {
+        text[len++] = '.';
+        for (uint8_t i = n; i < frac; i++)
+            text[len++] = '0';
+        for (uint8_t i = lead; i < n; i++)
+            text[len++] = digits[i];
+    }
+    PORT_CYCLES(20U + 4U * len);
+    return LCD_PutRight(col, row, text, len, width, ' ');
+}
+
+// Texto alinhado à esquerda num campo de 'width' células: cortado se
+// maior, completado com espaços se menor
+uint8_t LCD_BufferPutField(uint8_t col, uint8_t row, const char *str, uint8_t width)
+{
+    uint8_t start = col;
+
+    if (row >= LCD_ROWS)
+        return col;
+    while (width > 0U && col < LCD_COLS)
+    {
+        frame[row][col++] = *str ? *str++ : ' ';
+        width--;
+    }
+    PORT_CYCLES(10U + 6U * (col - start));
+    return col;
+}
+
+// Conteúdo de uma linha do framebuffer (LCD_COLS caracteres, sem
+// terminador), para quem precisa espelhar a tela
+const char *LCD_BufferRow(uint8_t row)
+{
+    return (row < LCD_ROWS) ? frame[row] : NULL;
+}
+
+// Enfileira só as células que mudaram. Trechos sujos separados por até
+// LCD_MERGE_GAP células limpas viram um único trecho: reenviar uma célula
+// custa o mesmo que reposicionar o cursor (uma operação de 37 us) e evita
+// um trecho a mais na fila.
+void LCD_Flush(void)
+{
+    uint16_t sent = 0;
+
+    for (uint8_t row = 0; row < LCD_ROWS; row++)
+    {
+        uint8_t col = 0;
+
+        while (col < LCD_COLS)
+        {
+            // Início do próximo trecho sujo
+            while (col < LCD_COLS && frame[row][col] == shadow[row][col])
+                col++;
+            if (col == LCD_COLS)
+                break;
+
+            // Fim do trecho, absorvendo lacunas curtas de células limpas
+            uint8_t start = col;
+            uint8_t end = col;
+            while (col < LCD_COLS && col - end <= LCD_MERGE_GAP + 1)
+            {
+                if (frame[row][col] != shadow[row][col])
+                    end = col;
+                col++;
+            }
+
+            if (cursor_row != row || cursor_col != start)
+            {
+                LCD_SetCursor(start, row);
+                sent++;
+            }
+            for (uint8_t c = start; c <= end; c++)
+                LCD_SendData((uint8_t)frame[row][c]);
+            sent += (uint16_t)(end + 1U - start);
+            col = end + 1;
+        }
+    }
+    if (sent != 0U)
+        TRACE(TRACE_LCD_FLUSH, 0U, sent);
+}
@@ -1,142 +1,566 @@
 #include "stm32g0xx_hal.h"
 #include "lcd.h" // Nosso driver LCD em 4 bits
-#include "stdio.h"
 #include "stdint.h"
 #include "main.h"
+#include "clock.h"
+#include "profile.h"
+#include "temp_sensor.h"
+#include "scheduler.h"
+#include "buttons.h"
+#include "pwm.h"
+#include "protect.h"
+#include "pid.h"
+#include "autotune.h"
+#include "power.h"
+#include "settings.h"
+#include "datalog.h"
+#include "timebase.h"
+#include "trace.h"
+#include "telemetry.h"
 
 // --- Definições de periféricos ---
 TIM_HandleTypeDef htim1;
+TIM_HandleTypeDef htim3; // Gatilho do ADC
+TIM_HandleTypeDef htim6; // Motor de transmissão do LCD
+TIM_HandleTypeDef htim7; // Base de tempo em us (timebase.c)
+TIM_HandleTypeDef htim14; // Tick de debounce dos botões
 ADC_HandleTypeDef hadc1;
+DMA_HandleTypeDef hdma_adc1;
+DMA_HandleTypeDef hdma_tim1_up; // Rampas de PWM (burst em CCR1)
+DMA_HandleTypeDef hdma_usart2_tx; // Telemetria (telemetry.c)
 GPIO_InitTypeDef GPIO_InitStruct = {0};
 
 // --- Variáveis globais ---
 uint16_t duty_cycle = 0; // Duty cycle do PWM (0 a 100%)
 uint8_t current_screen = 0; // Tela atual do display (0 ou 1)
-uint8_t temp_alert_active = 0; // Flag de alerta de temperatura
-float temperature = 0.0; // Valor lido do LM35 em °C
+volatile uint8_t temp_alert_active = 0; // Flag de alerta de temperatura (ISR do ADC)
+int32_t temperature_cdeg = 0; // Valor lido do LM35 em centésimos de °C
 uint16_t countdown_timer = 60; // Timer regressivo em segundos
+uint8_t control_mode = CONTROL_MANUAL; // Control_Mode
+int32_t setpoint_cdeg = 2700; // Setpoint do modo automático, em centésimos de °C
+
+#define SPLASH_MS 2000 // Tempo da tela de boas-vindas
+#define TEMP_ALARM_CDEG 3000 // Limite padrão do alarme: 30,00 °C
+#define TEMP_ALARM_MIN_CDEG 2500 // Faixa aceita para o limite gravado
+#define TEMP_ALARM_MAX_CDEG 9900
+#define TEMP_ALARM_HYST_CDEG 50 // Sai do alarme 0,50 °C abaixo do limite
+static int32_t alarm_cdeg = TEMP_ALARM_CDEG;
+
+// Sobretemperatura corta o PWM no break do TIM1; religa sozinho 5 s depois
+// que a temperatura cai, até 3 vezes. Depois disso, só com SCREEN longo.
+static const Protect_Policy protect_policy = { PROTECT_AUTO_REARM, 3, 5000 };
+
+// PWM de 20 kHz (fora da faixa audível) com 500 ns de dead time e pelo
+// menos 100 passos de duty: cabe nos três perfis (100 passos a 2 MHz,
+// 3200 a 64 MHz), bem abaixo dos 5% da interface
+static const Pwm_Config pwm_config = { 20000, 100, 500 };
+
+// Espera: um minuto sem uso com a saída desligada, a aquisição cai para
+// uma leitura por segundo e o núcleo fica em STOP entre as tarefas.
+// Botão, alarme ou saída ligada voltam à aquisição contínua.
+#define STANDBY_AFTER_MS 60000
+#define STANDBY_SAMPLE_MS 1000
+static uint8_t standby = 0;
+static uint32_t activity_tick = 0; // HAL_GetTick() do último uso
+static uint32_t standby_sample_tick = 0;
+
+#define CONTROL_SP_MIN_CDEG 2000
+#define CONTROL_SP_MAX_CDEG (alarm_cdeg - 100) // Longe do alarme
+#define CONTROL_SP_STEP_CDEG 50 // Passo de UP/DOWN no modo automático
+
+// Malha de temperatura: erro em centésimos de °C, saída em por mil do PWM.
+// Um período por média nova do ADC (TempSensor_PeriodMs()). Os ganhos
+// de partida são trocados pelos da auto-sintonia quando ela conclui.
+static Pid_Config temp_pid_config =
+{
+    .kp = PID_Q16(15.0),
+    .ki = PID_Q16(0.4),
+    .kd = PID_Q16(60.0),
+    .d_filter_ms = 1000,
+    .out_min = 0,
+    .out_max = 1000,
+};
+static Pid_Controller temp_pid;
+
+// Auto-sintonia por relé em torno do setpoint: ±20% de PWM sobre a saída
+// atual do PID. Desiste se a medida se afastar 0,8 °C (o alarme fica
+// acima) ou sem três ciclos concordantes em 30 min. Tyreus-Luyben PI:
+// o menor sobressinal nas plantas térmicas do bench_autotune.
+static const Autotune_Config temp_tune_config =
+{
+    .amplitude = 200,
+    .hysteresis = 5,
+    .out_min = 0,
+    .out_max = 1000,
+    .max_deviation = 80,
+    .timeout_ms = 1800000U,
+    .cycles = 3,
+    .tolerance_pct = 10,
+    .rule = AUTOTUNE_RULE_TL_PI,
+};
+static Autotune temp_tuner;
+
+// Ajustes persistentes (settings.c): gravados 2 s depois da última
+// mudança, para uma sequência de UP/DOWN virar um registro só, ou a cada
+// 30 s enquanto o valor não para (timer regressivo). O duty só vale no
+// manual; no automático é a saída do PID.
+#define SETTINGS_SAVE_DELAY_MS 2000
+#define SETTINGS_SAVE_MAX_MS 30000
+typedef struct
+{
+    uint16_t duty;
+    uint16_t countdown;
+    int32_t alarm_cdeg;
+    uint8_t screen;
+} App_Settings;
+static uint8_t settings_ok = 0;
+static uint8_t settings_dirty = 0;
+static App_Settings settings_seen; // Última leitura da tarefa
+static uint32_t settings_changed_tick = 0;
+static uint32_t settings_dirty_tick = 0;
+
+// Registro de campo (datalog.c): uma amostra por segundo no tempo nominal
+#define LOG_PERIOD_MS 1000
+static uint32_t log_tick = 0;
+
+// Telemetria (telemetry.c): uma amostra a cada Telemetry_GetPeriod() na
+// taxa cheia e a cada STANDBY_SAMPLE_MS em espera, com as leituras
+static uint32_t telemetry_tick = 0;
+
+// --- Tarefas agendadas ---
+static int8_t task_buzzer_off;
+static int8_t task_buttons;
+static int8_t task_countdown;
+static int8_t task_display;
+static int8_t task_splash;
 
 // --- Protótipos ---
 void SystemClock_Config(void);
 void GPIO_Init(void);
+void DMA_Init(void);
 void TIM1_Init(void);
+void TIM3_Init(void);
+void TIM6_Init(void);
+void TIM7_Init(void);
+void TIM14_Init(void);
+void USART2_Init(void);
 void ADC1_Init(void);
 void Buzzer_Beep(uint16_t duration_ms);
-void ReadTemperature(void);
+void SetDutyCycle(uint16_t duty);
+uint8_t ReadTemperature(void);
+void Control_Step(void);
+void Control_SetMode(uint8_t mode);
 void UpdateDisplay(void);
+void Task_Temperature(void);
+void Task_AlarmBlink(void);
+void Task_BuzzerOff(void);
+void Task_SplashDone(void);
+void Task_Buttons(void);
+void Task_Countdown(void);
+void Task_AdcCalibrate(void);
+void Task_Standby(void);
+void Task_Settings(void);
+void Task_Log(void);
+void Task_Telemetry(void);
+uint16_t LoadSettings(void);
+static void Standby_Activity(void);
 
 int main(void)
 {
+    uint16_t saved_duty;
+
     HAL_Init();
+    Trace_Init(); // Antes das tarefas: guarda os nomes
     SystemClock_Config();
+    TIM7_Init(); // Base de tempo em us, antes de quem mede tempo
     GPIO_Init();
+    DMA_Init();
     TIM1_Init(); // Inicializa PWM com dead-time (canal CH1 e CH1N)
+    TIM3_Init(); // Base de tempo da amostragem do ADC
+    TIM6_Init(); // Temporização do LCD em segundo plano
+    TIM14_Init(); // Debounce dos botões
     ADC1_Init();
-    LCD_Init();
+    USART2_Init(); // Telemetria pelo DMA
+    LCD_Init(&htim6);
+#ifdef LCD_RW_Pin
+    LCD_EnableBusyFlag(LCD_RW_GPIO_Port, LCD_RW_Pin);
+#endif
+    Buttons_Init(&htim14);
+
+    // Ajustes e registro de campo na flash: antes do Protect_Init, porque
+    // com o ECCL ligado uma palavra interrompida por falta de energia
+    // dispararia o break
+    saved_duty = LoadSettings();
+    if (DataLog_Init(LOG_PERIOD_MS) != HAL_OK)
+    {
+        while (1);
+    }
+
+    // Inicia PWM no canal 1 e seu complementar (CH1N), com preload. A
+    // proteção vem antes do alarme: o primeiro disparo já encontra MOE ligado.
+    if (Pwm_Init(&htim1, TIM_CHANNEL_1) != HAL_OK || Pwm_Configure(&pwm_config, NULL) != HAL_OK
+        || Pwm_Start() != HAL_OK
+        || Protect_Init(&htim1, &protect_policy) != HAL_OK)
+    {
+        while (1);
+    }
+
+    // Aquisição contínua do LM35 por TIM3 + ADC1 + DMA circular, com o
+    // oversampler do ADC em 16 bits e calibração antes da primeira leitura.
+    // O alarme fica no watchdog analógico do ADC.
+    TempSensor_SetAlarm(alarm_cdeg, alarm_cdeg - TEMP_ALARM_HYST_CDEG);
+    if (TempSensor_Start(&hadc1, &htim3, &TempSensor_Profile16Bit) != HAL_OK
+        || Pid_Init(&temp_pid, &temp_pid_config, TempSensor_PeriodMs()) != HAL_OK)
+    {
+        while (1);
+    }
+
+    // RTC no LSI: base de tempo do STOP entre as tarefas
+    if (Power_Init() != HAL_OK)
+    {
+        while (1);
+    }
 
-    // Inicia PWM no canal 1 e seu complementar (CH1N)
-    HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_1);
-    HAL_TIMEx_PWMN_Start(&htim1, TIM_CHANNEL_1);
+    // O duty gravado volta com a rampa de partida
+    if (saved_duty > 0)
+        SetDutyCycle(saved_duty);
 
     LCD_DisplayWelcome();
+    // Marca o boot para quem está lendo a telemetria
+    Telemetry_SendText("partida", 7);
+
+    // --- Tarefas ---
+    // Prioridade 0: caminho de temperatura/alarme, com latência limitada
+    // à pior tarefa em execução, independente da interface
+    Sched_AddPeriodic("Temperatura", Task_Temperature, 10, 0);
+    Sched_AddPeriodic("Alarme", Task_AlarmBlink, 100, 0);
+    Sched_AddPeriodic("Protecao", Protect_Poll, PROTECT_POLL_MS, 0);
+    task_buzzer_off = Sched_AddOneShot("Buzzer", Task_BuzzerOff, 0);
+    task_buttons = Sched_AddPeriodic("Botoes", Task_Buttons, 10, 1);
+    task_countdown = Sched_AddPeriodic("Countdown", Task_Countdown, 1000, 2);
+    task_splash = Sched_AddOneShot("Boas-vindas", Task_SplashDone, 3);
+    task_display = Sched_AddPeriodic("Display", UpdateDisplay, 200, 3);
+    Sched_AddPeriodic("Calibra ADC", Task_AdcCalibrate, TEMP_CAL_PERIOD_MS, 3);
+    Sched_AddPeriodic("Espera", Task_Standby, 100, 3);
+    Sched_AddPeriodic("Ajustes", Task_Settings, 1000, 3);
+    Sched_AddPeriodic("Registro", Task_Log, 10, 3);
+    Sched_AddPeriodic("Telemetria", Task_Telemetry, 10, 3);
+
+    // A interface só começa depois da tela de boas-vindas
     Buzzer_Beep(200);
-    HAL_Delay(2000);
-    LCD_Clear();
+    Sched_Trigger(task_splash, SPLASH_MS);
+    Sched_Trigger(task_buttons, SPLASH_MS);
+    Sched_Trigger(task_countdown, SPLASH_MS);
+    Sched_Trigger(task_display, SPLASH_MS);
+
+    Sched_Run();
+}
+
+// --- Tarefas do escalonador ---
+
+// Consome a média de temperatura quando houver uma nova e, no modo
+// automático ou na sintonia, fecha a malha com ela. O limiar do alarme é avaliado pelo
+// watchdog do ADC, não aqui. Em espera, uma leitura suspende a aquisição.
+void Task_Temperature(void)
+{
+    if (!ReadTemperature())
+        return;
+    if (standby)
+        TempSensor_Suspend();
+    if (control_mode != CONTROL_MANUAL)
+        Control_Step();
+}
+
+// Entrada e saída do alarme, na interrupção do watchdog do ADC. O break
+// desliga o estágio de potência ainda dentro da ISR.
+void TempSensor_AlarmCallback(uint8_t active)
+{
+    temp_alert_active = active;
+    if (active)
+        Protect_Trip(PROTECT_FAULT_OVERTEMP);
+    else
+        Protect_Release(PROTECT_FAULT_OVERTEMP);
+}
 
-    uint32_t last_temp_read = 0;
-    uint32_t last_timer_tick = 0;
-    uint32_t last_display_update = 0;
-    uint32_t last_alarm_toggle = 0;
+// Pisca LED e buzzer a cada 100ms se em alarme
+void Task_AlarmBlink(void)
+{
+    static uint8_t blinking = 0;
 
-    while (1)
+    PROF_BEGIN(PROF_ALARM);
+    if (temp_alert_active)
     {
-        // Leitura periódica da temperatura (a cada 100ms)
-        if (HAL_GetTick() - last_temp_read >= 100)
-        {
-            last_temp_read = HAL_GetTick();
-            ReadTemperature();
-        }
+        HAL_GPIO_TogglePin(ALARM_LED_GPIO_PORT, ALARM_LED);
+        HAL_GPIO_TogglePin(BUZZER_GPIO_PORT, BUZZER);
+        blinking = 1;
+    }
+    else if (blinking)
+    {
+        // Só na saída do alarme, para não cortar os bipes da interface
+        blinking = 0;
+        HAL_GPIO_WritePin(ALARM_LED_GPIO_PORT, ALARM_LED, GPIO_PIN_RESET);
+        HAL_GPIO_WritePin(BUZZER_GPIO_PORT, BUZZER, GPIO_PIN_RESET);
+    }
+    PROF_END(PROF_ALARM);
+}
 
-        // Lógica de alarme por temperatura
-        if (temperature >= 30.0)
-        {
-            temp_alert_active = 1;
-        }
-        else
-        {
-            temp_alert_active = 0;
-            HAL_GPIO_WritePin(ALARM_LED_GPIO_PORT, ALARM_LED, GPIO_PIN_RESET);
-            HAL_GPIO_WritePin(BUZZER_GPIO_PORT, BUZZER, GPIO_PIN_RESET);
-        }
+void Task_BuzzerOff(void)
+{
+    HAL_GPIO_WritePin(BUZZER_GPIO_PORT, BUZZER, GPIO_PIN_RESET);
+}
 
-        // Pisca LED e buzzer a cada 100ms se em alarme
-        if (temp_alert_active && (HAL_GetTick() - last_alarm_toggle >= 100))
-        {
-            last_alarm_toggle = HAL_GetTick();
-            HAL_GPIO_TogglePin(ALARM_LED_GPIO_PORT, ALARM_LED);
-            HAL_GPIO_TogglePin(BUZZER_GPIO_PORT, BUZZER);
-        }
+void Task_SplashDone(void)
+{
+    LCD_Clear();
+}
+
+// Consome os eventos dos botões sem bloquear. Segurar UP/DOWN repete o
+// passo de 5% a cada BUTTON_REPEAT_MS. O SCREEN troca de tela na soltura,
+// e só se a pressão não chegou ao LONG: o PRESS vem antes de se saber se
+// ela vai ser longa.
+void Task_Buttons(void)
+{
+    static uint8_t screen_long = 0; // LONG do SCREEN já atendido nesta pressão
+    Button_Event ev;
 
-        // Atualização do display a cada 200ms
-        if (HAL_GetTick() - last_display_update >= 200)
+    PROF_BEGIN(PROF_BUTTONS);
+    while (Buttons_GetEvent(&ev))
+    {
+        Standby_Activity();
+
+        // SCREEN longo religa a saída travada pela proteção ou, sem
+        // proteção atuando, passa por manual -> automático -> sintonia
+        if (ev.button == BUTTON_ID_SCREEN && ev.type == BUTTON_EV_LONG)
         {
-            last_display_update = HAL_GetTick();
-            UpdateDisplay();
+            screen_long = 1;
+            if (!Protect_IsTripped())
+            {
+                Control_SetMode((control_mode == CONTROL_TUNE) ? CONTROL_MANUAL
+                                                               : control_mode + 1U);
+                Buzzer_Beep(200);
+            }
+            else if (Protect_Clear() == HAL_OK)
+                Buzzer_Beep(200);
+            continue;
         }
-
-        // Botão UP: aumenta duty cycle em 5%
-        if (HAL_GPIO_ReadPin(BUTTON_GPIO_PORT, BUTTON_UP) == GPIO_PIN_RESET)
+        if (ev.button == BUTTON_ID_SCREEN) // Alterna entre telas, sem repetição
         {
-            if (duty_cycle < 100)
+            if (ev.type == BUTTON_EV_PRESS)
+                screen_long = 0;
+            else if (ev.type == BUTTON_EV_RELEASE && !screen_long)
             {
-                duty_cycle += 5;
-                __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_1, (duty_cycle * (htim1.Init.Period + 1)) / 100);
+                current_screen ^= 1;
                 Buzzer_Beep(50);
-                HAL_Delay(200);
             }
+            continue;
         }
+        if (ev.type != BUTTON_EV_PRESS && ev.type != BUTTON_EV_REPEAT)
+            continue;
 
-        // Botão DOWN: reduz duty cycle em 5%
-        if (HAL_GPIO_ReadPin(BUTTON_GPIO_PORT, BUTTON_DOWN) == GPIO_PIN_RESET)
+        switch (ev.button)
         {
-            if (duty_cycle > 0)
+        case BUTTON_ID_UP: // Aumenta duty cycle em 5% ou o setpoint em 0,5 °C
+            if (control_mode == CONTROL_AUTO)
+            {
+                if (setpoint_cdeg < CONTROL_SP_MAX_CDEG)
+                {
+                    setpoint_cdeg += CONTROL_SP_STEP_CDEG;
+                    Buzzer_Beep(50);
+                }
+            }
+            else if (control_mode == CONTROL_MANUAL && duty_cycle < 100)
             {
-                duty_cycle -= 5;
-                __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_1, (duty_cycle * (htim1.Init.Period + 1)) / 100);
+                SetDutyCycle(duty_cycle + 5);
                 Buzzer_Beep(50);
-                HAL_Delay(200);
             }
+            break;
+
+        case BUTTON_ID_DOWN: // Reduz duty cycle em 5% ou o setpoint em 0,5 °C
+            if (control_mode == CONTROL_AUTO)
+            {
+                if (setpoint_cdeg > CONTROL_SP_MIN_CDEG)
+                {
+                    setpoint_cdeg -= CONTROL_SP_STEP_CDEG;
+                    Buzzer_Beep(50);
+                }
+            }
+            else if (control_mode == CONTROL_MANUAL && duty_cycle > 0)
+            {
+                SetDutyCycle(duty_cycle - 5);
+                Buzzer_Beep(50);
+            }
+            break;
         }
+    }
+    PROF_END(PROF_BUTTONS);
+}
 
-        // Botão SCREEN: alterna entre telas (PWM/tempo e temperatura)
-        if (HAL_GPIO_ReadPin(BUTTON_GPIO_PORT, BUTTON_SCREEN) == GPIO_PIN_RESET)
+// Redução do timer regressivo a cada 1s se duty > 0, só no modo manual
+void Task_Countdown(void)
+{
+    PROF_BEGIN(PROF_COUNTDOWN);
+    if (duty_cycle > 0 && control_mode == CONTROL_MANUAL)
+    {
+        if (countdown_timer > 0)
+            countdown_timer--;
+        else
         {
-            current_screen ^= 1;
-            Buzzer_Beep(50);
-            HAL_Delay(300);
-            LCD_Clear();
+            SetDutyCycle(0);
         }
+    }
+    PROF_END(PROF_COUNTDOWN);
+}
+
+// Uso do painel: recomeça a contagem para a espera e sai dela
+static void Standby_Activity(void)
+{
+    activity_tick = HAL_GetTick();
+    if (standby)
+    {
+        standby = 0;
+        TempSensor_Resume();
+    }
+}
+
+// Espera só no manual com a saída desligada, sem alarme nem proteção
+// atuando, na tela principal: a de temperatura mantém a taxa cheia. Em
+// espera, a aquisição volta por uma leitura a cada STANDBY_SAMPLE_MS,
+// o que mantém o alarme com até um segundo de atraso.
+void Task_Standby(void)
+{
+    uint32_t now = HAL_GetTick();
 
-        // Redução do timer regressivo se duty > 0
-        if (duty_cycle > 0 && (HAL_GetTick() - last_timer_tick >= 1000))
+    if (control_mode != CONTROL_MANUAL || duty_cycle != 0 || Pwm_IsRamping()
+        || temp_alert_active || Protect_IsTripped() || current_screen != 0)
+    {
+        Standby_Activity();
+    }
+    else if (!standby)
+    {
+        if (now - activity_tick >= STANDBY_AFTER_MS)
         {
-            last_timer_tick = HAL_GetTick();
-            if (countdown_timer > 0)
-                countdown_timer--;
-            else
-            {
-                duty_cycle = 0;
-                __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_1, 0);
-            }
+            standby = 1;
+            standby_sample_tick = now;
+            TempSensor_Suspend();
+            DataLog_Flush(); // O bloco parcial não espera minutos em RAM
         }
     }
+    else if (now - standby_sample_tick >= STANDBY_SAMPLE_MS)
+    {
+        standby_sample_tick = now;
+        TempSensor_Resume();
+    }
+}
+
+static void Settings_Snapshot(App_Settings *now)
+{
+    now->duty = (control_mode == CONTROL_MANUAL) ? duty_cycle : settings_seen.duty;
+    now->countdown = countdown_timer;
+    now->alarm_cdeg = alarm_cdeg;
+    now->screen = current_screen;
+}
+
+// Grava os ajustes que mudaram. Settings_Write() ignora valores iguais ao
+// gravado; gravar para a CPU por 85 us a palavra dupla (22 ms quando uma
+// página precisa ser apagada)
+void Task_Settings(void)
+{
+    App_Settings now;
+    uint32_t tick = HAL_GetTick();
+
+    if (!settings_ok)
+        return;
+    Settings_Snapshot(&now);
+    if (now.duty != settings_seen.duty || now.countdown != settings_seen.countdown
+        || now.alarm_cdeg != settings_seen.alarm_cdeg || now.screen != settings_seen.screen)
+    {
+        settings_seen = now;
+        settings_changed_tick = tick;
+        if (!settings_dirty)
+            settings_dirty_tick = tick;
+        settings_dirty = 1;
+    }
+    if (settings_dirty && (tick - settings_changed_tick >= SETTINGS_SAVE_DELAY_MS
+                           || tick - settings_dirty_tick >= SETTINGS_SAVE_MAX_MS))
+    {
+        settings_dirty = 0;
+        Settings_Write(SETTINGS_KEY_DUTY, &now.duty, sizeof(now.duty));
+        Settings_Write(SETTINGS_KEY_COUNTDOWN, &now.countdown, sizeof(now.countdown));
+        Settings_Write(SETTINGS_KEY_ALARM, &now.alarm_cdeg, sizeof(now.alarm_cdeg));
+        Settings_Write(SETTINGS_KEY_SCREEN, &now.screen, sizeof(now.screen));
+    }
+}
+
+// Uma amostra a cada LOG_PERIOD_MS e um passo da gravação do bloco
+// pronto. O tempo da amostra é o nominal, que mantém os deltas de um
+// byte; um atraso de mais de um período (apagamento) vira salto de tempo.
+void Task_Log(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint8_t flags;
+
+    if (now - log_tick >= LOG_PERIOD_MS)
+    {
+        log_tick = (now - log_tick >= 2 * LOG_PERIOD_MS) ? now : log_tick + LOG_PERIOD_MS;
+        flags = (uint8_t)(control_mode << DATALOG_FLAG_MODE_Pos);
+        if (temp_alert_active)
+            flags |= DATALOG_FLAG_ALARM;
+        if (Protect_IsTripped())
+            flags |= DATALOG_FLAG_TRIP;
+        if (standby)
+            flags |= DATALOG_FLAG_STANDBY;
+        DataLog_Sample(log_tick, temperature_cdeg, duty_cycle, flags);
+    }
+    DataLog_Poll();
+}
+
+// Amostra para a telemetria no período da taxa atual. Não espera a
+// linha: com o buffer duplo cheio a amostra se perde (buraco na sequência).
+void Task_Telemetry(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t period = standby ? STANDBY_SAMPLE_MS : Telemetry_GetPeriod();
+    Telemetry_Sample s;
+
+    if (period == 0U || now - telemetry_tick < period)
+        return;
+    telemetry_tick = now;
+    s.time_ms = now;
+    s.temp_cdeg = temperature_cdeg;
+    s.duty_permille = Pwm_GetDutyPermille();
+    s.countdown_s = countdown_timer;
+    s.flags = (uint8_t)(control_mode << DATALOG_FLAG_MODE_Pos);
+    if (temp_alert_active)
+        s.flags |= DATALOG_FLAG_ALARM;
+    if (Protect_IsTripped())
+        s.flags |= DATALOG_FLAG_TRIP;
+    if (standby)
+        s.flags |= DATALOG_FLAG_STANDBY;
+    (void)Telemetry_SendSample(&s);
+}
+
+// O relé da auto-sintonia mede o período da oscilação: sem os 22 ms de
+// CPU parada no meio dela
+uint8_t DataLog_EraseAllowedCallback(void)
+{
+    return control_mode != CONTROL_TUNE;
+}
+
+// Recalibração periódica do ADC (deriva de offset)
+void Task_AdcCalibrate(void)
+{
+    TempSensor_Calibrate();
 }
 
 // --- Funções auxiliares ---
 
+// HSI16 -> PLL a 64 MHz (perfil pleno); os demais perfis estão em clock.c
 void SystemClock_Config(void)
 {
-    // Configuração feita via STM32CubeMX
+    if (Clock_Init() != HAL_OK)
+    {
+        while (1);
+    }
 }
 
 void GPIO_Init(void)
@@ -158,6 +582,13 @@ void GPIO_Init(void)
     GPIO_InitStruct.Pin = GPIO_PIN_3 | GPIO_PIN_5 | GPIO_PIN_4;
     HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
+#ifdef LCD_RW_Pin
+    // R/W em 0 (escrita) até o motor precisar ler o busy flag
+    HAL_GPIO_WritePin(LCD_RW_GPIO_Port, LCD_RW_Pin, GPIO_PIN_RESET);
+    GPIO_InitStruct.Pin = LCD_RW_Pin;
+    HAL_GPIO_Init(LCD_RW_GPIO_Port, &GPIO_InitStruct);
+#endif
+
     // PWM: PA8 (CH1), PA7 (CH1N)
     GPIO_InitStruct.Pin = GPIO_PIN_8 | GPIO_PIN_7;
     GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
@@ -166,12 +597,21 @@ void GPIO_Init(void)
     GPIO_InitStruct.Alternate = GPIO_AF2_TIM1;
     HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
-    // Botões com pull-up: PA0, PA1, PA6
+    // Botões com pull-up: PA0, PA1, PA6, com interrupção nas duas bordas
     GPIO_InitStruct.Pin = BUTTON_UP | BUTTON_DOWN | BUTTON_SCREEN;
-    GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
     GPIO_InitStruct.Pull = GPIO_PULLUP;
     HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
+    // Telemetria: USART2_TX no PD5
+    __HAL_RCC_GPIOD_CLK_ENABLE();
+    GPIO_InitStruct.Pin = TELEMETRY_TX_Pin;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    GPIO_InitStruct.Alternate = TELEMETRY_TX_AF;
+    HAL_GPIO_Init(TELEMETRY_TX_GPIO_Port, &GPIO_InitStruct);
+
     // Buzzer e LED: PA3 e PA4
     GPIO_InitStruct.Pin = BUZZER | ALARM_LED;
     GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
@@ -183,26 +623,51 @@ void GPIO_Init(void)
     GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
     GPIO_InitStruct.Pull = GPIO_NOPULL;
     HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+    // EXTI dos botões: linhas 0-1 (UP, DOWN) e 4-15 (SCREEN), mesma
+    // prioridade do tick de debounce (TIM14)
+    HAL_NVIC_SetPriority(EXTI0_1_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(EXTI0_1_IRQn);
+    HAL_NVIC_SetPriority(EXTI4_15_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(EXTI4_15_IRQn);
+}
+
+void DMA_Init(void)
+{
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    // DMA1 canal 1: ADC1 -> buffer circular de temperatura
+    HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+
+    // DMA1 canal 2: tabela de rampa -> TIM1 DMAR (CCR1); canal 3:
+    // buffer da telemetria -> USART2 TDR, na mesma IRQ
+    HAL_NVIC_SetPriority(DMA1_Channel2_3_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel2_3_IRQn);
 }
 
 void TIM1_Init(void)
 {
     __HAL_RCC_TIM1_CLK_ENABLE();
 
-    // Configuração para gerar 3 MHz com 8 MHz de clock: PSC = 0, ARR = 2
+    // PSC, ARR e CKD saem de Pwm_Configure() (pwm_config), refeitos a cada
+    // troca de perfil de clock
     htim1.Instance = TIM1;
     htim1.Init.Prescaler = 0;
     htim1.Init.CounterMode = TIM_COUNTERMODE_UP;
-    htim1.Init.Period = 2;
+    htim1.Init.Period = 0xFFFF;
     htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
     htim1.Init.RepetitionCounter = 0;
-    htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
-    HAL_TIM_PWM_Init(&htim1);
+    htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE; // ARR só muda no update
+    if (HAL_TIM_PWM_Init(&htim1) != HAL_OK)
+    {
+        while (1);
+    }
 
     // Configuração do canal 1
     TIM_OC_InitTypeDef sConfigOC = {0};
     sConfigOC.OCMode = TIM_OCMODE_PWM1;
-    sConfigOC.Pulse = 1; // 50% duty inicialmente
+    sConfigOC.Pulse = 0; // Desligado: duty_cycle começa em 0%
     sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
     sConfigOC.OCNPolarity = TIM_OCNPOLARITY_HIGH;
     sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
@@ -210,16 +675,135 @@ void TIM1_Init(void)
     sConfigOC.OCNIdleState = TIM_OCNIDLESTATE_RESET;
     HAL_TIM_PWM_ConfigChannel(&htim1, &sConfigOC, TIM_CHANNEL_1);
 
-    // Configuração do dead time
+    // Dead time e break. Com MOE = 0, CH1 e CH1N são forçados ao nível de
+    // repouso (OIS1 = OIS1N = 0, estágio desligado) pelo próprio timer. Sem
+    // saída automática: quem religa é a proteção (protect.c).
     TIM_BreakDeadTimeConfigTypeDef sBreakDeadTimeConfig = {0};
-    sBreakDeadTimeConfig.OffStateRunMode = TIM_OSSR_DISABLE;
-    sBreakDeadTimeConfig.OffStateIDLEMode = TIM_OSSI_DISABLE;
+    sBreakDeadTimeConfig.OffStateRunMode = TIM_OSSR_ENABLE;
+    sBreakDeadTimeConfig.OffStateIDLEMode = TIM_OSSI_ENABLE;
     sBreakDeadTimeConfig.LockLevel = TIM_LOCKLEVEL_OFF;
-    sBreakDeadTimeConfig.DeadTime = 2; // 1 us @ 8 MHz (aproximadamente)
-    sBreakDeadTimeConfig.BreakState = TIM_BREAK_DISABLE;
+    sBreakDeadTimeConfig.DeadTime = 0; // Em ns por Pwm_Configure(), que depende do perfil
+    sBreakDeadTimeConfig.BreakState = TIM_BREAK_ENABLE;
     sBreakDeadTimeConfig.BreakPolarity = TIM_BREAKPOLARITY_HIGH;
+    sBreakDeadTimeConfig.BreakFilter = 0;
     sBreakDeadTimeConfig.AutomaticOutput = TIM_AUTOMATICOUTPUT_DISABLE;
     HAL_TIMEx_ConfigBreakDeadTime(&htim1, &sBreakDeadTimeConfig);
+
+    // PA6 (BKIN) é o botão SCREEN: o pino fica fora do break. Restam o
+    // break por software e o do sistema (SYSCFG_CFGR2).
+    TIMEx_BreakInputConfigTypeDef sBreakInputConfig = {0};
+    sBreakInputConfig.Source = TIM_BREAKINPUTSOURCE_BKIN;
+    sBreakInputConfig.Enable = TIM_BREAKINPUTSOURCE_DISABLE;
+    sBreakInputConfig.Polarity = TIM_BREAKINPUTSOURCE_POLARITY_HIGH;
+    HAL_TIMEx_ConfigBreakInput(&htim1, TIM_BREAKINPUT_BRK, &sBreakInputConfig);
+
+    HAL_NVIC_SetPriority(TIM1_BRK_UP_TRG_COM_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(TIM1_BRK_UP_TRG_COM_IRQn);
+}
+
+void TIM3_Init(void)
+{
+    // 1 MHz / (999 + 1) = 1 kHz: um TRGO por amostra do ADC
+    htim3.Instance = TIM3;
+    htim3.Init.Prescaler = Clock_Prescaler(TIMEBASE_HZ);
+    htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim3.Init.Period = (1000000U / TEMP_SAMPLE_RATE_HZ) - 1U;
+    htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&htim3) != HAL_OK || Clock_RegisterTimer(&htim3, TIMEBASE_HZ) != HAL_OK)
+    {
+        while (1);
+    }
+
+    TIM_MasterConfigTypeDef sMasterConfig = {0};
+    sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+    HAL_TIMEx_MasterConfigSynchronization(&htim3, &sMasterConfig);
+}
+
+void TIM6_Init(void)
+{
+    // 1 MHz em modo de um pulso: cada disparo é um passo do motor do LCD,
+    // com o atraso programado em ARR pelo próprio driver
+    htim6.Instance = TIM6;
+    htim6.Init.Prescaler = Clock_Prescaler(TIMEBASE_HZ);
+    htim6.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim6.Init.Period = 1;
+    htim6.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&htim6) != HAL_OK || Clock_RegisterTimer(&htim6, TIMEBASE_HZ) != HAL_OK)
+    {
+        while (1);
+    }
+    SET_BIT(htim6.Instance->CR1, TIM_CR1_OPM);
+    __HAL_TIM_CLEAR_FLAG(&htim6, TIM_FLAG_UPDATE); // UG do init marca UIF
+    __HAL_TIM_ENABLE_IT(&htim6, TIM_IT_UPDATE);
+
+    HAL_NVIC_SetPriority(TIM6_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(TIM6_IRQn);
+}
+
+void TIM7_Init(void)
+{
+    // Contador livre de 16 bits a 1 MHz: timebase.c estende a 64 bits e
+    // refaz o PSC a cada troca de perfil (não entra em Clock_RegisterTimer)
+    htim7.Instance = TIM7;
+    htim7.Init.Prescaler = Clock_Prescaler(TIMEBASE_HZ);
+    htim7.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim7.Init.Period = TIMEBASE_PERIOD - 1U;
+    htim7.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&htim7) != HAL_OK)
+    {
+        while (1);
+    }
+
+    // Uma volta a cada 65 ms: qualquer prioridade serve, a leitura trata a
+    // volta pendente
+    HAL_NVIC_SetPriority(TIM7_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(TIM7_IRQn);
+    if (Timebase_Init(&htim7) != HAL_OK)
+    {
+        while (1);
+    }
+}
+
+void TIM14_Init(void)
+{
+    // Tick de 1 ms, parado em repouso: ligado pela primeira borda de um
+    // botão e desligado pelo driver quando todos estão soltos
+    htim14.Instance = TIM14;
+    htim14.Init.Prescaler = Clock_Prescaler(TIMEBASE_HZ);
+    htim14.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim14.Init.Period = 999;
+    htim14.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&htim14) != HAL_OK || Clock_RegisterTimer(&htim14, TIMEBASE_HZ) != HAL_OK)
+    {
+        while (1);
+    }
+    __HAL_TIM_CLEAR_FLAG(&htim14, TIM_FLAG_UPDATE); // UG do init marca UIF
+    __HAL_TIM_ENABLE_IT(&htim14, TIM_IT_UPDATE);
+
+    HAL_NVIC_SetPriority(TIM14_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(TIM14_IRQn);
+}
+
+void USART2_Init(void)
+{
+    __HAL_RCC_USART2_CLK_ENABLE();
+
+    // DMA1 canal 3: bytes do buffer duplo para o TDR, um por TXE
+    hdma_usart2_tx.Instance = DMA1_Channel3;
+    hdma_usart2_tx.Init.Request = DMA_REQUEST_USART2_TX;
+    hdma_usart2_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_usart2_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_usart2_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_usart2_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_usart2_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_usart2_tx.Init.Mode = DMA_NORMAL;
+    hdma_usart2_tx.Init.Priority = DMA_PRIORITY_LOW;
+    if (HAL_DMA_Init(&hdma_usart2_tx) != HAL_OK || Telemetry_Init(&hdma_usart2_tx, TELEMETRY_BAUD) != HAL_OK)
+    {
+        while (1);
+    }
 }
 
 void ADC1_Init(void)
@@ -227,61 +811,268 @@ void ADC1_Init(void)
     __HAL_RCC_ADC_CLK_ENABLE();
 
     hadc1.Instance = ADC1;
-    hadc1.Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV4;
+    hadc1.Init.ClockPrescaler = ADC_CLOCK_ASYNC_DIV4; // HSI16 / 4 = 4 MHz em qualquer perfil
     hadc1.Init.Resolution = ADC_RESOLUTION_12B;
     hadc1.Init.DataAlign = ADC_DATAALIGN_RIGHT;
     hadc1.Init.ScanConvMode = ADC_SCAN_DISABLE;
     hadc1.Init.EOCSelection = ADC_EOC_SINGLE_CONV;
     hadc1.Init.LowPowerAutoWait = DISABLE;
-    hadc1.Init.ContinuousConvMode = DISABLE;
+    hadc1.Init.ContinuousConvMode = DISABLE; // Uma conversão por TRGO
     hadc1.Init.NbrOfConversion = 1;
     hadc1.Init.DiscontinuousConvMode = DISABLE;
-    hadc1.Init.ExternalTrigConv = ADC_SOFTWARE_START;
-    hadc1.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
-    hadc1.Init.DMAContinuousRequests = DISABLE;
+    hadc1.Init.ExternalTrigConv = ADC_EXTERNALTRIG_T3_TRGO;
+    hadc1.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_RISING;
+    hadc1.Init.DMAContinuousRequests = ENABLE; // Necessário no DMA circular
+    hadc1.Init.Overrun = ADC_OVR_DATA_OVERWRITTEN;
+    hadc1.Init.SamplingTimeCommon1 = ADC_SAMPLETIME_39CYCLES_5; // Saída do LM35 tem impedância alta
+    hadc1.Init.OversamplingMode = DISABLE; // Ligado pelo perfil em TempSensor_Start()
 
     if (HAL_ADC_Init(&hadc1) != HAL_OK)
     {
         while (1);
     }
-}
 
-void ReadTemperature(void)
-{
+    // Canal fixo: configurado uma vez aqui, não a cada leitura
     ADC_ChannelConfTypeDef sConfig = {0};
-
     sConfig.Channel = ADC_CHANNEL_2; // LM35 conectado no PA2
     sConfig.Rank = ADC_REGULAR_RANK_1;
+    sConfig.SamplingTime = ADC_SAMPLINGTIME_COMMON_1;
     HAL_ADC_ConfigChannel(&hadc1, &sConfig);
 
-    HAL_ADC_Start(&hadc1);
-    HAL_ADC_PollForConversion(&hadc1, HAL_MAX_DELAY);
-    uint32_t adc_value = HAL_ADC_GetValue(&hadc1);
+    // Watchdog analógico do alarme: a prioridade mais alta do sistema
+    HAL_NVIC_SetPriority(ADC1_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(ADC1_IRQn);
+}
+
+// Retorna 1 se havia uma média nova
+uint8_t ReadTemperature(void)
+{
+    int32_t cdeg;
+    uint8_t fresh;
 
-    temperature = (adc_value * 330.0) / 4095.0; // Conversão para ºC
+    PROF_BEGIN(PROF_READ_TEMPERATURE);
+    // Sem espera: só atualiza quando o DMA entregou uma nova média,
+    // já convertida em ponto fixo
+    fresh = TempSensor_GetCentiCelsius(&cdeg);
+    if (fresh)
+    {
+        temperature_cdeg = cdeg;
+    }
+    PROF_END(PROF_READ_TEMPERATURE);
+    return fresh;
+}
+
+// Um passo da malha de temperatura, a cada média nova. Na sintonia, a
+// saída é a do relé; ao concluir, os ganhos novos assumem sem degrau.
+void Control_Step(void)
+{
+    int32_t out;
+
+    if (Protect_IsTripped())
+    {
+        // Saída cortada pelo break: a sintonia é perdida e o PID recomeça
+        // de zero quando religar
+        if (control_mode == CONTROL_TUNE)
+        {
+            Autotune_Abort(&temp_tuner);
+            control_mode = CONTROL_AUTO;
+        }
+        Pid_Reset(&temp_pid, setpoint_cdeg, temperature_cdeg, 0);
+        Pwm_SetDutyPermille(0);
+        duty_cycle = 0;
+        return;
+    }
+    if (control_mode == CONTROL_TUNE)
+    {
+        out = Autotune_Step(&temp_tuner, temperature_cdeg);
+        if (Autotune_GetState(&temp_tuner) != AUTOTUNE_RUNNING)
+        {
+            // Volta ao automático: com os ganhos novos se concluiu, com os
+            // que já tinha se falhou
+            if (Autotune_GetState(&temp_tuner) == AUTOTUNE_DONE
+                && Autotune_GetGains(&temp_tuner, &temp_pid_config) == HAL_OK
+                && Pid_Init(&temp_pid, &temp_pid_config, TempSensor_PeriodMs()) == HAL_OK)
+                Buzzer_Beep(500);
+            Pid_Reset(&temp_pid, setpoint_cdeg, temperature_cdeg, out);
+            control_mode = CONTROL_AUTO;
+        }
+        Pwm_SetDutyPermille((uint16_t)out);
+        duty_cycle = (uint16_t)((out + 5) / 10);
+        return;
+    }
+    out = Pid_Update(&temp_pid, setpoint_cdeg, temperature_cdeg);
+    Pwm_SetDutyPermille((uint16_t)out);
+    duty_cycle = (uint16_t)((out + 5) / 10);
+}
+
+// Troca de modo sem degrau: o PID parte do duty atual e, de volta ao
+// manual, o duty cai para a grade de 5% dos botões. A sintonia oscila em
+// torno da saída atual do PID; se não couber na faixa, fica no automático.
+void Control_SetMode(uint8_t mode)
+{
+    if (mode == CONTROL_AUTO && control_mode == CONTROL_MANUAL)
+        Pid_Reset(&temp_pid, setpoint_cdeg, temperature_cdeg, duty_cycle * 10);
+    if (mode == CONTROL_TUNE
+        && Autotune_Start(&temp_tuner, &temp_tune_config, setpoint_cdeg, temperature_cdeg,
+                          temp_pid.out, TempSensor_PeriodMs()) != HAL_OK)
+        mode = CONTROL_AUTO;
+    if (mode == CONTROL_MANUAL && control_mode == CONTROL_TUNE)
+        Autotune_Abort(&temp_tuner);
+    control_mode = mode;
+    if (mode == CONTROL_MANUAL)
+        SetDutyCycle(duty_cycle - duty_cycle % 5);
 }
 
 void UpdateDisplay(void)
 {
-    char buffer[32];
+    int32_t tenths = (temperature_cdeg + 5) / 10; // Uma casa decimal, arredondada
+    uint8_t col;
 
-    if (current_screen == 0)
+    PROF_BEGIN(PROF_UPDATE_DISPLAY);
+    // Monta a tela inteira em RAM; o flush só envia as células alteradas
+    LCD_BufferClear();
+    if (current_screen == 0 && control_mode == CONTROL_TUNE)
     {
-        LCD_SetCursor(0, 0);
-        snprintf(buffer, sizeof(buffer), "PWM:%d%% T:%ds", duty_cycle, countdown_timer);
-        LCD_Print(buffer);
+        // "SINT n:x PWM:nn%": ciclos medidos e concordantes
+        col = LCD_BufferPrint(0, 0, "SINT ");
+        col = LCD_BufferPutUInt(col, 0, temp_tuner.cycles, 0, ' ');
+        col = LCD_BufferPrint(col, 0, ":");
+        col = LCD_BufferPutUInt(col, 0, temp_tuner.agreed, 0, ' ');
+        col = LCD_BufferPrint(col, 0, " PWM:");
+        col = LCD_BufferPutUInt(col, 0, duty_cycle, 0, ' ');
+        LCD_BufferPrint(col, 0, "%");
+    }
+    else if (current_screen == 0 && control_mode == CONTROL_AUTO)
+    {
+        // "SP:nn.n PWM:nn%"
+        col = LCD_BufferPrint(0, 0, "SP:");
+        col = LCD_BufferPutFixed(col, 0, setpoint_cdeg / 10, 1, 0);
+        col = LCD_BufferPrint(col, 0, " PWM:");
+        col = LCD_BufferPutUInt(col, 0, duty_cycle, 0, ' ');
+        LCD_BufferPrint(col, 0, "%");
+    }
+    else if (current_screen == 0)
+    {
+        // "PWM:nn% T:nns"
+        col = LCD_BufferPrint(0, 0, "PWM:");
+        col = LCD_BufferPutUInt(col, 0, duty_cycle, 0, ' ');
+        col = LCD_BufferPrint(col, 0, "% T:");
+        col = LCD_BufferPutUInt(col, 0, countdown_timer, 0, ' ');
+        LCD_BufferPrint(col, 0, "s");
     }
     else
     {
-        LCD_SetCursor(0, 0);
-        sprintf(buffer, "Temp: %.1f ", temperature);
-        LCD_Print(buffer);
+        // "Temp: nn.n"
+        col = LCD_BufferPrint(0, 0, "Temp: ");
+        LCD_BufferPutFixed(col, 0, tenths, 1, 0);
     }
+    // Saída cortada pelo break: aparece nas duas telas
+    if (Protect_IsTripped())
+        LCD_BufferPrint(0, 1, Protect_IsLatched() ? "Protecao: travou" : "Protecao: ativa");
+    LCD_Flush();
+    PROF_END(PROF_UPDATE_DISPLAY);
 }
 
+// Lê os ajustes gravados. Valor ausente ou fora da faixa da interface
+// fica no padrão; o duty volta para ser aplicado depois do PWM. Sem a
+// flash de ajustes o painel funciona, só não guarda nada. Uma contagem
+// gravada já zerada volta ao padrão: nada na interface a rearma, e com ela
+// em 0 o Task_Countdown desligaria todo duty manual.
+uint16_t LoadSettings(void)
+{
+    App_Settings saved;
+
+    settings_ok = (Settings_Init() == HAL_OK);
+    if (settings_ok)
+    {
+        if (Settings_Read(SETTINGS_KEY_COUNTDOWN, &saved.countdown, sizeof(saved.countdown)) == HAL_OK
+            && saved.countdown != 0 && saved.countdown <= countdown_timer)
+            countdown_timer = saved.countdown;
+        if (Settings_Read(SETTINGS_KEY_ALARM, &saved.alarm_cdeg, sizeof(saved.alarm_cdeg)) == HAL_OK
+            && saved.alarm_cdeg >= TEMP_ALARM_MIN_CDEG && saved.alarm_cdeg <= TEMP_ALARM_MAX_CDEG)
+            alarm_cdeg = saved.alarm_cdeg;
+        if (Settings_Read(SETTINGS_KEY_SCREEN, &saved.screen, sizeof(saved.screen)) == HAL_OK
+            && saved.screen <= 1)
+            current_screen = saved.screen;
+        if (Settings_Read(SETTINGS_KEY_DUTY, &saved.duty, sizeof(saved.duty)) != HAL_OK
+            || saved.duty > 100 || saved.duty % 5 != 0)
+            saved.duty = 0;
+    }
+    else
+        saved.duty = 0;
+
+    if (setpoint_cdeg > CONTROL_SP_MAX_CDEG)
+        setpoint_cdeg = CONTROL_SP_MAX_CDEG;
+    Settings_Snapshot(&settings_seen);
+    settings_seen.duty = saved.duty;
+    return saved.duty;
+}
+
+// Novo duty cycle (0 a 100%) no canal 1 do PWM. Ligar e desligar são
+// rampas por DMA; os passos intermediários entram no próximo update.
+void SetDutyCycle(uint16_t duty)
+{
+    if (duty_cycle == 0 || duty == 0)
+        Pwm_RampTo(duty, PWM_SOFT_MS);
+    else
+        Pwm_SetDuty(duty);
+    duty_cycle = duty;
+}
+
+// Liga o buzzer e agenda o desligamento: não bloqueia
 void Buzzer_Beep(uint16_t duration_ms)
 {
+    PROF_BEGIN(PROF_BUZZER_BEEP);
     HAL_GPIO_WritePin(BUZZER_GPIO_PORT, BUZZER, GPIO_PIN_SET);
-    HAL_Delay(duration_ms);
-    HAL_GPIO_WritePin(BUZZER_GPIO_PORT, BUZZER, GPIO_PIN_RESET);
+    Sched_Trigger(task_buzzer_off, duration_ms);
+    PROF_END(PROF_BUZZER_BEEP);
+}
+
+// Update dos timers com interrupção
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM6)
+    {
+        LCD_TimerCallback(htim);
+    }
+    else if (htim->Instance == TIM14)
+    {
+        Buttons_TimerCallback(htim);
+    }
+    else if (htim->Instance == TIM1)
+    {
+        Pwm_RampCpltCallback(htim); // DMA da rampa concluído
+    }
+}
+
+// Break do TIM1: as saídas já estão desligadas pelo hardware
+void HAL_TIMEx_BreakCallback(TIM_HandleTypeDef *htim)
+{
+    Protect_BreakCallback(htim);
+}
+
+// Perfil de clock trocado: PSC, ARR e dead time do TIM1 e o BRR da USART2
+// para o clock novo
+void Clock_ProfileChangedCallback(uint8_t profile)
+{
+    (void)profile;
+    Pwm_Configure(&pwm_config, NULL);
+    Telemetry_ClockChanged();
+}
+
+// STOP congela TIM1, TIM3, TIM6, TIM14, o ADC e a USART2: só em espera,
+// com a aquisição suspensa, o PWM parado em 0%, LCD e botões em repouso e
+// a telemetria já na linha
+uint8_t Power_StopAllowedCallback(void)
+{
+    return standby && !TempSensor_IsRunning() && !Pwm_IsRamping() && !LCD_IsBusy()
+        && Buttons_IsIdle() && !Telemetry_IsBusy();
+}
+
+// Falha irrecuperável de inicialização (chamada pelo código do CubeMX)
+void Error_Handler(void)
+{
+    TIM1->EGR = TIM_EGR_BG; // Estágio de potência desligado antes de parar
+    __disable_irq();
+    while (1);
 }
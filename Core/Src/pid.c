@@ -0,0 +1,93 @@
+#include "pid.h"
+#include "port.h"
+
+static int64_t Pid_Clamp(int64_t value, int64_t min, int64_t max)
+{
+    if (value > max)
+        return max;
+    if (value < min)
+        return min;
+    return value;
+}
+
+// Discretiza os ganhos no período e zera o estado. As divisões de 64 bits
+// ficam aqui, fora do laço de controle.
+HAL_StatusTypeDef Pid_Init(Pid_Controller *pid, const Pid_Config *cfg, uint32_t period_ms)
+{
+    if (pid == NULL || cfg == NULL || period_ms == 0U || cfg->out_min >= cfg->out_max)
+        return HAL_ERROR;
+
+    pid->kp = cfg->kp;
+    pid->ki_ts = (int32_t)(((int64_t)cfg->ki * period_ms + 500) / 1000);
+    pid->kd_ts = (int32_t)(((int64_t)cfg->kd * 1000 + (int64_t)period_ms / 2) / period_ms);
+    pid->d_alpha = (int32_t)(((uint64_t)cfg->d_filter_ms << 16) / (cfg->d_filter_ms + period_ms));
+    pid->out_min = cfg->out_min;
+    pid->out_max = cfg->out_max;
+    pid->period_ms = period_ms;
+
+    pid->integ = (int64_t)cfg->out_min * PID_Q16_ONE;
+    pid->deriv = 0;
+    pid->pv_prev = 0;
+    pid->out = cfg->out_min;
+    pid->primed = 0;
+    return HAL_OK;
+}
+
+// Partida sem degrau: o integrador assume a saída atual menos a parcela
+// proporcional, e a derivada parte da medida atual
+void Pid_Reset(Pid_Controller *pid, int32_t setpoint, int32_t pv, int32_t out)
+{
+    int64_t min = (int64_t)pid->out_min * PID_Q16_ONE;
+    int64_t max = (int64_t)pid->out_max * PID_Q16_ONE;
+    int64_t p = (int64_t)pid->kp * (setpoint - pv);
+
+    pid->integ = Pid_Clamp((int64_t)out * PID_Q16_ONE - p, min, max);
+    pid->deriv = 0;
+    pid->pv_prev = pv;
+    pid->out = (int32_t)Pid_Clamp(out, pid->out_min, pid->out_max);
+    pid->primed = 1;
+}
+
+// Um passo do controlador, a cada period_ms
+int32_t Pid_Update(Pid_Controller *pid, int32_t setpoint, int32_t pv)
+{
+    int64_t min = (int64_t)pid->out_min * PID_Q16_ONE;
+    int64_t max = (int64_t)pid->out_max * PID_Q16_ONE;
+    int32_t err = setpoint - pv;
+    int64_t p, d, integ, u;
+
+    if (!pid->primed)
+    {
+        pid->pv_prev = pv;
+        pid->primed = 1;
+    }
+
+    p = (int64_t)pid->kp * err;
+
+    // d[n] = alpha * d[n-1] + (1 - alpha) * kd/Ts * (pv[n-1] - pv[n])
+    d = (int64_t)pid->kd_ts * (pid->pv_prev - pv);
+    pid->deriv = d + (((pid->deriv - d) * pid->d_alpha) >> 16);
+    pid->pv_prev = pv;
+
+    integ = pid->integ + (int64_t)pid->ki_ts * err;
+    u = p + integ + pid->deriv;
+
+    // Saturada no sentido do erro: o integrador fica onde estava
+    if (u > max)
+    {
+        u = max;
+        if (err > 0)
+            integ = pid->integ;
+    }
+    else if (u < min)
+    {
+        u = min;
+        if (err < 0)
+            integ = pid->integ;
+    }
+    pid->integ = Pid_Clamp(integ, min, max);
+
+    pid->out = (int32_t)((u + (PID_Q16_ONE / 2)) >> 16);
+    PORT_CYCLES(180); // 4 multiplicações de 64 bits (__aeabi_lmul) + somas e testes
+    return pid->out;
+}
@@ -0,0 +1,256 @@
+#include "power.h"
+#include "clock.h"
+#include "timebase.h"
+#include "port.h"
+
+#define POWER_RTC_PREDIV_A   (LSI_VALUE / POWER_RTC_HZ - 1U) // SSR a 16 kHz
+#define POWER_RTC_PREDIV_S   (POWER_RTC_HZ - 1U)             // Calendário a 1 Hz
+#define POWER_RTC_WUCKSEL    (3U << RTC_CR_WUCKSEL_Pos)      // Wakeup timer em RTCCLK / 2
+#define POWER_RTC_PER_MS     (POWER_RTC_HZ / 1000U)
+#define POWER_NS_PER_MS      1000000U
+#define POWER_NS_PER_TICK    (1000000000U / POWER_RTC_HZ)    // 62500 ns
+#define POWER_TIMEOUT_MS     5U                              // LSI (tSU de 130 us) e INITF
+
+static uint8_t rtc_ready = 0;
+static Power_Stats stats;
+static uint64_t stats_start_us = 0;
+static uint32_t frac_ns = 0; // Tempo em STOP ainda não somado a uwTick
+
+static void Power_RtcUnlock(void)
+{
+    RTC->WPR = 0xCAU;
+    RTC->WPR = 0x53U;
+}
+
+static void Power_RtcLock(void)
+{
+    RTC->WPR = 0xFFU;
+}
+
+// Com BYPSHAD o SSR vem direto do contador: duas leituras iguais
+static uint32_t Power_ReadSsr(void)
+{
+    uint32_t a, b = RTC->SSR;
+
+    do
+    {
+        a = b;
+        b = RTC->SSR;
+    } while (a != b);
+    return a;
+}
+
+// Espera a próxima borda do SSR (no máximo um tick do RTC, 62,5 us) e
+// devolve o valor novo: medir de borda a borda tira o truncamento das
+// leituras do intervalo dormido
+static uint32_t Power_WaitSsrEdge(void)
+{
+    uint32_t ssr = Power_ReadSsr(), next;
+
+    do
+    {
+        PORT_CYCLES(8);
+        next = Power_ReadSsr();
+    } while (next == ssr);
+    return next;
+}
+
+// Instante atual em us: ticks do HAL mais a fração do SysTick
+static uint64_t Power_Micros(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t load, tick, val;
+
+    __disable_irq();
+    load = SysTick->LOAD + 1U;
+    tick = HAL_GetTick();
+    val = SysTick->VAL;
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+    {
+        val = SysTick->VAL;
+        tick++;
+    }
+    __set_PRIMASK(primask);
+
+    return (uint64_t)tick * 1000U + (uint64_t)(load - 1U - val) * 1000U / load;
+}
+
+// RTC no LSI: SSR a POWER_RTC_HZ e wakeup timer no mesmo clock, ligado à
+// linha 19 do EXTI. O wakeup timer fica desligado fora do STOP.
+HAL_StatusTypeDef Power_Init(void)
+{
+    uint32_t tickstart;
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+
+    __HAL_RCC_LSI_ENABLE();
+    tickstart = HAL_GetTick();
+    while (__HAL_RCC_GET_FLAG(RCC_FLAG_LSIRDY) == 0U)
+    {
+        if (HAL_GetTick() - tickstart > POWER_TIMEOUT_MS)
+            return HAL_TIMEOUT;
+    }
+
+    // RTCSEL só muda depois de um reset do domínio de backup
+    if ((RCC->BDCR & RCC_BDCR_RTCSEL) != 0U && (RCC->BDCR & RCC_BDCR_RTCSEL) != RCC_RTCCLKSOURCE_LSI)
+    {
+        __HAL_RCC_BACKUPRESET_FORCE();
+        __HAL_RCC_BACKUPRESET_RELEASE();
+    }
+    __HAL_RCC_RTC_CONFIG(RCC_RTCCLKSOURCE_LSI);
+    __HAL_RCC_RTC_ENABLE();
+    __HAL_RCC_RTCAPB_CLK_ENABLE();
+
+    Power_RtcUnlock();
+    RTC->ICSR |= RTC_ICSR_INIT;
+    tickstart = HAL_GetTick();
+    while ((RTC->ICSR & RTC_ICSR_INITF) == 0U)
+    {
+        if (HAL_GetTick() - tickstart > POWER_TIMEOUT_MS)
+        {
+            Power_RtcLock();
+            return HAL_TIMEOUT;
+        }
+    }
+    // Dois acessos, como pede o RM0444: PREDIV_S e depois PREDIV_A
+    RTC->PRER = POWER_RTC_PREDIV_S << RTC_PRER_PREDIV_S_Pos;
+    RTC->PRER |= POWER_RTC_PREDIV_A << RTC_PRER_PREDIV_A_Pos;
+    RTC->CR = (RTC->CR & ~(RTC_CR_WUTE | RTC_CR_WUTIE | RTC_CR_WUCKSEL)) | RTC_CR_BYPSHAD | POWER_RTC_WUCKSEL;
+    RTC->ICSR &= ~RTC_ICSR_INIT;
+    Power_RtcLock();
+
+    EXTI->IMR1 |= EXTI_IMR1_IM19;
+    HAL_NVIC_SetPriority(RTC_TAMP_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(RTC_TAMP_IRQn);
+
+    rtc_ready = 1;
+    Power_ResetStats();
+    return HAL_OK;
+}
+
+// O regulador pedido vale também depois de acordar: no perfil mínimo
+// (low-power run) o principal tiraria o núcleo dele
+static void Power_Sleep(void)
+{
+    uint64_t start = Power_Micros();
+
+    HAL_PWR_EnterSLEEPMode((PWR->CR1 & PWR_CR1_LPR) ? PWR_LOWPOWERREGULATOR_ON : PWR_MAINREGULATOR_ON,
+                           PWR_SLEEPENTRY_WFI);
+    stats.us[POWER_MODE_SLEEP] += Power_Micros() - start;
+}
+
+// STOP 1 até 1 ms antes da próxima liberação. Retorna 0 sem parar se o
+// SysTick já venceu ou se o wakeup timer ainda não aceita escrita.
+static uint8_t Power_Stop(uint32_t next_ms)
+{
+    uint32_t load, done, ssr0, ssr1, ticks;
+    uint64_t start_us;
+    int32_t wut;
+
+    // Fração do ms corrente e base de us lidas logo na borda do SSR: o
+    // intervalo do RTC começa onde SysTick e TIM7 param de contar
+    ssr0 = Power_WaitSsrEdge();
+    load = SysTick->LOAD + 1U;
+    done = load - 1U - SysTick->VAL;
+    start_us = Timebase_Micros64();
+    HAL_SuspendTick();
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) || (RTC->ICSR & RTC_ICSR_WUTWF) == 0U)
+    {
+        HAL_ResumeTick();
+        return 0;
+    }
+
+    // Acordar 1 ms antes deixa a saída (PLL) e o arredondamento do RTC
+    // dentro da folga: a tarefa nunca começa atrasada
+    if (next_ms > POWER_STOP_MAX_MS)
+        next_ms = POWER_STOP_MAX_MS;
+    wut = (int32_t)((next_ms - 1U) * POWER_RTC_PER_MS)
+        - (int32_t)((uint64_t)done * POWER_RTC_PER_MS / load);
+    PORT_CYCLES(40);
+    if (wut <= 0)
+    {
+        HAL_ResumeTick();
+        return 0;
+    }
+
+    Power_RtcUnlock();
+    RTC->WUTR = (uint32_t)wut - 1U;
+    RTC->SCR = RTC_SCR_CWUTF;
+    RTC->CR |= RTC_CR_WUTE | RTC_CR_WUTIE;
+    Power_RtcLock();
+
+    Timebase_Suspend();
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+    if (RTC->SR & RTC_SR_WUTF)
+        stats.rtc_wakeups++;
+    else
+        stats.early_wakeups++;
+    Power_RtcUnlock();
+    RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+    Power_RtcLock();
+
+    // Sem o PLL, o perfil pleno segue no HSI16 até a próxima troca
+    (void)Clock_Resume();
+
+    // SysTick recomeça do zero na borda seguinte; uwTick recebe os ms
+    // inteiros do STOP e a fração fica para a próxima vez
+    ssr1 = Power_WaitSsrEdge();
+    HAL_InitTick(uwTickPrio);
+    ticks = (ssr0 + POWER_RTC_HZ - ssr1) % POWER_RTC_HZ;
+    Timebase_Resume(start_us, ticks * POWER_NS_PER_TICK);
+    frac_ns += ticks * POWER_NS_PER_TICK + (uint32_t)((uint64_t)done * POWER_NS_PER_MS / load);
+    uwTick += frac_ns / POWER_NS_PER_MS;
+    frac_ns %= POWER_NS_PER_MS;
+    stats.us[POWER_MODE_STOP] += ((uint64_t)ticks * 1000000U + POWER_RTC_HZ / 2U) / POWER_RTC_HZ;
+    PORT_CYCLES(60);
+    return 1;
+}
+
+// Chamada com as IRQs mascaradas: uma interrupção pendente acorda o
+// núcleo, e o handler só roda quando o chamador as reabilita
+Power_Mode Power_Idle(uint32_t next_ms)
+{
+    Power_Mode mode = POWER_MODE_SLEEP;
+
+    if (rtc_ready && next_ms >= POWER_STOP_MIN_MS && Power_StopAllowedCallback()
+        && Power_Stop(next_ms))
+        mode = POWER_MODE_STOP;
+    else
+        Power_Sleep();
+    stats.entries[mode]++;
+    return mode;
+}
+
+const Power_Stats *Power_GetStats(void)
+{
+    uint64_t total = Power_Micros() - stats_start_us;
+    uint64_t low = stats.us[POWER_MODE_SLEEP] + stats.us[POWER_MODE_STOP];
+
+    stats.us[POWER_MODE_RUN] = (total > low) ? total - low : 0U;
+    return &stats;
+}
+
+void Power_ResetStats(void)
+{
+    for (uint8_t i = 0; i < POWER_MODE_COUNT; i++)
+    {
+        stats.entries[i] = 0;
+        stats.us[i] = 0;
+    }
+    stats.rtc_wakeups = 0;
+    stats.early_wakeups = 0;
+    stats_start_us = Power_Micros();
+}
+
+// WUTF só é limpa aqui; o STOP desliga o wakeup timer ao acordar
+void Power_RtcIRQHandler(void)
+{
+    RTC->SCR = RTC_SCR_CWUTF;
+}
+
+__weak uint8_t Power_StopAllowedCallback(void)
+{
+    return 0;
+}
@@ -0,0 +1,198 @@
+#include "protect.h"
+#include "port.h"
+
+static TIM_HandleTypeDef *prot_htim;
+static Protect_Policy policy = { PROTECT_LATCHED, 0, 0 };
+static Protect_Stats stats;
+
+// Escritos nas ISRs (watchdog do ADC, break do timer) e lidos nas tarefas
+static volatile uint8_t tripped = 0;
+static volatile uint8_t latched = 0;
+static volatile uint8_t sw_break = 0;    // Break pedido por Protect_Trip()
+static volatile uint32_t active = 0;     // Falhas ainda presentes (bit por Protect_Fault)
+static volatile uint32_t released_ms = 0;
+static uint8_t auto_count = 0;           // Religamentos automáticos desde o último Clear
+
+HAL_StatusTypeDef Protect_Init(TIM_HandleTypeDef *htim, const Protect_Policy *policy_init)
+{
+    if (htim == NULL || !IS_TIM_BREAK_INSTANCE(htim->Instance))
+        return HAL_ERROR;
+
+    prot_htim = htim;
+    tripped = 0;
+    latched = 0;
+    sw_break = 0;
+    active = 0;
+    auto_count = 0;
+    Protect_SetPolicy(policy_init);
+
+    // Falhas do núcleo e das memórias levam ao break sem passar pela CPU.
+    // Os bits travam até o próximo reset.
+    SET_BIT(SYSCFG->CFGR2, SYSCFG_CFGR2_CLL | SYSCFG_CFGR2_SPL | SYSCFG_CFGR2_ECCL);
+
+    __HAL_TIM_CLEAR_FLAG(htim, TIM_FLAG_BREAK | TIM_FLAG_SYSTEM_BREAK);
+    __HAL_TIM_ENABLE_IT(htim, TIM_IT_BREAK);
+    return HAL_OK;
+}
+
+void Protect_SetPolicy(const Protect_Policy *policy_new)
+{
+    if (policy_new != NULL)
+        policy = *policy_new;
+}
+
+// Desliga as saídas e registra a falha. Pode ser chamada de qualquer ISR:
+// sw_break e a contabilidade vêm antes da escrita em EGR, tudo com as
+// interrupções mascaradas, para o break do timer (prioridade 1) não
+// tomar um disparo pedido daqui por falha do sistema.
+void Protect_Trip(Protect_Fault fault)
+{
+    uint32_t primask;
+
+    if (prot_htim == NULL || fault >= PROTECT_FAULT_COUNT)
+        return;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    sw_break = 1;
+    if (!(active & (1UL << fault)))
+    {
+        active |= 1UL << fault;
+        stats.trips[fault]++;
+        stats.last_fault = fault;
+        stats.last_trip_ms = HAL_GetTick();
+    }
+    tripped = 1;
+    if (policy.mode == PROTECT_LATCHED)
+        latched = 1;
+    prot_htim->Instance->EGR = TIM_EGR_BG; // MOE = 0 no próximo ciclo do timer
+    __set_PRIMASK(primask);
+    PORT_CYCLES(25);
+}
+
+// A condição da falha sumiu; o religamento fica com Protect_Poll() ou
+// Protect_Clear(), conforme a política
+void Protect_Release(Protect_Fault fault)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    active &= ~(1UL << fault);
+    if (active == 0U)
+        released_ms = HAL_GetTick();
+    __set_PRIMASK(primask);
+}
+
+// Religamento manual: zera a trava e o limite de religamentos automáticos.
+// Recusado enquanto alguma falha continua presente. O break do sistema só
+// sai de 'active' se o BIF/SBIF aceitarem ser limpos: com a fonte ainda
+// ativa (paridade, ECC, PVD) o hardware os mantém em 1.
+HAL_StatusTypeDef Protect_Clear(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    if (prot_htim == NULL)
+        return HAL_ERROR;
+    if ((active & ~(1UL << PROTECT_FAULT_SYSTEM)) != 0U)
+        return HAL_BUSY;
+
+    __disable_irq();
+    if (active & (1UL << PROTECT_FAULT_SYSTEM))
+    {
+        __HAL_TIM_CLEAR_FLAG(prot_htim, TIM_FLAG_BREAK | TIM_FLAG_SYSTEM_BREAK);
+        PORT_CYCLES(2); // Escrita e releitura do SR
+        if ((prot_htim->Instance->SR & (TIM_FLAG_BREAK | TIM_FLAG_SYSTEM_BREAK)) != 0U)
+        {
+            __set_PRIMASK(primask);
+            return HAL_BUSY;
+        }
+        // Um break de software que chegou com a interrupção desligada já
+        // foi contado em Protect_Trip()
+        sw_break = 0;
+        active &= ~(1UL << PROTECT_FAULT_SYSTEM);
+        __HAL_TIM_ENABLE_IT(prot_htim, TIM_IT_BREAK);
+    }
+    __set_PRIMASK(primask);
+
+    auto_count = 0;
+    if (!tripped)
+        return HAL_OK;
+
+    __disable_irq();
+    latched = 0;
+    tripped = 0;
+    __HAL_TIM_MOE_ENABLE(prot_htim); // Volta com o CCR atual no próximo período
+    __set_PRIMASK(primask);
+    stats.manual_clears++;
+    return HAL_OK;
+}
+
+// Religamento automático, a cada PROTECT_POLL_MS
+void Protect_Poll(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    if (!tripped || latched || active != 0U || policy.mode != PROTECT_AUTO_REARM)
+        return;
+    if ((HAL_GetTick() - released_ms) < policy.cooldown_ms)
+        return;
+
+    if (policy.max_rearms != 0U && auto_count >= policy.max_rearms)
+    {
+        latched = 1; // Falha recorrente: só o operador religa
+        return;
+    }
+
+    __disable_irq();
+    if (active == 0U)
+    {
+        tripped = 0;
+        __HAL_TIM_MOE_ENABLE(prot_htim);
+        auto_count++;
+        stats.auto_rearms++;
+    }
+    __set_PRIMASK(primask);
+}
+
+uint8_t Protect_IsTripped(void)
+{
+    return tripped;
+}
+
+uint8_t Protect_IsLatched(void)
+{
+    return tripped && latched;
+}
+
+uint32_t Protect_ActiveFaults(void)
+{
+    return active;
+}
+
+const Protect_Stats *Protect_GetStats(void)
+{
+    return &stats;
+}
+
+// O hardware já desligou as saídas. Break que não veio de Protect_Trip()
+// é falha do sistema: trava e fica em 'active' até Protect_Clear() ver a
+// fonte apagada. A interrupção do break sai junto: uma fonte que continua
+// ativa mantém o SBIF em 1 e a ISR entraria sem parar.
+void Protect_BreakCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim != prot_htim)
+        return;
+
+    if (sw_break)
+    {
+        sw_break = 0;
+        return;
+    }
+    __HAL_TIM_DISABLE_IT(htim, TIM_IT_BREAK);
+    active |= 1UL << PROTECT_FAULT_SYSTEM;
+    stats.trips[PROTECT_FAULT_SYSTEM]++;
+    stats.last_fault = PROTECT_FAULT_SYSTEM;
+    stats.last_trip_ms = HAL_GetTick();
+    tripped = 1;
+    latched = 1;
+}
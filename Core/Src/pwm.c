@@ -0,0 +1,336 @@
+#include "pwm.h"
+#include "clock.h"
+#include "port.h"
+#include "trace.h"
+
+#define PWM_MAX_COUNT   65536U   // PSC + 1 e ARR + 1 de 16 bits
+#define PWM_NS_PER_S    1000000000ULL
+
+static TIM_HandleTypeDef *pwm_htim;
+static uint32_t pwm_channel;
+static Pwm_Timing pwm_timing;
+
+static const uint32_t ckd_values[] = { TIM_CLOCKDIVISION_DIV1, TIM_CLOCKDIVISION_DIV2, TIM_CLOCKDIVISION_DIV4 };
+
+// Tabela lida pelo DMA durante a rampa: não pode mudar até o fim
+static uint32_t ramp[PWM_RAMP_MAX_STEPS];
+static volatile uint8_t ramping = 0;
+
+static uint32_t Pwm_Period(void)
+{
+    return __HAL_TIM_GET_AUTORELOAD(pwm_htim) + 1U;
+}
+
+static uint32_t Pwm_Ccr(uint8_t percent)
+{
+    if (percent > 100U)
+        percent = 100U;
+    return (percent * Pwm_Period()) / 100U;
+}
+
+// Interrompe a rampa em curso; o último CCR escrito pelo DMA fica valendo
+static void Pwm_StopRamp(void)
+{
+    if (!ramping)
+        return;
+    HAL_TIM_DMABurst_WriteStop(pwm_htim, TIM_DMA_UPDATE);
+    pwm_htim->Instance->RCR = 0; // Updates voltam a cada período
+    ramping = 0;
+}
+
+HAL_StatusTypeDef Pwm_Init(TIM_HandleTypeDef *htim, uint32_t channel)
+{
+    if (htim == NULL || htim->hdma[TIM_DMA_ID_UPDATE] == NULL)
+        return HAL_ERROR;
+
+    pwm_htim = htim;
+    pwm_channel = channel;
+    ramping = 0;
+
+    // CCRx já tem preload pela HAL; falta o ARR
+    __HAL_TIM_ENABLE_OCxPRELOAD(htim, channel);
+    SET_BIT(htim->Instance->CR1, TIM_CR1_ARPE);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef Pwm_Start(void)
+{
+    if (HAL_TIM_PWM_Start(pwm_htim, pwm_channel) != HAL_OK)
+        return HAL_ERROR;
+    return HAL_TIMEx_PWMN_Start(pwm_htim, pwm_channel);
+}
+
+// Novo duty no próximo update. Cancela uma rampa em andamento.
+void Pwm_SetDuty(uint8_t percent)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    Pwm_StopRamp();
+    __HAL_TIM_SET_COMPARE(pwm_htim, pwm_channel, Pwm_Ccr(percent));
+    __set_PRIMASK(primask);
+    TRACE(TRACE_PWM_UPDATE, 0U, Pwm_Ccr(percent));
+}
+
+// Mesmo caminho em por mil, para malhas de controle. O CCR é truncado na
+// resolução do timer (ARR + 1 passos).
+void Pwm_SetDutyPermille(uint16_t permille)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    if (permille > 1000U)
+        permille = 1000U;
+    __disable_irq();
+    Pwm_StopRamp();
+    __HAL_TIM_SET_COMPARE(pwm_htim, pwm_channel, (permille * Pwm_Period()) / 1000U);
+    __set_PRIMASK(primask);
+    TRACE(TRACE_PWM_UPDATE, 0U, (permille * Pwm_Period()) / 1000U);
+}
+
+// Duração de um DTG em ciclos de tDTS (RM0444, TIMx_BDTR):
+//   0xxxxxxx: DTG[6:0]               0 a 127, passo 1
+//   10xxxxxx: (64 + DTG[5:0]) * 2    128 a 254, passo 2
+//   110xxxxx: (32 + DTG[4:0]) * 8    256 a 504, passo 8
+//   111xxxxx: (32 + DTG[4:0]) * 16   512 a 1008, passo 16
+uint32_t Pwm_DeadTimeTicks(uint8_t dtg)
+{
+    if ((dtg & 0x80U) == 0U)
+        return dtg;
+    if ((dtg & 0xC0U) == 0x80U)
+        return (64U + (dtg & 0x3FU)) * 2U;
+    if ((dtg & 0xE0U) == 0xC0U)
+        return (32U + (dtg & 0x1FU)) * 8U;
+    return (32U + (dtg & 0x1FU)) * 16U;
+}
+
+// Menor DTG com pelo menos 'ticks' ciclos de tDTS; 0 se não cabe
+static uint8_t Pwm_EncodeDeadTime(uint32_t ticks, uint8_t *dtg)
+{
+    if (ticks <= 127U)
+        *dtg = (uint8_t)ticks;
+    else if (ticks <= 254U)
+        *dtg = (uint8_t)(0x80U | ((ticks + 1U) / 2U - 64U));
+    else if (ticks <= 504U)
+        *dtg = (uint8_t)(0xC0U | ((ticks + 7U) / 8U - 32U));
+    else if (ticks <= 1008U)
+        *dtg = (uint8_t)(0xE0U | ((ticks + 15U) / 16U - 32U));
+    else
+        return 0;
+    return 1;
+}
+
+// Erro |timer_hz - freq * n| / n comparado sem divisão: a < b?
+static uint8_t Pwm_BetterError(uint64_t err_a, uint64_t n_a, uint64_t err_b, uint64_t n_b)
+{
+    return err_a * n_b < err_b * n_a;
+}
+
+// PSC, ARR, CKD e DTG para 'timer_hz'. Só aritmética inteira: o mesmo
+// resultado no alvo e no host.
+HAL_StatusTypeDef Pwm_Calculate(const Pwm_Config *cfg, uint32_t timer_hz, Pwm_Timing *timing)
+{
+    uint64_t dt_ticks, n, best_err = 0, best_n = 0;
+    uint32_t p, p_min, best_p = 0, best_a = 0, best_dt = 0, best_ckd = 0;
+    int64_t err, den;
+    uint8_t best_dtg = 0, found = 0;
+
+    if (cfg == NULL || timing == NULL || timer_hz == 0U || cfg->freq_hz == 0U
+        || cfg->min_steps < 2U || (uint64_t)cfg->freq_hz * cfg->min_steps > timer_hz)
+        return HAL_ERROR;
+
+    // Menor PSC com ARR em 16 bits, e os seguintes: PSC maior perde
+    // resolução, mas pode acertar a frequência com ARR exato
+    p_min = (uint32_t)((timer_hz + (uint64_t)cfg->freq_hz * PWM_MAX_COUNT - 1U)
+                       / ((uint64_t)cfg->freq_hz * PWM_MAX_COUNT));
+    if (p_min == 0U)
+        p_min = 1U;
+    for (p = p_min; p < p_min + PWM_PSC_SEARCH && p <= PWM_MAX_COUNT; p++)
+    {
+        uint64_t step = (uint64_t)p * cfg->freq_hz;
+        uint32_t a = (uint32_t)((timer_hz + step / 2U) / step);
+        uint64_t diff;
+
+        if (a < cfg->min_steps || a > PWM_MAX_COUNT)
+            continue;
+        n = (uint64_t)p * a;
+        diff = (timer_hz > step * a) ? timer_hz - step * a : step * a - timer_hz;
+        if (!found || Pwm_BetterError(diff, n, best_err, best_n))
+        {
+            found = 1;
+            best_err = diff;
+            best_n = n;
+            best_p = p;
+            best_a = a;
+        }
+        if (diff == 0U)
+            break;
+    }
+    PORT_CYCLES(100U + 250U * (p - p_min + 1U)); // Uma divisão de 64 bits por PSC testado
+    if (!found)
+        return HAL_ERROR;
+
+    // Dead time em ciclos do timer, arredondado para cima; a CKD que dá o
+    // menor valor codificável (a menor CKD no empate)
+    dt_ticks = ((uint64_t)cfg->deadtime_ns * timer_hz + PWM_NS_PER_S - 1U) / PWM_NS_PER_S;
+    if (dt_ticks > 1008U * 4U)
+        return HAL_ERROR;
+    found = 0;
+    for (uint32_t i = 0; i < sizeof(ckd_values) / sizeof(ckd_values[0]); i++)
+    {
+        uint32_t div = 1UL << i;
+        uint32_t ticks;
+        uint8_t dtg;
+
+        if (!Pwm_EncodeDeadTime(((uint32_t)dt_ticks + div - 1U) / div, &dtg))
+            continue;
+        ticks = Pwm_DeadTimeTicks(dtg) * div;
+        if (!found || ticks < best_dt)
+        {
+            found = 1;
+            best_dt = ticks;
+            best_dtg = dtg;
+            best_ckd = ckd_values[i];
+        }
+    }
+    if (!found)
+        return HAL_ERROR;
+
+    err = ((int64_t)timer_hz - (int64_t)(cfg->freq_hz * best_n)) * 1000000;
+    den = (int64_t)(cfg->freq_hz * best_n);
+    timing->timer_hz = timer_hz;
+    timing->psc = (uint16_t)(best_p - 1U);
+    timing->arr = (uint16_t)(best_a - 1U);
+    timing->ckd = best_ckd;
+    timing->dtg = best_dtg;
+    timing->steps = best_a;
+    timing->freq_hz = (uint32_t)((timer_hz + best_n / 2U) / best_n);
+    timing->freq_error_ppm = (int32_t)(((err >= 0) ? err + den / 2 : err - den / 2) / den);
+    timing->deadtime_ns = (uint32_t)(((uint64_t)best_dt * PWM_NS_PER_S + timer_hz / 2U) / timer_hz);
+    return HAL_OK;
+}
+
+// Aplica a configuração no clock de timer atual (de novo a cada troca de
+// perfil). PSC, ARR e CCR têm preload e entram juntos no próximo update; o
+// CCR é reescalado para manter o duty. MOE cai durante a escrita de BDTR:
+// um break entre a leitura e a escrita não é desfeito por ela.
+HAL_StatusTypeDef Pwm_Configure(const Pwm_Config *cfg, Pwm_Timing *timing)
+{
+    uint32_t primask = __get_PRIMASK();
+    TIM_TypeDef *tim;
+    Pwm_Timing t;
+    uint32_t old_steps, ccr, bdtr;
+
+    if (pwm_htim == NULL || Pwm_Calculate(cfg, Clock_TimerHz(), &t) != HAL_OK)
+        return HAL_ERROR; // Antes do Pwm_Init: vale o próximo Pwm_Configure
+    tim = pwm_htim->Instance;
+
+    __disable_irq();
+    Pwm_StopRamp();
+    old_steps = Pwm_Period();
+    ccr = (uint32_t)(((uint64_t)__HAL_TIM_GET_COMPARE(pwm_htim, pwm_channel) * t.steps + old_steps / 2U)
+                     / old_steps);
+    pwm_htim->Init.Prescaler = t.psc;
+    pwm_htim->Init.ClockDivision = t.ckd;
+    __HAL_TIM_SET_PRESCALER(pwm_htim, t.psc);
+    __HAL_TIM_SET_AUTORELOAD(pwm_htim, t.arr);
+    __HAL_TIM_SET_COMPARE(pwm_htim, pwm_channel, (ccr > t.steps) ? t.steps : ccr);
+    MODIFY_REG(tim->CR1, TIM_CR1_CKD, t.ckd);
+
+    bdtr = tim->BDTR;
+    tim->BDTR = (bdtr & ~(TIM_BDTR_DTG | TIM_BDTR_MOE)) | t.dtg;
+    if ((bdtr & TIM_BDTR_MOE) && (tim->SR & (TIM_SR_BIF | TIM_SR_SBIF)) == 0U)
+        SET_BIT(tim->BDTR, TIM_BDTR_MOE);
+
+    // Parado, um UG com URS carrega os shadows já, sem UIF nem DMA
+    if ((tim->CR1 & TIM_CR1_CEN) == 0U)
+    {
+        SET_BIT(tim->CR1, TIM_CR1_URS);
+        tim->EGR = TIM_EGR_UG;
+        CLEAR_BIT(tim->CR1, TIM_CR1_URS);
+    }
+    pwm_timing = t;
+    __set_PRIMASK(primask);
+
+    if (timing != NULL)
+        *timing = t;
+    return HAL_OK;
+}
+
+const Pwm_Timing *Pwm_GetTiming(void)
+{
+    return &pwm_timing;
+}
+
+// Rampa linear do CCR atual até 'percent' em 'duration_ms'. Cada passo
+// dura RCR + 1 períodos; com RCR de 16 bits, rampas longas num PWM rápido
+// precisam de mais passos (repetidos) para cobrir a duração.
+HAL_StatusTypeDef Pwm_RampTo(uint8_t percent, uint32_t duration_ms)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t from, to, delta, steps, rcr;
+    uint64_t updates;
+    HAL_StatusTypeDef status;
+
+    __disable_irq();
+    Pwm_StopRamp();
+    __set_PRIMASK(primask);
+
+    from = __HAL_TIM_GET_COMPARE(pwm_htim, pwm_channel);
+    to = Pwm_Ccr(percent);
+    TRACE(TRACE_PWM_UPDATE, 1U, to);
+    delta = (to > from) ? (to - from) : (from - to);
+    if (delta == 0U || duration_ms == 0U)
+    {
+        __HAL_TIM_SET_COMPARE(pwm_htim, pwm_channel, to);
+        return HAL_OK;
+    }
+
+    // Períodos de PWM na duração pedida
+    updates = ((uint64_t)Clock_TimerHz() * duration_ms)
+            / (1000ULL * (pwm_htim->Instance->PSC + 1U) * Pwm_Period());
+
+    steps = (uint32_t)((updates + 0xFFFFU) / 0x10000U);
+    if (steps < delta)
+        steps = delta;
+    if (steps > PWM_RAMP_MAX_STEPS)
+        steps = PWM_RAMP_MAX_STEPS;
+    rcr = (uint32_t)(updates / steps);
+    rcr = (rcr == 0U) ? 0U : (rcr > 0x10000U ? 0xFFFFU : rcr - 1U);
+
+    for (uint32_t i = 0; i < steps; i++)
+    {
+        uint32_t k = ((i + 1U) * delta) / steps;
+        ramp[i] = (to > from) ? from + k : from - k;
+    }
+    PORT_CYCLES(40U + 12U * steps);
+
+    // RCR tem preload: o primeiro passo sai no próximo update, os demais
+    // a cada RCR + 1 períodos
+    pwm_htim->Instance->RCR = rcr;
+    ramping = 1;
+    status = HAL_TIM_DMABurst_MultiWriteStart(pwm_htim, TIM_DMABASE_CCR1 + (pwm_channel >> 2U),
+                                              TIM_DMA_UPDATE, ramp, TIM_DMABURSTLENGTH_1TRANSFER, steps);
+    if (status != HAL_OK)
+    {
+        ramping = 0;
+        pwm_htim->Instance->RCR = 0;
+    }
+    return status;
+}
+
+uint8_t Pwm_IsRamping(void)
+{
+    return ramping;
+}
+
+// Duty na saída agora (CCR), em por mil, inclusive no meio de uma rampa
+uint16_t Pwm_GetDutyPermille(void)
+{
+    return (uint16_t)((__HAL_TIM_GET_COMPARE(pwm_htim, pwm_channel) * 1000U + Pwm_Period() / 2U) / Pwm_Period());
+}
+
+void Pwm_RampCpltCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim == pwm_htim)
+        Pwm_StopRamp();
+}
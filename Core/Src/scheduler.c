@@ -0,0 +1,249 @@
+#include "scheduler.h"
+#include "port.h"
+#include "profile.h"
+#include "power.h"
+#include "trace.h"
+
+static Sched_Task tasks[SCHED_MAX_TASKS];
+static uint8_t task_count = 0;
+
+static uint64_t idle_cycles = 0;
+static uint64_t stats_start = 0;
+
+static int8_t Sched_Add(const char *name, Sched_TaskFn fn, uint32_t period_ms, uint8_t priority)
+{
+    Sched_Task *t;
+
+    if (task_count >= SCHED_MAX_TASKS || fn == NULL)
+        return -1;
+
+    t = &tasks[task_count];
+    t->name = name;
+    t->fn = fn;
+    t->period_ms = period_ms;
+    t->deadline_ms = period_ms; // Prazo implícito: até a próxima liberação
+    t->priority = priority;
+    t->release = HAL_GetTick() + period_ms;
+    t->armed = (period_ms != 0U);
+    Trace_SetTaskName(task_count, name);
+    return (int8_t)task_count++;
+}
+
+// Tarefa periódica: primeira execução daqui a 'period_ms'
+int8_t Sched_AddPeriodic(const char *name, Sched_TaskFn fn, uint32_t period_ms, uint8_t priority)
+{
+    if (period_ms == 0U)
+        return -1;
+    return Sched_Add(name, fn, period_ms, priority);
+}
+
+// Tarefa de disparo único: só roda depois de um Sched_Trigger()
+int8_t Sched_AddOneShot(const char *name, Sched_TaskFn fn, uint8_t priority)
+{
+    return Sched_Add(name, fn, 0U, priority);
+}
+
+void Sched_SetDeadline(int8_t id, uint32_t deadline_ms)
+{
+    if (id >= 0 && id < task_count)
+        tasks[id].deadline_ms = deadline_ms;
+}
+
+// (Re)agenda a tarefa para daqui a 'delay_ms'. Numa periódica, desloca a
+// fase; numa de disparo único, arma uma execução. Pode ser chamada de ISR.
+void Sched_Trigger(int8_t id, uint32_t delay_ms)
+{
+    if (id < 0 || id >= task_count)
+        return;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    tasks[id].release = HAL_GetTick() + delay_ms;
+    tasks[id].armed = 1;
+    __set_PRIMASK(primask);
+}
+
+void Sched_Cancel(int8_t id)
+{
+    if (id >= 0 && id < task_count)
+        tasks[id].armed = 0;
+}
+
+// --- Tempo ---
+
+// Instante atual em ciclos de CPU: ticks do HAL mais a fração do SysTick.
+// O Cortex-M0+ não tem DWT->CYCCNT.
+uint64_t Sched_Cycles(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t load, tick, val;
+
+    __disable_irq();
+    load = SysTick->LOAD + 1U;
+    tick = HAL_GetTick();
+    val = SysTick->VAL;
+    // SysTick já zerou mas a ISR ainda não incrementou o tick
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+    {
+        val = SysTick->VAL;
+        tick++;
+    }
+    __set_PRIMASK(primask);
+
+    return (uint64_t)tick * load + (load - 1U - val);
+}
+
+uint64_t Sched_IdleCycles(void)
+{
+    return idle_cycles;
+}
+
+uint64_t Sched_ElapsedCycles(void)
+{
+    return Sched_Cycles() - stats_start;
+}
+
+void Sched_ResetStats(void)
+{
+    for (uint8_t i = 0; i < task_count; i++)
+    {
+        tasks[i].runs = 0;
+        tasks[i].misses = 0;
+        tasks[i].max_late_ms = 0;
+        tasks[i].max_cycles = 0;
+        tasks[i].cycles = 0;
+    }
+    idle_cycles = 0;
+    stats_start = Sched_Cycles();
+}
+
+uint8_t Sched_TaskCount(void)
+{
+    return task_count;
+}
+
+const Sched_Task *Sched_GetTask(uint8_t id)
+{
+    return (id < task_count) ? &tasks[id] : NULL;
+}
+
+// --- Despacho ---
+
+// Tarefa pronta de maior prioridade (menor número); no empate, a que foi
+// liberada primeiro. Retorna -1 se nenhuma estiver pronta.
+static int8_t Sched_PickReady(uint32_t now)
+{
+    int8_t best = -1;
+
+    for (uint8_t i = 0; i < task_count; i++)
+    {
+        Sched_Task *t = &tasks[i];
+
+        if (!t->armed || (int32_t)(now - t->release) < 0)
+            continue;
+        if (best < 0 || t->priority < tasks[best].priority
+            || (t->priority == tasks[best].priority
+                && (int32_t)(t->release - tasks[best].release) < 0))
+            best = (int8_t)i;
+    }
+    PORT_CYCLES(20U + 14U * task_count);
+    return best;
+}
+
+// Milissegundos até a próxima liberação armada; UINT32_MAX se nenhuma
+static uint32_t Sched_NextRelease(uint32_t now)
+{
+    uint32_t next = UINT32_MAX;
+
+    for (uint8_t i = 0; i < task_count; i++)
+    {
+        int32_t wait = (int32_t)(tasks[i].release - now);
+
+        if (!tasks[i].armed)
+            continue;
+        if (wait < 0)
+            wait = 0;
+        if ((uint32_t)wait < next)
+            next = (uint32_t)wait;
+    }
+    PORT_CYCLES(12U + 10U * task_count);
+    return next;
+}
+
+static void Sched_Dispatch(Sched_Task *t, uint32_t now)
+{
+    uint32_t late = now - t->release;
+    uint64_t start;
+    uint32_t elapsed;
+
+    if (t->period_ms != 0U)
+    {
+        // Sem deriva: a próxima liberação conta da anterior. Se atrasou
+        // mais de um período, descarta as perdidas em vez de disparar em rajada.
+        t->release += t->period_ms;
+        if ((int32_t)(now - t->release) >= 0)
+            t->release = now + t->period_ms;
+    }
+    else
+    {
+        t->armed = 0;
+    }
+
+    if (late > t->max_late_ms)
+        t->max_late_ms = late;
+    if (t->deadline_ms != 0U && late > t->deadline_ms)
+        t->misses++;
+
+    start = Sched_Cycles();
+    TRACE(TRACE_TASK_BEGIN, t - tasks, (late > 0xFFFFU) ? 0xFFFFU : late);
+    t->fn();
+    TRACE(TRACE_TASK_END, t - tasks, 0U);
+    elapsed = (uint32_t)(Sched_Cycles() - start);
+
+    t->runs++;
+    t->cycles += elapsed;
+    if (elapsed > t->max_cycles)
+        t->max_cycles = elapsed;
+}
+
+// Dorme até a próxima interrupção ou liberação (SLEEP ou STOP, conforme
+// power.c). Com IRQs mascaradas, a checagem e o sono são atômicos: uma
+// ISR que libere uma tarefa acorda o núcleo, e o tempo dormido não
+// inclui o handler, que só roda ao reabilitar IRQs.
+static void Sched_Idle(void)
+{
+    uint32_t now;
+    uint64_t start;
+
+    __disable_irq();
+    now = HAL_GetTick();
+    if (Sched_PickReady(now) < 0)
+    {
+        Power_Mode mode;
+
+        TRACE(TRACE_IDLE_BEGIN, 0U, 0U);
+        start = Sched_Cycles();
+        mode = Power_Idle(Sched_NextRelease(now));
+        idle_cycles += Sched_Cycles() - start;
+        TRACE(TRACE_IDLE_END, 0U, mode);
+    }
+    __enable_irq();
+}
+
+void Sched_Run(void)
+{
+    Sched_ResetStats();
+
+    while (1)
+    {
+        PROF_LOOP();
+
+        uint32_t now = HAL_GetTick();
+        int8_t id = Sched_PickReady(now);
+
+        if (id < 0)
+            Sched_Idle();
+        else
+            Sched_Dispatch(&tasks[id], now);
+    }
+}
@@ -0,0 +1,453 @@
+#include <string.h>
+#include "settings.h"
+#include "crc32.h"
+#include "port.h"
+
+// Cabeçalho de página: magic | apagamentos << 16 | sequência << 32
+// Cabeçalho de registro: chave | tamanho << 16 | CRC-32 << 32, seguido
+// dos dados em palavras duplas completadas com 0xFF
+#define SETTINGS_MAGIC         0x4B56U
+#define SETTINGS_BLANK         0xFFFFFFFFFFFFFFFFULL
+#define SETTINGS_DWORD         8U
+#define SETTINGS_DWORDS        (SETTINGS_PAGE_SIZE / SETTINGS_DWORD)
+#define SETTINGS_NO_PAGE       0xFFU
+#define SETTINGS_SEQ_BLANK     0xFFFFFFFFU
+
+typedef enum
+{
+    PAGE_FREE = 0,  // Apagada inteira
+    PAGE_USED,      // Cabeçalho válido: parte do anel
+    PAGE_GARBAGE,   // Cabeçalho ou corpo estragado por apagamento interrompido
+} Settings_PageState;
+
+static Settings_Stats stats;
+static uint8_t page_state[SETTINGS_PAGES];
+static uint32_t page_seq[SETTINGS_PAGES];
+static uint32_t index_addr[SETTINGS_MAX_KEYS]; // Registro mais novo de cada chave (0: nenhum)
+static uint8_t active = SETTINGS_NO_PAGE;
+static uint16_t write_pos;                      // Próxima palavra dupla livre na página ativa
+static volatile uint8_t ecc_fault = 0;          // Marcado pelo NMI de erro duplo de ECC
+
+static uint32_t Settings_RecordCrc(uint16_t key, const void *data, uint16_t len)
+{
+    uint8_t head[4] = { (uint8_t)key, (uint8_t)(key >> 8), (uint8_t)len, (uint8_t)(len >> 8) };
+
+    return ~Crc32_Update(Crc32_Update(CRC32_INIT, head, sizeof(head)), data, len);
+}
+
+static uint32_t Settings_PageAddr(uint8_t page)
+{
+    return SETTINGS_ADDR + (uint32_t)page * SETTINGS_PAGE_SIZE;
+}
+
+static uint16_t Settings_DataDwords(uint16_t len)
+{
+    return (uint16_t)((len + SETTINGS_DWORD - 1U) / SETTINGS_DWORD);
+}
+
+// Leitura que sobrevive a um erro duplo de ECC: 0 se a palavra está
+// estragada (o NMI descartou a leitura)
+static uint8_t Settings_Load(uint32_t addr, uint64_t *value)
+{
+    ecc_fault = 0;
+    *value = PORT_FLASH_READ64(addr);
+    PORT_CYCLES(6);
+    if (ecc_fault)
+    {
+        ecc_fault = 0;
+        return 0;
+    }
+    return 1;
+}
+
+// Registro válido em 'addr' (até 'limit'): devolve a chave e o tamanho,
+// ou 0 se o cabeçalho, os dados ou o CRC não batem
+static uint8_t Settings_Check(uint32_t addr, uint32_t limit, uint16_t *key, uint16_t *len)
+{
+    uint64_t head, dword;
+    uint8_t data[SETTINGS_MAX_LEN + SETTINGS_DWORD];
+    uint16_t k, n, dwords;
+
+    if (addr + SETTINGS_DWORD > limit || !Settings_Load(addr, &head) || head == SETTINGS_BLANK)
+        return 0;
+    k = (uint16_t)head;
+    n = (uint16_t)(head >> 16);
+    if (k == 0U || k >= SETTINGS_MAX_KEYS || n == 0U || n > SETTINGS_MAX_LEN)
+        return 0;
+    dwords = Settings_DataDwords(n);
+    if (addr + SETTINGS_DWORD * (1U + dwords) > limit)
+        return 0;
+    for (uint16_t i = 0; i < dwords; i++)
+    {
+        if (!Settings_Load(addr + SETTINGS_DWORD * (1U + i), &dword))
+            return 0;
+        memcpy(&data[i * SETTINGS_DWORD], &dword, SETTINGS_DWORD);
+    }
+    if ((uint32_t)(head >> 32) != Settings_RecordCrc(k, data, n))
+        return 0;
+    *key = k;
+    *len = n;
+    return 1;
+}
+
+static HAL_StatusTypeDef Settings_Erase(uint8_t page)
+{
+    FLASH_EraseInitTypeDef erase = { 0 };
+    uint32_t page_error;
+    HAL_StatusTypeDef status;
+
+    erase.TypeErase = FLASH_TYPEERASE_PAGES;
+    erase.Banks = FLASH_BANK_1;
+    erase.Page = SETTINGS_FIRST_PAGE + page;
+    erase.NbPages = 1;
+
+    HAL_FLASH_Unlock();
+    status = HAL_FLASHEx_Erase(&erase, &page_error);
+    HAL_FLASH_Lock();
+
+    stats.erases++;
+    stats.page_erases[page]++;
+    page_state[page] = (status == HAL_OK) ? PAGE_FREE : PAGE_GARBAGE;
+    page_seq[page] = SETTINGS_SEQ_BLANK;
+    return status;
+}
+
+// Palavras duplas em sequência a partir de write_pos; um programa que
+// falha deixa a página fechada (o resto dela não é mais confiável)
+static HAL_StatusTypeDef Settings_Program(const uint64_t *dwords, uint16_t count)
+{
+    uint32_t addr = Settings_PageAddr(active) + (uint32_t)write_pos * SETTINGS_DWORD;
+    HAL_StatusTypeDef status = HAL_OK;
+
+    if (write_pos + count > SETTINGS_DWORDS)
+        return HAL_ERROR;
+
+    HAL_FLASH_Unlock();
+    for (uint16_t i = 0; i < count && status == HAL_OK; i++)
+        status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, addr + i * SETTINGS_DWORD, dwords[i]);
+    HAL_FLASH_Lock();
+
+    write_pos = (status == HAL_OK) ? (uint16_t)(write_pos + count) : (uint16_t)SETTINGS_DWORDS;
+    return status;
+}
+
+// Abre 'page' (apagada) como a página ativa, depois da atual no anel
+static HAL_StatusTypeDef Settings_Open(uint8_t page, uint32_t seq)
+{
+    uint64_t head = SETTINGS_MAGIC | ((uint64_t)stats.page_erases[page] << 16) | ((uint64_t)seq << 32);
+
+    active = page;
+    write_pos = 0;
+    page_state[page] = PAGE_USED;
+    page_seq[page] = seq;
+    return Settings_Program(&head, 1);
+}
+
+// Acrescenta o registro na página ativa, se couber
+static HAL_StatusTypeDef Settings_Append(uint16_t key, const void *data, uint16_t len)
+{
+    uint64_t rec[1U + SETTINGS_MAX_LEN / SETTINGS_DWORD];
+    uint16_t dwords = Settings_DataDwords(len);
+    uint32_t addr = Settings_PageAddr(active) + (uint32_t)write_pos * SETTINGS_DWORD;
+
+    if (write_pos + 1U + dwords > SETTINGS_DWORDS)
+        return HAL_BUSY;
+
+    rec[0] = key | ((uint64_t)len << 16) | ((uint64_t)Settings_RecordCrc(key, data, len) << 32);
+    memset(&rec[1], 0xFF, dwords * SETTINGS_DWORD);
+    memcpy(&rec[1], data, len);
+    if (Settings_Program(rec, (uint16_t)(1U + dwords)) != HAL_OK)
+        return HAL_ERROR;
+
+    index_addr[key] = addr;
+    stats.writes++;
+    return HAL_OK;
+}
+
+static uint8_t Settings_Oldest(void)
+{
+    uint8_t oldest = SETTINGS_NO_PAGE;
+
+    for (uint8_t p = 0; p < SETTINGS_PAGES; p++)
+    {
+        if (page_state[p] == PAGE_USED && p != active
+            && (oldest == SETTINGS_NO_PAGE || page_seq[p] < page_seq[oldest]))
+            oldest = p;
+    }
+    return oldest;
+}
+
+// Primeira página livre depois da ativa no anel: o desgaste gira por todas
+static uint8_t Settings_NextFree(void)
+{
+    for (uint8_t i = 1; i <= SETTINGS_PAGES; i++)
+    {
+        uint8_t p = (uint8_t)((active + i) % SETTINGS_PAGES);
+
+        if (page_state[p] == PAGE_FREE)
+            return p;
+    }
+    return SETTINGS_NO_PAGE;
+}
+
+// Copia para a página ativa os registros ainda válidos da mais antiga e a
+// apaga. Um corte no meio deixa a antiga intacta até o apagamento.
+static HAL_StatusTypeDef Settings_Compact(void)
+{
+    uint8_t oldest = Settings_Oldest();
+    uint32_t base;
+    uint64_t dword;
+    uint8_t data[SETTINGS_MAX_LEN + SETTINGS_DWORD];
+
+    if (oldest == SETTINGS_NO_PAGE)
+        return HAL_ERROR;
+    base = Settings_PageAddr(oldest);
+
+    for (uint16_t key = 1; key < SETTINGS_MAX_KEYS; key++)
+    {
+        uint32_t addr = index_addr[key];
+        uint16_t len;
+
+        if (addr < base || addr >= base + SETTINGS_PAGE_SIZE)
+            continue;
+        (void)Settings_Load(addr, &dword);
+        len = (uint16_t)(dword >> 16);
+        for (uint16_t i = 0; i < Settings_DataDwords(len); i++)
+        {
+            (void)Settings_Load(addr + SETTINGS_DWORD * (1U + i), &dword);
+            memcpy(&data[i * SETTINGS_DWORD], &dword, SETTINGS_DWORD);
+        }
+        if (Settings_Append(key, data, len) != HAL_OK)
+            return HAL_ERROR;
+    }
+
+    stats.compactions++;
+    return Settings_Erase(oldest);
+}
+
+// Página ativa cheia: abre a próxima livre e, se era a última, compacta
+// a mais antiga para manter sempre uma livre
+static HAL_StatusTypeDef Settings_Advance(void)
+{
+    uint8_t next = Settings_NextFree();
+
+    if (next == SETTINGS_NO_PAGE)
+        return HAL_ERROR;
+    if (Settings_Open(next, page_seq[active] + 1U) != HAL_OK)
+        return HAL_ERROR;
+    if (Settings_NextFree() == SETTINGS_NO_PAGE)
+        return Settings_Compact();
+    return HAL_OK;
+}
+
+// Palavras duplas já gravadas da página: a última não apagada, procurada
+// do fim para o começo (uma palavra estragada conta como gravada)
+static uint16_t Settings_UsedEnd(uint32_t base)
+{
+    uint64_t dword;
+
+    for (uint16_t i = SETTINGS_DWORDS; i > 1U; i--)
+    {
+        if (!Settings_Load(base + (uint32_t)(i - 1U) * SETTINGS_DWORD, &dword) || dword != SETTINGS_BLANK)
+            return i;
+    }
+    return 1U;
+}
+
+// Lê os registros da página para o índice e devolve a próxima posição
+// livre. Um registro inválido (gravação interrompida) faz a leitura
+// seguir palavra a palavra até o fim da área gravada, e a página continua
+// depois dela, com uma palavra de folga.
+static uint16_t Settings_Scan(uint8_t page)
+{
+    uint32_t base = Settings_PageAddr(page);
+    uint16_t pos = 1, end = SETTINGS_DWORDS, next = 1;
+    uint8_t torn = 0;
+    uint64_t head;
+
+    while (pos < end)
+    {
+        uint16_t key, len;
+
+        if (Settings_Check(base + (uint32_t)pos * SETTINGS_DWORD, base + SETTINGS_PAGE_SIZE, &key, &len))
+        {
+            index_addr[key] = base + (uint32_t)pos * SETTINGS_DWORD;
+            stats.records++;
+            pos = (uint16_t)(pos + 1U + Settings_DataDwords(len));
+            next = pos;
+            continue;
+        }
+        if (!torn)
+        {
+            if (Settings_Load(base + (uint32_t)pos * SETTINGS_DWORD, &head) && head == SETTINGS_BLANK)
+                return pos;
+            torn = 1;
+            stats.corrupt++;
+            end = Settings_UsedEnd(base);
+        }
+        pos++;
+    }
+
+    if (torn && end + 1U > next)
+        next = (uint16_t)(end + 1U);
+    return (next < SETTINGS_DWORDS) ? next : (uint16_t)SETTINGS_DWORDS;
+}
+
+static uint8_t Settings_IsBlank(uint8_t page)
+{
+    uint64_t dword;
+
+    for (uint16_t i = 0; i < SETTINGS_DWORDS; i++)
+    {
+        if (!Settings_Load(Settings_PageAddr(page) + (uint32_t)i * SETTINGS_DWORD, &dword)
+            || dword != SETTINGS_BLANK)
+            return 0;
+    }
+    return 1;
+}
+
+// Monta o índice a partir do log, em ordem de sequência. Páginas com
+// cabeçalho estragado e páginas "livres" com resto de apagamento
+// interrompido são apagadas aqui, antes de o ECCL ligar o break.
+HAL_StatusTypeDef Settings_Init(void)
+{
+    uint8_t order[SETTINGS_PAGES], used = 0;
+    uint16_t max_erases = 0;
+    uint64_t head;
+
+    memset(&stats, 0, sizeof(stats));
+    memset(index_addr, 0, sizeof(index_addr));
+    active = SETTINGS_NO_PAGE;
+    write_pos = SETTINGS_DWORDS;
+
+    for (uint8_t p = 0; p < SETTINGS_PAGES; p++)
+    {
+        page_seq[p] = SETTINGS_SEQ_BLANK;
+        if (!Settings_Load(Settings_PageAddr(p), &head))
+            page_state[p] = PAGE_GARBAGE;
+        else if (head == SETTINGS_BLANK)
+            page_state[p] = Settings_IsBlank(p) ? PAGE_FREE : PAGE_GARBAGE;
+        else if ((uint16_t)head == SETTINGS_MAGIC && (uint32_t)(head >> 32) != SETTINGS_SEQ_BLANK)
+        {
+            page_state[p] = PAGE_USED;
+            page_seq[p] = (uint32_t)(head >> 32);
+            stats.page_erases[p] = (uint16_t)(head >> 16);
+            if (stats.page_erases[p] > max_erases)
+                max_erases = stats.page_erases[p];
+        }
+        else
+            page_state[p] = PAGE_GARBAGE;
+    }
+
+    // Páginas sem cabeçalho perderam a contagem: vale a maior conhecida
+    for (uint8_t p = 0; p < SETTINGS_PAGES; p++)
+    {
+        if (page_state[p] == PAGE_USED)
+        {
+            order[used++] = p;
+            continue;
+        }
+        stats.page_erases[p] = max_erases;
+        if (page_state[p] == PAGE_GARBAGE && Settings_Erase(p) != HAL_OK)
+            return HAL_ERROR;
+    }
+
+    // Inserção: no máximo SETTINGS_PAGES páginas
+    for (uint8_t i = 1; i < used; i++)
+    {
+        for (uint8_t j = i; j > 0 && page_seq[order[j]] < page_seq[order[j - 1U]]; j--)
+        {
+            uint8_t t = order[j];
+
+            order[j] = order[j - 1U];
+            order[j - 1U] = t;
+        }
+    }
+    for (uint8_t i = 0; i < used; i++)
+    {
+        uint16_t next = Settings_Scan(order[i]);
+
+        if (i == used - 1U)
+        {
+            active = order[i];
+            write_pos = next;
+        }
+    }
+
+    if (active == SETTINGS_NO_PAGE)
+    {
+        if (Settings_Open(0, 1) != HAL_OK)
+            return HAL_ERROR;
+    }
+    else if (Settings_NextFree() == SETTINGS_NO_PAGE)
+    {
+        // Corte entre abrir a página e apagar a mais antiga
+        if (Settings_Compact() != HAL_OK)
+            return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+// Valor mais novo da chave; HAL_ERROR se nunca gravada ou de outro tamanho
+HAL_StatusTypeDef Settings_Read(uint16_t key, void *data, uint16_t len)
+{
+    uint64_t dword;
+    uint8_t buf[SETTINGS_MAX_LEN + SETTINGS_DWORD];
+    uint32_t addr;
+
+    if (key == 0U || key >= SETTINGS_MAX_KEYS || data == NULL || index_addr[key] == 0U)
+        return HAL_ERROR;
+    addr = index_addr[key];
+    if (!Settings_Load(addr, &dword) || (uint16_t)(dword >> 16) != len)
+        return HAL_ERROR;
+    for (uint16_t i = 0; i < Settings_DataDwords(len); i++)
+    {
+        if (!Settings_Load(addr + SETTINGS_DWORD * (1U + i), &dword))
+            return HAL_ERROR;
+        memcpy(&buf[i * SETTINGS_DWORD], &dword, SETTINGS_DWORD);
+    }
+    memcpy(data, buf, len);
+    return HAL_OK;
+}
+
+// Grava só se o valor mudou. Uma falha de programação fecha a página e a
+// gravação é repetida uma vez na seguinte.
+HAL_StatusTypeDef Settings_Write(uint16_t key, const void *data, uint16_t len)
+{
+    uint8_t current[SETTINGS_MAX_LEN];
+    HAL_StatusTypeDef status = HAL_ERROR;
+
+    if (key == 0U || key >= SETTINGS_MAX_KEYS || data == NULL || len == 0U || len > SETTINGS_MAX_LEN
+        || active == SETTINGS_NO_PAGE)
+        return HAL_ERROR;
+    if (Settings_Read(key, current, len) == HAL_OK && memcmp(current, data, len) == 0)
+        return HAL_OK;
+
+    for (uint8_t attempt = 0; attempt < 2U && status != HAL_OK; attempt++)
+    {
+        status = Settings_Append(key, data, len);
+        if (status != HAL_OK && Settings_Advance() == HAL_OK)
+            status = Settings_Append(key, data, len);
+    }
+    return status;
+}
+
+const Settings_Stats *Settings_GetStats(void)
+{
+    stats.free_bytes = (active == SETTINGS_NO_PAGE) ? 0U
+                     : (uint16_t)((SETTINGS_DWORDS - write_pos) * SETTINGS_DWORD);
+    return &stats;
+}
+
+uint8_t Settings_EccNmiHandler(void)
+{
+    uint32_t eccr = FLASH->ECCR;
+    uint32_t addr = FLASH_BASE + (eccr & FLASH_ECCR_ADDR_ECC) * SETTINGS_DWORD;
+
+    if ((eccr & FLASH_ECCR_ECCD) == 0U || addr < SETTINGS_ADDR
+        || addr >= SETTINGS_ADDR + SETTINGS_PAGES * SETTINGS_PAGE_SIZE)
+        return 0;
+    FLASH->ECCR = (eccr & FLASH_ECCR_ECCCIE) | FLASH_ECCR_ECCD;
+    ecc_fault = 1;
+    return 1;
+}
@@ -22,6 +22,11 @@
 #include "stm32g0xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "power.h"
+#include "settings.h"
+#include "datalog.h"
+#include "timebase.h"
+#include "trace.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -55,6 +60,13 @@
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern ADC_HandleTypeDef hadc1;
+extern DMA_HandleTypeDef hdma_adc1;
+extern DMA_HandleTypeDef hdma_tim1_up;
+extern DMA_HandleTypeDef hdma_usart2_tx;
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim6;
+extern TIM_HandleTypeDef htim14;
 
 /* USER CODE BEGIN EV */
 
@@ -69,7 +81,9 @@
 void NMI_Handler(void)
 {
   /* USER CODE BEGIN NonMaskableInt_IRQn 0 */
-
+  // Erro duplo de ECC numa gravação interrompida dos ajustes ou do registro
+  if (Settings_EccNmiHandler() || DataLog_EccNmiHandler())
+    return;
   /* USER CODE END NonMaskableInt_IRQn 0 */
   /* USER CODE BEGIN NonMaskableInt_IRQn 1 */
    while (1)
@@ -84,7 +98,7 @@ void NMI_Handler(void)
 void HardFault_Handler(void)
 {
   /* USER CODE BEGIN HardFault_IRQn 0 */
-
+  TIM1->EGR = TIM_EGR_BG; // Estágio de potência no estado seguro
   /* USER CODE END HardFault_IRQn 0 */
   while (1)
   {
@@ -125,11 +139,11 @@ void PendSV_Handler(void)
 void SysTick_Handler(void)
 {
   /* USER CODE BEGIN SysTick_IRQn 0 */
-
+  TRACE_ISR_IN(SysTick_IRQn);
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
-
+  TRACE_ISR_OUT(SysTick_IRQn);
   /* USER CODE END SysTick_IRQn 1 */
 }
 
@@ -140,6 +154,148 @@ void SysTick_Handler(void)
 /* please refer to the startup file (startup_stm32g0xx.s).                    */
 /******************************************************************************/
 
+/**
+  * @brief This function handles RTC and TAMP interrupts through EXTI lines 19 and 21.
+  */
+void RTC_TAMP_IRQHandler(void)
+{
+  /* USER CODE BEGIN RTC_TAMP_IRQn 0 */
+  TRACE_ISR_IN(RTC_TAMP_IRQn);
+  /* USER CODE END RTC_TAMP_IRQn 0 */
+  Power_RtcIRQHandler();
+  /* USER CODE BEGIN RTC_TAMP_IRQn 1 */
+  TRACE_ISR_OUT(RTC_TAMP_IRQn);
+  /* USER CODE END RTC_TAMP_IRQn 1 */
+}
+
+/**
+  * @brief This function handles EXTI line 0 and line 1 interrupts.
+  */
+void EXTI0_1_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI0_1_IRQn 0 */
+  TRACE_ISR_IN(EXTI0_1_IRQn);
+  /* USER CODE END EXTI0_1_IRQn 0 */
+  HAL_GPIO_EXTI_IRQHandler(BUTTON_UP);
+  HAL_GPIO_EXTI_IRQHandler(BUTTON_DOWN);
+  /* USER CODE BEGIN EXTI0_1_IRQn 1 */
+  TRACE_ISR_OUT(EXTI0_1_IRQn);
+  /* USER CODE END EXTI0_1_IRQn 1 */
+}
+
+/**
+  * @brief This function handles EXTI line 4 to 15 interrupts.
+  */
+void EXTI4_15_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI4_15_IRQn 0 */
+  TRACE_ISR_IN(EXTI4_15_IRQn);
+  /* USER CODE END EXTI4_15_IRQn 0 */
+  HAL_GPIO_EXTI_IRQHandler(BUTTON_SCREEN);
+  /* USER CODE BEGIN EXTI4_15_IRQn 1 */
+  TRACE_ISR_OUT(EXTI4_15_IRQn);
+  /* USER CODE END EXTI4_15_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA1 channel 1 interrupt.
+  */
+void DMA1_Channel1_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel1_IRQn 0 */
+  TRACE_ISR_IN(DMA1_Channel1_IRQn);
+  /* USER CODE END DMA1_Channel1_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_adc1);
+  /* USER CODE BEGIN DMA1_Channel1_IRQn 1 */
+  TRACE_ISR_OUT(DMA1_Channel1_IRQn);
+  /* USER CODE END DMA1_Channel1_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA1 channel 2 and channel 3 interrupts.
+  */
+void DMA1_Channel2_3_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel2_3_IRQn 0 */
+  TRACE_ISR_IN(DMA1_Channel2_3_IRQn);
+  /* USER CODE END DMA1_Channel2_3_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_tim1_up);
+  /* USER CODE BEGIN DMA1_Channel2_3_IRQn 1 */
+  HAL_DMA_IRQHandler(&hdma_usart2_tx);
+  TRACE_ISR_OUT(DMA1_Channel2_3_IRQn);
+  /* USER CODE END DMA1_Channel2_3_IRQn 1 */
+}
+
+/**
+  * @brief This function handles ADC1 interrupt.
+  */
+void ADC1_IRQHandler(void)
+{
+  /* USER CODE BEGIN ADC1_IRQn 0 */
+  TRACE_ISR_IN(ADC1_IRQn);
+  /* USER CODE END ADC1_IRQn 0 */
+  HAL_ADC_IRQHandler(&hadc1);
+  /* USER CODE BEGIN ADC1_IRQn 1 */
+  TRACE_ISR_OUT(ADC1_IRQn);
+  /* USER CODE END ADC1_IRQn 1 */
+}
+
+/**
+  * @brief This function handles TIM1 break, update, trigger and commutation interrupts.
+  */
+void TIM1_BRK_UP_TRG_COM_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM1_BRK_UP_TRG_COM_IRQn 0 */
+  TRACE_ISR_IN(TIM1_BRK_UP_TRG_COM_IRQn);
+  /* USER CODE END TIM1_BRK_UP_TRG_COM_IRQn 0 */
+  HAL_TIM_IRQHandler(&htim1);
+  /* USER CODE BEGIN TIM1_BRK_UP_TRG_COM_IRQn 1 */
+  TRACE_ISR_OUT(TIM1_BRK_UP_TRG_COM_IRQn);
+  /* USER CODE END TIM1_BRK_UP_TRG_COM_IRQn 1 */
+}
+
+/**
+  * @brief This function handles TIM6 global interrupt.
+  */
+void TIM6_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM6_IRQn 0 */
+  TRACE_ISR_IN(TIM6_IRQn);
+  /* USER CODE END TIM6_IRQn 0 */
+  HAL_TIM_IRQHandler(&htim6);
+  /* USER CODE BEGIN TIM6_IRQn 1 */
+  TRACE_ISR_OUT(TIM6_IRQn);
+  /* USER CODE END TIM6_IRQn 1 */
+}
+
+/**
+  * @brief This function handles TIM7 global interrupt.
+  */
+void TIM7_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM7_IRQn 0 */
+  TRACE_ISR_IN(TIM7_IRQn);
+  /* USER CODE END TIM7_IRQn 0 */
+  Timebase_IRQHandler();
+  /* USER CODE BEGIN TIM7_IRQn 1 */
+  TRACE_ISR_OUT(TIM7_IRQn);
+  /* USER CODE END TIM7_IRQn 1 */
+}
+
+/**
+  * @brief This function handles TIM14 global interrupt.
+  */
+void TIM14_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM14_IRQn 0 */
+  TRACE_ISR_IN(TIM14_IRQn);
+  /* USER CODE END TIM14_IRQn 0 */
+  HAL_TIM_IRQHandler(&htim14);
+  /* USER CODE BEGIN TIM14_IRQn 1 */
+  TRACE_ISR_OUT(TIM14_IRQn);
+  /* USER CODE END TIM14_IRQn 1 */
+}
+
 /* USER CODE BEGIN 1 */
 
 /* USER CODE END 1 */
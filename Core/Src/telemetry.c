@@ -0,0 +1,270 @@
+#include <string.h>
+#include "telemetry.h"
+#include "crc32.h"
+#include "port.h"
+
+#define TELEMETRY_OVER8_BELOW  64U   // PCLK por bit: abaixo disso, sobreamostragem por 8
+
+static DMA_HandleTypeDef *tx_hdma = NULL;
+static uint32_t tx_baud = TELEMETRY_BAUD;
+static uint32_t period_ms = TELEMETRY_PERIOD_MS;
+static uint8_t buf[2][TELEMETRY_BUF_SIZE];
+static uint16_t fill_len = 0;        // Bytes na metade de preenchimento
+static uint8_t fill = 0;             // Metade de preenchimento; a outra é do DMA
+static volatile uint8_t dma_busy = 0;
+static uint8_t seq = 0;
+static Telemetry_Stats stats;
+static char text_line[TELEMETRY_TEXT_MAX];
+static uint16_t text_len = 0;
+
+static void Telemetry_Put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void Telemetry_Put32(uint8_t *p, uint32_t v)
+{
+    Telemetry_Put16(p, (uint16_t)v);
+    Telemetry_Put16(p + 2, (uint16_t)(v >> 16));
+}
+
+// COBS: cada bloco começa com a distância até o próximo zero (0xFF para
+// 254 bytes sem zero) e o 0x00 fecha o quadro. 'out' tem de comportar
+// len + len / 254 + 2 bytes.
+static uint16_t Telemetry_Cobs(const uint8_t *in, uint16_t len, uint8_t *out)
+{
+    uint16_t code_at = 0, o = 1;
+    uint8_t code = 1;
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        if (in[i] != 0U)
+        {
+            out[o++] = in[i];
+            code++;
+        }
+        if (in[i] == 0U || code == 0xFFU)
+        {
+            out[code_at] = code;
+            code_at = o++;
+            code = 1;
+        }
+    }
+    out[code_at] = code;
+    out[o++] = 0x00U;
+    PORT_CYCLES(12U * len);
+    return o;
+}
+
+// Da ISR do DMA ou com as IRQs mascaradas: a metade com quadros vai para
+// o DMA e a outra passa a receber
+static void Telemetry_Kick(void)
+{
+    uint8_t tx = fill;
+    uint16_t len = fill_len;
+
+    if (dma_busy || len == 0U)
+        return;
+    fill ^= 1U;
+    fill_len = 0;
+    dma_busy = 1;
+    if (PORT_DMA_TX(tx_hdma, &USART2->TDR, buf[tx], len) != HAL_OK)
+    {
+        dma_busy = 0;
+        stats.dma_errors++;
+        return;
+    }
+    stats.bytes += len;
+    PORT_CYCLES(40);
+}
+
+static void Telemetry_TxCplt(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+    dma_busy = 0;
+    Telemetry_Kick();
+}
+
+static void Telemetry_TxError(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+    dma_busy = 0;
+    stats.dma_errors++;
+}
+
+// Tipo, sequência, corpo e CRC em COBS, copiados para a metade de
+// preenchimento. A sequência avança mesmo no descarte.
+static HAL_StatusTypeDef Telemetry_Queue(uint8_t type, const uint8_t *body, uint16_t len)
+{
+    uint8_t payload[TELEMETRY_PAYLOAD_MAX];
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    HAL_StatusTypeDef status = HAL_OK;
+    uint32_t primask;
+    uint16_t n;
+
+    if (tx_hdma == NULL || len > TELEMETRY_TEXT_MAX)
+        return HAL_ERROR;
+
+    payload[0] = type;
+    payload[1] = seq++;
+    memcpy(&payload[TELEMETRY_HEADER], body, len);
+    len += TELEMETRY_HEADER;
+    Telemetry_Put32(&payload[len], Crc32(payload, len));
+    n = Telemetry_Cobs(payload, len + TELEMETRY_CRC, frame);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (fill_len + n > TELEMETRY_BUF_SIZE)
+    {
+        stats.dropped++;
+        status = HAL_BUSY;
+    }
+    else
+    {
+        memcpy(&buf[fill][fill_len], frame, n);
+        fill_len += n;
+        stats.frames++;
+        if (fill_len > stats.max_fill)
+            stats.max_fill = fill_len;
+        Telemetry_Kick();
+    }
+    __set_PRIMASK(primask);
+    PORT_CYCLES(60U + n);
+    return status;
+}
+
+// DMA já iniciado (HAL_DMA_Init) no canal da USART2 TX, com a IRQ no NVIC;
+// clock e pino da USART2 ligados por quem chama
+HAL_StatusTypeDef Telemetry_Init(DMA_HandleTypeDef *hdma, uint32_t baud)
+{
+    if (hdma == NULL)
+        return HAL_ERROR;
+
+    hdma->XferCpltCallback = Telemetry_TxCplt;
+    hdma->XferErrorCallback = Telemetry_TxError;
+    tx_hdma = hdma;
+    fill = 0;
+    fill_len = 0;
+    dma_busy = 0;
+    seq = 0;
+    text_len = 0;
+    memset(&stats, 0, sizeof(stats));
+
+    USART2->CR1 = 0;
+    USART2->CR2 = 0;              // 1 stop bit
+    USART2->CR3 = USART_CR3_DMAT; // TXE pede o DMA
+    USART2->PRESC = 0;
+    return Telemetry_SetBaud(baud);
+}
+
+// BRR no PCLK atual, arredondado. Com menos de TELEMETRY_OVER8_BELOW
+// ciclos por bit (perfil de 2 MHz), sobreamostragem por 8: a 115200 o
+// erro cai de 2,1% para 0,8%. BRR e OVER8 só mudam com UE desligado, o
+// que corta o caractere na linha.
+HAL_StatusTypeDef Telemetry_SetBaud(uint32_t baud)
+{
+    uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+    uint32_t cr1 = USART_CR1_TE | USART_CR1_UE;
+    uint32_t div, primask;
+
+    if (baud == 0U || pclk / baud < 8U)
+        return HAL_ERROR;
+    if (pclk / baud < TELEMETRY_OVER8_BELOW)
+    {
+        div = (2U * pclk + baud / 2U) / baud;
+        div = (div & 0xFFF0U) | ((div & 0x000FU) >> 1);
+        cr1 |= USART_CR1_OVER8;
+    }
+    else
+        div = (pclk + baud / 2U) / baud;
+    if (div > 0xFFFFU)
+        return HAL_ERROR;
+
+    tx_baud = baud;
+    primask = __get_PRIMASK();
+    __disable_irq();
+    USART2->CR1 = 0;
+    USART2->BRR = div;
+    USART2->CR1 = cr1;
+    __set_PRIMASK(primask);
+    PORT_CYCLES(30);
+    return HAL_OK;
+}
+
+// Intervalo das amostras na taxa cheia, lido pela tarefa da aplicação
+void Telemetry_SetPeriod(uint32_t ms)
+{
+    period_ms = ms;
+}
+
+uint32_t Telemetry_GetPeriod(void)
+{
+    return period_ms;
+}
+
+HAL_StatusTypeDef Telemetry_SendSample(const Telemetry_Sample *s)
+{
+    uint8_t body[TELEMETRY_SAMPLE_SIZE];
+    int32_t temp;
+
+    if (s == NULL)
+        return HAL_ERROR;
+    temp = s->temp_cdeg;
+    if (temp > INT16_MAX)
+        temp = INT16_MAX;
+    else if (temp < INT16_MIN)
+        temp = INT16_MIN;
+
+    Telemetry_Put32(&body[0], s->time_ms);
+    Telemetry_Put16(&body[4], (uint16_t)(int16_t)temp);
+    Telemetry_Put16(&body[6], s->duty_permille);
+    Telemetry_Put16(&body[8], s->countdown_s);
+    body[10] = s->flags;
+    PORT_CYCLES(30);
+    return Telemetry_Queue(TELEMETRY_PKT_SAMPLE, body, sizeof(body));
+}
+
+// Texto além de TELEMETRY_TEXT_MAX é cortado
+HAL_StatusTypeDef Telemetry_SendText(const char *text, uint16_t len)
+{
+    if (text == NULL)
+        return HAL_ERROR;
+    if (len > TELEMETRY_TEXT_MAX)
+        len = TELEMETRY_TEXT_MAX;
+    return Telemetry_Queue(TELEMETRY_PKT_TEXT, (const uint8_t *)text, len);
+}
+
+// DMA com quadros ou o último byte ainda na linha: o STOP pararia o PCLK
+uint8_t Telemetry_IsBusy(void)
+{
+    if (tx_hdma == NULL)
+        return 0;
+    return dma_busy || (USART2->ISR & USART_ISR_TC) == 0U;
+}
+
+// Perfil de clock novo: mesmo baud no PCLK novo
+void Telemetry_ClockChanged(void)
+{
+    if (tx_hdma != NULL)
+        (void)Telemetry_SetBaud(tx_baud);
+}
+
+const Telemetry_Stats *Telemetry_GetStats(void)
+{
+    return &stats;
+}
+
+// printf() pela telemetria (_write de syscalls.c): uma linha por pacote,
+// sem o '\r' e cortada em TELEMETRY_TEXT_MAX. Só fora de ISRs.
+int __io_putchar(int ch)
+{
+    if (ch != '\n' && ch != '\r')
+        text_line[text_len++] = (char)ch;
+    if ((ch == '\n' && text_len != 0U) || text_len == TELEMETRY_TEXT_MAX)
+    {
+        (void)Telemetry_SendText(text_line, text_len);
+        text_len = 0;
+    }
+    return ch;
+}
@@ -0,0 +1,320 @@
+#include "temp_sensor.h"
+#include "trace.h"
+#include "port.h"
+
+// 14 bits: 16 conversões por gatilho (208 us com o ADC a 4 MHz e
+// amostragem de 39.5 ciclos), 10 resultados por leitura
+const TempSensor_Profile TempSensor_Profile12Bit = { 0, 0, TEMP_SAMPLE_RATE_HZ, TEMP_HALF_LEN };
+const TempSensor_Profile TempSensor_Profile14Bit = { 4, 2, 100, 10 };
+// 16 bits: 256 conversões por gatilho (3.3 ms), 10 resultados por leitura
+const TempSensor_Profile TempSensor_Profile16Bit = { 8, 4, 100, 10 };
+
+// Buffer circular preenchido pelo DMA (meia palavra por resultado)
+static uint16_t adc_samples[TEMP_BUFFER_LEN];
+
+static ADC_HandleTypeDef *temp_hadc;
+static TIM_HandleTypeDef *temp_htim;
+static const TempSensor_Profile *active = &TempSensor_Profile12Bit;
+static uint32_t block_len = TEMP_HALF_LEN;
+static uint32_t scale_q16 = TEMP_SCALE_Q16;
+static uint32_t full_scale = TEMP_ADC_FULL_SCALE;
+static uint32_t cal_factor = 0;
+
+// Alarme: limiares em centésimos e já convertidos para o watchdog
+static int32_t alarm_on_cdeg = INT32_MAX;
+static int32_t alarm_off_cdeg = INT32_MAX;
+static uint32_t awd_on = TEMP_ADC_FULL_SCALE + 1U;
+static uint32_t awd_off = TEMP_ADC_FULL_SCALE + 1U;
+static volatile uint8_t alarm_active = 0;
+
+// Soma de um bloco no pior caso vezes a escala cabe em 32 bits
+_Static_assert((uint64_t)TEMP_ADC_FULL_SCALE * TEMP_HALF_LEN * TEMP_SCALE_Q16
+               + (1UL << (TEMP_SCALE_SHIFT - 1U)) <= UINT32_MAX,
+               "TEMP_SCALE_Q16 estoura 32 bits");
+
+// Última soma pronta, publicada pelas callbacks de DMA
+static volatile uint32_t latest_sum = 0;
+static volatile uint8_t sum_ready = 0;
+static uint8_t running = 0;
+
+static void TempSensor_Average(const uint16_t *half)
+{
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < block_len; i++)
+        sum += half[i];
+    PORT_CYCLES(block_len * 6U); // ldrh + add + laço por amostra
+
+    latest_sum = sum;
+    sum_ready = 1;
+    TRACE(TRACE_ADC_READY, 0U, sum / block_len);
+}
+
+// Centésimos de °C -> limiar do watchdog, arredondado para cima. O
+// watchdog compara 12 bits: o código cru ou, com o oversampler, os bits
+// [15:4] do resultado (RM0444; nota do HighThreshold na HAL).
+static uint32_t TempSensor_WatchdogCode(int32_t cdeg)
+{
+    uint64_t code;
+
+    if (cdeg <= 0)
+        return 0;
+    code = ((uint64_t)cdeg * full_scale + (TEMP_VREF_MV * TEMP_CDEG_PER_MV - 1U))
+         / (TEMP_VREF_MV * TEMP_CDEG_PER_MV);
+    if (active->ratio_log2 > 0U)
+        code = (code + 15U) >> 4;
+    return (code > TEMP_ADC_FULL_SCALE) ? TEMP_ADC_FULL_SCALE + 1U : (uint32_t)code;
+}
+
+// Janela do estado atual, escrita direto em AWD1TR (pode mudar com o ADC
+// convertendo; vale a partir do próximo resultado). Um limiar acima do
+// fundo de escala desliga o lado correspondente.
+static void TempSensor_ArmWatchdog(void)
+{
+    uint32_t high, low;
+
+    if (alarm_active)
+    {
+        high = TEMP_ADC_FULL_SCALE;
+        low = (awd_off > TEMP_ADC_FULL_SCALE) ? TEMP_ADC_FULL_SCALE : awd_off;
+    }
+    else
+    {
+        high = (awd_on > TEMP_ADC_FULL_SCALE) ? TEMP_ADC_FULL_SCALE
+             : (awd_on == 0U) ? 0U : awd_on - 1U;
+        low = 0U;
+    }
+    MODIFY_REG(temp_hadc->Instance->AWD1TR, ADC_AWD1TR_HT1 | ADC_AWD1TR_LT1,
+               (high << ADC_AWD1TR_HT1_Pos) | low);
+}
+
+static void TempSensor_Stop(void)
+{
+    HAL_TIM_Base_Stop(temp_htim);
+    HAL_ADC_Stop_DMA(temp_hadc);
+    running = 0;
+}
+
+// Inicia o DMA circular com o ADC armado e só então o timer de gatilho,
+// com o contador zerado, para que a primeira conversão já caia no início
+// do buffer
+static HAL_StatusTypeDef TempSensor_Run(void)
+{
+    if (HAL_ADC_Start_DMA(temp_hadc, (uint32_t *)adc_samples, 2U * block_len) != HAL_OK)
+        return HAL_ERROR;
+    __HAL_TIM_SET_COUNTER(temp_htim, 0);
+    if (HAL_TIM_Base_Start(temp_htim) != HAL_OK)
+        return HAL_ERROR;
+    running = 1;
+    return HAL_OK;
+}
+
+// Calibração com o ADC desligado; o fator vale até o próximo reset
+static HAL_StatusTypeDef TempSensor_CalibrateStopped(void)
+{
+    if (HAL_ADCEx_Calibration_Start(temp_hadc) != HAL_OK)
+        return HAL_ERROR;
+    cal_factor = HAL_ADCEx_Calibration_GetValue(temp_hadc);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef TempSensor_Start(ADC_HandleTypeDef *hadc, TIM_HandleTypeDef *htim,
+                                   const TempSensor_Profile *profile)
+{
+    temp_hadc = hadc;
+    temp_htim = htim;
+    return TempSensor_SetProfile(profile);
+}
+
+// Troca o perfil: para a aquisição, reprograma o oversampler (só com o ADC
+// desligado), a taxa do TIM3 e a escala, recalibra e reinicia. A leitura
+// em andamento é descartada.
+HAL_StatusTypeDef TempSensor_SetProfile(const TempSensor_Profile *profile)
+{
+    uint64_t div;
+
+    if (profile == NULL || profile->ratio_log2 > 8U || profile->shift > profile->ratio_log2
+        || profile->rate_hz < 16U || profile->rate_hz > 1000U
+        || profile->block_len == 0U || profile->block_len > TEMP_HALF_LEN)
+        return HAL_ERROR;
+
+    TempSensor_Stop();
+
+    if (profile->ratio_log2 == 0U)
+        LL_ADC_SetOverSamplingScope(temp_hadc->Instance, LL_ADC_OVS_DISABLE);
+    else
+    {
+        LL_ADC_ConfigOverSamplingRatioShift(temp_hadc->Instance,
+                                            (uint32_t)(profile->ratio_log2 - 1U) << ADC_CFGR2_OVSR_Pos,
+                                            (uint32_t)profile->shift << ADC_CFGR2_OVSS_Pos);
+        // Um TRGO dispara a rajada inteira
+        LL_ADC_SetOverSamplingDiscont(temp_hadc->Instance, LL_ADC_OVS_REG_CONT);
+        LL_ADC_SetOverSamplingScope(temp_hadc->Instance, LL_ADC_OVS_GRP_REGULAR_CONTINUED);
+    }
+
+    // TIM3_Init deixa o contador em 1 MHz
+    __HAL_TIM_SET_AUTORELOAD(temp_htim, (1000000U / profile->rate_hz) - 1U);
+
+    // Escala Q16 do perfil: uma divisão de 64 bits, só aqui
+    full_scale = (TEMP_ADC_FULL_SCALE << profile->ratio_log2) >> profile->shift;
+    div = full_scale * profile->block_len;
+    scale_q16 = (uint32_t)(((((uint64_t)TEMP_VREF_MV * TEMP_CDEG_PER_MV) << TEMP_SCALE_SHIFT) + div / 2U) / div);
+    block_len = profile->block_len;
+    active = profile;
+    sum_ready = 0;
+
+    // Watchdog 1 sobre o canal convertido, limiares na escala do perfil
+    ADC_AnalogWDGConfTypeDef awd = {0};
+    awd.WatchdogNumber = ADC_ANALOGWATCHDOG_1;
+    awd.WatchdogMode = ADC_ANALOGWATCHDOG_ALL_REG;
+    awd.ITMode = ENABLE;
+    awd.HighThreshold = TEMP_ADC_FULL_SCALE;
+    awd.LowThreshold = 0;
+    if (HAL_ADC_AnalogWDGConfig(temp_hadc, &awd) != HAL_OK)
+        return HAL_ERROR;
+    awd_on = TempSensor_WatchdogCode(alarm_on_cdeg);
+    awd_off = TempSensor_WatchdogCode(alarm_off_cdeg);
+    TempSensor_ArmWatchdog();
+
+    if (TempSensor_CalibrateStopped() != HAL_OK)
+        return HAL_ERROR;
+    return TempSensor_Run();
+}
+
+// Recalibração periódica: o offset do ADC deriva com a temperatura e a
+// tensão. Para a aquisição por ~0.2 ms e descarta a leitura em andamento.
+HAL_StatusTypeDef TempSensor_Calibrate(void)
+{
+    uint8_t was_running = running;
+
+    TempSensor_Stop();
+    if (TempSensor_CalibrateStopped() != HAL_OK)
+        return HAL_ERROR;
+    return was_running ? TempSensor_Run() : HAL_OK;
+}
+
+// Aquisição suspensa: TIM3, ADC e DMA parados, sem consumo e sem IRQs.
+// A leitura em andamento é descartada; o alarme do watchdog fica sem
+// avaliação até TempSensor_Resume().
+void TempSensor_Suspend(void)
+{
+    if (running)
+        TempSensor_Stop();
+}
+
+// Retoma com o buffer do início: a próxima leitura sai um período depois
+HAL_StatusTypeDef TempSensor_Resume(void)
+{
+    if (running)
+        return HAL_OK;
+    sum_ready = 0;
+    return TempSensor_Run();
+}
+
+uint8_t TempSensor_IsRunning(void)
+{
+    return running;
+}
+
+// Soma de uma leitura (block_len resultados) -> centésimos de °C, com
+// arredondamento
+int32_t TempSensor_SumToCentiCelsius(uint32_t sum)
+{
+    PORT_CYCLES(8); // muls + adds + lsrs + retorno
+    return (int32_t)((sum * scale_q16 + (1UL << (TEMP_SCALE_SHIFT - 1U))) >> TEMP_SCALE_SHIFT);
+}
+
+// Retorna 1 e a temperatura média mais recente (centésimos de °C) se houver
+// uma nova desde a última chamada; 0 caso contrário. Não bloqueia.
+uint8_t TempSensor_GetCentiCelsius(int32_t *cdeg)
+{
+    if (!sum_ready)
+        return 0;
+    sum_ready = 0;
+    *cdeg = TempSensor_SumToCentiCelsius(latest_sum);
+    return 1;
+}
+
+// Média da última leitura, na resolução do perfil (TempSensor_Bits())
+uint16_t TempSensor_LastCode(void)
+{
+    return (uint16_t)((latest_sum + block_len / 2U) / block_len);
+}
+
+uint8_t TempSensor_Bits(void)
+{
+    return (uint8_t)(12U + active->ratio_log2 - active->shift);
+}
+
+// Intervalo entre médias novas: o período natural de quem as consome
+uint32_t TempSensor_PeriodMs(void)
+{
+    return (active->block_len * 1000U) / active->rate_hz;
+}
+
+// Último fator de calibração (CALFACT, 7 bits)
+uint32_t TempSensor_CalibrationFactor(void)
+{
+    return cal_factor;
+}
+
+// Limiares do alarme, com off_cdeg <= on_cdeg. Pode ser chamada com a
+// aquisição rodando: a janela nova vale a partir do próximo resultado.
+HAL_StatusTypeDef TempSensor_SetAlarm(int32_t on_cdeg, int32_t off_cdeg)
+{
+    uint32_t primask;
+
+    if (off_cdeg > on_cdeg)
+        return HAL_ERROR;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    alarm_on_cdeg = on_cdeg;
+    alarm_off_cdeg = off_cdeg;
+    if (temp_hadc != NULL)
+    {
+        awd_on = TempSensor_WatchdogCode(on_cdeg);
+        awd_off = TempSensor_WatchdogCode(off_cdeg);
+        TempSensor_ArmWatchdog();
+    }
+    __set_PRIMASK(primask);
+    return HAL_OK;
+}
+
+uint8_t TempSensor_AlarmActive(void)
+{
+    return alarm_active;
+}
+
+__weak void TempSensor_AlarmCallback(uint8_t active)
+{
+    (void)active;
+}
+
+// Resultado fora da janela: troca de estado e vira a janela, que passa a
+// valer já no próximo resultado
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc != temp_hadc)
+        return;
+    alarm_active ^= 1U;
+    TempSensor_ArmWatchdog();
+    PORT_CYCLES(20);
+    TempSensor_AlarmCallback(alarm_active);
+}
+
+// --- Callbacks do DMA (contexto de interrupção) ---
+
+// Primeira metade cheia: o DMA segue gravando na segunda
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Instance == ADC1)
+        TempSensor_Average(&adc_samples[0]);
+}
+
+// Segunda metade cheia: o DMA volta ao início do buffer
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Instance == ADC1)
+        TempSensor_Average(&adc_samples[block_len]);
+}
@@ -0,0 +1,205 @@
+#include "timebase.h"
+#include "clock.h"
+#include "port.h"
+
+static TIM_HandleTypeDef *tb_htim = NULL;
+static volatile uint64_t base_us = 0; // Instante do CNT = 0
+static uint32_t frac_ns = 0;          // Tempo em STOP ainda não somado à base
+
+// Base mais o contador, com a volta ainda não contada (UIF) já somada.
+// Se UIF subiu entre as leituras, a segunda leitura do CNT é a pós-volta.
+// Chamada com as IRQs mascaradas.
+static uint64_t Timebase_Now(TIM_TypeDef *tim)
+{
+    uint32_t cnt = tim->CNT;
+    uint64_t now = base_us;
+
+    if (tim->SR & TIM_SR_UIF)
+    {
+        cnt = tim->CNT;
+        now += TIMEBASE_PERIOD;
+    }
+    return now + cnt;
+}
+
+// Contador somado à base e zerado, com o PSC do registrador já valendo.
+// URS fica ligado: o UG não marca UIF, só a volta. Com as IRQs mascaradas.
+static void Timebase_Fold(TIM_TypeDef *tim)
+{
+    base_us = Timebase_Now(tim);
+    tim->SR = ~TIM_SR_UIF;
+    tim->EGR = TIM_EGR_UG;
+    PORT_CYCLES(12);
+}
+
+// Timer já iniciado pela HAL (HAL_TIM_Base_Init) e com a IRQ no NVIC:
+// volta de 16 bits, contagem de TIMEBASE_HZ e partida
+HAL_StatusTypeDef Timebase_Init(TIM_HandleTypeDef *htim)
+{
+    TIM_TypeDef *tim;
+
+    if (htim == NULL)
+        return HAL_ERROR;
+    tim = htim->Instance;
+
+    CLEAR_BIT(tim->CR1, TIM_CR1_CEN);
+    htim->Init.Prescaler = Clock_Prescaler(TIMEBASE_HZ);
+    htim->Init.Period = TIMEBASE_PERIOD - 1U;
+    tim->PSC = htim->Init.Prescaler;
+    tim->ARR = htim->Init.Period;
+    SET_BIT(tim->CR1, TIM_CR1_URS);
+    tim->EGR = TIM_EGR_UG;
+    tim->SR = ~TIM_SR_UIF;
+    base_us = 0;
+    frac_ns = 0;
+    tb_htim = htim;
+
+    __HAL_TIM_ENABLE_IT(htim, TIM_IT_UPDATE);
+    SET_BIT(tim->CR1, TIM_CR1_CEN);
+    return HAL_OK;
+}
+
+uint64_t Timebase_Micros64(void)
+{
+    uint32_t primask;
+    uint64_t now;
+
+    if (tb_htim == NULL)
+        return 0;
+    primask = __get_PRIMASK();
+    __disable_irq();
+    now = Timebase_Now(tb_htim->Instance);
+    __set_PRIMASK(primask);
+    PORT_CYCLES(24);
+    return now;
+}
+
+// Parte baixa: a diferença entre duas leituras vale até 71 min
+uint32_t Timebase_Micros(void)
+{
+    return (uint32_t)Timebase_Micros64();
+}
+
+// Para quem já mascarou as IRQs (trace.c): sem salvar o PRIMASK
+uint32_t Timebase_MicrosMasked(void)
+{
+    if (tb_htim == NULL)
+        return 0;
+    return (uint32_t)Timebase_Now(tb_htim->Instance);
+}
+
+// Espera ativa de pelo menos 'us' (até 1 us mais a última leitura além).
+// Curtas olham só o CNT, sem mascarar IRQs: uma ISR mais longa que a
+// meia volta que sobra não chega a enganar a diferença de 16 bits.
+// A CPU não dorme aqui; esperas de ms são do escalonador.
+void Timebase_DelayUs(uint32_t us)
+{
+    if (tb_htim == NULL || us == 0U)
+        return;
+
+    if (us < TIMEBASE_PERIOD / 2U)
+    {
+        TIM_TypeDef *tim = tb_htim->Instance;
+        uint16_t start = (uint16_t)tim->CNT;
+
+        while ((uint16_t)(tim->CNT - start) <= us)
+            PORT_CYCLES(6);
+    }
+    else
+    {
+        uint64_t start = Timebase_Micros64();
+
+        while (Timebase_Micros64() - start <= us)
+        {
+        }
+    }
+}
+
+// Perfil novo: o que foi contado até aqui vai para a base e o timer
+// recomeça no PSC novo. Nada a fazer se o clock de timer não mudou (o
+// HSIDIV reescrito com o mesmo valor, o SysTick refeito na saída do STOP).
+void Timebase_ClockChanged(void)
+{
+    uint32_t primask, psc;
+
+    if (tb_htim == NULL)
+        return;
+    psc = Clock_Prescaler(TIMEBASE_HZ);
+    if (psc == tb_htim->Instance->PSC)
+        return;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    tb_htim->Init.Prescaler = psc;
+    tb_htim->Instance->PSC = psc;
+    Timebase_Fold(tb_htim->Instance);
+    __set_PRIMASK(primask);
+}
+
+void Timebase_Suspend(void)
+{
+    uint32_t primask;
+
+    if (tb_htim == NULL)
+        return;
+    primask = __get_PRIMASK();
+    __disable_irq();
+    CLEAR_BIT(tb_htim->Instance->CR1, TIM_CR1_CEN);
+    Timebase_Fold(tb_htim->Instance);
+    __set_PRIMASK(primask);
+}
+
+// A fração de us fica para a próxima vez. A base nunca volta: o timer
+// contou até o Suspend, depois do início do intervalo.
+void Timebase_Resume(uint64_t start_us, uint32_t elapsed_ns)
+{
+    uint32_t primask;
+    uint64_t now;
+
+    if (tb_htim == NULL)
+        return;
+    frac_ns += elapsed_ns % 1000U;
+    now = start_us + elapsed_ns / 1000U + frac_ns / 1000U;
+    frac_ns %= 1000U;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (now > base_us)
+        base_us = now;
+    SET_BIT(tb_htim->Instance->CR1, TIM_CR1_CEN);
+    __set_PRIMASK(primask);
+    PORT_CYCLES(30);
+}
+
+void Timebase_IRQHandler(void)
+{
+    TIM_TypeDef *tim;
+
+    if (tb_htim == NULL)
+        return;
+    tim = tb_htim->Instance;
+    if (tim->SR & TIM_SR_UIF)
+    {
+        tim->SR = ~TIM_SR_UIF;
+        base_us += TIMEBASE_PERIOD;
+    }
+    PORT_CYCLES(20);
+}
+
+// A versão fraca da HAL mais a base de tempo. HAL_RCC_ClockConfig e
+// HAL_RCC_OscConfig (HSIDIV com o HSI16 no SYSCLK) chamam esta função
+// logo depois de trocar o SYSCLK: é o ponto mais próximo da troca.
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+    if ((uint32_t)uwTickFreq == 0U)
+        return HAL_ERROR;
+    if (HAL_SYSTICK_Config(SystemCoreClock / (1000U / (uint32_t)uwTickFreq)) != 0U)
+        return HAL_ERROR;
+    if (TickPriority >= (1UL << __NVIC_PRIO_BITS))
+        return HAL_ERROR;
+    HAL_NVIC_SetPriority(SysTick_IRQn, TickPriority, 0U);
+    uwTickPrio = TickPriority;
+
+    Timebase_ClockChanged();
+    return HAL_OK;
+}
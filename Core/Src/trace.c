@@ -0,0 +1,59 @@
+#include <string.h>
+#include "trace.h"
+#include "timebase.h"
+#include "port.h"
+
+_Static_assert((TRACE_CAPACITY & (TRACE_CAPACITY - 1U)) == 0U, "TRACE_CAPACITY tem de ser potência de 2");
+_Static_assert(sizeof(Trace_Event) == 8U, "Trace_Event fora do formato do trace_export");
+
+// Global com nome fixo: achado pelo símbolo no .map ou pela assinatura
+Trace_Buffer trace_buffer;
+
+// Anel vazio, todos os tipos gravados. Antes do Timebase_Init() os
+// instantes saem em 0.
+void Trace_Init(void)
+{
+    memset(&trace_buffer, 0, sizeof(trace_buffer));
+    trace_buffer.version = TRACE_VERSION;
+    trace_buffer.capacity = TRACE_CAPACITY;
+    trace_buffer.mask = TRACE_MASK_ALL;
+    trace_buffer.magic = TRACE_MAGIC;
+}
+
+// Tipos gravados daqui em diante (bits 1 << Trace_Type). O SysTick, a
+// 1 kHz, é o que mais enche o anel: filtrar as ISRs alonga a janela.
+void Trace_SetMask(uint32_t mask)
+{
+    trace_buffer.mask = mask & TRACE_MASK_ALL;
+}
+
+// Nome copiado para o anel: o dump não tem os ponteiros de string
+void Trace_SetTaskName(uint8_t id, const char *name)
+{
+    if (id >= SCHED_MAX_TASKS || name == NULL)
+        return;
+    strncpy(trace_buffer.names[id], name, TRACE_NAME_LEN - 1U);
+    trace_buffer.names[id][TRACE_NAME_LEN - 1U] = '\0';
+}
+
+// Pode ser chamada de qualquer ISR: a posição, o instante e o evento saem
+// juntos, com as IRQs mascaradas, e a ordem no anel é a ordem no tempo
+void Trace_Record(uint8_t type, uint8_t id, uint16_t arg)
+{
+    uint32_t primask;
+    Trace_Event *ev;
+
+    if ((trace_buffer.mask & (1UL << type)) == 0U)
+        return;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    ev = &trace_buffer.events[trace_buffer.head & (TRACE_CAPACITY - 1U)];
+    ev->time_us = Timebase_MicrosMasked();
+    ev->type = type;
+    ev->id = id;
+    ev->arg = arg;
+    trace_buffer.head++;
+    __set_PRIMASK(primask);
+    PORT_CYCLES(28);
+}
@@ -5,31 +5,76 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../Core/Src/autotune.c \
+../Core/Src/buttons.c \
+../Core/Src/clock.c \
+../Core/Src/crc32.c \
+../Core/Src/datalog.c \
 ../Core/Src/lcd.c \
 ../Core/Src/main.c \
+../Core/Src/pid.c \
+../Core/Src/power.c \
+../Core/Src/protect.c \
+../Core/Src/pwm.c \
+../Core/Src/scheduler.c \
+../Core/Src/settings.c \
 ../Core/Src/stm32g0xx_hal_msp.c \
 ../Core/Src/stm32g0xx_it.c \
 ../Core/Src/syscalls.c \
 ../Core/Src/sysmem.c \
-../Core/Src/system_stm32g0xx.c 
+../Core/Src/system_stm32g0xx.c \
+../Core/Src/telemetry.c \
+../Core/Src/temp_sensor.c \
+../Core/Src/timebase.c \
+../Core/Src/trace.c 
 
 OBJS += \
+./Core/Src/autotune.o \
+./Core/Src/buttons.o \
+./Core/Src/clock.o \
+./Core/Src/crc32.o \
+./Core/Src/datalog.o \
 ./Core/Src/lcd.o \
 ./Core/Src/main.o \
+./Core/Src/pid.o \
+./Core/Src/power.o \
+./Core/Src/protect.o \
+./Core/Src/pwm.o \
+./Core/Src/scheduler.o \
+./Core/Src/settings.o \
 ./Core/Src/stm32g0xx_hal_msp.o \
 ./Core/Src/stm32g0xx_it.o \
 ./Core/Src/syscalls.o \
 ./Core/Src/sysmem.o \
-./Core/Src/system_stm32g0xx.o 
+./Core/Src/system_stm32g0xx.o \
+./Core/Src/telemetry.o \
+./Core/Src/temp_sensor.o \
+./Core/Src/timebase.o \
+./Core/Src/trace.o 
 
 C_DEPS += \
+./Core/Src/autotune.d \
+./Core/Src/buttons.d \
+./Core/Src/clock.d \
+./Core/Src/crc32.d \
+./Core/Src/datalog.d \
 ./Core/Src/lcd.d \
 ./Core/Src/main.d \
+./Core/Src/pid.d \
+./Core/Src/power.d \
+./Core/Src/protect.d \
+./Core/Src/pwm.d \
+./Core/Src/scheduler.d \
+./Core/Src/settings.d \
 ./Core/Src/stm32g0xx_hal_msp.d \
 ./Core/Src/stm32g0xx_it.d \
 ./Core/Src/syscalls.d \
 ./Core/Src/sysmem.d \
-./Core/Src/system_stm32g0xx.d 
+./Core/Src/system_stm32g0xx.d \
+./Core/Src/telemetry.d \
+./Core/Src/temp_sensor.d \
+./Core/Src/timebase.d \
+./Core/Src/trace.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -39,7 +84,7 @@ Core/Src/%.o Core/Src/%.su Core/Src/%.cyclo: ../Core/Src/%.c Core/Src/subdir.mk
 clean: clean-Core-2f-Src
 
 clean-Core-2f-Src:
-	-$(RM) ./Core/Src/lcd.cyclo ./Core/Src/lcd.d ./Core/Src/lcd.o ./Core/Src/lcd.su ./Core/Src/main.cyclo ./Core/Src/main.d ./Core/Src/main.o ./Core/Src/main.su ./Core/Src/stm32g0xx_hal_msp.cyclo ./Core/Src/stm32g0xx_hal_msp.d ./Core/Src/stm32g0xx_hal_msp.o ./Core/Src/stm32g0xx_hal_msp.su ./Core/Src/stm32g0xx_it.cyclo ./Core/Src/stm32g0xx_it.d ./Core/Src/stm32g0xx_it.o ./Core/Src/stm32g0xx_it.su ./Core/Src/syscalls.cyclo ./Core/Src/syscalls.d ./Core/Src/syscalls.o ./Core/Src/syscalls.su ./Core/Src/sysmem.cyclo ./Core/Src/sysmem.d ./Core/Src/sysmem.o ./Core/Src/sysmem.su ./Core/Src/system_stm32g0xx.cyclo ./Core/Src/system_stm32g0xx.d ./Core/Src/system_stm32g0xx.o ./Core/Src/system_stm32g0xx.su
+	-$(RM) ./Core/Src/autotune.cyclo ./Core/Src/autotune.d ./Core/Src/autotune.o ./Core/Src/autotune.su ./Core/Src/buttons.cyclo ./Core/Src/buttons.d ./Core/Src/buttons.o ./Core/Src/buttons.su ./Core/Src/clock.cyclo ./Core/Src/clock.d ./Core/Src/clock.o ./Core/Src/clock.su ./Core/Src/crc32.cyclo ./Core/Src/crc32.d ./Core/Src/crc32.o ./Core/Src/crc32.su ./Core/Src/datalog.cyclo ./Core/Src/datalog.d ./Core/Src/datalog.o ./Core/Src/datalog.su ./Core/Src/lcd.cyclo ./Core/Src/lcd.d ./Core/Src/lcd.o ./Core/Src/lcd.su ./Core/Src/main.cyclo ./Core/Src/main.d ./Core/Src/main.o ./Core/Src/main.su ./Core/Src/pid.cyclo ./Core/Src/pid.d ./Core/Src/pid.o ./Core/Src/pid.su ./Core/Src/power.cyclo ./Core/Src/power.d ./Core/Src/power.o ./Core/Src/power.su ./Core/Src/protect.cyclo ./Core/Src/protect.d ./Core/Src/protect.o ./Core/Src/protect.su ./Core/Src/pwm.cyclo ./Core/Src/pwm.d ./Core/Src/pwm.o ./Core/Src/pwm.su ./Core/Src/scheduler.cyclo ./Core/Src/scheduler.d ./Core/Src/scheduler.o ./Core/Src/scheduler.su ./Core/Src/settings.cyclo ./Core/Src/settings.d ./Core/Src/settings.o ./Core/Src/settings.su ./Core/Src/stm32g0xx_hal_msp.cyclo ./Core/Src/stm32g0xx_hal_msp.d ./Core/Src/stm32g0xx_hal_msp.o ./Core/Src/stm32g0xx_hal_msp.su ./Core/Src/stm32g0xx_it.cyclo ./Core/Src/stm32g0xx_it.d ./Core/Src/stm32g0xx_it.o ./Core/Src/stm32g0xx_it.su ./Core/Src/syscalls.cyclo ./Core/Src/syscalls.d ./Core/Src/syscalls.o ./Core/Src/syscalls.su ./Core/Src/sysmem.cyclo ./Core/Src/sysmem.d ./Core/Src/sysmem.o ./Core/Src/sysmem.su ./Core/Src/system_stm32g0xx.cyclo ./Core/Src/system_stm32g0xx.d ./Core/Src/system_stm32g0xx.o ./Core/Src/system_stm32g0xx.su ./Core/Src/telemetry.cyclo ./Core/Src/telemetry.d ./Core/Src/telemetry.o ./Core/Src/telemetry.su ./Core/Src/temp_sensor.cyclo ./Core/Src/temp_sensor.d ./Core/Src/temp_sensor.o ./Core/Src/temp_sensor.su ./Core/Src/timebase.cyclo ./Core/Src/timebase.d ./Core/Src/timebase.o ./Core/Src/timebase.su ./Core/Src/trace.cyclo ./Core/Src/trace.d ./Core/Src/trace.o ./Core/Src/trace.su
 
 .PHONY: clean-Core-2f-Src
 
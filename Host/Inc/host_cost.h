@@ -0,0 +1,97 @@
+/**
+  ******************************************************************************
+  * @file    host_cost.h
+  * @brief   Modelo de custo em ciclos de CPU do Cortex-M0+ usado pelo
+  *          simulador de host.
+  *
+  *          Valores estimados a partir da listagem do build Debug (-O0,
+  *          Debug/Teste.list): instruções da função + chamada e retorno,
+  *          com 0 wait states de flash a 16 MHz. Não é um ISS; serve para
+  *          comparar versões do firmware entre si, não para fechar timing
+  *          absoluto.
+  ******************************************************************************
+  */
+
+#ifndef __HOST_COST_H
+#define __HOST_COST_H
+
+// --- Núcleo ---
+#define SIM_COST_IRQ_ENTRY            15   // empilhamento + vetor
+#define SIM_COST_IRQ_EXIT             13   // desempilhamento
+
+// --- HAL: sistema ---
+#define SIM_COST_HAL_GETTICK          12
+#define SIM_COST_HAL_INCTICK          20
+#define SIM_COST_HAL_DELAY_POLL       24   // uma volta do laço de HAL_Delay
+
+// --- HAL: RCC/PWR ---
+#define SIM_COST_RCC_OSC_CONFIG      350   // HAL_RCC_OscConfig sem as esperas de PLL
+#define SIM_COST_RCC_CLOCK_CONFIG    300   // HAL_RCC_ClockConfig sem o HAL_InitTick
+#define SIM_COST_PWR_CONFIG           40   // VOS / LPR: leitura-modificação-escrita
+#define SIM_RCC_PLL_LOCK_US           40   // tLOCK do PLL (datasheet: 40 us máx.)
+#define SIM_COST_RCC_READY_POLL       12   // uma volta da espera do PLLRDY (HAL_GetTick + CR)
+#define SIM_PWR_VOS_US                20   // Regulador principal até VOSF / REGLPF
+#define SIM_COST_PWR_LOW_POWER        30   // HAL_PWR_EnterSLEEPMode/STOPMode até o WFI
+#define SIM_PWR_STOP1_WAKE_US          9   // tWUSTOP1: STOP 1 -> HSI16 (datasheet)
+#define SIM_RCC_LSI_START_US         130   // tSU(LSI) máx.
+
+// --- HAL: GPIO ---
+#define SIM_COST_GPIO_WRITE           30
+#define SIM_COST_GPIO_READ            30
+#define SIM_COST_GPIO_TOGGLE          30
+#define SIM_COST_GPIO_BSRR             1   // Escrita inline: STR no IOPORT (ciclo único no M0+)
+#define SIM_COST_GPIO_INIT_PIN        60   // por pino configurado
+#define SIM_COST_GPIO_EXTI_HANDLER    25   // HAL_GPIO_EXTI_IRQHandler, por linha
+
+// --- HAL: ADC ---
+#define SIM_COST_ADC_INIT            400
+#define SIM_COST_ADC_CONFIG_CHANNEL  250
+#define SIM_COST_ADC_START           120
+#define SIM_COST_ADC_POLL_ENTRY       60
+#define SIM_COST_ADC_GETVALUE         10
+#define SIM_COST_ADC_IRQ_HANDLER      70   // HAL_ADC_IRQHandler: testes de flags
+#define SIM_ADC_CONV_ADC_CYCLES       14   // 1.5 amostragem + 12.5 SAR
+#define SIM_COST_ADC_CALIBRATION     300   // HAL_ADCEx_Calibration_Start sem as esperas
+#define SIM_ADC_CAL_ADC_CYCLES        82   // Um ciclo de calibração (ADCAL)
+#define SIM_ADC_CALFACT             0x44   // Fator que a calibração encontra
+#define SIM_ADC_UNCAL_OFFSET_LSB       4   // Erro de offset sem calibração
+
+// --- HAL: TIM ---
+#define SIM_COST_TIM_INIT            300
+#define SIM_COST_TIM_CONFIG_CHANNEL  200
+#define SIM_COST_TIM_START           100
+#define SIM_COST_TIM_MASTER_CONFIG   120
+#define SIM_COST_TIM_IRQ_HANDLER      60   // HAL_TIM_IRQHandler: testes de flags
+
+// --- HAL: DMA ---
+#define SIM_COST_DMA_INIT            250
+#define SIM_COST_DMA_START           150   // HAL_ADC_Start_DMA + HAL_DMA_Start_IT
+#define SIM_COST_DMA_IRQ              40   // teste/limpeza de flags no HAL_DMA_IRQHandler
+
+// --- HAL: FLASH ---
+#define SIM_COST_FLASH_LOCK           20   // HAL_FLASH_Unlock/Lock: chaves em KEYR, LOCK em CR
+#define SIM_COST_FLASH_PROGRAM        60   // HAL_FLASH_Program sem a espera de BSY1
+#define SIM_COST_FLASH_ERASE          80   // HAL_FLASHEx_Erase sem a espera de BSY1
+#define SIM_FLASH_PROG_US             85   // tprog de uma palavra dupla (datasheet: 85 us)
+#define SIM_FLASH_ERASE_US         22000   // tERASE de uma página (datasheet: 22 ms)
+
+// --- libgcc soft-float (só para comparação com o caminho de ponto fixo) ---
+// Caminho típico de cada rotina em Debug/Teste.list; __aeabi_ddiv e
+// __aeabi_dmul têm 772 e 699 instruções, quase todas fora do caminho comum
+#define SIM_COST_SF_UI2D              45   // __aeabi_ui2d
+#define SIM_COST_SF_DMUL             220   // __aeabi_dmul
+#define SIM_COST_SF_DDIV             620   // __aeabi_ddiv: divisão por laço de bits
+#define SIM_COST_SF_D2F               70   // __aeabi_d2f
+#define SIM_COST_SF_F2D               50   // __aeabi_f2d
+#define SIM_COST_SF_DCMPGE            75   // __aeabi_dcmpge + __gedf2
+
+// --- newlib-nano snprintf (só para comparação com o formatador do LCD) ---
+// Caminho de "%d" em _svfprintf_r/_printf_i de Debug/Teste.list; cada
+// dígito sai de uma divisão por 10 em __aeabi_uidivmod
+#define SIM_COST_SNPRINTF_CALL       150   // snprintf + entrada do _svfprintf_r
+#define SIM_COST_SNPRINTF_CHAR        12   // varredura do formato, por literal
+#define SIM_COST_SNPRINTF_PUTS        40   // __ssputs_r, por trecho copiado
+#define SIM_COST_SNPRINTF_INT        150   // _printf_i + _printf_common, por %d
+#define SIM_COST_UIDIVMOD             45   // __aeabi_uidivmod / __aeabi_idivmod
+
+#endif /* __HOST_COST_H */
@@ -0,0 +1,182 @@
+/**
+  ******************************************************************************
+  * @file    host_port.h
+  * @brief   Camada de portabilidade do build de host (Linux).
+  *
+  *          Este arquivo é pré-incluído (-include) em todas as unidades de
+  *          compilação do build de host. Ele puxa o header CMSIS real do
+  *          STM32G070 e redireciona as instâncias de periférico (GPIOA, TIM1,
+  *          ADC1, SysTick, ...) para blocos de registradores em RAM, mantidos
+  *          pelo simulador em host_periph.c. Assim main.c e lcd.c compilam
+  *          sem alterações contra os mesmos tipos e macros da HAL.
+  *
+  *          Atenção: funções inline do CMSIS/LL que acessam uma instância
+  *          fixa (SysTick_Config, NVIC_EnableIRQ, LL_RCC_*, ...) são
+  *          expandidas antes do redirecionamento e continuam apontando para
+  *          o endereço real. O firmware deve usar a HAL ou as macros __HAL_*.
+  ******************************************************************************
+  */
+
+#ifndef __HOST_PORT_H
+#define __HOST_PORT_H
+
+/* As intrínsecas CMSIS de máscara de interrupção são funções inline com
+ * assembly Thumb. Elas são renomeadas durante a inclusão do header real e
+ * trocadas abaixo pelas versões do simulador. */
+#define __enable_irq   __cmsis_enable_irq
+#define __disable_irq  __cmsis_disable_irq
+#define __get_PRIMASK  __cmsis_get_PRIMASK
+#define __set_PRIMASK  __cmsis_set_PRIMASK
+#define __ISB          __cmsis_ISB
+#define __DSB          __cmsis_DSB
+#define __DMB          __cmsis_DMB
+
+#include "stm32g0xx.h"
+
+#undef __enable_irq
+#undef __disable_irq
+#undef __get_PRIMASK
+#undef __set_PRIMASK
+#undef __ISB
+#undef __DSB
+#undef __DMB
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// --- Núcleo Cortex-M0+ ---
+void     Sim_EnableIrq(void);
+void     Sim_DisableIrq(void);
+uint32_t Sim_GetPrimask(void);
+void     Sim_SetPrimask(uint32_t primask);
+void     Sim_WaitForInterrupt(void);
+
+#define __enable_irq()      Sim_EnableIrq()
+#define __disable_irq()     Sim_DisableIrq()
+#define __get_PRIMASK()     Sim_GetPrimask()
+#define __set_PRIMASK(x)    Sim_SetPrimask(x)
+#define __ISB()             __sync_synchronize()
+#define __DSB()             __sync_synchronize()
+#define __DMB()             __sync_synchronize()
+
+#undef __NOP
+#undef __WFI
+#undef __WFE
+#undef __SEV
+#define __NOP()             ((void)0)
+#define __WFI()             Sim_WaitForInterrupt()
+#define __WFE()             Sim_WaitForInterrupt()
+#define __SEV()             ((void)0)
+
+// --- Blocos de registradores simulados ---
+extern GPIO_TypeDef        Sim_GPIOA;
+extern GPIO_TypeDef        Sim_GPIOB;
+extern GPIO_TypeDef        Sim_GPIOC;
+extern GPIO_TypeDef        Sim_GPIOD;
+extern GPIO_TypeDef        Sim_GPIOF;
+extern TIM_TypeDef         Sim_TIM1;
+extern TIM_TypeDef         Sim_TIM3;
+extern TIM_TypeDef         Sim_TIM6;
+extern TIM_TypeDef         Sim_TIM7;
+extern TIM_TypeDef         Sim_TIM14;
+extern TIM_TypeDef         Sim_TIM15;
+extern TIM_TypeDef         Sim_TIM16;
+extern TIM_TypeDef         Sim_TIM17;
+extern ADC_TypeDef         Sim_ADC1;
+extern ADC_Common_TypeDef  Sim_ADC1_COMMON;
+extern RCC_TypeDef         Sim_RCC;
+extern PWR_TypeDef         Sim_PWR;
+extern FLASH_TypeDef       Sim_FLASH;
+extern EXTI_TypeDef        Sim_EXTI;
+extern RTC_TypeDef         Sim_RTC;
+extern SYSCFG_TypeDef      Sim_SYSCFG;
+extern DMA_TypeDef         Sim_DMA1;
+extern DMA_Channel_TypeDef Sim_DMA1_Channel[7];
+extern USART_TypeDef       Sim_USART2;
+extern DBG_TypeDef         Sim_DBG;
+extern SysTick_Type        Sim_SysTick;
+extern NVIC_Type           Sim_NVIC;
+extern SCB_Type            Sim_SCB;
+
+// --- Redirecionamento das instâncias ---
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef GPIOD
+#undef GPIOF
+#define GPIOA               (&Sim_GPIOA)
+#define GPIOB               (&Sim_GPIOB)
+#define GPIOC               (&Sim_GPIOC)
+#define GPIOD               (&Sim_GPIOD)
+#define GPIOF               (&Sim_GPIOF)
+
+#undef TIM1
+#undef TIM3
+#undef TIM6
+#undef TIM7
+#undef TIM14
+#undef TIM15
+#undef TIM16
+#undef TIM17
+#define TIM1                (&Sim_TIM1)
+#define TIM3                (&Sim_TIM3)
+#define TIM6                (&Sim_TIM6)
+#define TIM7                (&Sim_TIM7)
+#define TIM14               (&Sim_TIM14)
+#define TIM15               (&Sim_TIM15)
+#define TIM16               (&Sim_TIM16)
+#define TIM17               (&Sim_TIM17)
+
+#undef ADC1
+#undef ADC1_COMMON
+#define ADC1                (&Sim_ADC1)
+#define ADC1_COMMON         (&Sim_ADC1_COMMON)
+
+#undef RCC
+#undef PWR
+#undef FLASH
+#undef EXTI
+#undef RTC
+#undef SYSCFG
+#undef DBG
+#define RCC                 (&Sim_RCC)
+#define PWR                 (&Sim_PWR)
+#define FLASH               (&Sim_FLASH)
+#define EXTI                (&Sim_EXTI)
+#define RTC                 (&Sim_RTC)
+#define SYSCFG              (&Sim_SYSCFG)
+#define DBG                 (&Sim_DBG)
+
+#undef DMA1
+#undef DMA1_Channel1
+#undef DMA1_Channel2
+#undef DMA1_Channel3
+#undef DMA1_Channel4
+#undef DMA1_Channel5
+#undef DMA1_Channel6
+#undef DMA1_Channel7
+#define DMA1                (&Sim_DMA1)
+#define DMA1_Channel1       (&Sim_DMA1_Channel[0])
+#define DMA1_Channel2       (&Sim_DMA1_Channel[1])
+#define DMA1_Channel3       (&Sim_DMA1_Channel[2])
+#define DMA1_Channel4       (&Sim_DMA1_Channel[3])
+#define DMA1_Channel5       (&Sim_DMA1_Channel[4])
+#define DMA1_Channel6       (&Sim_DMA1_Channel[5])
+#define DMA1_Channel7       (&Sim_DMA1_Channel[6])
+
+#undef USART2
+#define USART2              (&Sim_USART2)
+
+#undef SysTick
+#undef NVIC
+#undef SCB
+#define SysTick             (&Sim_SysTick)
+#define NVIC                (&Sim_NVIC)
+#define SCB                 (&Sim_SCB)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_PORT_H */
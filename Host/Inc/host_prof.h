@@ -0,0 +1,30 @@
+/**
+  ******************************************************************************
+  * @file    host_prof.h
+  * @brief   Perfilador do simulador de host: latência por iteração do laço
+  *          principal (PROF_LOOP) e ciclos atribuídos a cada tarefa
+  *          (PROF_BEGIN/PROF_END, ver Core/Inc/profile.h).
+  ******************************************************************************
+  */
+
+#ifndef __HOST_PROF_H
+#define __HOST_PROF_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "profile.h"
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t max;
+    uint64_t total;
+} Prof_Summary;
+
+void Prof_Reset(void);
+void Prof_LoopSummary(Prof_Summary *summary);
+void Prof_Report(FILE *out);
+
+#endif /* __HOST_PROF_H */
@@ -0,0 +1,141 @@
+/**
+  ******************************************************************************
+  * @file    host_sim.h
+  * @brief   Simulador de host: relógio virtual, eventos, interrupções e
+  *          estímulos externos (botões, entrada analógica).
+  *
+  *          O tempo só avança quando o firmware "gasta" ciclos: cada função
+  *          da HAL simulada cobra o custo modelado em host_cost.h, e as
+  *          esperas (HAL_Delay, PollForConversion, __WFI) saltam direto para
+  *          o próximo evento agendado. SysTick, ADC e timers são eventos.
+  *          Em STOP o relógio avança só pelos eventos (RTC, estímulos),
+  *          sem contar ciclos de CPU, até uma interrupção habilitada.
+  *
+  *          O relógio conta ticks fixos de SIM_CLOCK_HZ (um ciclo de CPU no
+  *          perfil pleno), para o tempo não mudar de escala quando o
+  *          firmware troca o SYSCLK: um ciclo de CPU vale
+  *          SIM_CLOCK_HZ / SystemCoreClock ticks. Sim_CyclesFromUs/Ms
+  *          devolvem ticks; Sim_Cycles() conta ciclos de CPU de verdade.
+  ******************************************************************************
+  */
+
+#ifndef __HOST_SIM_H
+#define __HOST_SIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "stm32g0xx_hal.h"
+#include "host_cost.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*Sim_EventFn)(void *arg);
+typedef uint16_t (*Sim_AnalogFn)(uint64_t now, void *ctx);
+
+#define SIM_CLOCK_HZ  64000000U
+
+// --- Relógio virtual ---
+uint64_t Sim_Now(void);
+uint64_t Sim_Micros(void);
+uint64_t Sim_CyclesFromUs(uint64_t us);
+uint64_t Sim_CyclesFromMs(uint64_t ms);
+uint64_t Sim_TicksFromHz(uint64_t count, uint32_t hz);
+uint64_t Sim_Cycles(void);
+void     Sim_Consume(uint32_t cycles);
+void     Sim_SpinUntil(uint64_t when);
+void     Sim_SpinToNextEvent(void);
+
+// --- Eventos agendados ---
+void     Sim_Schedule(uint64_t when, Sim_EventFn fn, void *arg);
+void     Sim_Cancel(Sim_EventFn fn, void *arg);
+
+// --- Interrupções ---
+void     Sim_RaiseIRQ(IRQn_Type irq);
+uint64_t Sim_IsrCycles(void);             // Em ticks
+uint8_t  Sim_InIsr(void);                 // Evento disparado dentro de um handler
+
+// --- STOP (HAL_PWR_EnterSTOPMode) ---
+int      Sim_EnterStop(uint64_t wake_ticks);
+void     Sim_ExitStop(void);
+uint64_t Sim_StopTicks(void);             // Tempo total em STOP, em ticks
+
+// --- Execução ---
+void     Sim_Reset(void);
+void     Sim_Run(void (*entry)(void), uint64_t duration);
+
+// --- Estímulos externos ---
+void     Sim_SetPinLevel(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState level);
+void     Sim_SetGpioWatch(void (*fn)(GPIO_TypeDef *port, uint32_t old_odr, void *ctx), void *ctx); // ODR mudou
+uint32_t Sim_GpioWrites(void);            // Escritas em registradores de saída (HAL ou BSRR/BRR)
+void     Sim_SetAnalogSource(uint32_t channel, Sim_AnalogFn fn, void *ctx);
+void     Sim_SetAnalogMillivolts(uint32_t channel, uint32_t millivolts);
+uint16_t Sim_SampleAnalog(uint32_t channel);
+void     Sim_SystemBreak(TIM_TypeDef *tim);   // Lockup/paridade/ECC no break do timer
+void     Sim_HoldSystemBreak(TIM_TypeDef *tim, uint8_t held); // Fonte que continua ativa até 'held' = 0
+void     Sim_SetPllLock(uint8_t locks);   // 0: o PLL nunca trava (timeout da HAL)
+
+// --- Flash (conteúdo preservado entre Sim_Reset) ---
+uint64_t Sim_FlashRead64(uint32_t addr);
+void     Sim_FlashPowerCut(uint32_t ops, uint32_t seed, void (*handler)(void)); // Corte na n-ésima operação
+void     Sim_FlashEraseAll(void);
+uint32_t Sim_FlashPageErases(uint32_t page);
+void     Sim_FlashDump(uint32_t addr, void *buf, uint32_t len);
+
+// --- Linha de TX da USART2 (preservada entre Sim_Reset) ---
+void     SimUsart_SetSink(void (*fn)(uint8_t byte, void *ctx), void *ctx); // Cada byte que sai
+int      SimUsart_OpenPty(char *name, size_t len); // Bytes também no PTY: fd do mestre, ou -1
+void     SimUsart_ClosePty(void);
+uint64_t SimUsart_TxBytes(void);
+
+// --- HD44780 nos pinos do LCD (main.h) ---
+typedef struct
+{
+    uint32_t instructions;  // Comandos e dados aceitos
+    uint32_t chars;         // ... dos quais dados
+    uint32_t busy_writes;   // Escritas com o controlador ocupado (perdidas)
+    uint32_t timing_errors; // EN, setup ou disputa do barramento fora do datasheet
+    uint32_t reads;         // Leituras do busy flag
+    uint32_t busy_reads;    // ... com BF = 1
+    uint32_t min_as_ns;     // Menor setup de RS/RW antes do EN subir (tAS)
+} SimLcd_Stats;
+
+void     SimLcd_Attach(uint32_t fosc_hz, GPIO_TypeDef *rw_port, uint16_t rw_pin); // rw_port NULL: R/W aterrado
+const SimLcd_Stats *SimLcd_GetStats(void);
+void     SimLcd_Row(uint8_t row, char out[17]);
+
+// --- Modelos de periférico (uso interno do simulador) ---
+void     SimSysTick_Arm(void);
+void     SimRcc_Reset(void);
+uint32_t Sim_TimerClockHz(void);
+uint32_t Sim_AdcKernelHz(void);
+void     SimGpio_Reset(void);
+void     Sim_GpioSync(GPIO_TypeDef *port);
+void     SimAdc_Reset(void);
+void     SimTim_Reset(void);
+void     SimTim_Sync(void);
+const char *SimTim_StopBlocker(void);
+int      SimAdc_Converting(void);
+void     SimRtc_Reset(void);
+void     SimRtc_Sync(void);
+void     SimDma_Reset(void);
+void     SimUsart_Reset(void);
+void     SimUsart_Sync(void);
+int      SimUsart_Busy(void);
+void     SimFlash_Reset(void);
+
+// DMA1: endereços do host ficam no simulador (CPAR/CMAR têm só 32 bits)
+HAL_StatusTypeDef SimDma_Start(DMA_HandleTypeDef *hdma, volatile void *periph, void *mem, uint32_t length);
+void     SimDma_Stop(DMA_HandleTypeDef *hdma);
+int      SimDma_Request(uint32_t request);
+int      SimDma_Ready(uint32_t request);
+
+// Evento de TRGO de um timer para os periféricos que o usam como gatilho
+void     SimAdc_ExternalTrigger(TIM_TypeDef *tim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_SIM_H */
@@ -0,0 +1,266 @@
+/**
+  ******************************************************************************
+  * @file    host_flash.c
+  * @brief   Flash simulada: os 128 KB do G070RB em palavras duplas, com a
+  *          HAL de gravação (HAL_FLASH_Program em palavra dupla) e de
+  *          apagamento de página (HAL_FLASHEx_Erase).
+  *
+  *          O conteúdo começa apagado e sobrevive a Sim_Reset(), como uma
+  *          flash de verdade; só os registradores voltam ao reset. Gravar
+  *          confere LOCK, alinhamento e palavra ainda apagada (PROGERR);
+  *          gravar e apagar param a CPU pelo tempo do datasheet com as
+  *          interrupções presas, porque o código roda da mesma flash.
+  *
+  *          Sim_FlashPowerCut() corta a energia no meio da n-ésima
+  *          operação: uma gravação deixa só parte dos bits descidos e a
+  *          palavra sem ECC coerente; um apagamento deixa cada palavra da
+  *          página apagada, intacta ou com lixo. Ler uma palavra assim por
+  *          Sim_FlashRead64() marca ECCD em FLASH->ECCR, leva ao break do
+  *          TIM1 se o ECCL estiver ligado e chama o NMI_Handler.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stm32g0xx_hal.h"
+#include "stm32g0xx_it.h"
+#include "host_sim.h"
+
+#define SIM_FLASH_SIZE    (128U * 1024U)
+#define SIM_FLASH_DWORDS  (SIM_FLASH_SIZE / 8U)
+#define SIM_FLASH_PAGES   (SIM_FLASH_SIZE / FLASH_PAGE_SIZE)
+#define SIM_FLASH_BLANK   0xFFFFFFFFFFFFFFFFULL
+
+FLASH_ProcessTypeDef pFlash;
+
+static uint64_t mem[SIM_FLASH_DWORDS];
+static uint8_t  torn[SIM_FLASH_DWORDS];   // ECC incoerente: gravação ou apagamento interrompido
+static uint32_t page_erases[SIM_FLASH_PAGES];
+static uint8_t  formatted;
+static uint32_t cut_ops;                  // Operações até o corte (0: sem corte)
+static uint32_t cut_rng;
+static void   (*cut_handler)(void);
+
+static void SimFlash_Format(void)
+{
+    if (!formatted)
+    {
+        memset(mem, 0xFF, sizeof(mem));
+        memset(torn, 0, sizeof(torn));
+        memset(page_erases, 0, sizeof(page_erases));
+        formatted = 1;
+    }
+}
+
+static uint32_t SimFlash_Random(void)
+{
+    cut_rng ^= cut_rng << 13;
+    cut_rng ^= cut_rng >> 17;
+    cut_rng ^= cut_rng << 5;
+    return cut_rng;
+}
+
+static uint64_t SimFlash_Random64(void)
+{
+    return ((uint64_t)SimFlash_Random() << 32) | SimFlash_Random();
+}
+
+static uint32_t SimFlash_Index(uint32_t addr)
+{
+    if (addr < FLASH_BASE || addr >= FLASH_BASE + SIM_FLASH_SIZE)
+    {
+        fprintf(stderr, "sim: acesso fora da flash em 0x%08lx\n", (unsigned long)addr);
+        abort();
+    }
+    SimFlash_Format();
+    return (addr - FLASH_BASE) / 8U;
+}
+
+// Conta a operação; 1 se a energia cai no meio dela
+static int SimFlash_Cut(void)
+{
+    return cut_ops != 0U && --cut_ops == 0U;
+}
+
+static void SimFlash_PowerLost(void)
+{
+    void (*handler)(void) = cut_handler;
+
+    cut_handler = NULL;
+    if (handler != NULL)
+        handler();
+    fprintf(stderr, "sim: corte de energia sem tratador\n");
+    abort();
+}
+
+// CPU parada durante a operação: nem interrupções são atendidas
+static void SimFlash_Stall(uint32_t us)
+{
+    uint32_t primask = Sim_GetPrimask();
+
+    Sim_DisableIrq();
+    Sim_SpinUntil(Sim_Now() + Sim_CyclesFromUs(us));
+    Sim_SetPrimask(primask);
+}
+
+void SimFlash_Reset(void)
+{
+    SimFlash_Format();
+    FLASH->CR = FLASH_CR_LOCK;
+    FLASH->SR = 0;
+    FLASH->ECCR = 0;
+    pFlash.ErrorCode = HAL_FLASH_ERROR_NONE;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    FLASH->CR &= ~FLASH_CR_LOCK;
+    Sim_Consume(SIM_COST_FLASH_LOCK);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    FLASH->CR |= FLASH_CR_LOCK;
+    Sim_Consume(SIM_COST_FLASH_LOCK);
+    return HAL_OK;
+}
+
+uint32_t HAL_FLASH_GetError(void)
+{
+    return pFlash.ErrorCode;
+}
+
+static HAL_StatusTypeDef SimFlash_Error(uint32_t flag)
+{
+    FLASH->SR |= flag;
+    pFlash.ErrorCode |= flag;
+    return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    uint32_t idx;
+
+    Sim_Consume(SIM_COST_FLASH_PROGRAM);
+    pFlash.ErrorCode = HAL_FLASH_ERROR_NONE;
+    FLASH->SR &= ~(FLASH_SR_PROGERR | FLASH_SR_WRPERR | FLASH_SR_PGAERR);
+    if (FLASH->CR & FLASH_CR_LOCK)
+        return SimFlash_Error(FLASH_SR_WRPERR);
+    if (TypeProgram != FLASH_TYPEPROGRAM_DOUBLEWORD || (Address & 7U) != 0U)
+        return SimFlash_Error(FLASH_SR_PGAERR);
+    idx = SimFlash_Index(Address);
+    // Só palavra apagada (ou escrita de zeros, que o RM0444 aceita)
+    if ((mem[idx] != SIM_FLASH_BLANK || torn[idx]) && Data != 0U)
+        return SimFlash_Error(FLASH_SR_PROGERR);
+
+    if (SimFlash_Cut())
+    {
+        // Parte dos bits já desceu; o ECC não foi gravado
+        if (SimFlash_Random() % 4U != 0U)
+        {
+            mem[idx] &= Data | SimFlash_Random64();
+            torn[idx] = 1;
+        }
+        SimFlash_PowerLost();
+    }
+    SimFlash_Stall(SIM_FLASH_PROG_US);
+    mem[idx] &= Data;
+    torn[idx] = 0;
+    FLASH->SR |= FLASH_SR_EOP;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+    Sim_Consume(SIM_COST_FLASH_ERASE);
+    *PageError = 0xFFFFFFFFU;
+    pFlash.ErrorCode = HAL_FLASH_ERROR_NONE;
+    if (FLASH->CR & FLASH_CR_LOCK)
+        return SimFlash_Error(FLASH_SR_WRPERR);
+    if (pEraseInit->TypeErase != FLASH_TYPEERASE_PAGES
+        || pEraseInit->Page + pEraseInit->NbPages > SIM_FLASH_PAGES)
+        return SimFlash_Error(FLASH_SR_PGAERR);
+
+    for (uint32_t page = pEraseInit->Page; page < pEraseInit->Page + pEraseInit->NbPages; page++)
+    {
+        uint32_t first = SimFlash_Index(FLASH_BASE + page * FLASH_PAGE_SIZE);
+
+        if (SimFlash_Cut())
+        {
+            for (uint32_t i = first; i < first + FLASH_PAGE_SIZE / 8U; i++)
+            {
+                switch (SimFlash_Random() % 3U)
+                {
+                case 0:
+                    mem[i] = SIM_FLASH_BLANK;
+                    torn[i] = 0;
+                    break;
+                case 1:
+                    break;
+                default:
+                    mem[i] |= SimFlash_Random64();
+                    torn[i] = 1;
+                    break;
+                }
+            }
+            *PageError = page;
+            SimFlash_PowerLost();
+        }
+        SimFlash_Stall(SIM_FLASH_ERASE_US);
+        for (uint32_t i = first; i < first + FLASH_PAGE_SIZE / 8U; i++)
+        {
+            mem[i] = SIM_FLASH_BLANK;
+            torn[i] = 0;
+        }
+        page_erases[page]++;
+    }
+    FLASH->SR |= FLASH_SR_EOP;
+    return HAL_OK;
+}
+
+// Leitura do firmware (PORT_FLASH_READ64): uma palavra sem ECC coerente
+// gera o erro duplo, como no alvo
+uint64_t Sim_FlashRead64(uint32_t addr)
+{
+    uint32_t idx = SimFlash_Index(addr & ~7U);
+
+    if (torn[idx])
+    {
+        FLASH->ECCR = (FLASH->ECCR & FLASH_ECCR_ECCCIE) | FLASH_ECCR_ECCD | (idx & FLASH_ECCR_ADDR_ECC);
+        if (SYSCFG->CFGR2 & SYSCFG_CFGR2_ECCL)
+            Sim_SystemBreak(TIM1);
+        NMI_Handler();
+    }
+    return mem[idx];
+}
+
+void Sim_FlashPowerCut(uint32_t ops, uint32_t seed, void (*handler)(void))
+{
+    cut_ops = ops;
+    cut_rng = seed ? seed : 1U;
+    cut_handler = handler;
+}
+
+void Sim_FlashEraseAll(void)
+{
+    formatted = 0;
+    SimFlash_Format();
+}
+
+uint32_t Sim_FlashPageErases(uint32_t page)
+{
+    return (page < SIM_FLASH_PAGES) ? page_erases[page] : 0U;
+}
+
+// Cópia crua (sem ECC), como a leitura da flash por um gravador
+void Sim_FlashDump(uint32_t addr, void *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        uint32_t idx = SimFlash_Index(addr + i);
+
+        ((uint8_t *)buf)[i] = (uint8_t)(mem[idx] >> (8U * ((addr + i) & 7U)));
+    }
+}
@@ -0,0 +1,141 @@
+/**
+  ******************************************************************************
+  * @file    host_hal.c
+  * @brief   HAL simulada: inicialização, base de tempo (SysTick) e NVIC.
+  ******************************************************************************
+  */
+
+#include "stm32g0xx_hal.h"
+#include "host_sim.h"
+
+__IO uint32_t uwTick;
+uint32_t uwTickPrio = (1UL << __NVIC_PRIO_BITS);
+HAL_TickFreqTypeDef uwTickFreq = HAL_TICK_FREQ_DEFAULT;
+
+__weak void HAL_MspInit(void)
+{
+}
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+    uwTick = 0;
+    uwTickFreq = HAL_TICK_FREQ_DEFAULT;
+    if (HAL_InitTick(TICK_INT_PRIORITY) != HAL_OK)
+        return HAL_ERROR;
+    HAL_MspInit();
+    return HAL_OK;
+}
+
+// Fraca como na HAL: o firmware a sobrescreve (timebase.c)
+__weak HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+    if ((uint32_t)uwTickFreq == 0U)
+        return HAL_ERROR;
+    if (HAL_SYSTICK_Config(SystemCoreClock / (1000U / (uint32_t)uwTickFreq)) != 0U)
+        return HAL_ERROR;
+    uwTickPrio = TickPriority;
+    return HAL_OK;
+}
+
+void HAL_IncTick(void)
+{
+    uwTick += (uint32_t)uwTickFreq;
+    Sim_Consume(SIM_COST_HAL_INCTICK);
+}
+
+uint32_t HAL_GetTick(void)
+{
+    Sim_Consume(SIM_COST_HAL_GETTICK);
+    return uwTick;
+}
+
+uint32_t HAL_GetTickPrio(void)
+{
+    return uwTickPrio;
+}
+
+HAL_TickFreqTypeDef HAL_GetTickFreq(void)
+{
+    return uwTickFreq;
+}
+
+HAL_StatusTypeDef HAL_SetTickFreq(HAL_TickFreqTypeDef Freq)
+{
+    HAL_TickFreqTypeDef prev = uwTickFreq;
+
+    uwTickFreq = Freq;
+    if (HAL_InitTick(uwTickPrio) != HAL_OK)
+    {
+        uwTickFreq = prev;
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+void HAL_SuspendTick(void)
+{
+    SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
+}
+
+void HAL_ResumeTick(void)
+{
+    SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t tickstart = HAL_GetTick();
+    uint32_t wait = Delay;
+
+    // Mesma semântica da HAL: garante no mínimo 'Delay' ms completos
+    if (wait < HAL_MAX_DELAY)
+        wait += (uint32_t)uwTickFreq;
+
+    while ((HAL_GetTick() - tickstart) < wait)
+    {
+        // Nada acontece entre dois ticks: salta direto para o próximo evento
+        Sim_SpinToNextEvent();
+    }
+}
+
+void HAL_SYSCFG_StrobeDBattpinsConfig(uint32_t ConfigDeadBattery)
+{
+    SYSCFG->CFGR1 |= ConfigDeadBattery;
+}
+
+// --- NVIC ---
+// ISER/ICER são registradores "escreve 1 para setar/limpar"; em RAM o
+// estado de habilitação fica acumulado direto em ISER[0].
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    // O simulador não modela preempção entre prioridades
+    (void)IRQn;
+    (void)PreemptPriority;
+    (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+        NVIC->ISER[0U] |= 1UL << ((uint32_t)IRQn & 0x1FUL);
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+        NVIC->ISER[0U] &= ~(1UL << ((uint32_t)IRQn & 0x1FUL));
+}
+
+// Equivalente a SysTick_Config() do CMSIS, que não pode ser usada no host:
+// as funções inline do CMSIS já foram compiladas com o endereço real do SysTick.
+uint32_t HAL_SYSTICK_Config(uint32_t TicksNumb)
+{
+    if ((TicksNumb - 1UL) > SysTick_LOAD_RELOAD_Msk)
+        return 1UL;
+    SysTick->LOAD = TicksNumb - 1UL;
+    SysTick->VAL = 0UL;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    SimSysTick_Arm();
+    return 0UL;
+}
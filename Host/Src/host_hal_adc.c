@@ -0,0 +1,487 @@
+/**
+  ******************************************************************************
+  * @file    host_hal_adc.c
+  * @brief   HAL ADC simulada: conversão com duração modelada (amostragem +
+  *          12.5 ciclos de ADC) e valor vindo da fonte analógica do cenário.
+  *          Com gatilho externo, cada TRGO do timer selecionado em EXTSEL
+  *          dispara uma conversão; com DMAEN, o resultado vai para o DMA.
+  *
+  *          Cada conversão leva ruído triangular de +-1 LSB e, sem
+  *          calibração (CALFACT = 0), um erro de offset fixo. Com o
+  *          oversampler (CFGR2.OVSE), um gatilho roda a rajada inteira de
+  *          conversões e o resultado é a soma deslocada e arredondada.
+  *          O watchdog analógico 1 compara cada resultado (com oversampler,
+  *          os bits [15:4]) com a janela de AWD1TR.
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "stm32g0xx_hal.h"
+#include "host_sim.h"
+
+#define SIM_ADC_CHANNELS   19
+#define SIM_ADC_VDDA_MV    3300U
+#define SIM_ADC_MAX_CODE   4095U
+
+typedef struct
+{
+    Sim_AnalogFn fn;
+    void *ctx;
+    uint32_t millivolts;
+} SimAdc_Input;
+
+static SimAdc_Input inputs[SIM_ADC_CHANNELS];
+static ADC_HandleTypeDef *active_hadc;
+static uint8_t converting;
+static uint32_t noise_state;
+
+// Duração de amostragem em meio-ciclos de ADC (1.5, 3.5, ... 160.5)
+static const uint16_t sampling_half_cycles[8] = { 3, 7, 15, 25, 39, 79, 159, 321 };
+
+static void SimAdc_ConversionDone(void *arg);
+static uint32_t SimAdc_SelectedChannel(const ADC_HandleTypeDef *hadc);
+
+void SimAdc_Reset(void)
+{
+    memset(&Sim_ADC1, 0, sizeof(Sim_ADC1));
+    memset(&Sim_ADC1_COMMON, 0, sizeof(Sim_ADC1_COMMON));
+    memset(inputs, 0, sizeof(inputs));
+    active_hadc = NULL;
+    converting = 0;
+    noise_state = 1U;
+}
+
+// Conversão em andamento: o ADC não pode ficar sem clock (STOP)
+int SimAdc_Converting(void)
+{
+    return converting;
+}
+
+// --- Entrada analógica ---
+
+void Sim_SetAnalogSource(uint32_t channel, Sim_AnalogFn fn, void *ctx)
+{
+    uint32_t idx = __LL_ADC_CHANNEL_TO_DECIMAL_NB(channel);
+
+    if (idx < SIM_ADC_CHANNELS)
+    {
+        inputs[idx].fn = fn;
+        inputs[idx].ctx = ctx;
+    }
+}
+
+void Sim_SetAnalogMillivolts(uint32_t channel, uint32_t millivolts)
+{
+    uint32_t idx = __LL_ADC_CHANNEL_TO_DECIMAL_NB(channel);
+
+    if (idx < SIM_ADC_CHANNELS)
+    {
+        inputs[idx].fn = NULL;
+        inputs[idx].millivolts = millivolts;
+    }
+}
+
+uint16_t Sim_SampleAnalog(uint32_t channel)
+{
+    uint32_t idx = __LL_ADC_CHANNEL_TO_DECIMAL_NB(channel);
+    uint32_t code;
+
+    if (idx >= SIM_ADC_CHANNELS)
+        return 0;
+    if (inputs[idx].fn != NULL)
+        return inputs[idx].fn(Sim_Now(), inputs[idx].ctx);
+
+    code = (inputs[idx].millivolts * 4095U + SIM_ADC_VDDA_MV / 2U) / SIM_ADC_VDDA_MV;
+    return (uint16_t)((code > 4095U) ? 4095U : code);
+}
+
+// --- Conversão ---
+
+// Ruído triangular em 1/256 de LSB, entre -1 e +1 LSB (LCG determinístico)
+static int32_t SimAdc_Noise(void)
+{
+    int32_t a, b;
+
+    noise_state = noise_state * 1664525U + 1013904223U;
+    a = (int32_t)(noise_state >> 24);
+    noise_state = noise_state * 1664525U + 1013904223U;
+    b = (int32_t)(noise_state >> 24);
+    return a + b - 255;
+}
+
+// Uma conversão de 12 bits: entrada com resolução abaixo de 1 LSB, offset
+// de quem não calibrou e ruído, arredondada e saturada
+static uint32_t SimAdc_ConvertOnce(const ADC_HandleTypeDef *hadc, uint32_t channel)
+{
+    uint32_t idx = __LL_ADC_CHANNEL_TO_DECIMAL_NB(channel);
+    int32_t q8;
+
+    if (idx >= SIM_ADC_CHANNELS)
+        return 0;
+    if (inputs[idx].fn != NULL)
+        q8 = (int32_t)inputs[idx].fn(Sim_Now(), inputs[idx].ctx) << 8;
+    else
+        q8 = (int32_t)(((uint64_t)inputs[idx].millivolts * SIM_ADC_MAX_CODE << 8) / SIM_ADC_VDDA_MV);
+
+    if (hadc->Instance->CALFACT == 0U)
+        q8 += SIM_ADC_UNCAL_OFFSET_LSB << 8;
+    q8 += SimAdc_Noise() + 128;
+
+    if (q8 < 0)
+        return 0;
+    return ((uint32_t)q8 >> 8 > SIM_ADC_MAX_CODE) ? SIM_ADC_MAX_CODE : (uint32_t)q8 >> 8;
+}
+
+static uint32_t SimAdc_OversampleLog2(const ADC_TypeDef *adc)
+{
+    if ((adc->CFGR2 & ADC_CFGR2_OVSE) == 0U)
+        return 0;
+    return ((adc->CFGR2 & ADC_CFGR2_OVSR) >> ADC_CFGR2_OVSR_Pos) + 1U;
+}
+
+// Resultado em DR: com oversampling, a soma de 2^(OVSR+1) conversões
+// deslocada de OVSS bits com arredondamento, truncada em 16 bits
+static uint32_t SimAdc_Result(const ADC_HandleTypeDef *hadc, uint32_t channel)
+{
+    uint32_t n = 1UL << SimAdc_OversampleLog2(hadc->Instance);
+    uint32_t shift = (hadc->Instance->CFGR2 & ADC_CFGR2_OVSS) >> ADC_CFGR2_OVSS_Pos;
+    uint32_t acc = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+        acc += SimAdc_ConvertOnce(hadc, channel);
+    if (n > 1U && shift > 0U)
+        acc = (acc + (1UL << (shift - 1U))) >> shift;
+    return acc & 0xFFFFU;
+}
+
+// Watchdog 1: resultado fora de [LT1, HT1] marca AWD1
+static void SimAdc_Watchdog(const ADC_HandleTypeDef *hadc)
+{
+    ADC_TypeDef *adc = hadc->Instance;
+    uint32_t value = (adc->CFGR2 & ADC_CFGR2_OVSE) ? (adc->DR >> 4) : adc->DR;
+    uint32_t high = (adc->AWD1TR & ADC_AWD1TR_HT1) >> ADC_AWD1TR_HT1_Pos;
+    uint32_t low = adc->AWD1TR & ADC_AWD1TR_LT1;
+
+    if ((adc->CFGR1 & ADC_CFGR1_AWD1EN) == 0U)
+        return;
+    if ((adc->CFGR1 & ADC_CFGR1_AWD1SGL)
+        && ((adc->CFGR1 & ADC_CFGR1_AWD1CH) >> ADC_CFGR1_AWD1CH_Pos)
+           != __LL_ADC_CHANNEL_TO_DECIMAL_NB(SimAdc_SelectedChannel(hadc)))
+        return;
+    if (value > high || value < low)
+        adc->ISR |= ADC_ISR_AWD1;
+}
+
+// --- Temporização ---
+
+static const uint16_t async_dividers[] = { 1, 2, 4, 6, 8, 10, 12, 16, 32, 64, 128, 256 };
+
+// Clock do ADC: PCLK dividido (síncrono, CKMODE) ou o kernel de
+// CCIPR.ADCSEL pelo PRESC (assíncrono)
+static uint32_t SimAdc_ClockHz(const ADC_HandleTypeDef *hadc)
+{
+    uint32_t presc;
+
+    switch (hadc->Init.ClockPrescaler)
+    {
+    case ADC_CLOCK_SYNC_PCLK_DIV1: return HAL_RCC_GetPCLK1Freq();
+    case ADC_CLOCK_SYNC_PCLK_DIV2: return HAL_RCC_GetPCLK1Freq() / 2U;
+    case ADC_CLOCK_SYNC_PCLK_DIV4: return HAL_RCC_GetPCLK1Freq() / 4U;
+    default:
+        presc = (hadc->Init.ClockPrescaler & ADC_CCR_PRESC) >> ADC_CCR_PRESC_Pos;
+        if (presc >= sizeof(async_dividers) / sizeof(async_dividers[0]))
+            presc = sizeof(async_dividers) / sizeof(async_dividers[0]) - 1U;
+        return Sim_AdcKernelHz() / async_dividers[presc];
+    }
+}
+
+// Uma conversão (com a média do oversampler) em ticks
+static uint64_t SimAdc_ConversionTicks(const ADC_HandleTypeDef *hadc)
+{
+    uint32_t smp = hadc->Instance->SMPR & 0x7U;
+    uint32_t half_cycles = sampling_half_cycles[smp] + 25U; // + 12.5 de SAR
+
+    return Sim_TicksFromHz(half_cycles, 2U * SimAdc_ClockHz(hadc)) << SimAdc_OversampleLog2(hadc->Instance);
+}
+
+static uint32_t SimAdc_SelectedChannel(const ADC_HandleTypeDef *hadc)
+{
+    uint32_t chselr = hadc->Instance->CHSELR;
+
+    for (uint32_t idx = 0; idx < SIM_ADC_CHANNELS; idx++)
+    {
+        if (chselr & (1UL << idx))
+            return __LL_ADC_DECIMAL_NB_TO_CHANNEL(idx);
+    }
+    return ADC_CHANNEL_0;
+}
+
+static void SimAdc_StartConversion(ADC_HandleTypeDef *hadc)
+{
+    converting = 1;
+    Sim_Schedule(Sim_Now() + SimAdc_ConversionTicks(hadc), SimAdc_ConversionDone, hadc);
+}
+
+static void SimAdc_ConversionDone(void *arg)
+{
+    ADC_HandleTypeDef *hadc = (ADC_HandleTypeDef *)arg;
+    ADC_TypeDef *adc = hadc->Instance;
+
+    converting = 0;
+    if ((adc->CR & ADC_CR_ADSTART) == 0U)
+        return;
+
+    if (adc->ISR & ADC_ISR_EOC)
+        adc->ISR |= ADC_ISR_OVR;
+    adc->DR = SimAdc_Result(hadc, SimAdc_SelectedChannel(hadc));
+    adc->ISR |= ADC_ISR_EOC | ADC_ISR_EOS;
+    SimAdc_Watchdog(hadc);
+
+    // A leitura de DR pelo DMA limpa EOC, como a do software
+    if ((adc->CFGR1 & ADC_CFGR1_DMAEN) && SimDma_Request(DMA_REQUEST_ADC1))
+        adc->ISR &= ~ADC_ISR_EOC;
+
+    if (hadc->Init.ContinuousConvMode == ENABLE)
+        SimAdc_StartConversion(hadc);
+    else if ((adc->CFGR1 & ADC_CFGR1_EXTEN) == 0U)
+        adc->CR &= ~ADC_CR_ADSTART;
+
+    if (adc->IER & (ADC_IER_EOCIE | ADC_IER_EOSIE)
+        || (adc->ISR & adc->IER & ADC_IER_AWD1IE))
+        Sim_RaiseIRQ(ADC1_IRQn);
+}
+
+// Gatilho externo: TRGO de um timer (EXTSEL conforme RM0444, tabela 59)
+void SimAdc_ExternalTrigger(TIM_TypeDef *tim)
+{
+    ADC_HandleTypeDef *hadc = active_hadc;
+    TIM_TypeDef *selected;
+
+    if (hadc == NULL || (hadc->Instance->CFGR1 & ADC_CFGR1_EXTEN) == 0U
+        || (hadc->Instance->CR & ADC_CR_ADSTART) == 0U || converting)
+        return;
+
+    switch ((hadc->Instance->CFGR1 & ADC_CFGR1_EXTSEL) >> ADC_CFGR1_EXTSEL_Pos)
+    {
+    case 0U: selected = TIM1;  break;
+    case 3U: selected = TIM3;  break;
+    case 4U: selected = TIM15; break;
+    case 5U: selected = TIM6;  break;
+    default: selected = NULL;  break;
+    }
+    if (tim == selected)
+        SimAdc_StartConversion(hadc);
+}
+
+static void SimAdc_DmaHalfCplt(DMA_HandleTypeDef *hdma)
+{
+    HAL_ADC_ConvHalfCpltCallback((ADC_HandleTypeDef *)hdma->Parent);
+}
+
+static void SimAdc_DmaCplt(DMA_HandleTypeDef *hdma)
+{
+    ADC_HandleTypeDef *hadc = (ADC_HandleTypeDef *)hdma->Parent;
+
+    hadc->State |= HAL_ADC_STATE_REG_EOC;
+    HAL_ADC_ConvCpltCallback(hadc);
+}
+
+// --- API da HAL ---
+
+__weak void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+}
+
+__weak void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+}
+
+__weak void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+}
+
+__weak void HAL_ADC_MspInit(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc)
+{
+    ADC_TypeDef *adc = hadc->Instance;
+
+    if (hadc->State == HAL_ADC_STATE_RESET)
+        HAL_ADC_MspInit(hadc);
+
+    adc->CFGR1 = hadc->Init.Resolution | hadc->Init.DataAlign
+               | ((hadc->Init.ContinuousConvMode == ENABLE) ? ADC_CFGR1_CONT : 0U)
+               | ((hadc->Init.DMAContinuousRequests == ENABLE) ? ADC_CFGR1_DMACFG : 0U)
+               | ((hadc->Init.Overrun == ADC_OVR_DATA_OVERWRITTEN) ? ADC_CFGR1_OVRMOD : 0U);
+    if (hadc->Init.ExternalTrigConv != ADC_SOFTWARE_START)
+        adc->CFGR1 |= (hadc->Init.ExternalTrigConv & ADC_CFGR1_EXTSEL)
+                    | (hadc->Init.ExternalTrigConvEdge & ADC_CFGR1_EXTEN);
+    adc->CFGR2 = hadc->Init.ClockPrescaler & ADC_CFGR2_CKMODE;
+    adc->SMPR = hadc->Init.SamplingTimeCommon1 & ADC_SMPR_SMP1;
+    hadc->ErrorCode = HAL_ADC_ERROR_NONE;
+    hadc->State = HAL_ADC_STATE_READY;
+    active_hadc = hadc;
+
+    Sim_Consume(SIM_COST_ADC_INIT);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, const ADC_ChannelConfTypeDef *pConfig)
+{
+    uint32_t idx = __LL_ADC_CHANNEL_TO_DECIMAL_NB(pConfig->Channel);
+
+    hadc->Instance->CHSELR |= 1UL << idx;
+    Sim_Consume(SIM_COST_ADC_CONFIG_CHANNEL);
+    return HAL_OK;
+}
+
+// Sem gatilho externo a primeira conversão começa já; com gatilho, o ADC
+// fica armado (ADSTART) esperando o TRGO
+static void SimAdc_Arm(ADC_HandleTypeDef *hadc)
+{
+    ADC_TypeDef *adc = hadc->Instance;
+
+    adc->CR |= ADC_CR_ADEN | ADC_CR_ADSTART;
+    adc->ISR &= ~(ADC_ISR_EOC | ADC_ISR_EOS | ADC_ISR_OVR);
+    hadc->State = HAL_ADC_STATE_REG_BUSY;
+    if ((adc->CFGR1 & ADC_CFGR1_EXTEN) == 0U)
+        SimAdc_StartConversion(hadc);
+}
+
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef *hadc)
+{
+    Sim_Consume(SIM_COST_ADC_START);
+    SimAdc_Arm(hadc);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length)
+{
+    DMA_HandleTypeDef *hdma = hadc->DMA_Handle;
+
+    if (hdma == NULL)
+        return HAL_ERROR;
+
+    Sim_Consume(SIM_COST_DMA_START);
+    hdma->XferHalfCpltCallback = SimAdc_DmaHalfCplt;
+    hdma->XferCpltCallback = SimAdc_DmaCplt;
+    if (SimDma_Start(hdma, &hadc->Instance->DR, pData, Length) != HAL_OK)
+        return HAL_ERROR;
+
+    hadc->Instance->CFGR1 |= ADC_CFGR1_DMAEN;
+    SimAdc_Arm(hadc);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc)
+{
+    HAL_StatusTypeDef status = HAL_ADC_Stop(hadc);
+
+    hadc->Instance->CFGR1 &= ~ADC_CFGR1_DMAEN;
+    if (hadc->DMA_Handle != NULL)
+        SimDma_Stop(hadc->DMA_Handle);
+    return status;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef *hadc)
+{
+    hadc->Instance->CR &= ~(ADC_CR_ADSTART | ADC_CR_ADEN);
+    Sim_Cancel(SimAdc_ConversionDone, hadc);
+    converting = 0;
+    hadc->State = HAL_ADC_STATE_READY;
+    Sim_Consume(SIM_COST_ADC_START);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef *hadc, uint32_t Timeout)
+{
+    uint32_t tickstart = HAL_GetTick();
+
+    Sim_Consume(SIM_COST_ADC_POLL_ENTRY);
+    while ((hadc->Instance->ISR & ADC_ISR_EOC) == 0U)
+    {
+        if (Timeout != HAL_MAX_DELAY && (HAL_GetTick() - tickstart) > Timeout)
+            return HAL_TIMEOUT;
+        Sim_SpinToNextEvent();
+    }
+
+    if (hadc->Init.ContinuousConvMode == DISABLE)
+        hadc->State = HAL_ADC_STATE_READY | HAL_ADC_STATE_REG_EOC;
+    return HAL_OK;
+}
+
+uint32_t HAL_ADC_GetValue(const ADC_HandleTypeDef *hadc)
+{
+    // A leitura de DR limpa EOC no hardware
+    hadc->Instance->ISR &= ~ADC_ISR_EOC;
+    Sim_Consume(SIM_COST_ADC_GETVALUE);
+    return hadc->Instance->DR;
+}
+
+// Calibração: o ADC precisa estar desligado (a HAL o desliga). São 8
+// ciclos de calibração com média, em espera ativa; o fator zera o offset.
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc)
+{
+    ADC_TypeDef *adc = hadc->Instance;
+
+    adc->CR &= ~(ADC_CR_ADSTART | ADC_CR_ADEN);
+    Sim_Cancel(SimAdc_ConversionDone, hadc);
+    converting = 0;
+    adc->CALFACT = SIM_ADC_CALFACT;
+    hadc->State = HAL_ADC_STATE_READY;
+    Sim_Consume(SIM_COST_ADC_CALIBRATION);
+    Sim_SpinUntil(Sim_Now() + Sim_TicksFromHz(8U * SIM_ADC_CAL_ADC_CYCLES, SimAdc_ClockHz(hadc)));
+    return HAL_OK;
+}
+
+uint32_t HAL_ADCEx_Calibration_GetValue(const ADC_HandleTypeDef *hadc)
+{
+    return hadc->Instance->CALFACT & ADC_CALFACT_CALFACT;
+}
+
+HAL_StatusTypeDef HAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef *hadc, const ADC_AnalogWDGConfTypeDef *pAnalogWDGConfig)
+{
+    ADC_TypeDef *adc = hadc->Instance;
+
+    if (pAnalogWDGConfig->WatchdogNumber != ADC_ANALOGWATCHDOG_1 || (adc->CR & ADC_CR_ADSTART))
+        return HAL_ERROR;
+
+    adc->CFGR1 &= ~(ADC_CFGR1_AWD1EN | ADC_CFGR1_AWD1SGL | ADC_CFGR1_AWD1CH);
+    if (pAnalogWDGConfig->WatchdogMode == ADC_ANALOGWATCHDOG_SINGLE_REG)
+        adc->CFGR1 |= ADC_CFGR1_AWD1EN | ADC_CFGR1_AWD1SGL
+                    | (__LL_ADC_CHANNEL_TO_DECIMAL_NB(pAnalogWDGConfig->Channel) << ADC_CFGR1_AWD1CH_Pos);
+    else if (pAnalogWDGConfig->WatchdogMode == ADC_ANALOGWATCHDOG_ALL_REG)
+        adc->CFGR1 |= ADC_CFGR1_AWD1EN;
+
+    adc->AWD1TR = (pAnalogWDGConfig->HighThreshold << ADC_AWD1TR_HT1_Pos)
+                | (pAnalogWDGConfig->LowThreshold & ADC_AWD1TR_LT1);
+    adc->ISR &= ~ADC_ISR_AWD1;
+    if (pAnalogWDGConfig->ITMode == ENABLE)
+        adc->IER |= ADC_IER_AWD1IE;
+    else
+        adc->IER &= ~ADC_IER_AWD1IE;
+    hadc->State &= ~HAL_ADC_STATE_AWD1;
+    Sim_Consume(SIM_COST_ADC_CONFIG_CHANNEL);
+    return HAL_OK;
+}
+
+// Só o watchdog 1 gera interrupção no modelo: callback e depois limpeza
+// da flag, como na HAL
+void HAL_ADC_IRQHandler(ADC_HandleTypeDef *hadc)
+{
+    ADC_TypeDef *adc = hadc->Instance;
+
+    Sim_Consume(SIM_COST_ADC_IRQ_HANDLER);
+    if ((adc->ISR & ADC_ISR_AWD1) && (adc->IER & ADC_IER_AWD1IE))
+    {
+        hadc->State |= HAL_ADC_STATE_AWD1;
+        HAL_ADC_LevelOutOfWindowCallback(hadc);
+        adc->ISR &= ~ADC_ISR_AWD1;
+    }
+}
@@ -0,0 +1,242 @@
+/**
+  ******************************************************************************
+  * @file    host_hal_dma.c
+  * @brief   DMA1 simulado: cada requisição de periférico (ADC, TIM, USART)
+  *          move um elemento entre o registrador e a memória, com flags de
+  *          meia-transferência e transferência completa e modo circular.
+  *
+  *          Os endereços ficam numa tabela do simulador e não em CPAR/CMAR,
+  *          que têm 32 bits e não comportam ponteiros do host.
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "stm32g0xx_hal.h"
+#include "host_sim.h"
+
+#define SIM_DMA_CHANNELS 7
+
+typedef struct
+{
+    DMA_HandleTypeDef *hdma;
+    volatile void *periph;
+    void *mem;
+    uint32_t length;
+    uint32_t index;
+} SimDma_Channel;
+
+static SimDma_Channel channels[SIM_DMA_CHANNELS];
+
+static const IRQn_Type channel_irq[SIM_DMA_CHANNELS] =
+{
+    DMA1_Channel1_IRQn,
+    DMA1_Channel2_3_IRQn, DMA1_Channel2_3_IRQn,
+    DMA1_Ch4_7_DMAMUX1_OVR_IRQn, DMA1_Ch4_7_DMAMUX1_OVR_IRQn,
+    DMA1_Ch4_7_DMAMUX1_OVR_IRQn, DMA1_Ch4_7_DMAMUX1_OVR_IRQn,
+};
+
+static uint32_t SimDma_Index(const DMA_HandleTypeDef *hdma)
+{
+    return (uint32_t)(hdma->Instance - &Sim_DMA1_Channel[0]);
+}
+
+static uint32_t SimDma_ElementSize(uint32_t align, uint32_t halfword, uint32_t word)
+{
+    if (align == word)
+        return 4U;
+    if (align == halfword)
+        return 2U;
+    return 1U;
+}
+
+static uint32_t SimDma_Load(const volatile void *addr, uint32_t size)
+{
+    switch (size)
+    {
+    case 4U: return *(const volatile uint32_t *)addr;
+    case 2U: return *(const volatile uint16_t *)addr;
+    default: return *(const volatile uint8_t *)addr;
+    }
+}
+
+static void SimDma_Store(volatile void *addr, uint32_t size, uint32_t value)
+{
+    switch (size)
+    {
+    case 4U: *(volatile uint32_t *)addr = value; break;
+    case 2U: *(volatile uint16_t *)addr = (uint16_t)value; break;
+    default: *(volatile uint8_t *)addr = (uint8_t)value; break;
+    }
+}
+
+void SimDma_Reset(void)
+{
+    memset(&Sim_DMA1, 0, sizeof(Sim_DMA1));
+    memset(Sim_DMA1_Channel, 0, sizeof(Sim_DMA1_Channel));
+    memset(channels, 0, sizeof(channels));
+}
+
+HAL_StatusTypeDef SimDma_Start(DMA_HandleTypeDef *hdma, volatile void *periph, void *mem, uint32_t length)
+{
+    uint32_t idx = SimDma_Index(hdma);
+
+    if (idx >= SIM_DMA_CHANNELS || length == 0U)
+        return HAL_ERROR;
+    if (hdma->State != HAL_DMA_STATE_READY)
+        return HAL_BUSY;
+
+    channels[idx].hdma = hdma;
+    channels[idx].periph = periph;
+    channels[idx].mem = mem;
+    channels[idx].length = length;
+    channels[idx].index = 0;
+
+    hdma->State = HAL_DMA_STATE_BUSY;
+    hdma->Instance->CNDTR = length;
+    hdma->Instance->CCR |= DMA_CCR_TCIE | DMA_CCR_TEIE | DMA_CCR_EN;
+    if (hdma->XferHalfCpltCallback != NULL)
+        hdma->Instance->CCR |= DMA_CCR_HTIE;
+    Sim_DMA1.IFCR = 0;
+    Sim_DMA1.ISR &= ~(0xFUL << (idx * 4U));
+    return HAL_OK;
+}
+
+void SimDma_Stop(DMA_HandleTypeDef *hdma)
+{
+    uint32_t idx = SimDma_Index(hdma);
+
+    if (idx >= SIM_DMA_CHANNELS)
+        return;
+    hdma->Instance->CCR &= ~(DMA_CCR_EN | DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE);
+    hdma->State = HAL_DMA_STATE_READY;
+    channels[idx].hdma = NULL;
+}
+
+// 1 se algum canal ligado atende 'request': o periférico tem o que pedir
+int SimDma_Ready(uint32_t request)
+{
+    for (uint32_t idx = 0; idx < SIM_DMA_CHANNELS; idx++)
+    {
+        DMA_HandleTypeDef *hdma = channels[idx].hdma;
+
+        if (hdma != NULL && hdma->Init.Request == request && (hdma->Instance->CCR & DMA_CCR_EN) != 0U)
+            return 1;
+    }
+    return 0;
+}
+
+// Uma requisição do periférico 'request' (DMA_REQUEST_xxx): move um elemento
+int SimDma_Request(uint32_t request)
+{
+    for (uint32_t idx = 0; idx < SIM_DMA_CHANNELS; idx++)
+    {
+        SimDma_Channel *ch = &channels[idx];
+        DMA_HandleTypeDef *hdma = ch->hdma;
+
+        if (hdma == NULL || hdma->Init.Request != request || (hdma->Instance->CCR & DMA_CCR_EN) == 0U)
+            continue;
+
+        uint32_t psize = SimDma_ElementSize(hdma->Init.PeriphDataAlignment,
+                                            DMA_PDATAALIGN_HALFWORD, DMA_PDATAALIGN_WORD);
+        uint32_t msize = SimDma_ElementSize(hdma->Init.MemDataAlignment,
+                                            DMA_MDATAALIGN_HALFWORD, DMA_MDATAALIGN_WORD);
+        uint8_t *mem = (uint8_t *)ch->mem;
+        uint32_t moff = (hdma->Init.MemInc == DMA_MINC_ENABLE) ? ch->index * msize : 0U;
+
+        if (hdma->Init.Direction == DMA_MEMORY_TO_PERIPH)
+            SimDma_Store(ch->periph, psize, SimDma_Load(mem + moff, msize));
+        else
+            SimDma_Store(mem + moff, msize, SimDma_Load(ch->periph, psize));
+
+        ch->index++;
+        hdma->Instance->CNDTR = ch->length - ch->index;
+
+        uint32_t flags = 0;
+        if (ch->index == ch->length / 2U)
+            flags |= DMA_ISR_HTIF1 | DMA_ISR_GIF1;
+        if (ch->index == ch->length)
+        {
+            flags |= DMA_ISR_TCIF1 | DMA_ISR_GIF1;
+            if (hdma->Init.Mode == DMA_CIRCULAR)
+            {
+                ch->index = 0;
+                hdma->Instance->CNDTR = ch->length;
+            }
+            else
+                hdma->Instance->CCR &= ~DMA_CCR_EN;
+        }
+        Sim_DMA1.ISR |= flags << (idx * 4U);
+
+        if (((flags & DMA_ISR_HTIF1) && (hdma->Instance->CCR & DMA_CCR_HTIE))
+            || ((flags & DMA_ISR_TCIF1) && (hdma->Instance->CCR & DMA_CCR_TCIE)))
+            Sim_RaiseIRQ(channel_irq[idx]);
+        return 1;
+    }
+    return 0;
+}
+
+// --- API da HAL ---
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+    if (hdma == NULL)
+        return HAL_ERROR;
+
+    hdma->ChannelIndex = SimDma_Index(hdma) * 4U;
+    hdma->Instance->CCR = hdma->Init.Direction | hdma->Init.PeriphInc | hdma->Init.MemInc
+                        | hdma->Init.PeriphDataAlignment | hdma->Init.MemDataAlignment
+                        | hdma->Init.Mode | hdma->Init.Priority;
+    hdma->ErrorCode = HAL_DMA_ERROR_NONE;
+    hdma->State = HAL_DMA_STATE_READY;
+    hdma->Lock = HAL_UNLOCKED;
+    Sim_Consume(SIM_COST_DMA_INIT);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma)
+{
+    if (hdma == NULL)
+        return HAL_ERROR;
+
+    SimDma_Stop(hdma);
+    hdma->Instance->CCR = 0;
+    hdma->State = HAL_DMA_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma)
+{
+    SimDma_Stop(hdma);
+    return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+    uint32_t idx = SimDma_Index(hdma);
+    uint32_t shift = idx * 4U;
+    uint32_t flags = (Sim_DMA1.ISR >> shift) & 0xFU;
+    uint32_t ccr = hdma->Instance->CCR;
+
+    if ((flags & DMA_ISR_HTIF1) && (ccr & DMA_CCR_HTIE))
+    {
+        if ((ccr & DMA_CCR_CIRC) == 0U)
+            hdma->Instance->CCR &= ~DMA_CCR_HTIE;
+        Sim_DMA1.ISR &= ~(DMA_ISR_HTIF1 << shift);
+        Sim_Consume(SIM_COST_DMA_IRQ);
+        if (hdma->XferHalfCpltCallback != NULL)
+            hdma->XferHalfCpltCallback(hdma);
+    }
+    if ((flags & DMA_ISR_TCIF1) && (ccr & DMA_CCR_TCIE))
+    {
+        if ((ccr & DMA_CCR_CIRC) == 0U)
+        {
+            hdma->Instance->CCR &= ~(DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE);
+            hdma->State = HAL_DMA_STATE_READY;
+        }
+        Sim_DMA1.ISR &= ~(DMA_ISR_TCIF1 << shift);
+        Sim_Consume(SIM_COST_DMA_IRQ);
+        if (hdma->XferCpltCallback != NULL)
+            hdma->XferCpltCallback(hdma);
+    }
+    Sim_DMA1.ISR &= ~(DMA_ISR_GIF1 << shift);
+}
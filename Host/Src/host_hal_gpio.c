@@ -0,0 +1,283 @@
+/**
+  ******************************************************************************
+  * @file    host_hal_gpio.c
+  * @brief   HAL GPIO simulada: ODR/IDR/BSRR em RAM e níveis externos dos
+  *          pinos de entrada controlados pelo cenário de simulação.
+  *
+  *          Toda mudança de IDR passa pelo EXTI: uma borda num pino
+  *          selecionado em EXTICR e habilitado em IMR1/RTSR1/FTSR1 marca
+  *          RPR1/FPR1 e pede a interrupção EXTIx_y correspondente.
+  *
+  *          Escritas diretas do firmware em BSRR/BRR ficam só na RAM até
+  *          PORT_GPIO_SYNC() (Sim_GpioSync), que as aplica no ODR como o
+  *          hardware. Toda mudança de ODR passa pelo observador opcional,
+  *          para os modelos de dispositivo ligados nos pinos.
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "stm32g0xx_hal.h"
+#include "host_sim.h"
+
+#define SIM_GPIO_PORTS 5
+
+typedef struct
+{
+    GPIO_TypeDef *port;
+    uint8_t index;        // Valor do port em EXTICR
+    uint16_t ext_level;   // nível imposto por fora (botões)
+    uint16_t ext_driven;  // pinos com nível externo definido
+} SimGpio_Port;
+
+static void (*watch_fn)(GPIO_TypeDef *port, uint32_t old_odr, void *ctx);
+static void *watch_ctx;
+static uint32_t writes;
+
+static SimGpio_Port ports[SIM_GPIO_PORTS] =
+{
+    { GPIOA, 0, 0, 0 },
+    { GPIOB, 1, 0, 0 },
+    { GPIOC, 2, 0, 0 },
+    { GPIOD, 3, 0, 0 },
+    { GPIOF, 5, 0, 0 },
+};
+
+static SimGpio_Port *SimGpio_Find(GPIO_TypeDef *port)
+{
+    for (int i = 0; i < SIM_GPIO_PORTS; i++)
+    {
+        if (ports[i].port == port)
+            return &ports[i];
+    }
+    return NULL;
+}
+
+static IRQn_Type SimGpio_ExtiIrq(uint32_t line)
+{
+    if (line <= 1U)
+        return EXTI0_1_IRQn;
+    if (line <= 3U)
+        return EXTI2_3_IRQn;
+    return EXTI4_15_IRQn;
+}
+
+// Bordas nos pinos 'changed' do port: pendências e IRQs do EXTI
+static void SimGpio_Exti(SimGpio_Port *p, uint32_t changed, uint32_t idr)
+{
+    for (uint32_t line = 0; line < 16; line++)
+    {
+        uint32_t bit = 1UL << line;
+        uint32_t mux = (EXTI->EXTICR[line >> 2U] >> (8U * (line & 0x3U))) & 0xFFU;
+        uint32_t pending = 0;
+
+        if ((changed & bit) == 0U || mux != p->index || (EXTI->IMR1 & bit) == 0U)
+            continue;
+        if ((idr & bit) && (EXTI->RTSR1 & bit))
+        {
+            EXTI->RPR1 |= bit;
+            pending = 1;
+        }
+        if (!(idr & bit) && (EXTI->FTSR1 & bit))
+        {
+            EXTI->FPR1 |= bit;
+            pending = 1;
+        }
+        if (pending)
+            Sim_RaiseIRQ(SimGpio_ExtiIrq(line));
+    }
+}
+
+// Recalcula o IDR a partir do modo de cada pino
+static void SimGpio_UpdateIdr(SimGpio_Port *p)
+{
+    GPIO_TypeDef *gpio = p->port;
+    uint32_t old = gpio->IDR;
+    uint32_t idr = 0;
+
+    for (uint32_t pin = 0; pin < 16; pin++)
+    {
+        uint32_t mode = (gpio->MODER >> (pin * 2U)) & 0x3U;
+        uint32_t pull = (gpio->PUPDR >> (pin * 2U)) & 0x3U;
+        uint32_t bit = 1UL << pin;
+        uint32_t level;
+
+        if (mode == 0x1U || mode == 0x2U)
+            level = gpio->ODR & bit;
+        else if (p->ext_driven & bit)
+            level = p->ext_level & bit;
+        else
+            level = (pull == 0x1U) ? bit : 0U;
+        idr |= level;
+    }
+    gpio->IDR = idr;
+    if (idr != old)
+        SimGpio_Exti(p, idr ^ old, idr);
+}
+
+void SimGpio_Reset(void)
+{
+    for (int i = 0; i < SIM_GPIO_PORTS; i++)
+    {
+        memset(ports[i].port, 0, sizeof(GPIO_TypeDef));
+        ports[i].ext_level = 0;
+        ports[i].ext_driven = 0;
+    }
+    memset(&Sim_EXTI, 0, sizeof(Sim_EXTI));
+    watch_fn = NULL;
+    watch_ctx = NULL;
+    writes = 0;
+}
+
+void Sim_SetGpioWatch(void (*fn)(GPIO_TypeDef *port, uint32_t old_odr, void *ctx), void *ctx)
+{
+    watch_fn = fn;
+    watch_ctx = ctx;
+}
+
+uint32_t Sim_GpioWrites(void)
+{
+    return writes;
+}
+
+// Novo ODR: IDR, EXTI e o observador
+static void SimGpio_Output(GPIO_TypeDef *port, uint32_t odr)
+{
+    SimGpio_Port *p = SimGpio_Find(port);
+    uint32_t old = port->ODR;
+
+    port->ODR = odr;
+    writes++;
+    if (p != NULL)
+        SimGpio_UpdateIdr(p);
+    if (watch_fn != NULL && odr != old)
+        watch_fn(port, old, watch_ctx);
+}
+
+// BSRR: a metade baixa liga, a alta desliga, ligar vence; BRR desliga
+void Sim_GpioSync(GPIO_TypeDef *port)
+{
+    uint32_t set = port->BSRR & 0xFFFFU;
+    uint32_t reset = (port->BSRR >> 16) | port->BRR;
+
+    port->BSRR = 0;
+    port->BRR = 0;
+    SimGpio_Output(port, (port->ODR & ~reset) | set);
+    Sim_Consume(SIM_COST_GPIO_BSRR);
+}
+
+void Sim_SetPinLevel(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState level)
+{
+    SimGpio_Port *p = SimGpio_Find(port);
+
+    if (p == NULL)
+        return;
+    p->ext_driven |= pin;
+    if (level == GPIO_PIN_SET)
+        p->ext_level |= pin;
+    else
+        p->ext_level &= (uint16_t)~pin;
+    SimGpio_UpdateIdr(p);
+}
+
+// --- API da HAL ---
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    for (uint32_t pin = 0; pin < 16; pin++)
+    {
+        if ((GPIO_Init->Pin & (1UL << pin)) == 0U)
+            continue;
+
+        uint32_t shift = pin * 2U;
+        GPIOx->MODER = (GPIOx->MODER & ~(0x3UL << shift)) | ((GPIO_Init->Mode & GPIO_MODE) << shift);
+        GPIOx->PUPDR = (GPIOx->PUPDR & ~(0x3UL << shift)) | (GPIO_Init->Pull << shift);
+        GPIOx->OSPEEDR = (GPIOx->OSPEEDR & ~(0x3UL << shift)) | (GPIO_Init->Speed << shift);
+        if ((GPIO_Init->Mode & GPIO_MODE) == MODE_AF)
+        {
+            uint32_t afr = pin >> 3U;
+            uint32_t afshift = (pin & 0x7U) * 4U;
+            GPIOx->AFR[afr] = (GPIOx->AFR[afr] & ~(0xFUL << afshift)) | (GPIO_Init->Alternate << afshift);
+        }
+        Sim_Consume(SIM_COST_GPIO_INIT_PIN);
+    }
+
+    SimGpio_Port *p = SimGpio_Find(GPIOx);
+    if (p == NULL)
+        return;
+    SimGpio_UpdateIdr(p);
+
+    // EXTI só depois do IDR assentar, como no hardware, em que o pull-up
+    // já atua antes de a linha ser habilitada
+    if ((GPIO_Init->Mode & EXTI_MODE) == 0U)
+        return;
+    for (uint32_t pin = 0; pin < 16; pin++)
+    {
+        uint32_t bit = 1UL << pin;
+        uint32_t shift = 8U * (pin & 0x3U);
+
+        if ((GPIO_Init->Pin & bit) == 0U)
+            continue;
+        EXTI->EXTICR[pin >> 2U] = (EXTI->EXTICR[pin >> 2U] & ~(0xFFUL << shift)) | ((uint32_t)p->index << shift);
+        EXTI->RTSR1 = (GPIO_Init->Mode & TRIGGER_RISING) ? (EXTI->RTSR1 | bit) : (EXTI->RTSR1 & ~bit);
+        EXTI->FTSR1 = (GPIO_Init->Mode & TRIGGER_FALLING) ? (EXTI->FTSR1 | bit) : (EXTI->FTSR1 & ~bit);
+        EXTI->EMR1 = (GPIO_Init->Mode & EXTI_EVT) ? (EXTI->EMR1 | bit) : (EXTI->EMR1 & ~bit);
+        EXTI->IMR1 = (GPIO_Init->Mode & EXTI_IT) ? (EXTI->IMR1 | bit) : (EXTI->IMR1 & ~bit);
+    }
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
+{
+    GPIO_InitTypeDef init = {0};
+
+    init.Pin = GPIO_Pin;
+    init.Mode = GPIO_MODE_ANALOG;
+    HAL_GPIO_Init(GPIOx, &init);
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    Sim_Consume(SIM_COST_GPIO_READ);
+    return ((GPIOx->IDR & GPIO_Pin) != 0U) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    // Mesmo efeito de uma escrita em BSRR/BRR
+    if (PinState != GPIO_PIN_RESET)
+        SimGpio_Output(GPIOx, GPIOx->ODR | GPIO_Pin);
+    else
+        SimGpio_Output(GPIOx, GPIOx->ODR & ~(uint32_t)GPIO_Pin);
+    Sim_Consume(SIM_COST_GPIO_WRITE);
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    SimGpio_Output(GPIOx, GPIOx->ODR ^ GPIO_Pin);
+    Sim_Consume(SIM_COST_GPIO_TOGGLE);
+}
+
+// RPR1/FPR1 são "escreva 1 para limpar"; em RAM a limpeza é explícita
+void HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin)
+{
+    Sim_Consume(SIM_COST_GPIO_EXTI_HANDLER);
+    if (EXTI->RPR1 & GPIO_Pin)
+    {
+        EXTI->RPR1 &= ~(uint32_t)GPIO_Pin;
+        HAL_GPIO_EXTI_Rising_Callback(GPIO_Pin);
+    }
+    if (EXTI->FPR1 & GPIO_Pin)
+    {
+        EXTI->FPR1 &= ~(uint32_t)GPIO_Pin;
+        HAL_GPIO_EXTI_Falling_Callback(GPIO_Pin);
+    }
+}
+
+__weak void HAL_GPIO_EXTI_Rising_Callback(uint16_t GPIO_Pin)
+{
+    (void)GPIO_Pin;
+}
+
+__weak void HAL_GPIO_EXTI_Falling_Callback(uint16_t GPIO_Pin)
+{
+    (void)GPIO_Pin;
+}
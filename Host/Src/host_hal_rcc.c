@@ -0,0 +1,327 @@
+/**
+  ******************************************************************************
+  * @file    host_hal_rcc.c
+  * @brief   HAL RCC/PWR simulada: HSI16, HSIDIV, PLL, troca do SYSCLK,
+  *          prescalers de AHB/APB, faixa do regulador, low-power run,
+  *          SLEEP e STOP, refletidos em Sim_RCC, Sim_PWR e Sim_FLASH.
+  *
+  *          SystemCoreClock sai dos registradores, como no alvo, e o
+  *          SysTick é refeito a cada troca (HAL_InitTick). Cada mudança
+  *          confere os limites do RM0444: wait states da flash e faixa do
+  *          regulador para o SYSCLK, low-power run só até 2 MHz. Violar um
+  *          deles aborta o simulador; no alvo seria leitura errada da
+  *          flash ou um núcleo fora de especificação, difíceis de achar.
+  *          Na saída do STOP o PLL fica desligado e o SYSCLK volta ao
+  *          HSISYS, como no alvo. Com Sim_SetPllLock(0) o PLL não trava e
+  *          a OscConfig espera o PLLRDY contra o HAL_GetTick(), como a HAL:
+  *          com as interrupções mascaradas o tick não anda, e o simulador
+  *          aborta em vez de girar para sempre. O LSI está em host_rtc.c;
+  *          HSE e LSE não são modelados.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "stm32g0xx_hal.h"
+#include "host_sim.h"
+
+#define SIM_RANGE1_HZ_PER_WS   24000000U   // Faixa 1: 0/1/2 WS até 24/48/64 MHz
+#define SIM_RANGE2_HZ_PER_WS    8000000U   // Faixa 2: 0/1 WS até 8/16 MHz
+#define SIM_RANGE2_MAX_HZ      16000000U
+#define SIM_LPR_MAX_HZ          2000000U
+#define SIM_PLL_TIMEOUT_MS      2U          // PLL_TIMEOUT_VALUE da HAL
+#define SIM_PLL_HANG_MS         100U        // Tick parado por tanto tempo: travou
+
+static uint8_t pll_dead;
+
+static uint32_t SimRcc_HsisysHz(void)
+{
+    return HSI_VALUE >> ((RCC->CR & RCC_CR_HSIDIV) >> RCC_CR_HSIDIV_Pos);
+}
+
+// Saída do PLL pelo divisor 'div' (campo PLLR ou PLLP, que valem campo + 1)
+static uint32_t SimRcc_PllHz(uint32_t div)
+{
+    uint32_t m = ((RCC->PLLCFGR & RCC_PLLCFGR_PLLM) >> RCC_PLLCFGR_PLLM_Pos) + 1U;
+    uint32_t n = (RCC->PLLCFGR & RCC_PLLCFGR_PLLN) >> RCC_PLLCFGR_PLLN_Pos;
+
+    return (uint32_t)(((uint64_t)HSI_VALUE * n) / (m * div));
+}
+
+static uint32_t SimRcc_PllRHz(void)
+{
+    return SimRcc_PllHz(((RCC->PLLCFGR & RCC_PLLCFGR_PLLR) >> RCC_PLLCFGR_PLLR_Pos) + 1U);
+}
+
+static uint32_t SimRcc_AhbShift(void)
+{
+    uint32_t hpre = (RCC->CFGR & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos;
+
+    if (hpre < 8U)
+        return 0U;
+    return (hpre < 12U) ? hpre - 7U : hpre - 6U; // /2../16, depois /64../512
+}
+
+static uint32_t SimRcc_ApbShift(void)
+{
+    uint32_t ppre = (RCC->CFGR & RCC_CFGR_PPRE) >> RCC_CFGR_PPRE_Pos;
+
+    return (ppre < 4U) ? 0U : ppre - 3U;
+}
+
+static void SimRcc_Fail(const char *what, uint32_t sysclk)
+{
+    fprintf(stderr, "sim: %s com SYSCLK de %lu Hz (faixa %lu, %lu WS, LPR %u)\n", what,
+            (unsigned long)sysclk, (unsigned long)((PWR->CR1 & PWR_CR1_VOS) >> PWR_CR1_VOS_Pos),
+            (unsigned long)(FLASH->ACR & FLASH_ACR_LATENCY), (PWR->CR1 & PWR_CR1_LPR) ? 1U : 0U);
+    abort();
+}
+
+// Limites do SYSCLK atual contra regulador e flash
+static void SimRcc_Check(void)
+{
+    uint32_t sysclk = HAL_RCC_GetSysClockFreq();
+    uint32_t ws = FLASH->ACR & FLASH_ACR_LATENCY;
+    int range2 = (PWR->CR1 & PWR_CR1_VOS) == PWR_REGULATOR_VOLTAGE_SCALE2;
+    uint32_t hz_per_ws = range2 ? SIM_RANGE2_HZ_PER_WS : SIM_RANGE1_HZ_PER_WS;
+
+    if (range2 && sysclk > SIM_RANGE2_MAX_HZ)
+        SimRcc_Fail("faixa 2 do regulador", sysclk);
+    if (sysclk > (ws + 1U) * hz_per_ws)
+        SimRcc_Fail("wait states de flash insuficientes", sysclk);
+    if ((PWR->CR1 & PWR_CR1_LPR) && sysclk > SIM_LPR_MAX_HZ)
+        SimRcc_Fail("low-power run", sysclk);
+}
+
+// Valores de reset: HSI16 ligado e sem divisor no SYSCLK, faixa 1, 0 WS
+void SimRcc_Reset(void)
+{
+    RCC->CR = RCC_CR_HSION | RCC_CR_HSIRDY;
+    RCC->CFGR = 0;
+    RCC->PLLCFGR = RCC_PLLCFGR_PLLN_4;
+    RCC->CCIPR = 0;
+    PWR->CR1 = PWR_REGULATOR_VOLTAGE_SCALE1;
+    PWR->SR2 = 0;
+    FLASH->ACR = 0;
+    pll_dead = 0;
+}
+
+void Sim_SetPllLock(uint8_t locks)
+{
+    pll_dead = !locks;
+}
+
+uint32_t Sim_TimerClockHz(void)
+{
+    uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+
+    return (SimRcc_ApbShift() == 0U) ? pclk : 2U * pclk;
+}
+
+// Clock de kernel assíncrono do ADC (CCIPR.ADCSEL)
+uint32_t Sim_AdcKernelHz(void)
+{
+    switch (RCC->CCIPR & RCC_CCIPR_ADCSEL)
+    {
+    case RCC_ADCCLKSOURCE_HSI:    return HSI_VALUE;
+    case RCC_ADCCLKSOURCE_PLLADC:
+        return SimRcc_PllHz(((RCC->PLLCFGR & RCC_PLLCFGR_PLLP) >> RCC_PLLCFGR_PLLP_Pos) + 1U);
+    default:                      return HAL_RCC_GetSysClockFreq();
+    }
+}
+
+// --- API da HAL ---
+
+uint32_t HAL_RCC_GetSysClockFreq(void)
+{
+    return ((RCC->CFGR & RCC_CFGR_SWS) == RCC_SYSCLKSOURCE_STATUS_PLLCLK) ? SimRcc_PllRHz()
+                                                                         : SimRcc_HsisysHz();
+}
+
+uint32_t HAL_RCC_GetHCLKFreq(void)
+{
+    return SystemCoreClock;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+    return SystemCoreClock >> SimRcc_ApbShift();
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct)
+{
+    int pll_is_sysclk = (RCC->CFGR & RCC_CFGR_SWS) == RCC_SYSCLKSOURCE_STATUS_PLLCLK;
+
+    Sim_Consume(SIM_COST_RCC_OSC_CONFIG);
+    if (RCC_OscInitStruct->OscillatorType & RCC_OSCILLATORTYPE_HSI)
+    {
+        // Em uso (SYSCLK ou entrada do PLL ligado): só o divisor muda
+        if (RCC_OscInitStruct->HSIState == RCC_HSI_OFF)
+            return HAL_ERROR;
+        RCC->CR = (RCC->CR & ~RCC_CR_HSIDIV) | RCC_OscInitStruct->HSIDiv | RCC_CR_HSION | RCC_CR_HSIRDY;
+        if (!pll_is_sysclk)
+        {
+            SystemCoreClock = SimRcc_HsisysHz() >> SimRcc_AhbShift();
+            SimRcc_Check();
+            if (HAL_InitTick(uwTickPrio) != HAL_OK)
+                return HAL_ERROR;
+        }
+    }
+
+    if (RCC_OscInitStruct->PLL.PLLState == RCC_PLL_ON)
+    {
+        uint32_t cfg = RCC_OscInitStruct->PLL.PLLSource | RCC_OscInitStruct->PLL.PLLM
+                     | (RCC_OscInitStruct->PLL.PLLN << RCC_PLLCFGR_PLLN_Pos)
+                     | RCC_OscInitStruct->PLL.PLLP | RCC_OscInitStruct->PLL.PLLR | RCC_PLLCFGR_PLLREN;
+
+        if (pll_is_sysclk)
+            return ((RCC->PLLCFGR & ~RCC_PLLCFGR_PLLPEN) == cfg) ? HAL_OK : HAL_ERROR;
+        if (RCC_OscInitStruct->PLL.PLLSource != RCC_PLLSOURCE_HSI)
+            return HAL_ERROR;
+        RCC->PLLCFGR = cfg;
+        RCC->CR |= RCC_CR_PLLON;
+        if (pll_dead)
+        {
+            uint32_t tickstart = HAL_GetTick();
+            uint64_t hang = Sim_Now() + Sim_CyclesFromMs(SIM_PLL_HANG_MS);
+
+            while ((HAL_GetTick() - tickstart) <= SIM_PLL_TIMEOUT_MS)
+            {
+                if (Sim_Now() > hang)
+                {
+                    fprintf(stderr, "sim: espera do PLLRDY sem o HAL_GetTick andar (IRQs mascaradas?)\n");
+                    abort();
+                }
+                Sim_Consume(SIM_COST_RCC_READY_POLL);
+            }
+            RCC->CR &= ~RCC_CR_PLLON;
+            return HAL_TIMEOUT;
+        }
+        Sim_SpinUntil(Sim_Now() + Sim_CyclesFromUs(SIM_RCC_PLL_LOCK_US));
+        RCC->CR |= RCC_CR_PLLRDY;
+    }
+    else if (RCC_OscInitStruct->PLL.PLLState == RCC_PLL_OFF)
+    {
+        if (pll_is_sysclk)
+            return HAL_ERROR;
+        RCC->CR &= ~(RCC_CR_PLLON | RCC_CR_PLLRDY);
+    }
+    return HAL_OK;
+}
+
+// Como na HAL: wait states sobem antes da troca e descem depois dela
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency)
+{
+    Sim_Consume(SIM_COST_RCC_CLOCK_CONFIG);
+    if (FLatency > (FLASH->ACR & FLASH_ACR_LATENCY))
+        FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY) | FLatency;
+
+    if (RCC_ClkInitStruct->ClockType & RCC_CLOCKTYPE_HCLK)
+        RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_HPRE) | RCC_ClkInitStruct->AHBCLKDivider;
+    if (RCC_ClkInitStruct->ClockType & RCC_CLOCKTYPE_SYSCLK)
+    {
+        uint32_t sw = RCC_ClkInitStruct->SYSCLKSource;
+
+        if (sw == RCC_SYSCLKSOURCE_PLLCLK && (RCC->CR & RCC_CR_PLLRDY) == 0U)
+            return HAL_ERROR;
+        if (sw != RCC_SYSCLKSOURCE_PLLCLK && sw != RCC_SYSCLKSOURCE_HSI)
+            return HAL_ERROR;
+        RCC->CFGR = (RCC->CFGR & ~(RCC_CFGR_SW | RCC_CFGR_SWS)) | sw | (sw << RCC_CFGR_SWS_Pos);
+    }
+    SimRcc_Check();
+
+    if (FLatency < (FLASH->ACR & FLASH_ACR_LATENCY))
+    {
+        FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY) | FLatency;
+        SimRcc_Check();
+    }
+    if (RCC_ClkInitStruct->ClockType & RCC_CLOCKTYPE_PCLK1)
+        RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_PPRE) | RCC_ClkInitStruct->APB1CLKDivider;
+
+    SystemCoreClock = HAL_RCC_GetSysClockFreq() >> SimRcc_AhbShift();
+    return HAL_InitTick(uwTickPrio);
+}
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit)
+{
+    if (PeriphClkInit->PeriphClockSelection & RCC_PERIPHCLK_ADC)
+        RCC->CCIPR = (RCC->CCIPR & ~RCC_CCIPR_ADCSEL) | PeriphClkInit->AdcClockSelection;
+    return HAL_OK;
+}
+
+uint32_t HAL_PWREx_GetVoltageRange(void)
+{
+    return PWR->CR1 & PWR_CR1_VOS;
+}
+
+HAL_StatusTypeDef HAL_PWREx_ControlVoltageScaling(uint32_t VoltageScaling)
+{
+    uint32_t from = PWR->CR1 & PWR_CR1_VOS;
+
+    PWR->CR1 = (PWR->CR1 & ~PWR_CR1_VOS) | VoltageScaling;
+    SimRcc_Check();
+    // Subir para a faixa 1 espera VOSF; descer é imediato
+    if (from != VoltageScaling && VoltageScaling == PWR_REGULATOR_VOLTAGE_SCALE1)
+        Sim_SpinUntil(Sim_Now() + Sim_CyclesFromUs(SIM_PWR_VOS_US));
+    Sim_Consume(SIM_COST_PWR_CONFIG);
+    return HAL_OK;
+}
+
+void HAL_PWREx_EnableLowPowerRunMode(void)
+{
+    PWR->CR1 |= PWR_CR1_LPR;
+    PWR->SR2 |= PWR_SR2_REGLPF;
+    SimRcc_Check();
+    Sim_Consume(SIM_COST_PWR_CONFIG);
+}
+
+HAL_StatusTypeDef HAL_PWREx_DisableLowPowerRunMode(void)
+{
+    PWR->CR1 &= ~PWR_CR1_LPR;
+    Sim_SpinUntil(Sim_Now() + Sim_CyclesFromUs(SIM_PWR_VOS_US));
+    PWR->SR2 &= ~PWR_SR2_REGLPF;
+    Sim_Consume(SIM_COST_PWR_CONFIG);
+    return HAL_OK;
+}
+
+void HAL_PWR_EnableBkUpAccess(void)
+{
+    PWR->CR1 |= PWR_CR1_DBP;
+}
+
+// Como na HAL: o regulador pedido vale também depois de acordar, então
+// PWR_MAINREGULATOR_ON em low-power run sai dele antes do WFI
+void HAL_PWR_EnterSLEEPMode(uint32_t Regulator, uint8_t SLEEPEntry)
+{
+    (void)SLEEPEntry;
+    Sim_Consume(SIM_COST_PWR_LOW_POWER);
+    if (Regulator != PWR_MAINREGULATOR_ON)
+    {
+        if ((PWR->SR2 & PWR_SR2_REGLPF) == 0U)
+            HAL_PWREx_EnableLowPowerRunMode();
+    }
+    else if ((PWR->SR2 & PWR_SR2_REGLPF) && HAL_PWREx_DisableLowPowerRunMode() != HAL_OK)
+        return;
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+    __WFI();
+}
+
+// STOP 0 ou 1 conforme o regulador. Ao acordar: PLL desligado e SYSCLK no
+// HSISYS (HSIDIV mantido), depois de tWUSTOP1
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry)
+{
+    (void)STOPEntry;
+    Sim_Consume(SIM_COST_PWR_LOW_POWER);
+    PWR->CR1 = (PWR->CR1 & ~PWR_CR1_LPMS)
+             | ((Regulator != PWR_MAINREGULATOR_ON) ? PWR_LOWPOWERMODE_STOP1 : PWR_LOWPOWERMODE_STOP0);
+    SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+    if (Sim_EnterStop(Sim_CyclesFromUs(SIM_PWR_STOP1_WAKE_US)))
+    {
+        RCC->CR &= ~(RCC_CR_PLLON | RCC_CR_PLLRDY);
+        RCC->CFGR &= ~(RCC_CFGR_SW | RCC_CFGR_SWS);
+        SystemCoreClock = SimRcc_HsisysHz() >> SimRcc_AhbShift();
+        SimRcc_Check();
+        Sim_ExitStop();
+    }
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+}
@@ -0,0 +1,652 @@
+/**
+  ******************************************************************************
+  * @file    host_hal_tim.c
+  * @brief   HAL TIM simulada: configuração de PWM/dead-time refletida nos
+  *          registradores em RAM (PSC, ARR, CCRx, CCER, BDTR).
+  *
+  *          O evento de update só é modelado quando alguém o observa (UIE,
+  *          UDE ou TRGO = update): um PWM de poucos ciclos de período
+  *          geraria eventos demais para o relógio virtual sem mudar nada.
+  *          O contador de repetição (RCR) espaça os updates, e com UDE cada
+  *          update pede um DMA; em modo burst o valor escrito em DMAR vai
+  *          para o registrador apontado por DCR.
+  *          Escritas diretas em CR1/DIER (fora da HAL) são percebidas por
+  *          SimTim_Sync(), chamada pelo núcleo a cada avanço do relógio;
+  *          ligar o UIE com o UIF já em 1 pede a interrupção, como no alvo.
+  *
+  *          O contador (CNT, só contagem crescente) sai da posição em ciclos
+  *          do clock de timer desde o último update, como no alvo: o PSC
+  *          tem sombra, carregada no update ou num UG (EGR), e uma troca
+  *          do clock de timer no meio do período muda só o ritmo do que
+  *          falta. Com o timer parado, o CNT escrito pelo firmware vale na
+  *          partida; com ele rodando, escritas no CNT são ignoradas. O UG
+  *          não marca UIF (o firmware usa URS ou limpa a flag), e no STOP
+  *          o contador de um timer sem update observado não congela.
+  *          O break (EGR.BG ou Sim_SystemBreak) zera MOE e marca BIF/SBIF;
+  *          com a fonte do sistema mantida (Sim_HoldSystemBreak), as flags
+  *          não aceitam ser limpas e o MOE não volta. A saída automática
+  *          (AOE) não é modelada.
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "stm32g0xx_hal.h"
+#include "host_sim.h"
+
+#define SIM_TIM_COUNT 8
+
+static TIM_TypeDef *const sim_timers[SIM_TIM_COUNT] = { TIM1, TIM3, TIM6, TIM7, TIM14, TIM15, TIM16, TIM17 };
+static uint8_t armed[SIM_TIM_COUNT];
+static uint8_t break_held[SIM_TIM_COUNT];  // Fonte do break do sistema ainda ativa
+static uint8_t uie_seen[SIM_TIM_COUNT];    // UIE no último SimTim_Sync
+
+// Posição do contador: 'cycles' ciclos do clock de timer desde o último
+// update, medidos em 'origin', mais o que passou desde então em 'hz'
+typedef struct
+{
+    uint64_t origin;
+    uint64_t cycles;
+    uint32_t psc;        // Sombra do PSC
+    uint32_t hz;
+    uint8_t counting;    // CEN visto pelo modelo
+} SimTim_Counter;
+
+static SimTim_Counter counters[SIM_TIM_COUNT];
+
+static volatile uint32_t *SimTim_Ccr(TIM_TypeDef *tim, uint32_t channel)
+{
+    switch (channel)
+    {
+    case TIM_CHANNEL_1: return &tim->CCR1;
+    case TIM_CHANNEL_2: return &tim->CCR2;
+    case TIM_CHANNEL_3: return &tim->CCR3;
+    default:            return &tim->CCR4;
+    }
+}
+
+static uint32_t SimTim_CcerShift(uint32_t channel)
+{
+    // TIM_CHANNEL_1..4 = 0x0, 0x4, 0x8, 0xC: mesmo deslocamento do CCER
+    return channel & 0x1FU;
+}
+
+static IRQn_Type SimTim_UpdateIrq(const TIM_TypeDef *tim)
+{
+    if (tim == TIM1)  return TIM1_BRK_UP_TRG_COM_IRQn;
+    if (tim == TIM3)  return TIM3_IRQn;
+    if (tim == TIM6)  return TIM6_IRQn;
+    if (tim == TIM7)  return TIM7_IRQn;
+    if (tim == TIM14) return TIM14_IRQn;
+    if (tim == TIM15) return TIM15_IRQn;
+    if (tim == TIM16) return TIM16_IRQn;
+    return TIM17_IRQn;
+}
+
+static uint32_t SimTim_UpdateRequest(const TIM_TypeDef *tim)
+{
+    if (tim == TIM1)  return DMA_REQUEST_TIM1_UP;
+    if (tim == TIM3)  return DMA_REQUEST_TIM3_UP;
+    if (tim == TIM6)  return DMA_REQUEST_TIM6_UP;
+    if (tim == TIM7)  return DMA_REQUEST_TIM7_UP;
+    if (tim == TIM15) return DMA_REQUEST_TIM15_UP;
+    if (tim == TIM16) return DMA_REQUEST_TIM16_UP;
+    if (tim == TIM17) return DMA_REQUEST_TIM17_UP;
+    return 0U;
+}
+
+// Período de update em ciclos do clock de timer, com o PSC da sombra
+static uint64_t SimTim_PeriodCycles(const TIM_TypeDef *tim, const SimTim_Counter *c)
+{
+    uint64_t period = (uint64_t)(c->psc + 1U) * (uint64_t)(tim->ARR + 1U);
+
+    if (IS_TIM_REPETITION_COUNTER_INSTANCE(tim))
+        period *= (uint64_t)(tim->RCR + 1U);
+    return period;
+}
+
+// Ciclos desde o último update, agora
+static uint64_t SimTim_Position(const SimTim_Counter *c)
+{
+    if (!c->counting)
+        return c->cycles;
+    return c->cycles + (Sim_Now() - c->origin) * c->hz / SIM_CLOCK_HZ;
+}
+
+// Fixa a posição de agora como nova origem
+static void SimTim_Fold(SimTim_Counter *c)
+{
+    c->cycles = SimTim_Position(c);
+    c->origin = Sim_Now();
+}
+
+// Zera o contador e carrega a sombra do PSC (update ou UG)
+static void SimTim_Restart(TIM_TypeDef *tim, SimTim_Counter *c)
+{
+    c->cycles = 0;
+    c->origin = Sim_Now();
+    c->psc = tim->PSC;
+    tim->CNT = 0;
+}
+
+static int SimTim_UpdateObserved(const TIM_TypeDef *tim)
+{
+    return (tim->DIER & (TIM_DIER_UIE | TIM_DIER_UDE)) != 0U
+        || (tim->CR2 & TIM_CR2_MMS) == TIM_TRGO_UPDATE;
+}
+
+// Requisição de DMA do update. Com DCR configurado, cada transferência
+// entra em DMAR e o timer a copia para DBA, DBA + 1, ... (DBL + 1 vezes).
+// DCR = 0 é tratado como DMA direto a um registrador.
+static void SimTim_UpdateDma(TIM_TypeDef *tim)
+{
+    uint32_t request = SimTim_UpdateRequest(tim);
+    uint32_t base = (tim->DCR & TIM_DCR_DBA) >> TIM_DCR_DBA_Pos;
+    uint32_t count = ((tim->DCR & TIM_DCR_DBL) >> TIM_DCR_DBL_Pos) + 1U;
+
+    if (request == 0U)
+        return;
+    if (tim->DCR == 0U)
+    {
+        SimDma_Request(request);
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (!SimDma_Request(request))
+            break;
+        ((volatile uint32_t *)tim)[base + i] = tim->DMAR;
+    }
+}
+
+static uint32_t SimTim_Index(const TIM_TypeDef *tim)
+{
+    uint32_t i = 0;
+
+    while (i < SIM_TIM_COUNT && sim_timers[i] != tim)
+        i++;
+    return i;
+}
+
+static int SimTim_Running(const TIM_TypeDef *tim)
+{
+    return (tim->CR1 & TIM_CR1_CEN) && SimTim_UpdateObserved(tim);
+}
+
+// Próximo update, da posição atual até o fim do período
+static void SimTim_ScheduleUpdate(TIM_TypeDef *tim, uint32_t idx);
+
+static void SimTim_UpdateEvent(void *arg)
+{
+    TIM_TypeDef *tim = (TIM_TypeDef *)arg;
+    uint32_t idx = SimTim_Index(tim);
+
+    armed[idx] = 0;
+    if (!SimTim_Running(tim))
+        return;
+
+    SimTim_Restart(tim, &counters[idx]);
+    // One-pulse: o update zera CEN e o contador para
+    if (tim->CR1 & TIM_CR1_OPM)
+    {
+        tim->CR1 &= ~TIM_CR1_CEN;
+        counters[idx].counting = 0;
+    }
+    else
+        SimTim_ScheduleUpdate(tim, idx);
+    tim->SR |= TIM_SR_UIF;
+    if ((tim->CR2 & TIM_CR2_MMS) == TIM_TRGO_UPDATE)
+        SimAdc_ExternalTrigger(tim);
+    if (tim->DIER & TIM_DIER_UDE)
+        SimTim_UpdateDma(tim);
+    if (tim->DIER & TIM_DIER_UIE)
+        Sim_RaiseIRQ(SimTim_UpdateIrq(tim));
+}
+
+// Break: MOE cai na hora, as saídas vão para o nível de repouso
+static void SimTim_Break(TIM_TypeDef *tim, uint32_t flags)
+{
+    tim->BDTR &= ~TIM_BDTR_MOE;
+    tim->SR |= flags;
+    if (tim->DIER & TIM_DIER_BIE)
+        Sim_RaiseIRQ(SimTim_UpdateIrq(tim));
+}
+
+void Sim_SystemBreak(TIM_TypeDef *tim)
+{
+    if (IS_TIM_BREAK_INSTANCE(tim))
+        SimTim_Break(tim, TIM_SR_BIF | TIM_SR_SBIF);
+}
+
+void Sim_HoldSystemBreak(TIM_TypeDef *tim, uint8_t held)
+{
+    uint32_t i = SimTim_Index(tim);
+
+    if (i == SIM_TIM_COUNT || !IS_TIM_BREAK_INSTANCE(tim))
+        return;
+    if (held && !break_held[i])
+        SimTim_Break(tim, TIM_SR_BIF | TIM_SR_SBIF);
+    break_held[i] = held;
+}
+
+static void SimTim_ScheduleUpdate(TIM_TypeDef *tim, uint32_t idx)
+{
+    SimTim_Counter *c = &counters[idx];
+    uint64_t period = SimTim_PeriodCycles(tim, c);
+    uint64_t done = SimTim_Position(c);
+
+    Sim_Schedule(Sim_Now() + Sim_TicksFromHz((done < period) ? period - done : 0U, c->hz),
+                 SimTim_UpdateEvent, tim);
+    armed[idx] = 1;
+}
+
+// CEN ligado ou desligado: o contador para onde está e recomeça do CNT
+static void SimTim_Count(TIM_TypeDef *tim, SimTim_Counter *c)
+{
+    uint8_t on = (tim->CR1 & TIM_CR1_CEN) ? 1U : 0U;
+
+    if (on == c->counting)
+        return;
+    if (on)
+    {
+        c->cycles = (uint64_t)tim->CNT * (c->psc + 1U);
+        c->origin = Sim_Now();
+    }
+    else
+        SimTim_Fold(c);
+    c->counting = on;
+}
+
+// UG escrito no EGR: contador zerado e PSC carregado
+static void SimTim_Generate(TIM_TypeDef *tim, uint32_t idx)
+{
+    if ((tim->EGR & TIM_EGR_UG) == 0U)
+        return;
+    tim->EGR &= ~TIM_EGR_UG;
+    SimTim_Restart(tim, &counters[idx]);
+    if (armed[idx])
+    {
+        Sim_Cancel(SimTim_UpdateEvent, tim);
+        SimTim_ScheduleUpdate(tim, idx);
+    }
+}
+
+// (Re)agenda o próximo update conforme a posição atual do contador
+static void SimTim_Arm(TIM_TypeDef *tim)
+{
+    uint32_t idx = SimTim_Index(tim);
+
+    SimTim_Generate(tim, idx);
+    SimTim_Count(tim, &counters[idx]);
+    Sim_Cancel(SimTim_UpdateEvent, tim);
+    armed[idx] = 0;
+    if (SimTim_Running(tim))
+        SimTim_ScheduleUpdate(tim, idx);
+}
+
+// CNT de agora. Sem update observado, as voltas são dadas aqui mesmo (a
+// primeira carrega a sombra do PSC); com ele, o update ainda na fila deixa
+// o contador no topo, sem voltar a 0 antes de UIF.
+static void SimTim_UpdateCnt(TIM_TypeDef *tim, uint32_t idx)
+{
+    SimTim_Counter *c = &counters[idx];
+    uint64_t period = SimTim_PeriodCycles(tim, c);
+    uint64_t pos = SimTim_Position(c);
+
+    if (pos >= period)
+    {
+        if (armed[idx])
+        {
+            tim->CNT = tim->ARR;
+            return;
+        }
+        SimTim_Fold(c);
+        c->cycles -= period;
+        c->psc = tim->PSC;
+        c->cycles %= SimTim_PeriodCycles(tim, c);
+        pos = c->cycles;
+    }
+    tim->CNT = (uint32_t)((pos / (c->psc + 1U)) % (tim->ARR + 1U));
+}
+
+// Percebe timers ligados ou desligados por escrita direta de registrador,
+// UG e trocas do clock de timer
+void SimTim_Sync(void)
+{
+    uint32_t hz = Sim_TimerClockHz();
+
+    for (uint32_t i = 0; i < SIM_TIM_COUNT; i++)
+    {
+        TIM_TypeDef *tim = sim_timers[i];
+        SimTim_Counter *c = &counters[i];
+
+        // O que passou foi no clock antigo; o resto do período, no novo
+        if (hz != c->hz)
+        {
+            SimTim_Fold(c);
+            c->hz = hz;
+            if (armed[i])
+            {
+                Sim_Cancel(SimTim_UpdateEvent, tim);
+                SimTim_ScheduleUpdate(tim, i);
+            }
+        }
+        // BG vale com ou sem BKE; o bit volta a zero sozinho
+        if (tim->EGR & TIM_EGR_BG)
+        {
+            tim->EGR &= ~TIM_EGR_BG;
+            if (IS_TIM_BREAK_INSTANCE(tim))
+                SimTim_Break(tim, TIM_SR_BIF);
+        }
+        // Fonte mantida: o SBIF e o MOE = 0 voltam assim que o firmware mexe
+        if (break_held[i])
+        {
+            tim->SR |= TIM_SR_BIF | TIM_SR_SBIF;
+            tim->BDTR &= ~TIM_BDTR_MOE;
+        }
+        if ((tim->DIER & TIM_DIER_UIE) && !uie_seen[i] && (tim->SR & TIM_SR_UIF))
+            Sim_RaiseIRQ(SimTim_UpdateIrq(tim));
+        uie_seen[i] = (tim->DIER & TIM_DIER_UIE) != 0U;
+        SimTim_Generate(tim, i);
+        if (SimTim_Running(tim) != armed[i] || ((tim->CR1 & TIM_CR1_CEN) != 0U) != c->counting)
+            SimTim_Arm(tim);
+        if (c->counting)
+            SimTim_UpdateCnt(tim, i);
+    }
+}
+
+// Motivo para não entrar em STOP, ou NULL: um timer com o update
+// observado pararia no meio do trabalho, e uma saída de PWM ligada
+// congelaria num nível qualquer
+const char *SimTim_StopBlocker(void)
+{
+    static const char *const names[SIM_TIM_COUNT] =
+    {
+        "TIM1 rodando", "TIM3 rodando", "TIM6 rodando", "TIM7 rodando",
+        "TIM14 rodando", "TIM15 rodando", "TIM16 rodando", "TIM17 rodando",
+    };
+
+    for (uint32_t i = 0; i < SIM_TIM_COUNT; i++)
+    {
+        TIM_TypeDef *tim = sim_timers[i];
+
+        if (SimTim_Running(tim))
+            return names[i];
+        if (!IS_TIM_BREAK_INSTANCE(tim) || (tim->CR1 & TIM_CR1_CEN) == 0U
+            || (tim->BDTR & TIM_BDTR_MOE) == 0U)
+            continue;
+        for (uint32_t ch = TIM_CHANNEL_1; ch <= TIM_CHANNEL_4; ch += TIM_CHANNEL_2)
+        {
+            if ((tim->CCER & (TIM_CCER_CC1E << SimTim_CcerShift(ch))) && *SimTim_Ccr(tim, ch) != 0U)
+                return "PWM com duty diferente de zero";
+        }
+    }
+    return NULL;
+}
+
+void SimTim_Reset(void)
+{
+    for (uint32_t i = 0; i < SIM_TIM_COUNT; i++)
+    {
+        memset(sim_timers[i], 0, sizeof(TIM_TypeDef));
+        sim_timers[i]->ARR = 0xFFFFU;
+        if (IS_TIM_BREAK_INSTANCE(sim_timers[i]))
+            sim_timers[i]->AF1 = TIM1_AF1_BKINE; // Valor de reset: BKIN ligado
+        armed[i] = 0;
+        break_held[i] = 0;
+        uie_seen[i] = 0;
+        memset(&counters[i], 0, sizeof(counters[i]));
+        counters[i].hz = Sim_TimerClockHz();
+    }
+}
+
+static void SimTim_BaseConfig(TIM_HandleTypeDef *htim)
+{
+    TIM_TypeDef *tim = htim->Instance;
+
+    tim->PSC = htim->Init.Prescaler;
+    tim->ARR = htim->Init.Period;
+    tim->RCR = htim->Init.RepetitionCounter;
+    tim->CR1 = (tim->CR1 & ~(TIM_CR1_DIR | TIM_CR1_CMS | TIM_CR1_CKD | TIM_CR1_ARPE))
+             | htim->Init.CounterMode | htim->Init.ClockDivision | htim->Init.AutoReloadPreload;
+    tim->EGR = TIM_EGR_UG;
+    SimTim_Sync();
+    htim->State = HAL_TIM_STATE_READY;
+    htim->DMABurstState = HAL_DMA_BURST_STATE_READY;
+    Sim_Consume(SIM_COST_TIM_INIT);
+}
+
+// --- API da HAL ---
+
+__weak void HAL_TIM_Base_MspInit(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+__weak void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim)
+{
+    if (htim->State == HAL_TIM_STATE_RESET)
+        HAL_TIM_Base_MspInit(htim);
+    SimTim_BaseConfig(htim);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim)
+{
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    htim->State = HAL_TIM_STATE_BUSY;
+    SimTim_Arm(htim->Instance);
+    Sim_Consume(SIM_COST_TIM_START);
+    return HAL_OK;
+}
+
+__weak void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
+{
+    TIM_TypeDef *tim = htim->Instance;
+
+    Sim_Consume(SIM_COST_TIM_IRQ_HANDLER);
+    if ((tim->SR & TIM_SR_UIF) && (tim->DIER & TIM_DIER_UIE))
+    {
+        tim->SR &= ~TIM_SR_UIF;
+        HAL_TIM_PeriodElapsedCallback(htim);
+    }
+    if ((tim->SR & (TIM_SR_BIF | TIM_SR_SBIF)) && (tim->DIER & TIM_DIER_BIE))
+    {
+        tim->SR &= ~(TIM_SR_BIF | TIM_SR_SBIF);
+        HAL_TIMEx_BreakCallback(htim);
+    }
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef *htim)
+{
+    htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    htim->State = HAL_TIM_STATE_READY;
+    SimTim_Arm(htim->Instance);
+    Sim_Consume(SIM_COST_TIM_START);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim,
+                                                        const TIM_MasterConfigTypeDef *sMasterConfig)
+{
+    TIM_TypeDef *tim = htim->Instance;
+
+    tim->CR2 = (tim->CR2 & ~TIM_CR2_MMS) | sMasterConfig->MasterOutputTrigger;
+    if (IS_TIM_TRGO2_INSTANCE(tim))
+        tim->CR2 = (tim->CR2 & ~TIM_CR2_MMS2) | sMasterConfig->MasterOutputTrigger2;
+    tim->SMCR = (tim->SMCR & ~TIM_SMCR_MSM) | sMasterConfig->MasterSlaveMode;
+    SimTim_Arm(tim);
+    Sim_Consume(SIM_COST_TIM_MASTER_CONFIG);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim)
+{
+    if (htim->State == HAL_TIM_STATE_RESET)
+        HAL_TIM_PWM_MspInit(htim);
+    SimTim_BaseConfig(htim);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, const TIM_OC_InitTypeDef *sConfig,
+                                            uint32_t Channel)
+{
+    TIM_TypeDef *tim = htim->Instance;
+    uint32_t shift = SimTim_CcerShift(Channel);
+    volatile uint32_t *ccmr = (Channel <= TIM_CHANNEL_2) ? &tim->CCMR1 : &tim->CCMR2;
+    uint32_t ccmr_shift = (Channel == TIM_CHANNEL_2 || Channel == TIM_CHANNEL_4) ? 8U : 0U;
+
+    // Como na HAL real: modo PWM com preload de CCRx sempre habilitado
+    *ccmr = (*ccmr & ~((TIM_CCMR1_OC1M | TIM_CCMR1_OC1PE | TIM_CCMR1_OC1FE) << ccmr_shift))
+          | ((sConfig->OCMode | TIM_CCMR1_OC1PE | sConfig->OCFastMode) << ccmr_shift);
+    tim->CCER = (tim->CCER & ~((TIM_CCER_CC1P | TIM_CCER_CC1NP) << shift))
+              | ((sConfig->OCPolarity | sConfig->OCNPolarity) << shift);
+    tim->CR2 = (tim->CR2 & ~((TIM_CR2_OIS1 | TIM_CR2_OIS1N) << (shift / 2U)))
+             | ((sConfig->OCIdleState | sConfig->OCNIdleState) << (shift / 2U));
+    *SimTim_Ccr(tim, Channel) = sConfig->Pulse;
+
+    Sim_Consume(SIM_COST_TIM_CONFIG_CHANNEL);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_ConfigBreakDeadTime(TIM_HandleTypeDef *htim,
+                                                const TIM_BreakDeadTimeConfigTypeDef *sBreakDeadTimeConfig)
+{
+    const TIM_BreakDeadTimeConfigTypeDef *cfg = sBreakDeadTimeConfig;
+
+    htim->Instance->BDTR = (cfg->DeadTime & TIM_BDTR_DTG) | cfg->LockLevel | cfg->OffStateIDLEMode
+                         | cfg->OffStateRunMode | cfg->BreakState | cfg->BreakPolarity
+                         | cfg->AutomaticOutput | (cfg->BreakFilter << TIM_BDTR_BKF_Pos);
+    Sim_Consume(SIM_COST_TIM_CONFIG_CHANNEL);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_ConfigBreakInput(TIM_HandleTypeDef *htim, uint32_t BreakInput,
+                                             const TIMEx_BreakInputConfigTypeDef *sBreakInputConfig)
+{
+    TIM_TypeDef *tim = htim->Instance;
+
+    // Só o pino BKIN existe no G070 (sem comparadores)
+    if (BreakInput != TIM_BREAKINPUT_BRK || sBreakInputConfig->Source != TIM_BREAKINPUTSOURCE_BKIN)
+        return HAL_ERROR;
+    tim->AF1 = (tim->AF1 & ~(TIM1_AF1_BKINE | TIM1_AF1_BKINP))
+             | (sBreakInputConfig->Enable << TIM1_AF1_BKINE_Pos)
+             | (sBreakInputConfig->Polarity << TIM1_AF1_BKINP_Pos);
+    Sim_Consume(SIM_COST_TIM_MASTER_CONFIG);
+    return HAL_OK;
+}
+
+__weak void HAL_TIMEx_BreakCallback(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    TIM_TypeDef *tim = htim->Instance;
+
+    tim->CCER |= TIM_CCER_CC1E << SimTim_CcerShift(Channel);
+    if (IS_TIM_BREAK_INSTANCE(tim))
+        tim->BDTR |= TIM_BDTR_MOE;
+    tim->CR1 |= TIM_CR1_CEN;
+    SimTim_Arm(tim);
+    Sim_Consume(SIM_COST_TIM_START);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    TIM_TypeDef *tim = htim->Instance;
+
+    tim->CCER &= ~(TIM_CCER_CC1E << SimTim_CcerShift(Channel));
+    if ((tim->CCER & (TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E
+                      | TIM_CCER_CC1NE | TIM_CCER_CC2NE | TIM_CCER_CC3NE)) == 0U)
+    {
+        tim->BDTR &= ~TIM_BDTR_MOE;
+        tim->CR1 &= ~TIM_CR1_CEN;
+        SimTim_Arm(tim);
+    }
+    Sim_Consume(SIM_COST_TIM_START);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_PWMN_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    TIM_TypeDef *tim = htim->Instance;
+
+    tim->CCER |= TIM_CCER_CC1NE << SimTim_CcerShift(Channel);
+    tim->BDTR |= TIM_BDTR_MOE;
+    tim->CR1 |= TIM_CR1_CEN;
+    SimTim_Arm(tim);
+    Sim_Consume(SIM_COST_TIM_START);
+    return HAL_OK;
+}
+
+// --- DMA burst ---
+
+static void SimTim_DmaPeriodElapsedCplt(DMA_HandleTypeDef *hdma)
+{
+    TIM_HandleTypeDef *htim = (TIM_HandleTypeDef *)hdma->Parent;
+
+    if (hdma->Init.Mode == DMA_NORMAL)
+        htim->State = HAL_TIM_STATE_READY;
+    HAL_TIM_PeriodElapsedCallback(htim);
+}
+
+static void SimTim_DmaPeriodElapsedHalfCplt(DMA_HandleTypeDef *hdma)
+{
+    HAL_TIM_PeriodElapsedHalfCpltCallback((TIM_HandleTypeDef *)hdma->Parent);
+}
+
+__weak void HAL_TIM_PeriodElapsedHalfCpltCallback(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
+
+// Só a requisição de update, que é a única usada pelo firmware
+HAL_StatusTypeDef HAL_TIM_DMABurst_MultiWriteStart(TIM_HandleTypeDef *htim, uint32_t BurstBaseAddress,
+                                                   uint32_t BurstRequestSrc, const uint32_t *BurstBuffer,
+                                                   uint32_t BurstLength, uint32_t DataLength)
+{
+    DMA_HandleTypeDef *hdma = htim->hdma[TIM_DMA_ID_UPDATE];
+
+    if (htim->DMABurstState == HAL_DMA_BURST_STATE_BUSY)
+        return HAL_BUSY;
+    if (BurstRequestSrc != TIM_DMA_UPDATE || hdma == NULL || BurstBuffer == NULL)
+        return HAL_ERROR;
+
+    htim->DMABurstState = HAL_DMA_BURST_STATE_BUSY;
+    hdma->XferCpltCallback = SimTim_DmaPeriodElapsedCplt;
+    hdma->XferHalfCpltCallback = SimTim_DmaPeriodElapsedHalfCplt;
+    if (SimDma_Start(hdma, &htim->Instance->DMAR, (void *)BurstBuffer, DataLength) != HAL_OK)
+        return HAL_ERROR;
+
+    htim->Instance->DCR = BurstBaseAddress | BurstLength;
+    htim->Instance->DIER |= TIM_DIER_UDE;
+    SimTim_Sync();
+    Sim_Consume(SIM_COST_DMA_START);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_DMABurst_WriteStop(TIM_HandleTypeDef *htim, uint32_t BurstRequestSrc)
+{
+    if (BurstRequestSrc != TIM_DMA_UPDATE)
+        return HAL_ERROR;
+
+    if (htim->hdma[TIM_DMA_ID_UPDATE] != NULL)
+        SimDma_Stop(htim->hdma[TIM_DMA_ID_UPDATE]);
+    htim->Instance->DIER &= ~TIM_DIER_UDE;
+    htim->DMABurstState = HAL_DMA_BURST_STATE_READY;
+    SimTim_Sync();
+    Sim_Consume(SIM_COST_TIM_START);
+    return HAL_OK;
+}
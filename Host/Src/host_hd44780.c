@@ -0,0 +1,262 @@
+/**
+  ******************************************************************************
+  * @file    host_hd44780.c
+  * @brief   HD44780 simulado nos pinos do LCD do main.h, observando o ODR
+  *          pelo modelo de GPIO.
+  *
+  *          Lê o barramento na borda de descida do EN, como o controlador:
+  *          inicialização por instrução em 8 bits, passagem para 4 bits,
+  *          DDRAM de duas linhas e o busy flag com os tempos de execução do
+  *          datasheet escalados para o fosc do modelo (270 kHz típico, de
+  *          190 a 350 kHz). Com R/W ligado a um pino, EN em 1 e R/W em 1
+  *          faz o modelo dirigir D4-D7 (BF e contador de endereço).
+  *
+  *          Confere o timing do lado do MCU (Vcc = 3 V, o pior caso):
+  *          largura do pulso de EN, ciclo do EN, setup de RS/RW e dos dados
+  *          antes das bordas, e qualquer escrita com o controlador ocupado
+  *          (que o HD44780 real perderia: aqui ela é descartada também).
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "stm32g0xx_hal.h"
+#include "host_sim.h"
+#include "main.h"
+
+// Tempos do datasheet em ns (HD44780U, Vcc = 2,7 a 4,5 V)
+#define LCD_T_PWEH_NS     450U    // Largura do pulso de EN
+#define LCD_T_CYCE_NS     1000U   // Ciclo do EN
+#define LCD_T_AS_NS       60U     // Setup de RS e R/W antes do EN subir
+#define LCD_T_DSW_NS      195U    // Setup dos dados antes do EN descer
+#define LCD_POWER_ON_MS   40U     // Vcc estável até a primeira instrução
+
+#define LCD_FOSC_REF_HZ   270000U
+#define LCD_EXEC_NS       37000U  // A 270 kHz
+#define LCD_CLEAR_NS      1520000U
+#define LCD_DDRAM_SIZE    0x80U
+
+static struct
+{
+    uint32_t fosc_hz;
+    GPIO_TypeDef *rw_port;        // NULL: R/W aterrado
+    uint16_t rw_pin;
+
+    uint8_t four_bit;
+    uint8_t half;                 // Primeiro nibble do par já passou (4 bits)
+    uint8_t high;
+    uint8_t increment;
+    uint8_t ac;                   // Contador de endereço da DDRAM
+    uint8_t ddram[LCD_DDRAM_SIZE];
+    uint64_t busy_until;
+    uint64_t power_on;
+
+    // Últimos níveis e quando mudaram
+    uint8_t en, rs, rw, data;
+    uint64_t t_en_rise, t_ctrl, t_data;
+
+    SimLcd_Stats stats;
+} lcd;
+
+static uint64_t SimLcd_Ns(uint64_t ticks)
+{
+    return ticks * 1000000000ULL / SIM_CLOCK_HZ;
+}
+
+static uint64_t SimLcd_ExecTicks(uint32_t ns_at_ref)
+{
+    return Sim_CyclesFromUs(1) * ns_at_ref / 1000U * LCD_FOSC_REF_HZ / lcd.fosc_hz;
+}
+
+static uint8_t SimLcd_Level(GPIO_TypeDef *port, uint16_t pin)
+{
+    return (port->ODR & pin) ? 1U : 0U;
+}
+
+static uint8_t SimLcd_Data(void)
+{
+    return (uint8_t)(SimLcd_Level(LCD_D4_GPIO_Port, LCD_D4_Pin) | SimLcd_Level(LCD_D5_GPIO_Port, LCD_D5_Pin) << 1
+                     | SimLcd_Level(LCD_D6_GPIO_Port, LCD_D6_Pin) << 2 | SimLcd_Level(LCD_D7_GPIO_Port, LCD_D7_Pin) << 3);
+}
+
+// Nibble que o controlador põe em D4-D7 numa leitura
+static void SimLcd_Drive(uint8_t nibble)
+{
+    Sim_SetPinLevel(LCD_D4_GPIO_Port, LCD_D4_Pin, (nibble & 0x1U) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    Sim_SetPinLevel(LCD_D5_GPIO_Port, LCD_D5_Pin, (nibble & 0x2U) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    Sim_SetPinLevel(LCD_D6_GPIO_Port, LCD_D6_Pin, (nibble & 0x4U) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    Sim_SetPinLevel(LCD_D7_GPIO_Port, LCD_D7_Pin, (nibble & 0x8U) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
+
+// O MCU também dirigindo o barramento numa leitura: disputa
+static uint8_t SimLcd_McuDrivesBus(void)
+{
+    static const struct { GPIO_TypeDef *port; uint16_t pin; } pins[4] = {
+        { LCD_D4_GPIO_Port, LCD_D4_Pin }, { LCD_D5_GPIO_Port, LCD_D5_Pin },
+        { LCD_D6_GPIO_Port, LCD_D6_Pin }, { LCD_D7_GPIO_Port, LCD_D7_Pin },
+    };
+
+    for (int i = 0; i < 4; i++)
+    {
+        uint32_t pos = (uint32_t)__builtin_ctz(pins[i].pin);
+
+        if (((pins[i].port->MODER >> (2U * pos)) & 0x3U) == 0x1U)
+            return 1;
+    }
+    return 0;
+}
+
+static void SimLcd_Execute(uint8_t rs, uint8_t value)
+{
+    uint64_t now = Sim_Now();
+    uint32_t exec = LCD_EXEC_NS;
+
+    if (now < lcd.busy_until || now < lcd.power_on + Sim_CyclesFromMs(LCD_POWER_ON_MS))
+    {
+        lcd.stats.busy_writes++;
+        return;
+    }
+    lcd.stats.instructions++;
+
+    if (rs)
+    {
+        lcd.ddram[lcd.ac & (LCD_DDRAM_SIZE - 1U)] = value;
+        lcd.ac = (uint8_t)(lcd.increment ? lcd.ac + 1U : lcd.ac - 1U) & (LCD_DDRAM_SIZE - 1U);
+        lcd.stats.chars++;
+    }
+    else if (value & 0x80U)
+        lcd.ac = value & 0x7FU;
+    else if (value & 0x40U)
+    {
+        // Endereço da CGRAM: o firmware não usa caracteres próprios
+    }
+    else if (value & 0x20U)
+        lcd.four_bit = (value & 0x10U) ? 0U : 1U;   // Function set: DL
+    else if (value & 0x04U && value < 0x08U)
+        lcd.increment = (value & 0x02U) ? 1U : 0U;
+    else if (value == 0x01U)
+    {
+        memset(lcd.ddram, ' ', sizeof(lcd.ddram));
+        lcd.ac = 0;
+        lcd.increment = 1;
+        exec = LCD_CLEAR_NS;
+    }
+    else if ((value & 0xFEU) == 0x02U)
+    {
+        lcd.ac = 0;
+        exec = LCD_CLEAR_NS;
+    }
+    lcd.busy_until = now + SimLcd_ExecTicks(exec);
+}
+
+static void SimLcd_Fall(uint64_t now)
+{
+    if (SimLcd_Ns(now - lcd.t_en_rise) < LCD_T_PWEH_NS || SimLcd_Ns(now - lcd.t_data) < LCD_T_DSW_NS)
+        lcd.stats.timing_errors++;
+
+    if (lcd.rw)
+    {
+        // Fim de um nibble de leitura: o barramento volta a ficar solto
+        lcd.half = lcd.four_bit ? (uint8_t)!lcd.half : 0U;
+        return;
+    }
+    if (!lcd.four_bit)
+    {
+        // 8 bits: D0-D3 não ligados, lidos como 0
+        SimLcd_Execute(lcd.rs, (uint8_t)(lcd.data << 4));
+        return;
+    }
+    if (!lcd.half)
+    {
+        lcd.high = lcd.data;
+        lcd.half = 1;
+        return;
+    }
+    lcd.half = 0;
+    SimLcd_Execute(lcd.rs, (uint8_t)((lcd.high << 4) | lcd.data));
+}
+
+static void SimLcd_Rise(uint64_t now)
+{
+    uint64_t as_ns = SimLcd_Ns(now - lcd.t_ctrl);
+
+    if (SimLcd_Ns(now - lcd.t_en_rise) < LCD_T_CYCE_NS || as_ns < LCD_T_AS_NS)
+        lcd.stats.timing_errors++;
+    if (as_ns < lcd.stats.min_as_ns)
+        lcd.stats.min_as_ns = (uint32_t)as_ns;
+    lcd.t_en_rise = now;
+
+    if (lcd.rw)
+    {
+        uint8_t busy = (now < lcd.busy_until) ? 1U : 0U;
+
+        if (SimLcd_McuDrivesBus())
+            lcd.stats.timing_errors++;
+        if (lcd.rs == 0U && !lcd.half)
+        {
+            lcd.stats.reads++;
+            lcd.stats.busy_reads += busy;
+        }
+        SimLcd_Drive(lcd.half ? (uint8_t)(lcd.ac & 0x0FU) : (uint8_t)((busy << 3) | ((lcd.ac >> 4) & 0x7U)));
+    }
+}
+
+static void SimLcd_Watch(GPIO_TypeDef *port, uint32_t old_odr, void *ctx)
+{
+    uint64_t now = Sim_Now();
+    uint8_t en = SimLcd_Level(LCD_EN_GPIO_Port, LCD_EN_Pin);
+    uint8_t rs = SimLcd_Level(LCD_RS_GPIO_Port, LCD_RS_Pin);
+    uint8_t rw = lcd.rw_port ? SimLcd_Level(lcd.rw_port, lcd.rw_pin) : 0U;
+    uint8_t data = SimLcd_Data();
+
+    (void)port;
+    (void)old_odr;
+    (void)ctx;
+    if (rs != lcd.rs || rw != lcd.rw)
+    {
+        // RS/RW mudando com o EN em 1 estraga o ciclo
+        if (lcd.en && en)
+            lcd.stats.timing_errors++;
+        lcd.t_ctrl = now;
+    }
+    if (data != lcd.data)
+        lcd.t_data = now;
+    lcd.rs = rs;
+    lcd.rw = rw;
+    lcd.data = data;
+
+    if (en && !lcd.en)
+    {
+        lcd.en = 1;
+        SimLcd_Rise(now);
+    }
+    else if (!en && lcd.en)
+    {
+        lcd.en = 0;
+        SimLcd_Fall(now);
+    }
+}
+
+void SimLcd_Attach(uint32_t fosc_hz, GPIO_TypeDef *rw_port, uint16_t rw_pin)
+{
+    memset(&lcd, 0, sizeof(lcd));
+    memset(lcd.ddram, ' ', sizeof(lcd.ddram));
+    lcd.stats.min_as_ns = UINT32_MAX;
+    lcd.fosc_hz = fosc_hz ? fosc_hz : LCD_FOSC_REF_HZ;
+    lcd.rw_port = rw_port;
+    lcd.rw_pin = rw_pin;
+    lcd.increment = 1;
+    lcd.power_on = Sim_Now();
+    Sim_SetGpioWatch(SimLcd_Watch, NULL);
+}
+
+const SimLcd_Stats *SimLcd_GetStats(void)
+{
+    return &lcd.stats;
+}
+
+// Linha visível (16 colunas) com terminador
+void SimLcd_Row(uint8_t row, char out[17])
+{
+    memcpy(out, &lcd.ddram[row ? 0x40U : 0x00U], 16);
+    out[16] = '\0';
+}
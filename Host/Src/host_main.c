@@ -0,0 +1,206 @@
+/**
+  ******************************************************************************
+  * @file    host_main.c
+  * @brief   Executável de host: roda o main() do firmware sobre a HAL
+  *          simulada durante um tempo virtual e imprime um resumo.
+  *
+  *          Uso: host_sim [-t ms] [-T graus] [-p botao@inicio_ms:duracao_ms]...
+  *                        [-l arquivo] [-r arquivo] [-u]
+  *            -t  tempo virtual de execução (padrão 10000 ms)
+  *            -T  temperatura do LM35 em °C (padrão 25)
+  *            -p  pressiona um botão (up, down, screen); pode repetir
+  *            -l  grava a imagem do anel do registro de campo no fim
+  *                (para o datalog_decode)
+  *            -r  grava o anel do rastro de execução no fim (para o
+  *                trace_export)
+ *            -u  liga a USART2 da telemetria a um PTY, com o nome em
+ *                stderr (para o telemetry_decode). Com o PTY cheio o
+ *                simulador espera o leitor, e no fim espera ele esvaziar.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "main.h"
+#include "host_sim.h"
+#include "protect.h"
+#include "datalog.h"
+#include "trace.h"
+#include "telemetry.h"
+
+#define MAX_PRESSES 16
+
+typedef struct
+{
+    uint16_t pin;
+    uint32_t start_ms;
+    uint32_t duration_ms;
+} Host_Press;
+
+// --- Estado do firmware observado ---
+extern uint16_t duty_cycle;
+extern uint8_t current_screen;
+extern volatile uint8_t temp_alert_active;
+extern int32_t temperature_cdeg;
+extern uint16_t countdown_timer;
+
+int Firmware_Main(void);
+
+static Host_Press presses[MAX_PRESSES];
+static int press_count;
+
+static void Host_Entry(void)
+{
+    Firmware_Main();
+}
+
+static void Host_ButtonDown(void *arg)
+{
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, (uint16_t)(uintptr_t)arg, GPIO_PIN_RESET);
+}
+
+static void Host_ButtonUp(void *arg)
+{
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, (uint16_t)(uintptr_t)arg, GPIO_PIN_SET);
+}
+
+static int Host_ParsePress(const char *arg, Host_Press *press)
+{
+    char name[16];
+    unsigned start, duration;
+
+    if (sscanf(arg, "%15[a-z]@%u:%u", name, &start, &duration) != 3)
+        return -1;
+    if (strcmp(name, "up") == 0)
+        press->pin = BUTTON_UP;
+    else if (strcmp(name, "down") == 0)
+        press->pin = BUTTON_DOWN;
+    else if (strcmp(name, "screen") == 0)
+        press->pin = BUTTON_SCREEN;
+    else
+        return -1;
+    press->start_ms = start;
+    press->duration_ms = duration;
+    return 0;
+}
+
+static void Host_Usage(const char *prog)
+{
+    fprintf(stderr, "uso: %s [-t ms] [-T graus] [-p botao@inicio_ms:duracao_ms]... [-l arquivo] [-r arquivo]"
+            " [-u]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t run_ms = 10000;
+    double temp_c = 25.0;
+    const char *log_path = NULL;
+    const char *trace_path = NULL;
+    int use_pty = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            run_ms = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc)
+            temp_c = strtod(argv[++i], NULL);
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+            log_path = argv[++i];
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            trace_path = argv[++i];
+        else if (strcmp(argv[i], "-u") == 0)
+            use_pty = 1;
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc && press_count < MAX_PRESSES)
+        {
+            if (Host_ParsePress(argv[++i], &presses[press_count]) != 0)
+                Host_Usage(argv[0]);
+            press_count++;
+        }
+        else
+            Host_Usage(argv[0]);
+    }
+
+    Sim_Reset();
+    SimLcd_Attach(0, NULL, 0);   // HD44780 típico, R/W aterrado como na placa
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_UP | BUTTON_DOWN | BUTTON_SCREEN, GPIO_PIN_SET);
+    // LM35: 10 mV/°C
+    Sim_SetAnalogMillivolts(ADC_CHANNEL_2, (uint32_t)(temp_c * 10.0 + 0.5));
+
+    for (int i = 0; i < press_count; i++)
+    {
+        void *pin = (void *)(uintptr_t)presses[i].pin;
+        Sim_Schedule(Sim_CyclesFromMs(presses[i].start_ms), Host_ButtonDown, pin);
+        Sim_Schedule(Sim_CyclesFromMs(presses[i].start_ms + presses[i].duration_ms), Host_ButtonUp, pin);
+    }
+
+    if (use_pty)
+    {
+        char name[64];
+
+        if (SimUsart_OpenPty(name, sizeof(name)) < 0)
+        {
+            perror("pty");
+            return 1;
+        }
+        fprintf(stderr, "telemetria em %s\n", name);
+    }
+
+    Sim_Run(Host_Entry, Sim_CyclesFromMs(run_ms));
+    SimUsart_ClosePty();
+
+    printf("tempo virtual      : %llu ms (%llu ciclos @ %lu Hz)\n",
+           (unsigned long long)(Sim_Micros() / 1000U), (unsigned long long)Sim_Now(),
+           (unsigned long)SystemCoreClock);
+    printf("ciclos em ISR      : %llu\n", (unsigned long long)Sim_IsrCycles());
+    printf("HAL_GetTick        : %lu ms\n", (unsigned long)uwTick);
+    printf("duty_cycle         : %u %% (CCR1=%lu ARR=%lu)\n", duty_cycle,
+           (unsigned long)TIM1->CCR1, (unsigned long)TIM1->ARR);
+    printf("temperatura        : %d.%02d C (alerta=%u)\n", (int)(temperature_cdeg / 100), (int)(temperature_cdeg % 100),
+           temp_alert_active);
+    printf("saida PWM (MOE)    : %s%s\n", (TIM1->BDTR & TIM_BDTR_MOE) ? "ligada" : "cortada pelo break",
+           Protect_IsLatched() ? " (travada)" : "");
+    printf("countdown_timer    : %u s\n", countdown_timer);
+    printf("tela atual         : %u\n", current_screen);
+    {
+        char row0[17], row1[17];
+
+        SimLcd_Row(0, row0);
+        SimLcd_Row(1, row1);
+        printf("LCD                : [%s] [%s] (%lu escritas ocupado, %lu erros de timing)\n", row0, row1,
+               (unsigned long)SimLcd_GetStats()->busy_writes, (unsigned long)SimLcd_GetStats()->timing_errors);
+    }
+    printf("registro de campo  : %lu amostras, %lu blocos gravados\n",
+           (unsigned long)DataLog_GetStats()->samples, (unsigned long)DataLog_GetStats()->blocks);
+    if (log_path != NULL)
+    {
+        static uint8_t image[DATALOG_SIZE];
+        FILE *f = fopen(log_path, "wb");
+
+        Sim_FlashDump(DATALOG_ADDR, image, sizeof(image));
+        if (f == NULL || fwrite(image, 1, sizeof(image), f) != sizeof(image))
+        {
+            perror(log_path);
+            return 1;
+        }
+        fclose(f);
+    }
+    printf("telemetria         : %lu quadros, %lu descartados, %llu bytes na linha\n",
+           (unsigned long)Telemetry_GetStats()->frames, (unsigned long)Telemetry_GetStats()->dropped,
+           (unsigned long long)SimUsart_TxBytes());
+    printf("rastro             : %lu eventos gravados (anel de %u)\n", (unsigned long)trace_buffer.head,
+           TRACE_CAPACITY);
+    if (trace_path != NULL)
+    {
+        FILE *f = fopen(trace_path, "wb");
+
+        if (f == NULL || fwrite(&trace_buffer, 1, sizeof(trace_buffer), f) != sizeof(trace_buffer))
+        {
+            perror(trace_path);
+            return 1;
+        }
+        fclose(f);
+    }
+    return 0;
+}
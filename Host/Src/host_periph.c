@@ -0,0 +1,38 @@
+/**
+  ******************************************************************************
+  * @file    host_periph.c
+  * @brief   Blocos de registradores simulados. As macros GPIOA, TIM1, ADC1,
+  *          SysTick, ... apontam para cá via host_port.h.
+  ******************************************************************************
+  */
+
+#include "stm32g0xx.h"
+
+GPIO_TypeDef        Sim_GPIOA;
+GPIO_TypeDef        Sim_GPIOB;
+GPIO_TypeDef        Sim_GPIOC;
+GPIO_TypeDef        Sim_GPIOD;
+GPIO_TypeDef        Sim_GPIOF;
+TIM_TypeDef         Sim_TIM1;
+TIM_TypeDef         Sim_TIM3;
+TIM_TypeDef         Sim_TIM6;
+TIM_TypeDef         Sim_TIM7;
+TIM_TypeDef         Sim_TIM14;
+TIM_TypeDef         Sim_TIM15;
+TIM_TypeDef         Sim_TIM16;
+TIM_TypeDef         Sim_TIM17;
+ADC_TypeDef         Sim_ADC1;
+ADC_Common_TypeDef  Sim_ADC1_COMMON;
+RCC_TypeDef         Sim_RCC;
+PWR_TypeDef         Sim_PWR;
+FLASH_TypeDef       Sim_FLASH;
+EXTI_TypeDef        Sim_EXTI;
+RTC_TypeDef         Sim_RTC;
+SYSCFG_TypeDef      Sim_SYSCFG;
+DMA_TypeDef         Sim_DMA1;
+DMA_Channel_TypeDef Sim_DMA1_Channel[7];
+USART_TypeDef       Sim_USART2;
+DBG_TypeDef         Sim_DBG;
+SysTick_Type        Sim_SysTick;
+NVIC_Type           Sim_NVIC;
+SCB_Type            Sim_SCB;
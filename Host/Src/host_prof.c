@@ -0,0 +1,195 @@
+/**
+  ******************************************************************************
+  * @file    host_prof.c
+  * @brief   Perfilador do simulador de host.
+  *
+  *          - Latência de iteração: ciclos entre dois PROF_LOOP() seguidos.
+  *          - Tarefas: tempo exclusivo (sem tarefas aninhadas e sem ISRs),
+  *            número de chamadas e pior caso inclusivo por chamada.
+  *          As estatísticas começam na primeira passagem por PROF_LOOP(),
+  *          deixando de fora a inicialização.
+  ******************************************************************************
+  */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_prof.h"
+#include "host_sim.h"
+
+#define PROF_MAX_DEPTH   8
+#define PROF_HIST_BINS   24
+
+typedef struct
+{
+    uint64_t calls;
+    uint64_t exclusive;
+    uint64_t worst;
+} Prof_TaskStats;
+
+typedef struct
+{
+    Prof_Task task;
+    uint64_t start;
+    uint64_t isr_start;
+    uint64_t children;
+} Prof_Frame;
+
+#define PROF_TASK_NAME(id, name) name,
+static const char *const task_names[PROF_TASK_COUNT] = { PROF_TASK_LIST(PROF_TASK_NAME) };
+#undef PROF_TASK_NAME
+
+static Prof_TaskStats tasks[PROF_TASK_COUNT];
+static Prof_Frame stack[PROF_MAX_DEPTH];
+static int depth;
+
+static uint64_t *loop_samples;
+static size_t loop_count;
+static size_t loop_capacity;
+static uint64_t loop_last;
+static uint64_t loop_isr_start;
+static uint64_t window_start;
+static int started;
+
+void Prof_Reset(void)
+{
+    memset(tasks, 0, sizeof(tasks));
+    depth = 0;
+    loop_count = 0;
+    started = 0;
+}
+
+// --- Marcadores chamados pelo firmware ---
+
+void Prof_Begin(Prof_Task task)
+{
+    if (depth >= PROF_MAX_DEPTH)
+        return;
+    stack[depth].task = task;
+    stack[depth].start = Sim_Now();
+    stack[depth].isr_start = Sim_IsrCycles();
+    stack[depth].children = 0;
+    depth++;
+}
+
+void Prof_End(Prof_Task task)
+{
+    if (depth == 0 || stack[depth - 1].task != task)
+        return;
+
+    Prof_Frame *f = &stack[--depth];
+    uint64_t inclusive = (Sim_Now() - f->start) - (Sim_IsrCycles() - f->isr_start);
+
+    if (started)
+    {
+        tasks[task].calls++;
+        tasks[task].exclusive += inclusive - f->children;
+        if (inclusive > tasks[task].worst)
+            tasks[task].worst = inclusive;
+    }
+    if (depth > 0)
+        stack[depth - 1].children += inclusive;
+}
+
+void Prof_Loop(void)
+{
+    uint64_t now = Sim_Now();
+
+    if (!started)
+    {
+        started = 1;
+        memset(tasks, 0, sizeof(tasks));
+        window_start = now;
+        loop_isr_start = Sim_IsrCycles();
+    }
+    else
+    {
+        if (loop_count == loop_capacity)
+        {
+            loop_capacity = loop_capacity ? loop_capacity * 2 : 4096;
+            loop_samples = realloc(loop_samples, loop_capacity * sizeof(uint64_t));
+        }
+        loop_samples[loop_count++] = now - loop_last;
+    }
+    loop_last = now;
+}
+
+// --- Relatório ---
+
+static int Prof_Compare(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t Prof_Percentile(const uint64_t *sorted, size_t n, unsigned pct)
+{
+    size_t idx = (n * pct + 99U) / 100U;
+    return sorted[(idx == 0) ? 0 : idx - 1];
+}
+
+void Prof_LoopSummary(Prof_Summary *summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    if (loop_count == 0)
+        return;
+
+    qsort(loop_samples, loop_count, sizeof(uint64_t), Prof_Compare);
+    summary->count = loop_count;
+    summary->p50 = Prof_Percentile(loop_samples, loop_count, 50);
+    summary->p99 = Prof_Percentile(loop_samples, loop_count, 99);
+    summary->max = loop_samples[loop_count - 1];
+    for (size_t i = 0; i < loop_count; i++)
+        summary->total += loop_samples[i];
+}
+
+static double Prof_Us(uint64_t ticks)
+{
+    return (double)ticks * 1e6 / (double)SIM_CLOCK_HZ;
+}
+
+void Prof_Report(FILE *out)
+{
+    Prof_Summary s;
+    uint64_t window = Sim_Now() - window_start;
+    uint64_t isr = Sim_IsrCycles() - loop_isr_start;
+    uint64_t hist[PROF_HIST_BINS] = {0};
+
+    Prof_LoopSummary(&s);
+
+    fprintf(out, "janela medida        : %.1f ms (%llu iteracoes)\n",
+            Prof_Us(window) / 1000.0, (unsigned long long)s.count);
+    fprintf(out, "latencia da iteracao : p50 %.1f us | p99 %.1f us | max %.1f us\n",
+            Prof_Us(s.p50), Prof_Us(s.p99), Prof_Us(s.max));
+
+    // Histograma em potências de 2 de microssegundos
+    for (size_t i = 0; i < s.count; i++)
+    {
+        uint64_t us = (uint64_t)Prof_Us(loop_samples[i]);
+        int bin = 0;
+        while (us > 1 && bin < PROF_HIST_BINS - 1)
+        {
+            us >>= 1;
+            bin++;
+        }
+        hist[bin]++;
+    }
+    fprintf(out, "histograma (us)      :\n");
+    for (int b = 0; b < PROF_HIST_BINS; b++)
+    {
+        if (hist[b] == 0)
+            continue;
+        fprintf(out, "  < %8llu : %8llu\n", 2ULL << b, (unsigned long long)hist[b]);
+    }
+
+    fprintf(out, "%-16s %8s %12s %8s %12s\n", "tarefa", "chamadas", "total (ms)", "% CPU", "pior (us)");
+    for (int t = 0; t < PROF_TASK_COUNT; t++)
+    {
+        fprintf(out, "%-16s %8llu %12.2f %7.2f%% %12.1f\n", task_names[t],
+                (unsigned long long)tasks[t].calls, Prof_Us(tasks[t].exclusive) / 1000.0,
+                window ? 100.0 * (double)tasks[t].exclusive / (double)window : 0.0,
+                Prof_Us(tasks[t].worst));
+    }
+    fprintf(out, "%-16s %8s %12.2f %7.2f%%\n", "ISRs", "-", Prof_Us(isr) / 1000.0,
+            window ? 100.0 * (double)isr / (double)window : 0.0);
+}
@@ -0,0 +1,147 @@
+/**
+  ******************************************************************************
+  * @file    host_rtc.c
+  * @brief   RTC simulado sobre o LSI (32 kHz): partida do LSI, modo INIT,
+  *          contador de subsegundos (SSR) e o wakeup timer, que marca
+  *          WUTF e pede RTC_TAMP_IRQn pela linha 19 do EXTI.
+  *
+  *          O firmware mexe no RTC só por registradores; as escritas são
+  *          percebidas por SimRtc_Sync(), chamada pelo núcleo a cada
+  *          avanço do relógio (inclusive em STOP, onde o RTC segue
+  *          contando). O SSR é calculado do tempo virtual desde a saída do
+  *          INIT, como se BYPSHAD estivesse ligado. A proteção de escrita
+  *          (WPR), o calendário e os alarmes não são modelados.
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "stm32g0xx_hal.h"
+#include "host_sim.h"
+
+#define SIM_LSI_TICKS  (SIM_CLOCK_HZ / LSI_VALUE)   // Ticks por ciclo do LSI
+
+static uint8_t  lsi_on;
+static uint64_t lsi_on_at;
+static uint8_t  in_init;
+static uint64_t origin;          // Saída do INIT: SSR = PREDIV_S
+static uint8_t  wut_enabled;
+static uint64_t wut_period;      // Em ticks
+
+static void SimRtc_Wakeup(void *arg);
+
+void SimRtc_Reset(void)
+{
+    memset(&Sim_RTC, 0, sizeof(Sim_RTC));
+    // Valores de reset do RM0444
+    RTC->PRER = (0x7FUL << RTC_PRER_PREDIV_A_Pos) | (0xFFUL << RTC_PRER_PREDIV_S_Pos);
+    RTC->WUTR = RTC_WUTR_WUT;
+    RTC->ICSR = RTC_ICSR_WUTWF;
+    lsi_on = 0;
+    lsi_on_at = 0;
+    in_init = 0;
+    origin = 0;
+    wut_enabled = 0;
+    wut_period = 0;
+}
+
+// RTCCLK presente: LSI pronto, selecionado em RTCSEL e RTCEN ligado
+static int SimRtc_Clocked(void)
+{
+    return (RCC->CSR & RCC_CSR_LSIRDY) && (RCC->BDCR & RCC_BDCR_RTCEN)
+        && (RCC->BDCR & RCC_BDCR_RTCSEL) == RCC_RTCCLKSOURCE_LSI;
+}
+
+// Período do clock do wakeup timer em ticks: RTCCLK / 16, 8, 4, 2 ou ck_spre
+static uint64_t SimRtc_WutClockTicks(void)
+{
+    uint32_t wucksel = (RTC->CR & RTC_CR_WUCKSEL) >> RTC_CR_WUCKSEL_Pos;
+    uint32_t prediv_a = (RTC->PRER & RTC_PRER_PREDIV_A) >> RTC_PRER_PREDIV_A_Pos;
+    uint32_t prediv_s = (RTC->PRER & RTC_PRER_PREDIV_S) >> RTC_PRER_PREDIV_S_Pos;
+
+    if (wucksel < 4U)
+        return (uint64_t)SIM_LSI_TICKS << (4U - wucksel);
+    return (uint64_t)SIM_LSI_TICKS * (prediv_a + 1U) * (prediv_s + 1U);
+}
+
+static void SimRtc_Wakeup(void *arg)
+{
+    (void)arg;
+    RTC->SR |= RTC_SR_WUTF;
+    if (RTC->CR & RTC_CR_WUTIE)
+    {
+        RTC->MISR |= RTC_MISR_WUTMF;
+        if (EXTI->IMR1 & EXTI_IMR1_IM19)
+            Sim_RaiseIRQ(RTC_TAMP_IRQn);
+    }
+    // Recarrega sozinho enquanto WUTE estiver ligado
+    Sim_Schedule(Sim_Now() + wut_period, SimRtc_Wakeup, NULL);
+}
+
+void SimRtc_Sync(void)
+{
+    uint64_t now = Sim_Now();
+    uint32_t prediv_a, prediv_s;
+    uint64_t count;
+
+    // LSI: LSIRDY tSU(LSI) depois de LSION
+    if ((RCC->CSR & RCC_CSR_LSION) == 0U)
+    {
+        lsi_on = 0;
+        RCC->CSR &= ~RCC_CSR_LSIRDY;
+    }
+    else if (!lsi_on)
+    {
+        lsi_on = 1;
+        lsi_on_at = now;
+    }
+    if (lsi_on && now >= lsi_on_at + Sim_CyclesFromUs(SIM_RCC_LSI_START_US))
+        RCC->CSR |= RCC_CSR_LSIRDY;
+
+    // Escrita de 1 em SCR limpa a flag correspondente de SR
+    if (RTC->SCR & RTC_SCR_CWUTF)
+    {
+        RTC->SR &= ~RTC_SR_WUTF;
+        RTC->MISR &= ~RTC_MISR_WUTMF;
+    }
+    RTC->SCR = 0;
+
+    if (!SimRtc_Clocked())
+        return;
+
+    // INIT: contadores parados; na saída, o SSR recomeça de PREDIV_S
+    if (RTC->ICSR & RTC_ICSR_INIT)
+    {
+        RTC->ICSR |= RTC_ICSR_INITF;
+        in_init = 1;
+    }
+    else if (in_init)
+    {
+        RTC->ICSR &= ~RTC_ICSR_INITF;
+        in_init = 0;
+        origin = now;
+    }
+    prediv_a = (RTC->PRER & RTC_PRER_PREDIV_A) >> RTC_PRER_PREDIV_A_Pos;
+    prediv_s = (RTC->PRER & RTC_PRER_PREDIV_S) >> RTC_PRER_PREDIV_S_Pos;
+    count = (in_init ? 0U : (now - origin) / SIM_LSI_TICKS) / (prediv_a + 1U);
+    RTC->SSR = prediv_s - (uint32_t)(count % (prediv_s + 1U));
+    RTC->ICSR |= RTC_ICSR_RSF;
+
+    // Wakeup timer: WUTWF com WUTE desligado; na subida de WUTE, o
+    // primeiro WUTF sai WUT + 1 períodos do clock selecionado depois
+    if ((RTC->CR & RTC_CR_WUTE) == 0U)
+    {
+        RTC->ICSR |= RTC_ICSR_WUTWF;
+        if (wut_enabled)
+        {
+            Sim_Cancel(SimRtc_Wakeup, NULL);
+            wut_enabled = 0;
+        }
+    }
+    else if (!wut_enabled)
+    {
+        RTC->ICSR &= ~RTC_ICSR_WUTWF;
+        wut_enabled = 1;
+        wut_period = ((uint64_t)(RTC->WUTR & RTC_WUTR_WUT) + 1U) * SimRtc_WutClockTicks();
+        Sim_Schedule(now + wut_period, SimRtc_Wakeup, NULL);
+    }
+}
@@ -0,0 +1,529 @@
+/**
+  ******************************************************************************
+  * @file    host_sim.c
+  * @brief   Núcleo do simulador de host: relógio virtual em ticks de
+  *          SIM_CLOCK_HZ, fila de eventos, SysTick, despacho de
+  *          interrupções e o STOP.
+  ******************************************************************************
+  */
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_sim.h"
+#include "stm32g0xx_hal.h"
+#include "stm32g0xx_it.h"
+
+#define SIM_MAX_EVENTS   256
+#define SIM_IRQ_COUNT    32
+
+typedef struct
+{
+    uint64_t when;
+    Sim_EventFn fn;
+    void *arg;
+} Sim_Event;
+
+typedef void (*Sim_Handler)(void);
+
+// --- Vetores de interrupção (fracos: só os que o firmware define) ---
+#define SIM_WEAK_HANDLER(name) extern void name(void) __attribute__((weak))
+SIM_WEAK_HANDLER(WWDG_IRQHandler);
+SIM_WEAK_HANDLER(RTC_TAMP_IRQHandler);
+SIM_WEAK_HANDLER(FLASH_IRQHandler);
+SIM_WEAK_HANDLER(RCC_IRQHandler);
+SIM_WEAK_HANDLER(EXTI0_1_IRQHandler);
+SIM_WEAK_HANDLER(EXTI2_3_IRQHandler);
+SIM_WEAK_HANDLER(EXTI4_15_IRQHandler);
+SIM_WEAK_HANDLER(DMA1_Channel1_IRQHandler);
+SIM_WEAK_HANDLER(DMA1_Channel2_3_IRQHandler);
+SIM_WEAK_HANDLER(DMA1_Ch4_7_DMAMUX1_OVR_IRQHandler);
+SIM_WEAK_HANDLER(ADC1_IRQHandler);
+SIM_WEAK_HANDLER(TIM1_BRK_UP_TRG_COM_IRQHandler);
+SIM_WEAK_HANDLER(TIM1_CC_IRQHandler);
+SIM_WEAK_HANDLER(TIM3_IRQHandler);
+SIM_WEAK_HANDLER(TIM6_IRQHandler);
+SIM_WEAK_HANDLER(TIM7_IRQHandler);
+SIM_WEAK_HANDLER(TIM14_IRQHandler);
+SIM_WEAK_HANDLER(TIM15_IRQHandler);
+SIM_WEAK_HANDLER(TIM16_IRQHandler);
+SIM_WEAK_HANDLER(TIM17_IRQHandler);
+SIM_WEAK_HANDLER(USART1_IRQHandler);
+SIM_WEAK_HANDLER(USART2_IRQHandler);
+
+static Sim_Handler const irq_vectors[SIM_IRQ_COUNT] =
+{
+    [WWDG_IRQn]                   = WWDG_IRQHandler,
+    [RTC_TAMP_IRQn]               = RTC_TAMP_IRQHandler,
+    [FLASH_IRQn]                  = FLASH_IRQHandler,
+    [RCC_IRQn]                    = RCC_IRQHandler,
+    [EXTI0_1_IRQn]                = EXTI0_1_IRQHandler,
+    [EXTI2_3_IRQn]                = EXTI2_3_IRQHandler,
+    [EXTI4_15_IRQn]               = EXTI4_15_IRQHandler,
+    [DMA1_Channel1_IRQn]          = DMA1_Channel1_IRQHandler,
+    [DMA1_Channel2_3_IRQn]        = DMA1_Channel2_3_IRQHandler,
+    [DMA1_Ch4_7_DMAMUX1_OVR_IRQn] = DMA1_Ch4_7_DMAMUX1_OVR_IRQHandler,
+    [ADC1_IRQn]                   = ADC1_IRQHandler,
+    [TIM1_BRK_UP_TRG_COM_IRQn]    = TIM1_BRK_UP_TRG_COM_IRQHandler,
+    [TIM1_CC_IRQn]                = TIM1_CC_IRQHandler,
+    [TIM3_IRQn]                   = TIM3_IRQHandler,
+    [TIM6_IRQn]                   = TIM6_IRQHandler,
+    [TIM7_IRQn]                   = TIM7_IRQHandler,
+    [TIM14_IRQn]                  = TIM14_IRQHandler,
+    [TIM15_IRQn]                  = TIM15_IRQHandler,
+    [TIM16_IRQn]                  = TIM16_IRQHandler,
+    [TIM17_IRQn]                  = TIM17_IRQHandler,
+    [USART1_IRQn]                 = USART1_IRQHandler,
+    [USART2_IRQn]                 = USART2_IRQHandler,
+};
+
+// --- Estado do simulador ---
+uint32_t SystemCoreClock = 16000000UL; // HSI16 após o reset
+
+static uint64_t sim_now;
+static uint64_t sim_stop_at;
+static uint64_t sim_cycles;
+static uint64_t sim_isr_cycles;
+static uint8_t  sim_in_isr;
+static uint8_t  sim_primask;
+static uint32_t sim_irq_pending;
+static uint8_t  sim_systick_pending;
+static uint64_t sim_systick_reload;
+static uint32_t sim_irq_taken;
+static uint64_t sim_stop_ticks;
+static uint32_t sim_systick_frozen;   // Ciclos de SysTick contados ao entrar em STOP
+static jmp_buf  sim_exit;
+static uint8_t  sim_running;
+
+static Sim_Event events[SIM_MAX_EVENTS];
+static uint32_t event_count;
+
+static void Sim_SysTickEvent(void *arg);
+static void Sim_SysTickSync(void);
+static void Sim_Dispatch(void);
+
+// --- Relógio virtual ---
+
+uint64_t Sim_Now(void)
+{
+    return sim_now;
+}
+
+uint64_t Sim_Micros(void)
+{
+    return sim_now / (SIM_CLOCK_HZ / 1000000U);
+}
+
+uint64_t Sim_CyclesFromUs(uint64_t us)
+{
+    return us * (SIM_CLOCK_HZ / 1000000U);
+}
+
+uint64_t Sim_CyclesFromMs(uint64_t ms)
+{
+    return ms * (SIM_CLOCK_HZ / 1000U);
+}
+
+// 'count' períodos de um clock de 'hz', arredondado para o tick mais próximo
+uint64_t Sim_TicksFromHz(uint64_t count, uint32_t hz)
+{
+    return (count * SIM_CLOCK_HZ + hz / 2U) / hz;
+}
+
+uint64_t Sim_Cycles(void)
+{
+    return sim_cycles;
+}
+
+uint64_t Sim_IsrCycles(void)
+{
+    return sim_isr_cycles;
+}
+
+uint8_t Sim_InIsr(void)
+{
+    return sim_in_isr;
+}
+
+static int Sim_NextEvent(void)
+{
+    int best = -1;
+    for (uint32_t i = 0; i < event_count; i++)
+    {
+        if (best < 0 || events[i].when < events[best].when)
+            best = (int)i;
+    }
+    return best;
+}
+
+static void Sim_FireEvent(int idx)
+{
+    Sim_Event ev = events[idx];
+    events[idx] = events[--event_count];
+    if (ev.when > sim_now)
+        sim_now = ev.when;
+    ev.fn(ev.arg);
+}
+
+static void Sim_CheckStop(void)
+{
+    if (sim_running && !sim_in_isr && sim_now >= sim_stop_at)
+        longjmp(sim_exit, 1);
+}
+
+// Avança 'ticks' de tempo virtual, disparando os eventos do caminho
+static void Sim_Advance(uint64_t ticks)
+{
+    uint64_t remaining = ticks;
+
+    SimTim_Sync();
+    SimRtc_Sync();
+    SimUsart_Sync();
+    if (sim_in_isr)
+        sim_isr_cycles += ticks;
+
+    for (;;)
+    {
+        int idx = Sim_NextEvent();
+        if (idx < 0 || events[idx].when > sim_now + remaining)
+            break;
+        if (events[idx].when > sim_now)
+            remaining -= events[idx].when - sim_now;
+        Sim_FireEvent(idx);
+        Sim_Dispatch();
+    }
+    sim_now += remaining;
+    SimTim_Sync();
+    SimRtc_Sync();
+    SimUsart_Sync();
+    Sim_SysTickSync();
+    Sim_CheckStop();
+}
+
+// Ciclos de CPU no SYSCLK atual: 1 tick a 64 MHz, 32 ticks a 2 MHz
+void Sim_Consume(uint32_t cycles)
+{
+    sim_cycles += cycles;
+    Sim_Advance(Sim_TicksFromHz(cycles, SystemCoreClock));
+}
+
+void Sim_SpinUntil(uint64_t when)
+{
+    if (when > sim_now)
+    {
+        sim_cycles += (when - sim_now) * SystemCoreClock / SIM_CLOCK_HZ;
+        Sim_Advance(when - sim_now);
+    }
+}
+
+void Sim_SpinToNextEvent(void)
+{
+    int idx;
+
+    SimTim_Sync();
+    SimRtc_Sync();
+    SimUsart_Sync();
+    idx = Sim_NextEvent();
+
+    if (idx < 0)
+    {
+        // Nada agendado: o firmware ficaria preso para sempre
+        if (sim_running && sim_now < sim_stop_at)
+            sim_now = sim_stop_at;
+        Sim_CheckStop();
+        return;
+    }
+    if (events[idx].when > sim_now)
+    {
+        sim_cycles += (events[idx].when - sim_now) * SystemCoreClock / SIM_CLOCK_HZ;
+        if (sim_in_isr)
+            sim_isr_cycles += events[idx].when - sim_now;
+    }
+    Sim_FireEvent(idx);
+    SimTim_Sync();
+    SimRtc_Sync();
+    Sim_SysTickSync();
+    Sim_Dispatch();
+    Sim_CheckStop();
+}
+
+// --- Eventos agendados ---
+
+void Sim_Schedule(uint64_t when, Sim_EventFn fn, void *arg)
+{
+    // Evento perdido congelaria o SysTick ou um periférico sem aviso
+    if (event_count >= SIM_MAX_EVENTS)
+    {
+        fprintf(stderr, "sim: fila de eventos cheia (%d)\n", SIM_MAX_EVENTS);
+        abort();
+    }
+    events[event_count].when = when;
+    events[event_count].fn = fn;
+    events[event_count].arg = arg;
+    event_count++;
+}
+
+void Sim_Cancel(Sim_EventFn fn, void *arg)
+{
+    for (uint32_t i = 0; i < event_count; )
+    {
+        if (events[i].fn == fn && events[i].arg == arg)
+            events[i] = events[--event_count];
+        else
+            i++;
+    }
+}
+
+// --- SysTick ---
+
+// O SysTick conta no HCLK: o período em ticks muda com o perfil de clock
+static uint64_t Sim_SysTickPeriod(void)
+{
+    return Sim_TicksFromHz((uint64_t)SysTick->LOAD + 1U, SystemCoreClock);
+}
+
+void SimSysTick_Arm(void)
+{
+    Sim_Cancel(Sim_SysTickEvent, NULL);
+    sim_systick_reload = sim_now;
+    if (SysTick->CTRL & SysTick_CTRL_ENABLE_Msk)
+        Sim_Schedule(sim_now + Sim_SysTickPeriod(), Sim_SysTickEvent, NULL);
+}
+
+static void Sim_SysTickEvent(void *arg)
+{
+    (void)arg;
+    sim_systick_reload = sim_now;
+    SysTick->CTRL |= SysTick_CTRL_COUNTFLAG_Msk;
+    if (SysTick->CTRL & SysTick_CTRL_TICKINT_Msk)
+    {
+        sim_systick_pending = 1;
+        SCB->ICSR |= SCB_ICSR_PENDSTSET_Msk;
+    }
+    Sim_Schedule(sim_now + Sim_SysTickPeriod(), Sim_SysTickEvent, NULL);
+}
+
+// VAL conta de LOAD até 0 desde a última recarga
+static void Sim_SysTickSync(void)
+{
+    uint64_t elapsed;
+
+    if (SysTick->CTRL & SysTick_CTRL_ENABLE_Msk)
+    {
+        elapsed = (sim_now - sim_systick_reload) * SystemCoreClock / SIM_CLOCK_HZ;
+        SysTick->VAL = SysTick->LOAD - (uint32_t)(elapsed % (SysTick->LOAD + 1U));
+    }
+}
+
+// --- Interrupções ---
+
+void Sim_RaiseIRQ(IRQn_Type irq)
+{
+    if (irq == SysTick_IRQn)
+    {
+        sim_systick_pending = 1;
+        SCB->ICSR |= SCB_ICSR_PENDSTSET_Msk;
+    }
+    else if (irq >= 0 && irq < SIM_IRQ_COUNT)
+        sim_irq_pending |= 1UL << irq;
+    Sim_Dispatch();
+}
+
+static void Sim_RunHandler(Sim_Handler handler)
+{
+    sim_in_isr = 1;
+    sim_irq_taken++;
+    Sim_Consume(SIM_COST_IRQ_ENTRY);
+    handler();
+    Sim_Consume(SIM_COST_IRQ_EXIT);
+    sim_in_isr = 0;
+}
+
+static void Sim_Dispatch(void)
+{
+    if (sim_in_isr || sim_primask)
+        return;
+
+    for (;;)
+    {
+        if (sim_systick_pending)
+        {
+            sim_systick_pending = 0;
+            SCB->ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+            Sim_RunHandler(SysTick_Handler);
+            continue;
+        }
+
+        uint32_t ready = sim_irq_pending & NVIC->ISER[0U];
+        if (ready == 0U)
+            break;
+
+        uint32_t irq = (uint32_t)__builtin_ctz(ready);
+        sim_irq_pending &= ~(1UL << irq);
+        if (irq_vectors[irq] != NULL)
+            Sim_RunHandler(irq_vectors[irq]);
+    }
+}
+
+void Sim_EnableIrq(void)
+{
+    sim_primask = 0;
+    Sim_Dispatch();
+}
+
+void Sim_DisableIrq(void)
+{
+    sim_primask = 1;
+}
+
+uint32_t Sim_GetPrimask(void)
+{
+    return sim_primask;
+}
+
+void Sim_SetPrimask(uint32_t primask)
+{
+    sim_primask = (uint8_t)(primask & 1U);
+    Sim_Dispatch();
+}
+
+static int Sim_IrqPending(void)
+{
+    return sim_systick_pending || (sim_irq_pending & NVIC->ISER[0U]) != 0U;
+}
+
+// Como no M0+, uma interrupção pendente acorda o WFI mesmo com PRIMASK
+// setado; nesse caso o handler só roda quando o firmware reabilita IRQs
+void Sim_WaitForInterrupt(void)
+{
+    uint32_t taken = sim_irq_taken;
+
+    while (sim_irq_taken == taken && !Sim_IrqPending())
+    {
+        Sim_SpinToNextEvent();
+    }
+}
+
+// --- STOP ---
+
+uint64_t Sim_StopTicks(void)
+{
+    return sim_stop_ticks;
+}
+
+// Só eventos, sem ciclos de CPU, até 'until' ou, com 'wake_on_irq', até
+// uma interrupção habilitada ficar pendente
+static void Sim_StopUntil(uint64_t until, int wake_on_irq)
+{
+    while (!(wake_on_irq && Sim_IrqPending()))
+    {
+        int idx = Sim_NextEvent();
+        int fire = (idx >= 0 && events[idx].when <= until);
+        uint64_t when = fire ? events[idx].when : until;
+
+        if (!fire && !sim_running)
+            return; // Fora do Sim_Run: nada acordaria o núcleo
+        if (sim_running && when > sim_stop_at)
+            when = sim_stop_at;
+        if (when > sim_now)
+        {
+            sim_stop_ticks += when - sim_now;
+            sim_now = when;
+        }
+        Sim_CheckStop();
+        if (!fire)
+            return;
+        Sim_FireEvent(idx);
+        SimRtc_Sync();
+    }
+}
+
+// STOP: HCLK e clocks de APB parados até uma interrupção (EXTI, RTC).
+// Timers e ADC congelariam no meio do trabalho, então entrar com algum
+// deles ativo aborta o simulador, como as violações de clock do RCC.
+// O SysTick congela com o VAL atual; 'wake_ticks' é a latência de saída.
+// Retorna 0 sem parar se já havia interrupção pendente (o WFI não dorme).
+int Sim_EnterStop(uint64_t wake_ticks)
+{
+    const char *blocker = SimTim_StopBlocker();
+
+    if (blocker == NULL && SimAdc_Converting())
+        blocker = "ADC convertendo";
+    if (blocker == NULL && SimUsart_Busy())
+        blocker = "USART2 transmitindo";
+    if (blocker != NULL)
+    {
+        fprintf(stderr, "sim: STOP com %s\n", blocker);
+        abort();
+    }
+    if (Sim_IrqPending())
+        return 0;
+
+    Sim_SysTickSync();
+    sim_systick_frozen = SysTick->LOAD - SysTick->VAL;
+    Sim_Cancel(Sim_SysTickEvent, NULL);
+    Sim_StopUntil(UINT64_MAX, 1);
+    // Eventos durante a latência de saída ainda veem o núcleo parado
+    Sim_StopUntil(sim_now + wake_ticks, 0);
+    return 1;
+}
+
+// Núcleo de volta: o SysTick continua do VAL congelado, no HCLK atual
+void Sim_ExitStop(void)
+{
+    sim_systick_reload = sim_now - Sim_TicksFromHz(sim_systick_frozen, SystemCoreClock);
+    if (SysTick->CTRL & SysTick_CTRL_ENABLE_Msk)
+        Sim_Schedule(sim_systick_reload + Sim_SysTickPeriod(), Sim_SysTickEvent, NULL);
+    Sim_SysTickSync();
+    Sim_Dispatch();
+}
+
+// --- Execução ---
+
+void Sim_Reset(void)
+{
+    sim_now = 0;
+    sim_stop_at = 0;
+    sim_cycles = 0;
+    sim_isr_cycles = 0;
+    sim_in_isr = 0;
+    sim_primask = 0;
+    sim_irq_pending = 0;
+    sim_systick_pending = 0;
+    sim_systick_reload = 0;
+    sim_irq_taken = 0;
+    sim_stop_ticks = 0;
+    sim_systick_frozen = 0;
+    event_count = 0;
+    SystemCoreClock = 16000000UL;
+
+    memset(&Sim_SysTick, 0, sizeof(Sim_SysTick));
+    memset(&Sim_NVIC, 0, sizeof(Sim_NVIC));
+    memset(&Sim_SCB, 0, sizeof(Sim_SCB));
+    memset(&Sim_RCC, 0, sizeof(Sim_RCC));
+    memset(&Sim_PWR, 0, sizeof(Sim_PWR));
+    memset(&Sim_FLASH, 0, sizeof(Sim_FLASH));
+    memset(&Sim_SYSCFG, 0, sizeof(Sim_SYSCFG));
+    memset(&Sim_DBG, 0, sizeof(Sim_DBG));
+    SimRcc_Reset();
+    SimGpio_Reset();
+    SimAdc_Reset();
+    SimTim_Reset();
+    SimDma_Reset();
+    SimUsart_Reset();
+    SimRtc_Reset();
+    SimFlash_Reset();
+}
+
+void Sim_Run(void (*entry)(void), uint64_t duration)
+{
+    sim_stop_at = sim_now + duration;
+    sim_running = 1;
+    if (setjmp(sim_exit) == 0)
+    {
+        entry();
+    }
+    sim_running = 0;
+    sim_in_isr = 0;
+}
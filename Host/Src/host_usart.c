@@ -0,0 +1,224 @@
+/**
+  ******************************************************************************
+  * @file    host_usart.c
+  * @brief   USART2 simulada, só a transmissão pelo DMA: TDR, registrador de
+  *          deslocamento e TC, com o tempo de cada caractere saído do BRR,
+  *          OVER8, PRESC e do PCLK atual.
+  *
+  *          Como o RTC, a USART é mexida só por registradores: as escritas
+  *          são percebidas por SimUsart_Sync(), chamada pelo núcleo a cada
+  *          avanço do relógio. Com UE, TE e DMAT ligados e um canal do DMA
+  *          pronto, TXE pede DMA_REQUEST_USART2_TX; o byte passa do TDR para
+  *          a linha e, no fim do caractere, chega ao destino registrado e ao
+  *          PTY, se houver. Sem clock (USART2EN), UE ou TE, a linha para.
+  *          Escritas da CPU no TDR, a recepção e o FIFO não são modelados.
+  ******************************************************************************
+  */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "stm32g0xx_hal.h"
+#include "host_sim.h"
+
+// Atrasos de retorno de carro do termios, homônimos dos registradores
+#undef CR1
+#undef CR2
+#undef CR3
+
+#define SIM_PTY_DRAIN_MS  2000U
+#define SIM_PTY_QUIET_MS  20U
+
+static uint8_t active;           // Caractere na linha
+static uint8_t shift;            // ... e o byte dele
+static uint8_t holding;          // Byte no TDR esperando a linha
+static uint8_t kick_pending;
+static uint64_t tx_bytes;
+
+static void (*sink_fn)(uint8_t byte, void *ctx);
+static void *sink_ctx;
+static int pty_master = -1;
+static int pty_slave = -1;
+
+static const uint16_t presc_div[12] = { 1, 2, 4, 6, 8, 10, 12, 16, 32, 64, 128, 256 };
+
+static void SimUsart_Kick(void *arg);
+static void SimUsart_CharDone(void *arg);
+
+static int SimUsart_Enabled(void)
+{
+    return (RCC->APBENR1 & RCC_APBENR1_USART2EN) && (USART2->CR1 & USART_CR1_UE)
+        && (USART2->CR1 & USART_CR1_TE);
+}
+
+// Ticks de um caractere: start, dados (M1:M0 = 7, 8 ou 9 bits) e stop
+static uint64_t SimUsart_CharTicks(void)
+{
+    uint32_t cr1 = USART2->CR1;
+    uint32_t data = (cr1 & USART_CR1_M1) ? 7U : ((cr1 & USART_CR1_M0) ? 9U : 8U);
+    uint32_t stop = ((USART2->CR2 & USART_CR2_STOP) >= USART_CR2_STOP_1) ? 2U : 1U;
+    uint32_t presc = USART2->PRESC & USART_PRESC_PRESCALER;
+    uint32_t brr = USART2->BRR & 0xFFFFU;
+    uint32_t hz = HAL_RCC_GetPCLK1Freq() / presc_div[(presc < 12U) ? presc : 11U];
+    uint64_t div = brr;
+
+    if (cr1 & USART_CR1_OVER8)
+    {
+        div = (brr & 0xFFF0U) | ((brr & 0x0007U) << 1);
+        hz *= 2U;
+    }
+    if (div == 0U)
+        div = 1U;
+    return Sim_TicksFromHz((1U + data + stop) * div, hz);
+}
+
+// TXE: o DMA põe o próximo byte no TDR
+static void SimUsart_Load(void)
+{
+    if (holding || !(USART2->CR3 & USART_CR3_DMAT) || !SimDma_Request(DMA_REQUEST_USART2_TX))
+        return;
+    holding = 1;
+    USART2->ISR &= ~(USART_ISR_TXE_TXFNF | USART_ISR_TC);
+}
+
+// TDR para a linha e TXE de volta; sem byte, a linha fica ociosa e TC sobe
+static void SimUsart_Shift(void)
+{
+    if (!holding)
+    {
+        active = 0;
+        USART2->ISR |= USART_ISR_TC;
+        return;
+    }
+    shift = (uint8_t)USART2->TDR;
+    holding = 0;
+    active = 1;
+    USART2->ISR |= USART_ISR_TXE_TXFNF;
+    Sim_Schedule(Sim_Now() + SimUsart_CharTicks(), SimUsart_CharDone, NULL);
+    SimUsart_Load();
+}
+
+static void SimUsart_Kick(void *arg)
+{
+    (void)arg;
+    kick_pending = 0;
+    if (!SimUsart_Enabled())
+        return;
+    SimUsart_Load();
+    if (!active)
+        SimUsart_Shift();
+}
+
+static void SimUsart_CharDone(void *arg)
+{
+    (void)arg;
+    tx_bytes++;
+    if (sink_fn != NULL)
+        sink_fn(shift, sink_ctx);
+    // Leitor lento segura o simulador: o PTY não perde bytes
+    if (pty_master >= 0 && write(pty_master, &shift, 1) < 0)
+        SimUsart_ClosePty();
+    SimUsart_Shift();
+}
+
+void SimUsart_Reset(void)
+{
+    memset(&Sim_USART2, 0, sizeof(Sim_USART2));
+    USART2->ISR = USART_ISR_TXE_TXFNF | USART_ISR_TC;
+    active = 0;
+    holding = 0;
+    kick_pending = 0;
+    tx_bytes = 0;
+}
+
+// Fora do tempo de um evento, o DMA é pedido num evento imediato: a
+// requisição pode terminar o canal e chamar a ISR dele
+void SimUsart_Sync(void)
+{
+    if (!SimUsart_Enabled())
+    {
+        if (active || holding)
+        {
+            Sim_Cancel(SimUsart_CharDone, NULL);
+            active = 0;
+            holding = 0;
+            USART2->ISR |= USART_ISR_TXE_TXFNF | USART_ISR_TC;
+        }
+        return;
+    }
+    if (!kick_pending && !holding && (USART2->CR3 & USART_CR3_DMAT) && SimDma_Ready(DMA_REQUEST_USART2_TX))
+    {
+        kick_pending = 1;
+        Sim_Schedule(Sim_Now(), SimUsart_Kick, NULL);
+    }
+}
+
+int SimUsart_Busy(void)
+{
+    return active || holding;
+}
+
+void SimUsart_SetSink(void (*fn)(uint8_t byte, void *ctx), void *ctx)
+{
+    sink_fn = fn;
+    sink_ctx = ctx;
+}
+
+// PTY em modo cru (sem eco nem tradução de fim de linha): o leitor abre
+// 'name' como uma porta serial
+int SimUsart_OpenPty(char *name, size_t len)
+{
+    struct termios tio;
+
+    SimUsart_ClosePty();
+    pty_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pty_master < 0 || grantpt(pty_master) != 0 || unlockpt(pty_master) != 0
+        || ptsname_r(pty_master, name, len) != 0)
+    {
+        SimUsart_ClosePty();
+        return -1;
+    }
+    // O escravo fica aberto aqui: o modo cru vale antes do leitor chegar
+    pty_slave = open(name, O_RDWR | O_NOCTTY);
+    if (pty_slave < 0 || tcgetattr(pty_slave, &tio) != 0)
+    {
+        SimUsart_ClosePty();
+        return -1;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(pty_slave, TCSANOW, &tio);
+    return pty_master;
+}
+
+// Fechar o mestre descarta o que o leitor ainda não leu: espera a fila
+// do escravo ficar vazia por SIM_PTY_QUIET_MS seguidos (até
+// SIM_PTY_DRAIN_MS) e o leitor recebe EIO (fim). Um zero só não basta: o
+// que o mestre acabou de escrever passa por um buffer do kernel que o
+// TIOCINQ ainda não conta.
+void SimUsart_ClosePty(void)
+{
+    int queued;
+    uint32_t quiet = 0;
+
+    for (uint32_t ms = 0; pty_slave >= 0 && ms < SIM_PTY_DRAIN_MS && quiet < SIM_PTY_QUIET_MS; ms++)
+    {
+        if (ioctl(pty_slave, TIOCINQ, &queued) != 0)
+            break;
+        quiet = (queued == 0) ? quiet + 1U : 0U;
+        usleep(1000);
+    }
+    if (pty_master >= 0)
+        close(pty_master);
+    if (pty_slave >= 0)
+        close(pty_slave);
+    pty_master = -1;
+    pty_slave = -1;
+}
+
+uint64_t SimUsart_TxBytes(void)
+{
+    return tx_bytes;
+}
@@ -0,0 +1,163 @@
+/**
+  ******************************************************************************
+  * @file    bench_alarm.c
+  * @brief   Latência do alarme de sobretemperatura: watchdog analógico do
+  *          ADC contra a comparação por polling que o laço fazia.
+  *
+  *          O firmware roda inteiro sob o relógio virtual. Em cada ensaio o
+  *          LM35 salta de 28 para 31 °C numa fase diferente do gatilho do
+  *          ADC; depois cai para 29,8 °C (dentro da histerese: o alarme tem
+  *          que continuar) e para 28 °C (o alarme tem que sair).
+  *
+  *          O caminho antigo ligava o alarme na tarefa de temperatura assim
+  *          que a média publicada passava de 30 °C; o instante em que
+  *          temperature_cdeg cruza o limiar é exatamente esse momento.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include "main.h"
+#include "host_sim.h"
+
+#define BENCH_BOOT_MS       500U
+#define BENCH_TRIALS        20U
+#define BENCH_TRIAL_MS      1000U
+#define BENCH_BAND_MS       400U   // Queda para dentro da histerese
+#define BENCH_CLEAR_MS      600U   // Queda para abaixo da histerese
+#define BENCH_MONITOR_US    20U
+#define BENCH_ALARM_CDEG    3000
+
+extern volatile uint8_t temp_alert_active;
+extern int32_t temperature_cdeg;
+
+int Firmware_Main(void);
+
+typedef struct
+{
+    uint64_t step_at;
+    uint64_t awd_at;     // temp_alert_active subiu
+    uint64_t poll_at;    // temperature_cdeg >= limiar
+    uint64_t clear_at;   // temp_alert_active desceu
+} Bench_Trial;
+
+static Bench_Trial trials[BENCH_TRIALS];
+static uint32_t current = BENCH_TRIALS;
+static uint32_t band_drops = 0;
+static uint8_t in_band = 0;
+
+static void Bench_Entry(void)
+{
+    Firmware_Main();
+}
+
+static void Bench_SetMillivolts(void *arg)
+{
+    Sim_SetAnalogMillivolts(ADC_CHANNEL_2, (uint32_t)(uintptr_t)arg);
+}
+
+static void Bench_StepUp(void *arg)
+{
+    current = (uint32_t)(uintptr_t)arg;
+    trials[current].step_at = Sim_Now();
+    Bench_SetMillivolts((void *)(uintptr_t)310U);
+}
+
+static void Bench_Band(void *arg)
+{
+    (void)arg;
+    in_band = 1;
+    Bench_SetMillivolts((void *)(uintptr_t)298U);
+}
+
+static void Bench_Clear(void *arg)
+{
+    (void)arg;
+    in_band = 0;
+    trials[current].clear_at = UINT64_MAX; // Esperando a saída
+    Bench_SetMillivolts((void *)(uintptr_t)280U);
+}
+
+// Observa as variáveis do firmware sem gastar ciclos da CPU simulada
+static void Bench_Monitor(void *arg)
+{
+    (void)arg;
+    if (current < BENCH_TRIALS)
+    {
+        Bench_Trial *t = &trials[current];
+
+        if (t->awd_at == 0 && temp_alert_active)
+            t->awd_at = Sim_Now();
+        if (t->poll_at == 0 && temperature_cdeg >= BENCH_ALARM_CDEG)
+            t->poll_at = Sim_Now();
+        if (in_band && !temp_alert_active)
+            band_drops++;
+        if (t->clear_at == UINT64_MAX && !temp_alert_active)
+            t->clear_at = Sim_Now();
+    }
+    Sim_Schedule(Sim_Now() + Sim_CyclesFromUs(BENCH_MONITOR_US), Bench_Monitor, NULL);
+}
+
+static double Bench_Ms(uint64_t ticks)
+{
+    return (double)ticks * 1000.0 / (double)SIM_CLOCK_HZ;
+}
+
+int main(void)
+{
+    double awd_sum = 0.0, poll_sum = 0.0, clear_sum = 0.0;
+    double awd_max = 0.0, poll_min = 1e9, poll_max = 0.0, clear_max = 0.0;
+    uint32_t missed = 0;
+
+    Sim_Reset();
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_UP | BUTTON_DOWN | BUTTON_SCREEN, GPIO_PIN_SET);
+    Sim_SetAnalogMillivolts(ADC_CHANNEL_2, 280U);
+    Sim_Schedule(0, Bench_Monitor, NULL);
+
+    for (uint32_t i = 0; i < BENCH_TRIALS; i++)
+    {
+        // Fase do degrau varre o período do gatilho e o bloco de 100 ms
+        uint64_t at = Sim_CyclesFromMs(BENCH_BOOT_MS + i * BENCH_TRIAL_MS)
+                    + Sim_CyclesFromUs(i * 5130U);
+
+        Sim_Schedule(at, Bench_StepUp, (void *)(uintptr_t)i);
+        Sim_Schedule(at + Sim_CyclesFromMs(BENCH_BAND_MS), Bench_Band, NULL);
+        Sim_Schedule(at + Sim_CyclesFromMs(BENCH_CLEAR_MS), Bench_Clear, NULL);
+    }
+
+    Sim_Run(Bench_Entry, Sim_CyclesFromMs(BENCH_BOOT_MS + BENCH_TRIALS * BENCH_TRIAL_MS));
+
+    for (uint32_t i = 0; i < BENCH_TRIALS; i++)
+    {
+        const Bench_Trial *t = &trials[i];
+        double awd, poll, clear;
+
+        if (t->awd_at == 0 || t->poll_at == 0 || t->clear_at == 0 || t->clear_at == UINT64_MAX)
+        {
+            missed++;
+            continue;
+        }
+        awd = Bench_Ms(t->awd_at - t->step_at);
+        poll = Bench_Ms(t->poll_at - t->step_at);
+        clear = Bench_Ms(t->clear_at - (t->step_at + Sim_CyclesFromMs(BENCH_CLEAR_MS)));
+        awd_sum += awd;
+        poll_sum += poll;
+        clear_sum += clear;
+        awd_max = (awd > awd_max) ? awd : awd_max;
+        poll_max = (poll > poll_max) ? poll : poll_max;
+        poll_min = (poll < poll_min) ? poll : poll_min;
+        clear_max = (clear > clear_max) ? clear : clear_max;
+    }
+
+    printf("== bench_alarm (%lu Hz) ==\n", (unsigned long)SystemCoreClock);
+    printf("degrau 28 -> 31 °C, %u ensaios, fase do degrau variando\n", BENCH_TRIALS);
+    printf("%-30s %10s %10s\n", "deteccao", "media (ms)", "pior (ms)");
+    printf("%-30s %10.2f %10.2f\n", "watchdog do ADC (ISR)",
+           awd_sum / (BENCH_TRIALS - missed), awd_max);
+    printf("%-30s %10.2f %10.2f\n", "media publicada (polling)",
+           poll_sum / (BENCH_TRIALS - missed), poll_max);
+    printf("%-30s %10.2f %10.2f\n", "saida abaixo de 29,5 °C",
+           clear_sum / (BENCH_TRIALS - missed), clear_max);
+    printf("quedas na histerese (29,8 °C): %lu, ensaios incompletos: %lu\n",
+           (unsigned long)band_drops, (unsigned long)missed);
+    return (missed == 0 && band_drops == 0 && awd_max < poll_min) ? 0 : 1;
+}
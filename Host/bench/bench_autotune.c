@@ -0,0 +1,216 @@
+/**
+  ******************************************************************************
+  * @file    bench_autotune.c
+  * @brief   Auto-sintonia por relé contra plantas de primeira ordem com
+  *          tempo morto (FOPDT): tempo até convergir, Ku/Pu estimados
+  *          contra os analíticos e a malha fechada com os ganhos obtidos.
+  *
+  *          A planta K e^(-Ls) / (tau s + 1) roda no período do PID do
+  *          firmware (TempSensor_PeriodMs() com o perfil de 16 bits), em
+  *          centésimos de °C por por mil de PWM, com ruído uniforme de
+  *          ±1 c°C na medida. O código de autotune.c e pid.c é o do
+  *          firmware, chamado direto a cada amostra.
+  *
+  *          Ku e Pu analíticos: a frequência última resolve
+  *          w L + atan(w tau) = pi; Ku = sqrt(1 + (w tau)^2) / K, Pu = 2 pi / w.
+  *          O relé é uma aproximação de primeiro harmônico: o erro esperado
+  *          em Ku cresce com L / tau.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include "host_sim.h"
+#include "autotune.h"
+
+#define BENCH_PERIOD_MS     100U
+#define BENCH_BIAS          300     // Por mil
+#define BENCH_STEP_CDEG     100     // Degrau de setpoint na malha fechada
+#define BENCH_BAND_CDEG     5       // Faixa de acomodação (5% do degrau)
+#define BENCH_MAX_DELAY     256U    // Amostras de tempo morto
+
+typedef struct
+{
+    const char *name;
+    double k;       // c°C por por mil
+    double tau_s;
+    double l_s;
+} Bench_Plant;
+
+typedef struct
+{
+    const Bench_Plant *p;
+    double y;                       // Desvio sobre o ambiente, c°C
+    int32_t u_line[BENCH_MAX_DELAY];
+    uint32_t delay;
+    uint32_t head;
+    uint32_t noise;
+} Fopdt;
+
+static const Bench_Plant plants[] =
+{
+    { "K=1   tau=60s  L=5s",  1.0,  60.0,  5.0 },
+    { "K=1   tau=30s  L=10s", 1.0,  30.0, 10.0 },
+    { "K=2   tau=120s L=3s",  2.0, 120.0,  3.0 },
+    { "K=0.5 tau=20s  L=15s", 0.5,  20.0, 15.0 },
+};
+#define BENCH_PLANTS (sizeof(plants) / sizeof(plants[0]))
+
+static const char *const rule_names[] = { "Z-N PID", "sem sobressinal", "Tyreus-Luyben PI" };
+
+static const Autotune_Config tune_config =
+{
+    .amplitude = 200,
+    .hysteresis = 3,
+    .out_min = 0,
+    .out_max = 1000,
+    .max_deviation = 2000,
+    .timeout_ms = 3600000U,
+    .cycles = 3,
+    .tolerance_pct = 10,
+    .rule = AUTOTUNE_RULE_ZN_PID,
+};
+
+static void Fopdt_Init(Fopdt *f, const Bench_Plant *p, int32_t u0)
+{
+    memset(f, 0, sizeof(*f));
+    f->p = p;
+    f->y = p->k * u0;
+    f->delay = (uint32_t)(p->l_s * 1000.0 / BENCH_PERIOD_MS + 0.5);
+    for (uint32_t i = 0; i < BENCH_MAX_DELAY; i++)
+        f->u_line[i] = u0;
+    f->noise = 12345U;
+}
+
+// Um período: aplica u (que chega depois de L) e devolve a medida
+static int32_t Fopdt_Step(Fopdt *f, int32_t u)
+{
+    double dt = BENCH_PERIOD_MS / 1000.0;
+    int32_t u_delayed;
+    double target;
+
+    f->u_line[f->head] = u;
+    u_delayed = f->u_line[(f->head + BENCH_MAX_DELAY - f->delay) % BENCH_MAX_DELAY];
+    f->head = (f->head + 1U) % BENCH_MAX_DELAY;
+
+    target = f->p->k * u_delayed;
+    f->y = target + (f->y - target) * exp(-dt / f->p->tau_s);
+    f->noise = f->noise * 1664525U + 1013904223U;
+    return (int32_t)lround(f->y) + (int32_t)(f->noise >> 30) - 1;
+}
+
+static void Bench_Ultimate(const Bench_Plant *p, double *ku, double *pu_s)
+{
+    double lo = 1e-6, hi = M_PI / p->l_s;
+
+    for (int i = 0; i < 100; i++)
+    {
+        double w = 0.5 * (lo + hi);
+
+        if (w * p->l_s + atan(w * p->tau_s) < M_PI)
+            lo = w;
+        else
+            hi = w;
+    }
+    *ku = sqrt(1.0 + pow(lo * p->tau_s, 2.0)) / p->k;
+    *pu_s = 2.0 * M_PI / lo;
+}
+
+// Degrau de setpoint com os ganhos da regra; sobressinal (%) e acomodação (s)
+static uint8_t Bench_ClosedLoop(const Bench_Plant *p, const Autotune *at, uint8_t rule,
+                                double *overshoot, double *settle_s)
+{
+    Autotune tuned = *at;
+    Pid_Config cfg;
+    Pid_Controller pid;
+    Fopdt f;
+    int32_t sp0 = (int32_t)lround(p->k * BENCH_BIAS);
+    int32_t sp = sp0 + BENCH_STEP_CDEG;
+    int32_t pv = sp0, u = BENCH_BIAS, peak = sp0;
+    uint32_t n, last_out = 0;
+    uint32_t samples = (uint32_t)(40.0 * at->pu_ms / BENCH_PERIOD_MS);
+
+    tuned.cfg.rule = rule;
+    if (Autotune_GetGains(&tuned, &cfg) != HAL_OK
+        || Pid_Init(&pid, &cfg, BENCH_PERIOD_MS) != HAL_OK)
+        return 0;
+    Fopdt_Init(&f, p, BENCH_BIAS);
+    Pid_Reset(&pid, sp0, pv, u);
+
+    for (n = 1; n <= samples; n++)
+    {
+        u = Pid_Update(&pid, sp, pv);
+        pv = Fopdt_Step(&f, u);
+        if (pv > peak)
+            peak = pv;
+        if (pv > sp + BENCH_BAND_CDEG || pv < sp - BENCH_BAND_CDEG)
+            last_out = n;
+    }
+    *overshoot = 100.0 * (peak > sp ? peak - sp : 0) / BENCH_STEP_CDEG;
+    *settle_s = last_out * BENCH_PERIOD_MS / 1000.0;
+    return last_out < samples - samples / 4U;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    Sim_Reset();
+    printf("== bench_autotune (relé d=%ld, eps=%ld c°C, %u ciclos a %u%%) ==\n",
+           (long)tune_config.amplitude, (long)tune_config.hysteresis,
+           tune_config.cycles, tune_config.tolerance_pct);
+    printf("%-22s %10s %8s %8s %8s %8s %8s %8s\n", "planta", "converge", "ciclos",
+           "Ku", "Ku real", "Pu (s)", "Pu real", "ciclos/am");
+
+    for (uint32_t i = 0; i < BENCH_PLANTS; i++)
+    {
+        const Bench_Plant *p = &plants[i];
+        Autotune at;
+        Fopdt f;
+        int32_t sp = (int32_t)lround(p->k * BENCH_BIAS);
+        int32_t pv = sp, u;
+        uint64_t start, cycles = 0;
+        uint32_t steps = 0;
+        double ku_true, pu_true, ku, pu;
+
+        Fopdt_Init(&f, p, BENCH_BIAS);
+        Bench_Ultimate(p, &ku_true, &pu_true);
+        if (Autotune_Start(&at, &tune_config, sp, pv, BENCH_BIAS, BENCH_PERIOD_MS) != HAL_OK)
+        {
+            failed++;
+            continue;
+        }
+        while (Autotune_GetState(&at) == AUTOTUNE_RUNNING)
+        {
+            start = Sim_Cycles();
+            u = Autotune_Step(&at, pv);
+            cycles += Sim_Cycles() - start;
+            steps++;
+            pv = Fopdt_Step(&f, u);
+        }
+        if (Autotune_GetState(&at) != AUTOTUNE_DONE)
+        {
+            printf("%-22s falhou (erro %u)\n", p->name, at.error);
+            failed++;
+            continue;
+        }
+
+        ku = at.ku / 65536.0;
+        pu = at.pu_ms / 1000.0;
+        printf("%-22s %8.0f s %8u %8.2f %8.2f %8.1f %8.1f %8.1f\n", p->name,
+               at.elapsed_ms / 1000.0, at.cycles, ku, ku_true, pu, pu_true,
+               (double)cycles / steps);
+
+        for (uint8_t rule = 0; rule < 3U; rule++)
+        {
+            double overshoot = 0.0, settle = 0.0;
+            uint8_t ok = Bench_ClosedLoop(p, &at, rule, &overshoot, &settle);
+
+            printf("    %-18s sobressinal %6.1f %%  acomodacao %7.1f s  %s\n",
+                   rule_names[rule], overshoot, settle, ok ? "" : "NAO ACOMODOU");
+            failed += !ok;
+        }
+    }
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,332 @@
+/**
+  ******************************************************************************
+  * @file    bench_clock.c
+  * @brief   Perfis de clock em tempo de execução: o firmware inteiro passa
+  *          por todas as trocas entre Pleno, Economia e Mínimo e, em cada
+  *          perfil, o tempo que a aplicação enxerga tem de ficar igual.
+  *
+  *          Por perfil, numa janela depois da troca:
+  *           - SYSCLK e SystemCoreClock no valor da tabela;
+  *           - SysTick: uwTick avança 1 ms por ms de tempo virtual;
+  *           - TIM1: frequência do PWM e dead time (PSC, ARR, CKD e DTG
+  *             contra o clock do timer);
+  *           - TIM3/TIM6/TIM14 contando a 1 MHz;
+  *           - ADC: conversões por segundo iguais às do perfil pleno;
+  *           - escalonador sem prazos perdidos.
+ *          Cada troca espera o motor do LCD no meio de um passo do TIM6
+ *          (um SCREEN antes força uma tela inteira). Depois da sequência,
+ *          BENCH_PINGPONG trocas entre Pleno e Economia, também no meio de
+ *          telas: o passo que está no timer na hora da troca do SYSCLK cai
+ *          em pontos diferentes a cada vez. O HD44780 simulado confere
+ *          pulsos e esperas através de todas as trocas, e a DDRAM tem de
+ *          terminar igual ao framebuffer.
+ *          Por fim, uma troca para o Pleno com o PLL sem travar: o timeout
+ *          da HAL (HAL_GetTick, que anda no SysTick) tem de devolver erro
+ *          em poucos ms, com o perfil, o SYSCLK e os timers do anterior.
+  *          As trocas rodam a partir de eventos do simulador, no meio do
+  *          laço do firmware; o simulador aborta se a ordem regulador /
+  *          wait states / clock violar os limites do RM0444.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+#include "host_sim.h"
+#include "clock.h"
+#include "pwm.h"
+#include "scheduler.h"
+#include "lcd.h"
+
+#define BENCH_BOOT_MS      1000U
+#define BENCH_PROFILE_MS   3000U
+#define BENCH_SETTLE_MS    500U    // Médias do sensor e PSC com preload
+#define BENCH_PWM_HZ       20000U
+#define BENCH_DEADTIME_NS  500U
+#define BENCH_COUNT_HZ     1000000U
+#define BENCH_FLUSH_WAIT_MS 400U   // A troca espera o LCD até aí, dentro do BENCH_SETTLE_MS
+#define BENCH_SCREEN_MS     50U    // SCREEN curto: a tela troca na soltura
+#define BENCH_FLUSH_POLL_US 5U
+#define BENCH_PINGPONG      100U   // Trocas Pleno <-> Economia no fim
+#define BENCH_PINGPONG_MS   400U   // Duas rodadas da tarefa Display (200 ms)
+#define BENCH_PLL_FAIL_MS   5U     // PLL_TIMEOUT_VALUE da HAL é 2 ms
+
+int Firmware_Main(void);
+
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim3;
+extern TIM_HandleTypeDef htim6;
+extern TIM_HandleTypeDef htim14;
+
+// Pleno -> Economia -> Mínimo -> Pleno -> Mínimo -> Economia -> Pleno:
+// as seis trocas possíveis
+static const uint8_t sequence[] =
+{
+    CLOCK_PROFILE_FULL, CLOCK_PROFILE_LOW_POWER, CLOCK_PROFILE_ULTRA_LOW, CLOCK_PROFILE_FULL,
+    CLOCK_PROFILE_ULTRA_LOW, CLOCK_PROFILE_LOW_POWER, CLOCK_PROFILE_FULL,
+};
+#define BENCH_STEPS (sizeof(sequence) / sizeof(sequence[0]))
+
+typedef struct
+{
+    uint8_t switched;
+    uint8_t mid_step;         // TIM6 contando um passo do LCD na troca
+    uint32_t sysclk;
+    uint32_t tick_ms;
+    uint64_t conversions;
+    uint64_t cpu_cycles;
+    uint32_t misses;
+    uint32_t pwm_hz;
+    uint32_t deadtime_ns;
+    uint32_t count_hz[3];
+} Bench_Window;
+
+static Bench_Window windows[BENCH_STEPS];
+static uint64_t conversions;
+static uint32_t start_tick;
+static uint64_t start_conversions;
+static uint64_t start_cycles;
+static uint32_t start_misses;
+static uint32_t pingpong_ok;
+static uint32_t pingpong_mid;
+
+static struct
+{
+    HAL_StatusTypeDef status;   // Troca com o PLL sem travar
+    uint64_t ticks;
+    uint8_t profile;
+    uint32_t sysclk;
+    uint32_t count_hz;
+    HAL_StatusTypeDef retry;    // Com o PLL de volta
+} pll_fail;
+
+static void Bench_Entry(void)
+{
+    Firmware_Main();
+}
+
+// 25 °C fixos; conta as conversões do ADC (uma chamada por conversão)
+static uint16_t Bench_Analog(uint64_t now, void *ctx)
+{
+    (void)now;
+    (void)ctx;
+    conversions++;
+    return 310U; // 250 mV
+}
+
+static uint32_t Bench_Misses(void)
+{
+    uint32_t misses = 0;
+
+    for (uint8_t i = 0; i < Sched_TaskCount(); i++)
+        misses += Sched_GetTask(i)->misses;
+    return misses;
+}
+
+static uint32_t Bench_CountHz(const TIM_HandleTypeDef *htim)
+{
+    return Sim_TimerClockHz() / (htim->Instance->PSC + 1U);
+}
+
+static void Bench_Screen(void *arg)
+{
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_SCREEN, arg ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+// Só com o LCD no meio de um passo, por até BENCH_FLUSH_WAIT_MS
+static void Bench_Switch(void *arg)
+{
+    uint32_t step = (uint32_t)(uintptr_t)arg;
+    uint64_t at = Sim_CyclesFromMs(BENCH_BOOT_MS + step * BENCH_PROFILE_MS + BENCH_FLUSH_WAIT_MS);
+    uint8_t mid = LCD_IsBusy() && (htim6.Instance->CR1 & TIM_CR1_CEN) != 0U;
+
+    if (step != 0U && !mid && Sim_Now() < at)
+    {
+        Sim_Schedule(Sim_Now() + Sim_CyclesFromUs(BENCH_FLUSH_POLL_US), Bench_Switch, arg);
+        return;
+    }
+    windows[step].mid_step = mid;
+    windows[step].switched = (Clock_SetProfile(sequence[step]) == HAL_OK);
+}
+
+static uint64_t Bench_PingPongAt(uint32_t k)
+{
+    return Sim_CyclesFromMs(BENCH_BOOT_MS + BENCH_STEPS * BENCH_PROFILE_MS + k * BENCH_PINGPONG_MS);
+}
+
+static void Bench_PingPong(void *arg);
+
+// SCREEN e a troca seguinte, uma rodada por vez (a fila de eventos é curta)
+static void Bench_PingPongStart(void *arg)
+{
+    Bench_Screen((void *)1);
+    Sim_Schedule(Sim_Now() + Sim_CyclesFromMs(BENCH_SCREEN_MS), Bench_Screen, NULL);
+    Bench_PingPong(arg);
+}
+
+// Economia nas pares, Pleno nas ímpares: termina no Pleno
+static void Bench_PingPong(void *arg)
+{
+    uint32_t k = (uint32_t)(uintptr_t)arg;
+    uint64_t at = Bench_PingPongAt(k) + Sim_CyclesFromMs(BENCH_PINGPONG_MS * 3U / 4U);
+    uint8_t mid = LCD_IsBusy() && (htim6.Instance->CR1 & TIM_CR1_CEN) != 0U;
+
+    if (!mid && Sim_Now() < at)
+    {
+        Sim_Schedule(Sim_Now() + Sim_CyclesFromUs(BENCH_FLUSH_POLL_US), Bench_PingPong, arg);
+        return;
+    }
+    pingpong_mid += mid;
+    pingpong_ok += (Clock_SetProfile((k & 1U) ? CLOCK_PROFILE_FULL : CLOCK_PROFILE_LOW_POWER) == HAL_OK);
+    if (k + 1U < BENCH_PINGPONG)
+        Sim_Schedule(Bench_PingPongAt(k + 1U), Bench_PingPongStart, (void *)(uintptr_t)(k + 1U));
+}
+
+// Economia -> Pleno com o PLL morto, depois de novo com ele vivo. Só no
+// laço do firmware: com o LCD no meio de um passo não há STOP, e fora de
+// handler o SysTick preempta a espera da HAL
+static void Bench_PllFail(void *arg)
+{
+    uint64_t start;
+
+    if (!LCD_IsBusy() || (htim6.Instance->CR1 & TIM_CR1_CEN) == 0U || Sim_InIsr())
+    {
+        Sim_Schedule(Sim_Now() + Sim_CyclesFromUs(BENCH_FLUSH_POLL_US), Bench_PllFail, arg);
+        return;
+    }
+    (void)Clock_SetProfile(CLOCK_PROFILE_LOW_POWER);
+    Sim_SetPllLock(0);
+    start = Sim_Now();
+    pll_fail.status = Clock_SetProfile(CLOCK_PROFILE_FULL);
+    pll_fail.ticks = Sim_Now() - start;
+    pll_fail.profile = Clock_GetProfile();
+    pll_fail.sysclk = HAL_RCC_GetSysClockFreq();
+    pll_fail.count_hz = Bench_CountHz(&htim6);
+    Sim_SetPllLock(1);
+    pll_fail.retry = Clock_SetProfile(CLOCK_PROFILE_FULL);
+}
+
+// SCREEN para ter o LCD ocupado na hora da troca
+static void Bench_PllFailStart(void *arg)
+{
+    Bench_Screen((void *)1);
+    Sim_Schedule(Sim_Now() + Sim_CyclesFromMs(BENCH_SCREEN_MS), Bench_Screen, NULL);
+    Sim_Schedule(Sim_Now() + Sim_CyclesFromMs(BENCH_SCREEN_MS), Bench_PllFail, arg);
+}
+
+static void Bench_Begin(void *arg)
+{
+    (void)arg;
+    start_tick = uwTick;
+    start_conversions = conversions;
+    start_cycles = Sim_Cycles();
+    start_misses = Bench_Misses();
+}
+
+static void Bench_End(void *arg)
+{
+    Bench_Window *w = &windows[(uintptr_t)arg];
+    TIM_TypeDef *tim1 = htim1.Instance;
+    uint32_t timer_hz = Sim_TimerClockHz();
+    uint32_t dtg = tim1->BDTR & TIM_BDTR_DTG;
+
+    w->sysclk = HAL_RCC_GetSysClockFreq();
+    w->tick_ms = uwTick - start_tick;
+    w->conversions = conversions - start_conversions;
+    w->cpu_cycles = Sim_Cycles() - start_cycles;
+    w->misses = Bench_Misses() - start_misses;
+    w->pwm_hz = (uint32_t)(((uint64_t)timer_hz + (uint64_t)(tim1->PSC + 1U) * (tim1->ARR + 1U) / 2U)
+                           / ((uint64_t)(tim1->PSC + 1U) * (tim1->ARR + 1U)));
+    dtg = Pwm_DeadTimeTicks((uint8_t)dtg) << ((tim1->CR1 & TIM_CR1_CKD) >> TIM_CR1_CKD_Pos);
+    w->deadtime_ns = (uint32_t)(((uint64_t)dtg * 1000000000ULL + timer_hz / 2U) / timer_hz);
+    w->count_hz[0] = Bench_CountHz(&htim3);
+    w->count_hz[1] = Bench_CountHz(&htim6);
+    w->count_hz[2] = Bench_CountHz(&htim14);
+    if (w->sysclk != SystemCoreClock)
+        w->sysclk = 0;
+}
+
+int main(void)
+{
+    const uint32_t window_ms = BENCH_PROFILE_MS - BENCH_SETTLE_MS;
+    uint32_t failed = 0;
+    const SimLcd_Stats *lcd;
+    uint32_t mismatches = 0;
+    uint8_t pll_ok;
+
+    Sim_Reset();
+    SimLcd_Attach(0, NULL, 0);
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_UP | BUTTON_DOWN | BUTTON_SCREEN, GPIO_PIN_SET);
+    Sim_SetAnalogSource(ADC_CHANNEL_2, Bench_Analog, NULL);
+
+    for (uint32_t i = 0; i < BENCH_STEPS; i++)
+    {
+        uint32_t at = BENCH_BOOT_MS + i * BENCH_PROFILE_MS;
+
+        // O primeiro passo é o perfil do boot: a troca só confirma
+        Sim_Schedule(Sim_CyclesFromMs(at), Bench_Switch, (void *)(uintptr_t)i);
+        if (i != 0U)
+        {
+            Sim_Schedule(Sim_CyclesFromMs(at), Bench_Screen, (void *)1);
+            Sim_Schedule(Sim_CyclesFromMs(at + BENCH_SCREEN_MS), Bench_Screen, NULL);
+        }
+        Sim_Schedule(Sim_CyclesFromMs(at + BENCH_SETTLE_MS), Bench_Begin, NULL);
+        Sim_Schedule(Sim_CyclesFromMs(at + BENCH_PROFILE_MS) - 1U, Bench_End, (void *)(uintptr_t)i);
+    }
+    Sim_Schedule(Bench_PingPongAt(0), Bench_PingPongStart, (void *)0);
+    Sim_Schedule(Bench_PingPongAt(BENCH_PINGPONG), Bench_PllFailStart, NULL);
+    Sim_Run(Bench_Entry, Sim_CyclesFromMs(BENCH_BOOT_MS + BENCH_STEPS * BENCH_PROFILE_MS
+                                          + (BENCH_PINGPONG + 1U) * BENCH_PINGPONG_MS));
+
+    printf("== bench_clock (janela de %lu ms por perfil) ==\n", (unsigned long)window_ms);
+    printf("%-9s %10s %9s %10s %9s %9s %8s %9s %7s %5s\n", "perfil", "SYSCLK", "tick ms",
+           "ADC conv/s", "PWM Hz", "DT (ns)", "TIM MHz", "CPU MHz", "perdas", "LCD");
+    for (uint32_t i = 0; i < BENCH_STEPS; i++)
+    {
+        const Bench_Window *w = &windows[i];
+        const Clock_Profile *p = &Clock_Profiles[sequence[i]];
+        double conv_rate = (double)w->conversions * 1000.0 / window_ms;
+        double ref_rate = (double)windows[0].conversions * 1000.0 / window_ms;
+        uint8_t ok = w->switched && w->sysclk == p->sysclk_hz
+                  && (w->tick_ms + 1U >= window_ms && w->tick_ms <= window_ms + 1U)
+                  && conv_rate > 0.995 * ref_rate && conv_rate < 1.005 * ref_rate
+                  && w->pwm_hz == BENCH_PWM_HZ && w->deadtime_ns == BENCH_DEADTIME_NS
+                  && w->count_hz[0] == BENCH_COUNT_HZ && w->count_hz[1] == BENCH_COUNT_HZ
+                  && w->count_hz[2] == BENCH_COUNT_HZ && w->misses == 0U && (i == 0U || w->mid_step);
+
+        printf("%-9s %10lu %9lu %10.1f %9lu %9lu %8.3f %9.3f %7lu %5s %s\n", p->name,
+               (unsigned long)w->sysclk, (unsigned long)w->tick_ms, conv_rate,
+               (unsigned long)w->pwm_hz, (unsigned long)w->deadtime_ns, w->count_hz[0] / 1e6,
+               (double)w->cpu_cycles / (window_ms * 1000.0), (unsigned long)w->misses,
+               (i == 0U) ? "-" : (w->mid_step ? "passo" : "parado"), ok ? "ok" : "FALHOU");
+        failed += !ok;
+    }
+    printf("perfil final: %s\n", Clock_Profiles[Clock_GetProfile()].name);
+
+    lcd = SimLcd_GetStats();
+    for (uint8_t row = 0; row < LCD_ROWS; row++)
+    {
+        char shown[LCD_COLS + 1];
+
+        SimLcd_Row(row, shown);
+        mismatches += (memcmp(shown, LCD_BufferRow(row), LCD_COLS) != 0);
+    }
+    printf("LCD nas trocas (+%lu Pleno/Economia, %lu no meio de um passo): %lu escritas ocupado, %lu erros de "
+           "timing, %lu linhas diferentes %s\n", (unsigned long)pingpong_ok, (unsigned long)pingpong_mid,
+           (unsigned long)lcd->busy_writes, (unsigned long)lcd->timing_errors, (unsigned long)mismatches,
+           (lcd->busy_writes || lcd->timing_errors || mismatches) ? "FALHOU" : "ok");
+    failed += (lcd->busy_writes != 0U || lcd->timing_errors != 0U || mismatches != 0U);
+    failed += (pingpong_ok != BENCH_PINGPONG || pingpong_mid != BENCH_PINGPONG);
+
+    pll_ok = (pll_fail.status != HAL_OK && pll_fail.ticks < Sim_CyclesFromMs(BENCH_PLL_FAIL_MS)
+              && pll_fail.profile == CLOCK_PROFILE_LOW_POWER
+              && pll_fail.sysclk == Clock_Profiles[CLOCK_PROFILE_LOW_POWER].sysclk_hz
+              && pll_fail.count_hz == BENCH_COUNT_HZ && pll_fail.retry == HAL_OK
+              && Clock_GetProfile() == CLOCK_PROFILE_FULL);
+    printf("PLL sem travar: erro %d em %.2f ms, ficou em %s a %lu Hz, TIM6 a %.3f MHz; de novo com PLL: %d %s\n",
+           (int)pll_fail.status, (double)pll_fail.ticks / Sim_CyclesFromMs(1),
+           Clock_Profiles[pll_fail.profile < CLOCK_PROFILE_COUNT ? pll_fail.profile : 0].name,
+           (unsigned long)pll_fail.sysclk, pll_fail.count_hz / 1e6, (int)pll_fail.retry, pll_ok ? "ok" : "FALHOU");
+    failed += !pll_ok;
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,313 @@
+/**
+  ******************************************************************************
+  * @file    bench_datalog.c
+  * @brief   Registro de campo de datalog.c na flash simulada, sem o resto
+  *          do firmware: DataLog_Sample() a cada segundo e DataLog_Poll()
+  *          a cada 10 ms de tempo virtual, como a tarefa do main.c.
+  *
+  *          Por perfil de sinal (estável, aquecimento com o PID mexendo no
+  *          duty, passos manuais, alarme e espera), com o anel dando voltas:
+  *           - bytes de flash por amostra, cabeçalhos inclusos;
+  *           - tempo de flash por bloco (soma das chamadas que gravam) e
+  *             a maior parada de uma chamada, sem e com apagamento;
+  *           - ida e volta: as amostras decodificadas da imagem do anel
+  *             são as últimas geradas, sem erro, e o boot seguinte
+  *             continua a sequência de blocos.
+  *          Depois, cortes de energia no meio das gravações: o decodificador
+  *          descarta os blocos interrompidos e todo o resto confere.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <math.h>
+#include "host_sim.h"
+#include "datalog.h"
+#include "datalog_dec.h"
+
+#define BENCH_PERIOD_MS      1000U
+#define BENCH_POLL_MS        10U
+#define BENCH_SAMPLES        30000U    // ~8 h: o anel dá uma volta e meia
+#define BENCH_MAX_BYTES      3.0       // Por amostra, no pior perfil
+#define BENCH_MAX_POLL_US    150.0     // Uma palavra dupla por chamada
+#define BENCH_CUT_CYCLES     300U
+#define BENCH_CUT_SAMPLES    2000U
+
+typedef enum
+{
+    PROFILE_STEADY = 0,
+    PROFILE_HEATING,
+    PROFILE_MANUAL,
+    PROFILE_ALARM,
+    PROFILE_COUNT
+} Bench_Profile;
+
+static const char *const profile_names[PROFILE_COUNT] = { "estavel", "aquecimento", "manual", "alarme/espera" };
+
+typedef struct
+{
+    uint16_t boot;
+    uint32_t time_ms;
+    int16_t temp;
+    uint8_t duty;
+    uint8_t flags;
+} Bench_Truth;
+
+static Bench_Truth truth[BENCH_CUT_CYCLES * BENCH_CUT_SAMPLES];
+static uint32_t truth_count;
+static uint8_t image[DATALOG_SIZE];
+static uint32_t rng = 2024U;
+static jmp_buf power_cut;
+
+static uint32_t Bench_Random(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+// Ruído do LM35 filtrado: alguns centésimos
+static int32_t Bench_Noise(void)
+{
+    return (int32_t)(Bench_Random() % 7U) - 3;
+}
+
+static void Bench_Signal(Bench_Profile p, uint32_t k, int32_t *temp, uint16_t *duty, uint8_t *flags)
+{
+    switch (p)
+    {
+    case PROFILE_STEADY:
+        *temp = 2500 + Bench_Noise();
+        *duty = 0;
+        *flags = 0;
+        break;
+    case PROFILE_HEATING:
+    {
+        // Primeira ordem até 60 °C (tau de 20 min) e o PID mexendo em 0,1%
+        double rise = 1.0 - exp(-(double)(k % 7200U) / 1200.0);
+
+        *temp = 2500 + (int32_t)(3500.0 * rise) + Bench_Noise();
+        *duty = (uint16_t)(100.0 * (1.0 - rise) + (Bench_Random() % 5U));
+        *flags = 1U << DATALOG_FLAG_MODE_Pos;
+        break;
+    }
+    case PROFILE_MANUAL:
+        *duty = (uint16_t)(5U * ((k / 30U) % 21U));
+        *temp = 2500 + *duty * 10 + Bench_Noise();
+        *flags = 0;
+        break;
+    default:
+        *temp = 2900 + (int32_t)(200.0 * sin((double)k / 300.0)) + Bench_Noise();
+        *duty = 0;
+        *flags = (*temp >= 3000 ? DATALOG_FLAG_ALARM : 0U) | ((k / 600U) % 2U ? DATALOG_FLAG_STANDBY : 0U);
+        break;
+    }
+}
+
+typedef struct
+{
+    uint64_t poll_ticks;        // Chamadas que gravaram uma palavra dupla
+    uint64_t max_poll_ticks;
+    uint64_t erase_ticks;
+    uint64_t max_erase_ticks;
+    uint32_t erases;
+} Bench_Timing;
+
+// Um período de amostragem: a amostra e as chamadas de 10 ms
+static void Bench_Period(uint32_t time_ms, int32_t temp, uint16_t duty, uint8_t flags, Bench_Timing *t)
+{
+    DataLog_Sample(time_ms, temp, duty, flags);
+    for (uint32_t i = 0; i < BENCH_PERIOD_MS / BENCH_POLL_MS; i++)
+    {
+        uint32_t erases = DataLog_GetStats()->erases;
+        uint8_t busy = DataLog_Busy();
+        uint64_t start = Sim_Now(), spent;
+
+        DataLog_Poll();
+        spent = Sim_Now() - start;
+        if (DataLog_GetStats()->erases != erases)
+        {
+            t->erases++;
+            t->erase_ticks += spent;
+            if (spent > t->max_erase_ticks)
+                t->max_erase_ticks = spent;
+        }
+        else if (busy)
+        {
+            t->poll_ticks += spent;
+            if (spent > t->max_poll_ticks)
+                t->max_poll_ticks = spent;
+        }
+        Sim_SpinUntil(start + Sim_CyclesFromMs(BENCH_POLL_MS));
+    }
+}
+
+static int Bench_TruthCompare(const void *a, const void *b)
+{
+    const Bench_Truth *x = a, *y = b;
+
+    if (x->boot != y->boot)
+        return (x->boot > y->boot) - (x->boot < y->boot);
+    return (x->time_ms > y->time_ms) - (x->time_ms < y->time_ms);
+}
+
+typedef struct
+{
+    uint32_t checked;
+    uint32_t errors;
+    uint32_t first;             // Índice em truth[] da primeira decodificada
+    uint32_t next;              // Próximo índice esperado (perfis: sequência contínua)
+    uint8_t contiguous;
+} Bench_Check;
+
+// Cada amostra decodificada tem de existir, igual, entre as geradas
+static void Bench_CheckSample(const LogDec_Sample *s, void *ctx)
+{
+    Bench_Check *c = ctx;
+    Bench_Truth key = { .boot = s->boot, .time_ms = s->time_ms };
+    const Bench_Truth *t = bsearch(&key, truth, truth_count, sizeof(truth[0]), Bench_TruthCompare);
+
+    c->checked++;
+    if (t == NULL || t->temp != s->temp_cdeg || t->duty != s->duty || t->flags != s->flags)
+    {
+        c->errors++;
+        return;
+    }
+    if (c->checked == 1U)
+        c->first = (uint32_t)(t - truth);
+    else if (c->contiguous && (uint32_t)(t - truth) != c->next)
+        c->errors++;
+    c->next = (uint32_t)(t - truth) + 1U;
+}
+
+static uint32_t Bench_Run(Bench_Profile p)
+{
+    Bench_Timing t = {0};
+    Bench_Check check = { .contiguous = 1 };
+    LogDec_Summary sum;
+    const DataLog_Stats *st;
+    uint32_t blocks, seq, failed = 0;
+    double bytes, per_block_us;
+
+    Sim_Reset();
+    Sim_FlashEraseAll();
+    truth_count = 0;
+    if (DataLog_Init(BENCH_PERIOD_MS) != HAL_OK)
+        return 1;
+
+    for (uint32_t k = 0; k < BENCH_SAMPLES; k++)
+    {
+        int32_t temp;
+        uint16_t duty;
+        uint8_t flags;
+
+        Bench_Signal(p, k, &temp, &duty, &flags);
+        truth[truth_count++] = (Bench_Truth){ 0, (k + 1U) * BENCH_PERIOD_MS, (int16_t)temp, (uint8_t)duty, flags };
+        Bench_Period((k + 1U) * BENCH_PERIOD_MS, temp, duty, flags, &t);
+    }
+    // Desligamento previsto: o bloco em montagem vai para a flash
+    DataLog_Flush();
+    while (DataLog_Busy())
+        DataLog_Poll();
+    st = DataLog_GetStats();
+    blocks = st->blocks;
+    seq = st->seq;
+
+    Sim_FlashDump(DATALOG_ADDR, image, sizeof(image));
+    LogDec_Image(image, sizeof(image), Bench_CheckSample, &check, &sum);
+    bytes = (double)sum.bytes / sum.samples;
+    per_block_us = (double)t.poll_ticks / blocks / Sim_CyclesFromUs(1);
+
+    // O anel guarda as últimas amostras, até a derradeira
+    failed += (check.errors != 0U || sum.bad_blocks != 0U || sum.gaps != 0U || st->dropped != 0U);
+    failed += (check.next != truth_count || sum.samples != check.checked);
+    failed += (bytes > BENCH_MAX_BYTES);
+    failed += ((double)t.max_poll_ticks / Sim_CyclesFromUs(1) > BENCH_MAX_POLL_US);
+    failed += (t.erases == 0U);
+
+    // Boot seguinte: a sequência continua e o contador de boots sobe
+    Sim_Reset();
+    if (DataLog_Init(BENCH_PERIOD_MS) != HAL_OK || DataLog_GetStats()->seq != seq || DataLog_GetStats()->boot != 1U)
+        failed++;
+
+    printf("%-14s %7lu %6lu %6lu %8.2f %10.0f %9.1f %6lu %9.1f  %s\n", profile_names[p],
+           (unsigned long)check.checked, (unsigned long)blocks, (unsigned long)sum.blocks, bytes, per_block_us,
+           (double)t.max_poll_ticks / Sim_CyclesFromUs(1), (unsigned long)t.erases,
+           t.erases ? (double)t.max_erase_ticks / Sim_CyclesFromMs(1) : 0.0, failed ? "FALHOU" : "ok");
+    return failed;
+}
+
+static void Bench_PowerCut(void)
+{
+    longjmp(power_cut, 1);
+}
+
+// Liga, amostra até a energia cair numa operação de flash sorteada
+static uint32_t Bench_Cuts(void)
+{
+    Bench_Timing t = {0};
+    Bench_Check check = {0};
+    LogDec_Summary sum;
+    volatile uint32_t cuts = 0;
+    uint32_t failed;
+
+    Sim_Reset();
+    Sim_FlashEraseAll();
+    truth_count = 0;
+    for (uint32_t c = 0; c < BENCH_CUT_CYCLES; c++)
+    {
+        Sim_Reset();
+        if (DataLog_Init(BENCH_PERIOD_MS) != HAL_OK)
+            return 1;
+        if (setjmp(power_cut) == 0)
+        {
+            uint16_t boot = DataLog_GetStats()->boot;
+
+            // Boot anterior cortado antes do primeiro bloco: o número se repete
+            while (truth_count > 0U && truth[truth_count - 1U].boot == boot)
+                truth_count--;
+
+            Sim_FlashPowerCut(1U + Bench_Random() % 400U, Bench_Random(), Bench_PowerCut);
+            for (uint32_t k = 0; k < BENCH_CUT_SAMPLES; k++)
+            {
+                int32_t temp;
+                uint16_t duty;
+                uint8_t flags;
+
+                Bench_Signal((Bench_Profile)(c % PROFILE_COUNT), k, &temp, &duty, &flags);
+                truth[truth_count++] = (Bench_Truth){ boot, (k + 1U) * BENCH_PERIOD_MS, (int16_t)temp, (uint8_t)duty, flags };
+                Bench_Period((k + 1U) * BENCH_PERIOD_MS, temp, duty, flags, &t);
+            }
+            Sim_FlashPowerCut(0, 0, NULL);
+        }
+        else
+            cuts++;
+    }
+
+    qsort(truth, truth_count, sizeof(truth[0]), Bench_TruthCompare);
+    Sim_FlashDump(DATALOG_ADDR, image, sizeof(image));
+    LogDec_Image(image, sizeof(image), Bench_CheckSample, &check, &sum);
+    failed = (check.errors != 0U || cuts == 0U || sum.blocks == 0U);
+    printf("cortes de energia: %lu ciclos, %lu cortes, %lu blocos validos, %lu interrompidos, "
+           "%lu amostras conferidas, %lu erros  %s\n", (unsigned long)BENCH_CUT_CYCLES, (unsigned long)cuts,
+           (unsigned long)sum.blocks, (unsigned long)sum.bad_blocks, (unsigned long)check.checked,
+           (unsigned long)check.errors, failed ? "FALHOU" : "ok");
+    return failed;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    printf("== bench_datalog (registro de campo, anel de %u blocos de %u bytes) ==\n",
+           (unsigned)DATALOG_BLOCKS, (unsigned)DATALOG_BLOCK_SIZE);
+    printf("%-14s %7s %6s %6s %8s %10s %9s %6s %9s\n", "perfil", "amostr.", "blocos", "no anel",
+           "B/amostr", "us/bloco", "parada us", "apag.", "apag. ms");
+    for (uint32_t p = 0; p < PROFILE_COUNT; p++)
+        failed += Bench_Run((Bench_Profile)p);
+    failed += Bench_Cuts();
+    return (failed == 0) ? 0 : 1;
+}
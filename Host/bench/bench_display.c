@@ -0,0 +1,178 @@
+/**
+  ******************************************************************************
+  * @file    bench_display.c
+  * @brief   Custo por atualização da tela: o caminho antigo, snprintf da
+  *          newlib-nano num buffer + LCD_BufferPrint, contra o formatador
+  *          de lcd.c, que escreve os campos direto no framebuffer.
+  *
+  *          O snprintf roda no host para gerar o texto e cobra o custo
+  *          modelado das rotinas da newlib (host_cost.h); o formatador é o
+  *          do firmware, medido pelo relógio virtual. As duas telas são
+  *          montadas para todos os valores possíveis e o framebuffer tem
+  *          que sair igual célula a célula.
+  *
+  *          O ganho de flash vem do mapa do build Debug (Debug/Teste.map),
+  *          que ainda linkava com -u _printf_float.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "host_sim.h"
+#include "lcd.h"
+
+#define BENCH_TEMP_MAX_CDEG   33000  // Fundo de escala do LM35 no ADC
+#define BENCH_COUNTDOWN_MAX   60
+
+// snprintf com o custo do caminho inteiro da newlib-nano: um trecho por
+// literal contínuo, um _printf_i por conversão, uma divisão por dígito
+static void Bench_Snprintf(char *buf, size_t size, const char *fmt, ...)
+{
+    uint32_t cycles = SIM_COST_SNPRINTF_CALL;
+    uint32_t literals = 0;
+    uint8_t in_run = 0;
+    int len;
+    va_list ap;
+
+    va_start(ap, fmt);
+    len = vsnprintf(buf, size, fmt, ap);
+    va_end(ap);
+
+    for (const char *p = fmt; *p; p++)
+    {
+        if (p[0] == '%' && p[1] == 'd')
+        {
+            cycles += SIM_COST_SNPRINTF_INT;
+            in_run = 0;
+            p++;
+            continue;
+        }
+        if (p[0] == '%' && p[1] == '%')
+            p++;
+        cycles += SIM_COST_SNPRINTF_CHAR;
+        literals++;
+        if (!in_run)
+            cycles += SIM_COST_SNPRINTF_PUTS;
+        in_run = 1;
+    }
+    cycles += (uint32_t)(len - (int)literals) * SIM_COST_UIDIVMOD;
+    Sim_Consume(cycles);
+}
+
+// Telas como eram em UpdateDisplay()
+static void Bench_OldPwm(uint16_t duty, uint16_t countdown)
+{
+    char buffer[32];
+
+    LCD_BufferClear();
+    Bench_Snprintf(buffer, sizeof(buffer), "PWM:%d%% T:%ds", duty, countdown);
+    LCD_BufferPrint(0, 0, buffer);
+}
+
+static void Bench_OldTemp(int32_t cdeg)
+{
+    char buffer[32];
+    int tenths = (int)((cdeg + 5) / 10);
+
+    Sim_Consume(SIM_COST_UIDIVMOD * 3U); // /10 acima e / e % abaixo
+    LCD_BufferClear();
+    Bench_Snprintf(buffer, sizeof(buffer), "Temp: %d.%d ", tenths / 10, tenths % 10);
+    LCD_BufferPrint(0, 0, buffer);
+}
+
+// Telas como são agora em UpdateDisplay()
+static void Bench_NewPwm(uint16_t duty, uint16_t countdown)
+{
+    uint8_t col;
+
+    LCD_BufferClear();
+    col = LCD_BufferPrint(0, 0, "PWM:");
+    col = LCD_BufferPutUInt(col, 0, duty, 0, ' ');
+    col = LCD_BufferPrint(col, 0, "% T:");
+    col = LCD_BufferPutUInt(col, 0, countdown, 0, ' ');
+    LCD_BufferPrint(col, 0, "s");
+}
+
+static void Bench_NewTemp(int32_t cdeg)
+{
+    int32_t tenths = (cdeg + 5) / 10;
+    uint8_t col;
+
+    Sim_Consume(SIM_COST_UIDIVMOD);
+    LCD_BufferClear();
+    col = LCD_BufferPrint(0, 0, "Temp: ");
+    LCD_BufferPutFixed(col, 0, tenths, 1, 0);
+}
+
+static void Bench_Snapshot(char out[LCD_ROWS][LCD_COLS])
+{
+    for (uint8_t row = 0; row < LCD_ROWS; row++)
+        memcpy(out[row], LCD_BufferRow(row), LCD_COLS);
+}
+
+int main(void)
+{
+    char old_frame[LCD_ROWS][LCD_COLS];
+    char new_frame[LCD_ROWS][LCD_COLS];
+    uint64_t start, old_cycles = 0, new_cycles = 0;
+    uint32_t refreshes = 0, mismatches = 0;
+
+    // Bytes em .text no mapa do build Debug, por objeto da biblioteca
+    const uint32_t flash_float = 1498U + 3473U + 2218U; // vfprintf_float, dtoa, mprec
+    const uint32_t flash_double = 1736U + 1848U + 1652U + 1424U + 264U + 144U
+                                + 232U + 228U + 136U + 124U + 68U + 120U + 92U + 72U;
+    const uint32_t flash_int = 104U + 64U + 717U + 796U;   // snprintf, sprintf, svfprintf, vfprintf_i
+
+    Sim_Reset();
+
+    for (uint16_t duty = 0; duty <= 100U; duty++)
+    {
+        for (uint16_t countdown = 0; countdown <= BENCH_COUNTDOWN_MAX; countdown++)
+        {
+            start = Sim_Cycles();
+            Bench_OldPwm(duty, countdown);
+            old_cycles += Sim_Cycles() - start;
+            Bench_Snapshot(old_frame);
+
+            start = Sim_Cycles();
+            Bench_NewPwm(duty, countdown);
+            new_cycles += Sim_Cycles() - start;
+            Bench_Snapshot(new_frame);
+
+            mismatches += (memcmp(old_frame, new_frame, sizeof(old_frame)) != 0);
+            refreshes++;
+        }
+    }
+
+    for (int32_t cdeg = 0; cdeg <= BENCH_TEMP_MAX_CDEG; cdeg++)
+    {
+        start = Sim_Cycles();
+        Bench_OldTemp(cdeg);
+        old_cycles += Sim_Cycles() - start;
+        Bench_Snapshot(old_frame);
+
+        start = Sim_Cycles();
+        Bench_NewTemp(cdeg);
+        new_cycles += Sim_Cycles() - start;
+        Bench_Snapshot(new_frame);
+
+        mismatches += (memcmp(old_frame, new_frame, sizeof(old_frame)) != 0);
+        refreshes++;
+    }
+
+    printf("== bench_display (%lu Hz) ==\n", (unsigned long)SystemCoreClock);
+    printf("%-28s %12s %14s\n", "caminho", "ciclos/tela", "us/tela");
+    printf("%-28s %12.1f %14.3f\n", "snprintf + LCD_BufferPrint",
+           (double)old_cycles / refreshes, (double)old_cycles / refreshes * 1e6 / SystemCoreClock);
+    printf("%-28s %12.1f %14.3f\n", "formatador no framebuffer",
+           (double)new_cycles / refreshes, (double)new_cycles / refreshes * 1e6 / SystemCoreClock);
+    printf("ganho                        : %.1fx em %lu telas, %lu diferentes\n",
+           (double)old_cycles / (double)new_cycles, (unsigned long)refreshes,
+           (unsigned long)mismatches);
+    printf("flash (Debug/Teste.map)      : -u _printf_float %lu B + double soft-float %lu B"
+           " + printf inteiro %lu B = %lu B a menos\n",
+           (unsigned long)flash_float, (unsigned long)flash_double, (unsigned long)flash_int,
+           (unsigned long)(flash_float + flash_double + flash_int));
+    return (mismatches == 0 && new_cycles < old_cycles) ? 0 : 1;
+}
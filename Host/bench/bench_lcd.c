@@ -0,0 +1,132 @@
+/**
+  ******************************************************************************
+  * @file    bench_lcd.c
+  * @brief   Motor do LCD contra o HD44780 simulado (host_hd44780.c), com o
+  *          timer de um pulso e a ISR do firmware (TIM6_Init do main.c):
+  *          R/W aterrado (tempos fixos do oscilador mais lento) contra
+  *          leitura do busy flag, em controladores de 190, 270 e 350 kHz.
+  *
+  *          Por combinação:
+  *           - caracteres por segundo escrevendo linhas inteiras (posição
+  *             do cursor inclusa) e tempo de um clear;
+  *           - ciclos de ISR por caractere, o preço das leituras do flag;
+  *           - o menor setup de RS/RW antes do EN subir (tAS);
+  *           - conformidade: nenhuma escrita com o controlador ocupado,
+  *             nenhum pulso ou setup fora do datasheet, e a DDRAM do modelo
+  *             igual ao texto enviado.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "host_sim.h"
+#include "lcd.h"
+
+#define BENCH_ROWS        200U
+#define BENCH_CLEARS      10U
+#define BENCH_RW_PORT     GPIOC
+#define BENCH_RW_PIN      GPIO_PIN_6   // Livre no pinout do main.h
+
+extern TIM_HandleTypeDef htim6;
+void SystemClock_Config(void);
+void GPIO_Init(void);
+void TIM6_Init(void);
+
+static const uint32_t fosc_khz[] = { 190, 270, 350 };
+
+static void Bench_Drain(void)
+{
+    while (LCD_IsBusy())
+        Sim_SpinToNextEvent();
+}
+
+static uint32_t Bench_Run(uint8_t busy_flag, uint32_t fosc)
+{
+    char text[LCD_COLS + 1], shown[LCD_COLS + 1];
+    uint64_t start, row_ticks, clear_ticks, isr;
+    uint32_t chars = 0, mismatches = 0, failed;
+    const SimLcd_Stats *st;
+
+    Sim_Reset();
+    HAL_Init();
+    SystemClock_Config();
+    GPIO_Init();
+    TIM6_Init();
+    SimLcd_Attach(fosc * 1000U, busy_flag ? BENCH_RW_PORT : NULL, BENCH_RW_PIN);
+    if (busy_flag)
+    {
+        GPIO_InitTypeDef init = { .Pin = BENCH_RW_PIN, .Mode = GPIO_MODE_OUTPUT_PP };
+
+        HAL_GPIO_Init(BENCH_RW_PORT, &init);
+    }
+    LCD_Init(&htim6);
+    if (busy_flag)
+        LCD_EnableBusyFlag(BENCH_RW_PORT, BENCH_RW_PIN);
+    Bench_Drain();
+
+    // Linhas inteiras, alternando as duas, como um LCD_Flush com tudo sujo
+    start = Sim_Now();
+    isr = Sim_IsrCycles();
+    for (uint32_t r = 0; r < BENCH_ROWS; r++)
+    {
+        snprintf(text, sizeof(text), "Linha %05lu %4lu", (unsigned long)r, (unsigned long)(r * 37U % 1000U));
+        LCD_SetCursor(0, (uint8_t)(r & 1U));
+        LCD_Print(text);
+        chars += LCD_COLS;
+        Bench_Drain();
+        SimLcd_Row((uint8_t)(r & 1U), shown);
+        mismatches += (strcmp(shown, text) != 0);
+    }
+    row_ticks = Sim_Now() - start;
+    isr = Sim_IsrCycles() - isr;
+
+    start = Sim_Now();
+    for (uint32_t c = 0; c < BENCH_CLEARS; c++)
+    {
+        LCD_Clear();
+        Bench_Drain();
+    }
+    clear_ticks = (Sim_Now() - start) / BENCH_CLEARS;
+    SimLcd_Row(0, shown);
+    mismatches += (strcmp(shown, "                ") != 0);
+
+    st = SimLcd_GetStats();
+    failed = (st->busy_writes != 0U || st->timing_errors != 0U || mismatches != 0U || LCD_GetStats()->bf_timeouts != 0U);
+    printf("%-10s %4lu kHz %9.0f %9.1f %9.1f %7.2f %6lu %6lu %6lu %6lu  %s\n",
+           busy_flag ? "busy flag" : "fixo", (unsigned long)fosc,
+           (double)chars * SIM_CLOCK_HZ / row_ticks, (double)isr * SystemCoreClock / SIM_CLOCK_HZ / chars,
+           (double)LCD_GetStats()->bf_polls / LCD_GetStats()->bytes, (double)clear_ticks / Sim_CyclesFromMs(1),
+           (unsigned long)st->min_as_ns, (unsigned long)st->busy_writes, (unsigned long)st->timing_errors,
+           (unsigned long)mismatches, failed ? "FALHOU" : "ok");
+    return failed;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    printf("== bench_lcd (HD44780 simulado, SYSCLK do perfil pleno) ==\n");
+    printf("%-10s %8s %9s %9s %9s %7s %6s %6s %6s %6s\n", "modo", "fosc", "car/s", "ciclos/c",
+           "leit./B", "clear", "tAS ns", "ocup.", "timing", "tela");
+    // Um processo por combinação: o estado do firmware (perfil de clock,
+    // timers registrados) não volta com o Sim_Reset()
+    for (uint8_t mode = 0; mode < 2U; mode++)
+    {
+        for (uint32_t i = 0; i < sizeof(fosc_khz) / sizeof(fosc_khz[0]); i++)
+        {
+            int status = 1;
+            pid_t pid;
+
+            fflush(stdout);
+            pid = fork();
+            if (pid == 0)
+                exit(Bench_Run(mode, fosc_khz[i]) ? 1 : 0);
+            if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                failed++;
+        }
+    }
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+/**
+  ******************************************************************************
+  * @file    bench_lcdbus.c
+  * @brief   Barramento do LCD: escritas em registradores de GPIO e ciclos
+  *          gastos nelas por caractere, com D4-D7 e RS agrupados por
+  *          port (gpio_bus.h) contra o caminho antigo, um
+  *          HAL_GPIO_WritePin por pino.
+  *
+  *          O motor de lcd.c é percorrido passo a passo chamando
+  *          LCD_TimerCallback() direto (o tempo entre passos não entra na
+  *          conta, e o resto da ISR é igual nos dois caminhos). O caminho antigo é reproduzido aqui na mesma ordem de
+  *          escritas. Um observador de GPIO decodifica o barramento na
+  *          borda de descida do EN, como o HD44780, e os dois caminhos têm
+  *          que entregar os mesmos bytes com o mesmo RS.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <string.h>
+#include "host_sim.h"
+#include "lcd.h"
+
+#define BENCH_MAX_BYTES   512U
+#define BENCH_ROUNDS      12U     // 34 bytes por rodada
+
+typedef struct
+{
+    uint8_t nibbles;      // Nibbles de inicialização ainda por vir (byte único)
+    uint8_t half;         // 1: nibble alto já capturado
+    uint8_t high;
+    uint16_t count;
+    uint16_t bytes[BENCH_MAX_BYTES];   // RS no bit 8
+} Bench_Capture;
+
+static TIM_HandleTypeDef bench_tim;
+static Bench_Capture captured;
+
+static uint8_t Bench_Pin(GPIO_TypeDef *port, uint16_t pin)
+{
+    return (port->ODR & pin) ? 1U : 0U;
+}
+
+// Borda de descida do EN: o HD44780 lê RS e D4-D7
+static void Bench_Watch(GPIO_TypeDef *port, uint32_t old_odr, void *ctx)
+{
+    Bench_Capture *c = ctx;
+    uint8_t nibble;
+
+    if (port != LCD_EN_GPIO_Port || (old_odr & LCD_EN_Pin) == 0U || (port->ODR & LCD_EN_Pin) != 0U)
+        return;
+    nibble = (uint8_t)(Bench_Pin(LCD_D4_GPIO_Port, LCD_D4_Pin) | Bench_Pin(LCD_D5_GPIO_Port, LCD_D5_Pin) << 1
+                       | Bench_Pin(LCD_D6_GPIO_Port, LCD_D6_Pin) << 2 | Bench_Pin(LCD_D7_GPIO_Port, LCD_D7_Pin) << 3);
+    if (c->nibbles > 0U)
+    {
+        c->nibbles--;
+        return;
+    }
+    if (!c->half)
+    {
+        c->high = nibble;
+        c->half = 1;
+        return;
+    }
+    c->half = 0;
+    if (c->count < BENCH_MAX_BYTES)
+        c->bytes[c->count++] = (uint16_t)((Bench_Pin(LCD_RS_GPIO_Port, LCD_RS_Pin) << 8) | (c->high << 4) | nibble);
+}
+
+// Caminho antigo de um byte, na ordem das escritas do motor de antes
+static void Bench_OldNibble(uint8_t data)
+{
+    HAL_GPIO_WritePin(LCD_D4_GPIO_Port, LCD_D4_Pin, (data >> 0) & 0x01);
+    HAL_GPIO_WritePin(LCD_D5_GPIO_Port, LCD_D5_Pin, (data >> 1) & 0x01);
+    HAL_GPIO_WritePin(LCD_D6_GPIO_Port, LCD_D6_Pin, (data >> 2) & 0x01);
+    HAL_GPIO_WritePin(LCD_D7_GPIO_Port, LCD_D7_Pin, (data >> 3) & 0x01);
+}
+
+static void Bench_OldByte(uint8_t rs, uint8_t data)
+{
+    HAL_GPIO_WritePin(LCD_RS_GPIO_Port, LCD_RS_Pin, rs ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    Bench_OldNibble(data >> 4);
+    HAL_GPIO_WritePin(LCD_EN_GPIO_Port, LCD_EN_Pin, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(LCD_EN_GPIO_Port, LCD_EN_Pin, GPIO_PIN_RESET);
+    Bench_OldNibble(data & 0x0F);
+    HAL_GPIO_WritePin(LCD_EN_GPIO_Port, LCD_EN_Pin, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(LCD_EN_GPIO_Port, LCD_EN_Pin, GPIO_PIN_RESET);
+}
+
+// Roda o motor até a fila esvaziar
+static void Bench_Drain(void)
+{
+    while (LCD_IsBusy())
+        LCD_TimerCallback(&bench_tim);
+}
+
+// Texto de uma rodada: as telas de UpdateDisplay(), variando
+static void Bench_Screen(uint32_t round, char rows[LCD_ROWS][LCD_COLS + 1])
+{
+    snprintf(rows[0], LCD_COLS + 1, "Temp: %2lu.%lu C    ", (unsigned long)(20U + round), (unsigned long)(round % 10U));
+    snprintf(rows[1], LCD_COLS + 1, "PWM:%3lu%% T:%2lus  ", (unsigned long)(round * 5U % 101U), (unsigned long)(60U - round));
+}
+
+typedef struct
+{
+    uint32_t writes;
+    uint64_t cycles;
+} Bench_Cost;
+
+static void Bench_Report(const char *name, const Bench_Cost *c, uint32_t chars)
+{
+    printf("%-26s %8.1f %12.1f %10.2f\n", name, (double)c->writes / chars, (double)c->cycles / chars,
+           (double)c->cycles / chars * 1e6 / SystemCoreClock);
+}
+
+static uint32_t Bench_Check(const uint16_t *expected, uint32_t count)
+{
+    uint32_t errors = (captured.count != count);
+
+    for (uint32_t i = 0; i < count && i < captured.count; i++)
+        errors += (captured.bytes[i] != expected[i]);
+    return errors;
+}
+
+int main(void)
+{
+    char rows[LCD_ROWS][LCD_COLS + 1];
+    uint16_t expected[BENCH_MAX_BYTES];
+    uint32_t bytes = 0, chars = 0, errors_new, errors_old;
+    Bench_Cost new_cost = {0}, old_cost = {0};
+    uint32_t writes;
+    uint64_t start;
+
+    Sim_Reset();
+    HAL_Init();
+    bench_tim.Instance = TIM6;
+    LCD_Init(&bench_tim);
+    Bench_Drain();
+
+    // Caminho novo: o firmware, duas linhas por rodada. Só os caracteres
+    // entram na conta; o comando de posição entra na conferência.
+    memset(&captured, 0, sizeof(captured));
+    Sim_SetGpioWatch(Bench_Watch, &captured);
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++)
+    {
+        Bench_Screen(r, rows);
+        for (uint8_t row = 0; row < LCD_ROWS; row++)
+        {
+            LCD_SetCursor(0, row);
+            Bench_Drain();
+            expected[bytes++] = (uint16_t)(0x80U | (row ? 0x40U : 0x00U));
+
+            LCD_Print(rows[row]);
+            writes = Sim_GpioWrites();
+            start = Sim_Cycles();
+            Bench_Drain();
+            new_cost.cycles += Sim_Cycles() - start;
+            new_cost.writes += Sim_GpioWrites() - writes;
+            for (uint8_t i = 0; i < LCD_COLS; i++)
+                expected[bytes++] = (uint16_t)(0x100U | (uint8_t)rows[row][i]);
+            chars += LCD_COLS;
+        }
+    }
+    errors_new = Bench_Check(expected, bytes);
+
+    // Caminho antigo: os mesmos bytes, mesmo decodificador
+    memset(&captured, 0, sizeof(captured));
+    writes = Sim_GpioWrites();
+    start = Sim_Cycles();
+    for (uint32_t i = 0; i < bytes; i++)
+    {
+        if (expected[i] & 0x100U)
+        {
+            Bench_OldByte(1, (uint8_t)expected[i]);
+        }
+        else
+        {
+            // Posição: fora da conta, como no caminho novo
+            uint64_t t = Sim_Cycles();
+            uint32_t w = Sim_GpioWrites();
+
+            Bench_OldByte(0, (uint8_t)expected[i]);
+            start += Sim_Cycles() - t;
+            writes += Sim_GpioWrites() - w;
+        }
+    }
+    old_cost.cycles = Sim_Cycles() - start;
+    old_cost.writes = Sim_GpioWrites() - writes;
+    errors_old = Bench_Check(expected, bytes);
+
+    printf("== bench_lcdbus (%lu Hz, %lu caracteres) ==\n", (unsigned long)SystemCoreClock, (unsigned long)chars);
+    printf("%-26s %8s %12s %10s\n", "caminho", "escritas", "ciclos GPIO", "us GPIO");
+    Bench_Report("HAL_GPIO_WritePin por pino", &old_cost, chars);
+    Bench_Report("BSRR agrupado por port", &new_cost, chars);
+    printf("ganho                      : %.2fx em ciclos, %lu -> %lu escritas por caractere\n",
+           (double)old_cost.cycles / new_cost.cycles, (unsigned long)(old_cost.writes / chars),
+           (unsigned long)(new_cost.writes / chars));
+    printf("barramento decodificado    : %lu bytes, %lu erros (novo), %lu erros (antigo)  %s\n",
+           (unsigned long)bytes, (unsigned long)errors_new, (unsigned long)errors_old,
+           (errors_new || errors_old || new_cost.writes >= old_cost.writes) ? "FALHOU" : "ok");
+    return (errors_new || errors_old || new_cost.writes >= old_cost.writes) ? 1 : 0;
+}
@@ -0,0 +1,212 @@
+/**
+  ******************************************************************************
+  * @file    bench_pid.c
+  * @brief   Malha fechada de temperatura contra uma planta térmica simulada:
+  *          tempo de acomodação, sobressinal e rejeição de perturbação.
+  *
+  *          Planta de dois nós: a massa aquecida (ganho de PLANT_GAIN_C com
+  *          100% de PWM sobre o ambiente, constante PLANT_TAU_S) e o LM35
+  *          colado nela (PLANT_SENSOR_TAU_S). A potência é o duty real do
+  *          TIM1 (CCR1 / (ARR + 1)), zero com MOE desligado. A saída do
+  *          LM35 vira código de 12 bits com dither, e o ADC simulado
+  *          acrescenta o próprio ruído.
+  *
+  *          O firmware roda inteiro sob o relógio virtual; o modo automático
+  *          é ligado como o operador faria (SCREEN longo) e o setpoint sobe
+  *          pelo botão UP.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <math.h>
+#include "main.h"
+#include "host_sim.h"
+
+#define PLANT_AMBIENT_C      25.0
+#define PLANT_GAIN_C         10.0   // Elevação com 100% de PWM
+#define PLANT_TAU_S          60.0
+#define PLANT_SENSOR_TAU_S   4.0
+#define PLANT_STEP_US        1000U  // Passo mínimo de integração
+
+#define BENCH_AUTO_AT_MS     3000U
+#define BENCH_SP_UP_AT_MS    300000U
+#define BENCH_DIST_AT_MS     600000U
+#define BENCH_END_MS         900000U
+#define BENCH_DIST_C         (-2.0) // Ambiente cai 2 °C
+#define BENCH_MONITOR_MS     10U
+#define BENCH_BAND_C         0.10   // Faixa de acomodação
+
+extern uint8_t control_mode;
+extern int32_t setpoint_cdeg;
+extern int32_t temperature_cdeg;
+
+int Firmware_Main(void);
+
+typedef struct
+{
+    double ambient;
+    double mass;     // °C
+    double sensor;   // °C
+    uint64_t last;
+    uint32_t noise;
+} Plant;
+
+typedef struct
+{
+    const char *name;
+    uint32_t from_ms;
+    uint32_t to_ms;
+    double target;       // Setpoint do trecho
+    double peak_dev;     // Maior desvio no sentido do sobressinal
+    double step;         // Tamanho do degrau (0 = perturbação)
+    uint64_t last_out;   // Último instante fora da faixa
+    double sum_abs;      // Erro absoluto médio depois de acomodar
+    uint32_t n_settled;
+} Segment;
+
+static Plant plant;
+static Segment segments[] =
+{
+    { "setpoint 25,0 -> 27,0 °C", BENCH_AUTO_AT_MS, BENCH_SP_UP_AT_MS, 27.0, 0, 2.0, 0, 0, 0 },
+    { "setpoint 27,0 -> 28,0 °C", BENCH_SP_UP_AT_MS, BENCH_DIST_AT_MS, 28.0, 0, 1.0, 0, 0, 0 },
+    { "ambiente 25 -> 23 °C",     BENCH_DIST_AT_MS, BENCH_END_MS,      28.0, 0, 0.0, 0, 0, 0 },
+};
+#define BENCH_SEGMENTS (sizeof(segments) / sizeof(segments[0]))
+
+static double Plant_Duty(void)
+{
+    if (!(TIM1->BDTR & TIM_BDTR_MOE))
+        return 0.0;
+    return (double)TIM1->CCR1 / (double)(TIM1->ARR + 1U);
+}
+
+// Solução exata de cada nó no passo, com a potência constante
+static void Plant_Advance(uint64_t now)
+{
+    double dt;
+    double target;
+
+    if (now - plant.last < Sim_CyclesFromUs(PLANT_STEP_US))
+        return;
+    dt = (double)(now - plant.last) / (double)SIM_CLOCK_HZ;
+    plant.last = now;
+
+    target = plant.ambient + PLANT_GAIN_C * Plant_Duty();
+    plant.mass = target + (plant.mass - target) * exp(-dt / PLANT_TAU_S);
+    plant.sensor = plant.mass + (plant.sensor - plant.mass) * exp(-dt / PLANT_SENSOR_TAU_S);
+}
+
+// LM35 (10 mV/°C) -> código de 12 bits, com dither uniforme de 1 LSB
+static uint16_t Plant_Lm35(uint64_t now, void *ctx)
+{
+    double code;
+
+    (void)ctx;
+    Plant_Advance(now);
+    plant.noise = plant.noise * 1664525U + 1013904223U;
+    code = plant.sensor * 10.0 * 4095.0 / 3300.0 + (double)(plant.noise >> 8) / 16777216.0;
+    return (code >= 4095.0) ? 4095U : (uint16_t)code;
+}
+
+static void Bench_Entry(void)
+{
+    Firmware_Main();
+}
+
+static void Bench_Button(void *arg)
+{
+    uint32_t v = (uint32_t)(uintptr_t)arg;
+
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, (uint16_t)(v & 0xFFFFU), (v >> 16) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+static void Bench_Press(uint16_t pin, uint32_t at_ms, uint32_t hold_ms)
+{
+    Sim_Schedule(Sim_CyclesFromMs(at_ms), Bench_Button, (void *)(uintptr_t)(pin | (1UL << 16)));
+    Sim_Schedule(Sim_CyclesFromMs(at_ms + hold_ms), Bench_Button, (void *)(uintptr_t)pin);
+}
+
+static void Bench_Disturb(void *arg)
+{
+    (void)arg;
+    Plant_Advance(Sim_Now());
+    plant.ambient += BENCH_DIST_C;
+}
+
+static void Bench_Monitor(void *arg)
+{
+    uint64_t now = Sim_Now();
+    uint32_t ms = (uint32_t)(now * 1000U / SIM_CLOCK_HZ);
+
+    (void)arg;
+    Plant_Advance(now);
+    for (uint32_t i = 0; i < BENCH_SEGMENTS; i++)
+    {
+        Segment *s = &segments[i];
+        double dev;
+
+        if (ms < s->from_ms || ms >= s->to_ms)
+            continue;
+        // Sobressinal: acima do alvo nos degraus de subida, abaixo na queda do ambiente
+        dev = (s->step > 0.0) ? plant.sensor - s->target : s->target - plant.sensor;
+        if (dev > s->peak_dev)
+            s->peak_dev = dev;
+        if (fabs(plant.sensor - s->target) > BENCH_BAND_C)
+            s->last_out = now;
+        else if (s->last_out != 0U && now - s->last_out > Sim_CyclesFromMs(30000U))
+        {
+            s->sum_abs += fabs(plant.sensor - s->target);
+            s->n_settled++;
+        }
+    }
+    Sim_Schedule(now + Sim_CyclesFromMs(BENCH_MONITOR_MS), Bench_Monitor, NULL);
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    plant.ambient = PLANT_AMBIENT_C;
+    plant.mass = PLANT_AMBIENT_C;
+    plant.sensor = PLANT_AMBIENT_C;
+    plant.noise = 1U;
+
+    Sim_Reset();
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_UP | BUTTON_DOWN | BUTTON_SCREEN, GPIO_PIN_SET);
+    Sim_SetAnalogSource(ADC_CHANNEL_2, Plant_Lm35, NULL);
+    Sim_Schedule(0, Bench_Monitor, NULL);
+
+    // SCREEN longo liga o automático; dois UP sobem 1 °C
+    Bench_Press(BUTTON_SCREEN, BENCH_AUTO_AT_MS - 1200U, 1200U);
+    Bench_Press(BUTTON_UP, BENCH_SP_UP_AT_MS - 600U, 100U);
+    Bench_Press(BUTTON_UP, BENCH_SP_UP_AT_MS - 300U, 100U);
+    Sim_Schedule(Sim_CyclesFromMs(BENCH_DIST_AT_MS), Bench_Disturb, NULL);
+
+    Sim_Run(Bench_Entry, Sim_CyclesFromMs(BENCH_END_MS));
+
+    printf("== bench_pid (%lu Hz) ==\n", (unsigned long)SystemCoreClock);
+    printf("planta: +%.0f °C com 100%% de PWM, tau %.0f s, sensor %.0f s; PWM com %lu passos\n",
+           PLANT_GAIN_C, PLANT_TAU_S, PLANT_SENSOR_TAU_S, (unsigned long)(TIM1->ARR + 1U));
+    printf("%-26s %13s %14s %16s\n", "trecho", "sobressinal", "acomodacao (s)", "erro medio (°C)");
+    for (uint32_t i = 0; i < BENCH_SEGMENTS; i++)
+    {
+        const Segment *s = &segments[i];
+        double settle = (s->last_out == 0U) ? 0.0
+                      : (double)s->last_out / SIM_CLOCK_HZ - s->from_ms / 1000.0;
+        uint8_t settled = (s->last_out != 0U)
+                       && (s->last_out < Sim_CyclesFromMs(s->to_ms) - Sim_CyclesFromMs(60000U));
+
+        if (s->step > 0.0)
+            printf("%-26s %11.1f %% %14.1f %16.3f\n", s->name,
+                   100.0 * s->peak_dev / s->step, settle,
+                   s->n_settled ? s->sum_abs / s->n_settled : 0.0);
+        else
+            printf("%-26s %10.2f °C %14.1f %16.3f\n", s->name, s->peak_dev, settle,
+                   s->n_settled ? s->sum_abs / s->n_settled : 0.0);
+        failed += !settled;
+    }
+    printf("modo: %u, setpoint final %ld c°C, medida %ld c°C, planta %.2f °C\n",
+           control_mode, (long)setpoint_cdeg, (long)temperature_cdeg, plant.sensor);
+
+    return (failed == 0 && control_mode == CONTROL_AUTO && setpoint_cdeg == 2800) ? 0 : 1;
+}
@@ -0,0 +1,237 @@
+/**
+  ******************************************************************************
+  * @file    bench_power.c
+  * @brief   Baixo consumo entre as tarefas: residência em RUN, SLEEP e STOP
+  *          com o firmware inteiro sob o relógio virtual.
+  *
+  *          Uma única execução, com janelas de medida em sequência:
+  *           - Manual 50%: PWM ligado pelo UP, só SLEEP;
+  *           - Espera: saída de volta a 0% pelo DOWN; 60 s depois o
+  *             firmware entra em espera e o ocioso vira STOP. O STOP
+  *             contado pelo firmware (SSR do RTC) tem de bater com o do
+  *             simulador, uwTick não pode derivar do tempo virtual e o
+  *             escalonador não pode perder prazos;
+  *           - Botão: SCREEN pressionado em espera acorda o STOP pela
+  *             EXTI; mede a latência da soltura (quando a tela troca) até
+  *             a troca de tela;
+  *           - Automático: SCREEN longo liga a malha fechada, só SLEEP, e
+  *             não troca a tela.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include "main.h"
+#include "host_sim.h"
+#include "power.h"
+#include "scheduler.h"
+
+#define BENCH_MILLIVOLTS     250U     // 25 °C no LM35
+#define BENCH_UP_AT_MS       2500U    // Depois da tela de boas-vindas
+#define BENCH_DOWN_AT_MS     50000U
+#define BENCH_STEPS          10U      // 10 x 5% = 50%
+#define BENCH_PRESS_AT_MS    200000U  // SCREEN em espera
+#define BENCH_PRESS_MS       100U
+#define BENCH_AUTO_AT_MS     203000U  // SCREEN longo: automático
+#define BENCH_END_MS         260000U
+#define BENCH_MONITOR_MS     1U
+#define BENCH_OFFSET_MS      1000U    // Amostras de uwTick no início e no fim da janela
+#define BENCH_MIN_STOP       0.75     // Fração mínima de STOP em espera
+#define BENCH_STOP_ERR       0.02     // STOP do firmware contra o simulador
+#define BENCH_MAX_DRIFT_MS   2
+#define BENCH_MAX_LATENCY_MS 40U
+
+extern uint8_t current_screen;
+
+int Firmware_Main(void);
+
+typedef struct
+{
+    int64_t offset;            // Maior uwTick - tempo virtual (ms)
+    uint32_t left;             // Amostras restantes
+} Bench_Offset;
+
+typedef struct
+{
+    const char *name;
+    uint32_t from_ms;
+    uint32_t to_ms;
+    uint8_t expect_stop;
+    Power_Stats stats;
+    uint64_t stop_start;
+    uint64_t sim_stop_us;
+    uint32_t misses_start;
+    uint32_t misses;
+    Bench_Offset offset_start;
+    Bench_Offset offset_end;
+} Bench_Window;
+
+static Bench_Window windows[] =
+{
+    { .name = "Manual 50%", .from_ms = 5000U,   .to_ms = 45000U,  .expect_stop = 0 },
+    { .name = "Espera",     .from_ms = 120000U, .to_ms = 180000U, .expect_stop = 1 },
+    { .name = "Botao",      .from_ms = 185000U, .to_ms = 200100U, .expect_stop = 1 },
+    { .name = "Automatico", .from_ms = 210000U, .to_ms = 250000U, .expect_stop = 0 },
+};
+#define BENCH_WINDOWS (sizeof(windows) / sizeof(windows[0]))
+
+static uint8_t screen_seen;
+static uint64_t released_at;
+static uint64_t latency_ticks;
+
+static void Bench_Entry(void)
+{
+    Firmware_Main();
+}
+
+static void Bench_Button(void *arg)
+{
+    uint32_t v = (uint32_t)(uintptr_t)arg;
+
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, (uint16_t)(v & 0xFFFFU), (v >> 16) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+static void Bench_Press(uint16_t pin, uint32_t at_ms, uint32_t hold_ms)
+{
+    Sim_Schedule(Sim_CyclesFromMs(at_ms), Bench_Button, (void *)(uintptr_t)(pin | (1UL << 16)));
+    Sim_Schedule(Sim_CyclesFromMs(at_ms + hold_ms), Bench_Button, (void *)(uintptr_t)pin);
+}
+
+static uint32_t Bench_Misses(void)
+{
+    uint32_t misses = 0;
+
+    for (uint8_t i = 0; i < Sched_TaskCount(); i++)
+        misses += Sched_GetTask(i)->misses;
+    return misses;
+}
+
+// uwTick só é corrigido na saída do STOP: o maior adiantamento sobre o
+// tempo virtual, a cada ms durante BENCH_OFFSET_MS, é o de núcleo acordado
+static void Bench_SampleOffset(void *arg)
+{
+    Bench_Offset *o = arg;
+    int64_t now_ms = (int64_t)(Sim_Now() / Sim_CyclesFromMs(1));
+
+    if ((int64_t)uwTick - now_ms > o->offset)
+        o->offset = (int64_t)uwTick - now_ms;
+    if (--o->left > 0U)
+        Sim_Schedule(Sim_Now() + Sim_CyclesFromMs(1), Bench_SampleOffset, o);
+}
+
+static void Bench_StartOffset(Bench_Offset *o, uint32_t from_ms)
+{
+    o->offset = INT64_MIN;
+    o->left = BENCH_OFFSET_MS;
+    Sim_Schedule(Sim_CyclesFromMs(from_ms) + Sim_CyclesFromUs(500), Bench_SampleOffset, o);
+}
+
+// Só lê variáveis: nada aqui pode consumir ciclos do firmware
+static void Bench_WindowStart(void *arg)
+{
+    Bench_Window *w = arg;
+
+    Power_ResetStats();
+    w->stop_start = Sim_StopTicks();
+    w->misses_start = Bench_Misses();
+}
+
+static void Bench_WindowEnd(void *arg)
+{
+    Bench_Window *w = arg;
+
+    w->stats = *Power_GetStats();
+    w->sim_stop_us = (Sim_StopTicks() - w->stop_start) / Sim_CyclesFromUs(1);
+    w->misses = Bench_Misses() - w->misses_start;
+}
+
+static void Bench_Monitor(void *arg)
+{
+    (void)arg;
+    if (current_screen != 0)
+    {
+        screen_seen = 1;
+        latency_ticks = Sim_Now() - released_at;
+        return;
+    }
+    Sim_Schedule(Sim_Now() + Sim_CyclesFromMs(BENCH_MONITOR_MS), Bench_Monitor, NULL);
+}
+
+static void Bench_Released(void *arg)
+{
+    (void)arg;
+    released_at = Sim_Now();
+    Sim_Schedule(Sim_Now() + Sim_CyclesFromMs(BENCH_MONITOR_MS), Bench_Monitor, NULL);
+}
+
+static uint32_t Bench_Report(const Bench_Window *w)
+{
+    const Power_Stats *st = &w->stats;
+    uint64_t total = st->us[POWER_MODE_RUN] + st->us[POWER_MODE_SLEEP] + st->us[POWER_MODE_STOP];
+    double stop = (double)st->us[POWER_MODE_STOP] / total;
+    double err = w->sim_stop_us ? ((double)st->us[POWER_MODE_STOP] - w->sim_stop_us) / w->sim_stop_us : 0.0;
+    int32_t drift = (int32_t)(w->offset_end.offset - w->offset_start.offset);
+    uint32_t failed = 0;
+
+    if (w->expect_stop)
+    {
+        failed += (stop < BENCH_MIN_STOP);
+        failed += (err > BENCH_STOP_ERR || err < -BENCH_STOP_ERR);
+    }
+    else
+    {
+        failed += (st->entries[POWER_MODE_STOP] != 0U || w->sim_stop_us != 0U);
+    }
+    failed += (drift > BENCH_MAX_DRIFT_MS || drift < -BENCH_MAX_DRIFT_MS);
+    failed += (w->misses != 0U);
+
+    printf("%-12s %6.1f%% %6.1f%% %6.1f%% %8lu %8lu %6lu/%-6lu %+6.2f%% %+6ld %6lu  %s\n", w->name,
+           100.0 * st->us[POWER_MODE_RUN] / total, 100.0 * st->us[POWER_MODE_SLEEP] / total,
+           100.0 * stop, (unsigned long)st->entries[POWER_MODE_SLEEP],
+           (unsigned long)st->entries[POWER_MODE_STOP], (unsigned long)st->rtc_wakeups,
+           (unsigned long)st->early_wakeups, 100.0 * err, (long)drift,
+           (unsigned long)w->misses, failed ? "FALHOU" : "ok");
+    return failed;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    Sim_Reset();
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_UP | BUTTON_DOWN | BUTTON_SCREEN, GPIO_PIN_SET);
+    Sim_SetAnalogMillivolts(ADC_CHANNEL_2, BENCH_MILLIVOLTS);
+
+    for (uint32_t i = 0; i < BENCH_STEPS; i++)
+    {
+        Bench_Press(BUTTON_UP, BENCH_UP_AT_MS + i * 100U, 50U);
+        Bench_Press(BUTTON_DOWN, BENCH_DOWN_AT_MS + i * 100U, 50U);
+    }
+    Bench_Press(BUTTON_SCREEN, BENCH_PRESS_AT_MS, BENCH_PRESS_MS);
+    Sim_Schedule(Sim_CyclesFromMs(BENCH_PRESS_AT_MS + BENCH_PRESS_MS), Bench_Released, NULL);
+    Bench_Press(BUTTON_SCREEN, BENCH_AUTO_AT_MS, 1200U);
+    for (uint32_t i = 0; i < BENCH_WINDOWS; i++)
+    {
+        Bench_Window *w = &windows[i];
+
+        Sim_Schedule(Sim_CyclesFromMs(w->from_ms), Bench_WindowStart, w);
+        Sim_Schedule(Sim_CyclesFromMs(w->to_ms), Bench_WindowEnd, w);
+        Bench_StartOffset(&w->offset_start, w->from_ms);
+        Bench_StartOffset(&w->offset_end, w->to_ms - BENCH_OFFSET_MS);
+    }
+
+    Sim_Run(Bench_Entry, Sim_CyclesFromMs(BENCH_END_MS));
+
+    printf("== bench_power (RUN / SLEEP / STOP entre as tarefas) ==\n");
+    printf("%-12s %7s %7s %7s %8s %8s %13s %7s %6s %6s\n", "janela", "RUN", "SLEEP", "STOP",
+           "n SLEEP", "n STOP", "RTC/cedo", "erro", "deriva", "perdas");
+    for (uint32_t i = 0; i < BENCH_WINDOWS; i++)
+        failed += Bench_Report(&windows[i]);
+
+    printf("latencia do botao em espera: %.2f ms (limite %u ms)\n",
+           screen_seen ? (double)latency_ticks / Sim_CyclesFromMs(1) : -1.0, BENCH_MAX_LATENCY_MS);
+    failed += (!screen_seen || latency_ticks > Sim_CyclesFromMs(BENCH_MAX_LATENCY_MS));
+    printf("tela depois do SCREEN longo: %u (esperada 1) %s\n", current_screen, current_screen == 1U ? "ok" : "FALHOU");
+    failed += (current_screen != 1U);
+    failed += (windows[2].stats.early_wakeups == 0U);
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+/**
+  ******************************************************************************
+  * @file    bench_protect.c
+  * @brief   Proteção pelo break do TIM1: latência do corte, religamento
+  *          automático, trava por falha recorrente, religamento manual e
+  *          break do sistema.
+  *
+  *          O firmware roda inteiro sob o relógio virtual com a política de
+  *          main.c (religa 5 s depois que a temperatura cai, até 3 vezes).
+  *          O estado do estágio de potência é o MOE do TIM1: com MOE = 0 o
+  *          timer força CH1/CH1N ao repouso, qualquer que seja o CCR.
+  *
+  *          Roteiro:
+  *           - 4 sobretemperaturas: as 3 primeiras religam sozinhas, a 4ª
+  *             trava;
+  *           - SCREEN longo religa; SCREEN longo com a falha presente é
+  *             recusado;
+  *           - break do sistema (lockup/paridade) trava; SCREEN longo com
+  *             a fonte ainda ativa é recusado, depois dela sumir religa;
+  *           - nenhum SCREEN longo troca a tela.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include "main.h"
+#include "host_sim.h"
+#include "protect.h"
+
+#define BENCH_MONITOR_US    20U
+#define BENCH_HOT_MV        310U   // 31 °C
+#define BENCH_COLD_MV       280U   // 28 °C
+#define BENCH_OVERTEMPS     4U
+#define BENCH_CYCLE_MS      8000U
+#define BENCH_HOT_MS        1000U
+#define BENCH_LONG_PRESS_MS 1500U
+#define BENCH_END_MS        56000U
+
+extern uint8_t current_screen;
+
+int Firmware_Main(void);
+
+typedef struct
+{
+    uint32_t at_ms;
+    uint8_t moe;       // Esperado
+    const char *what;
+} Bench_Check;
+
+static const Bench_Check checks[] =
+{
+    {  1500U, 0, "1a sobretemperatura: cortado" },
+    {  7500U, 1, "1a: religou sozinho" },
+    { 15500U, 1, "2a: religou sozinho" },
+    { 23500U, 1, "3a: religou sozinho" },
+    { 31500U, 0, "4a: travado apos 3 religamentos" },
+    { 33500U, 0, "SCREEN pressionado, antes do longo" },
+    { 35000U, 1, "SCREEN longo religou" },
+    { 38400U, 0, "SCREEN longo com falha: recusado" },
+    { 44000U, 1, "religou sozinho (contador zerado)" },
+    { 46500U, 0, "break do sistema: cortado" },
+    { 50800U, 0, "SCREEN longo com a fonte ativa: recusado" },
+    { 52000U, 0, "break do sistema: travado" },
+    { 54000U, 1, "SCREEN longo religou" },
+};
+#define BENCH_CHECKS (sizeof(checks) / sizeof(checks[0]))
+
+static uint8_t results[BENCH_CHECKS];
+static uint8_t moe_last = 1;
+static uint64_t step_at = 0;
+static uint64_t cool_at = 0;
+static double trip_sum = 0.0, trip_max = 0.0;
+static double rearm_sum = 0.0, rearm_max = 0.0;
+static uint32_t trips = 0, rearms = 0;
+
+static void Bench_Entry(void)
+{
+    Firmware_Main();
+}
+
+static double Bench_Ms(uint64_t ticks)
+{
+    return (double)ticks * 1000.0 / (double)SIM_CLOCK_HZ;
+}
+
+static uint8_t Bench_Moe(void)
+{
+    return (TIM1->BDTR & TIM_BDTR_MOE) != 0U;
+}
+
+static void Bench_Hot(void *arg)
+{
+    (void)arg;
+    step_at = Sim_Now();
+    Sim_SetAnalogMillivolts(ADC_CHANNEL_2, BENCH_HOT_MV);
+}
+
+static void Bench_Cold(void *arg)
+{
+    (void)arg;
+    cool_at = Sim_Now();
+    Sim_SetAnalogMillivolts(ADC_CHANNEL_2, BENCH_COLD_MV);
+}
+
+static void Bench_ScreenDown(void *arg)
+{
+    (void)arg;
+    cool_at = 0; // Religamento manual não entra na média do automático
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_SCREEN, GPIO_PIN_RESET);
+}
+
+static void Bench_ScreenUp(void *arg)
+{
+    (void)arg;
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_SCREEN, GPIO_PIN_SET);
+}
+
+static void Bench_SystemFault(void *arg)
+{
+    Sim_HoldSystemBreak(TIM1, arg != NULL);
+}
+
+// O MOE e o estado que a proteção informa têm de concordar; os SCREEN são
+// todos longos, então a tela continua a primeira
+static void Bench_Verify(void *arg)
+{
+    uint32_t i = (uint32_t)(uintptr_t)arg;
+
+    results[i] = (Bench_Moe() == checks[i].moe && Protect_IsTripped() == !checks[i].moe && current_screen == 0U);
+}
+
+// Observa MOE sem gastar ciclos da CPU simulada
+static void Bench_Monitor(void *arg)
+{
+    uint8_t moe = Bench_Moe();
+
+    (void)arg;
+    if (moe != moe_last)
+    {
+        if (!moe && step_at != 0U)
+        {
+            double ms = Bench_Ms(Sim_Now() - step_at);
+
+            trip_sum += ms;
+            trip_max = (ms > trip_max) ? ms : trip_max;
+            trips++;
+            step_at = 0;
+        }
+        else if (moe && cool_at != 0U)
+        {
+            double ms = Bench_Ms(Sim_Now() - cool_at);
+
+            rearm_sum += ms;
+            rearm_max = (ms > rearm_max) ? ms : rearm_max;
+            rearms++;
+            cool_at = 0;
+        }
+        moe_last = moe;
+    }
+    Sim_Schedule(Sim_Now() + Sim_CyclesFromUs(BENCH_MONITOR_US), Bench_Monitor, NULL);
+}
+
+static void Bench_LongPress(uint32_t at_ms)
+{
+    Sim_Schedule(Sim_CyclesFromMs(at_ms), Bench_ScreenDown, NULL);
+    Sim_Schedule(Sim_CyclesFromMs(at_ms + BENCH_LONG_PRESS_MS), Bench_ScreenUp, NULL);
+}
+
+int main(void)
+{
+    const Protect_Stats *stats;
+    uint32_t failed = 0;
+
+    Sim_Reset();
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_UP | BUTTON_DOWN | BUTTON_SCREEN, GPIO_PIN_SET);
+    Sim_SetAnalogMillivolts(ADC_CHANNEL_2, BENCH_COLD_MV);
+    Sim_Schedule(0, Bench_Monitor, NULL);
+
+    for (uint32_t i = 0; i < BENCH_OVERTEMPS; i++)
+    {
+        uint32_t at = 1000U + i * BENCH_CYCLE_MS;
+
+        Sim_Schedule(Sim_CyclesFromMs(at) + Sim_CyclesFromUs(i * 3170U), Bench_Hot, NULL);
+        Sim_Schedule(Sim_CyclesFromMs(at + BENCH_HOT_MS), Bench_Cold, NULL);
+    }
+    Bench_LongPress(33000U);
+
+    // Falha presente durante o SCREEN longo
+    Sim_Schedule(Sim_CyclesFromMs(36000U), Bench_Hot, NULL);
+    Bench_LongPress(36500U);
+    Sim_Schedule(Sim_CyclesFromMs(38500U), Bench_Cold, NULL);
+
+    // Fonte do break do sistema ativa de 46 s a 51 s
+    Sim_Schedule(Sim_CyclesFromMs(46000U), Bench_SystemFault, (void *)1);
+    Bench_LongPress(49000U);
+    Sim_Schedule(Sim_CyclesFromMs(51000U), Bench_SystemFault, NULL);
+    Bench_LongPress(52200U);
+
+    for (uint32_t i = 0; i < BENCH_CHECKS; i++)
+        Sim_Schedule(Sim_CyclesFromMs(checks[i].at_ms), Bench_Verify, (void *)(uintptr_t)i);
+
+    Sim_Run(Bench_Entry, Sim_CyclesFromMs(BENCH_END_MS));
+
+    stats = Protect_GetStats();
+    printf("== bench_protect (%lu Hz) ==\n", (unsigned long)SystemCoreClock);
+    printf("%-36s %10s %10s\n", "", "media (ms)", "pior (ms)");
+    printf("%-36s %10.2f %10.2f\n", "degrau 28 -> 31 °C ate MOE = 0",
+           trips ? trip_sum / trips : 0.0, trip_max);
+    printf("%-36s %10.2f %10.2f\n", "queda para 28 °C ate religar (auto)",
+           rearms ? rearm_sum / rearms : 0.0, rearm_max);
+    for (uint32_t i = 0; i < BENCH_CHECKS; i++)
+    {
+        printf("  %6lu ms  MOE=%u  %-36s %s\n", (unsigned long)checks[i].at_ms, checks[i].moe,
+               checks[i].what, results[i] ? "ok" : "FALHOU");
+        failed += !results[i];
+    }
+    printf("disparos: sobretemperatura %lu, sistema %lu; religamentos: automaticos %lu, manuais %lu\n",
+           (unsigned long)stats->trips[PROTECT_FAULT_OVERTEMP],
+           (unsigned long)stats->trips[PROTECT_FAULT_SYSTEM],
+           (unsigned long)stats->auto_rearms, (unsigned long)stats->manual_clears);
+
+    return (failed == 0 && stats->trips[PROTECT_FAULT_OVERTEMP] == BENCH_OVERTEMPS + 1U
+            && stats->trips[PROTECT_FAULT_SYSTEM] == 1U && stats->auto_rearms == 4U
+            && stats->manual_clears == 2U) ? 0 : 1;
+}
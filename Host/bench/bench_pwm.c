@@ -0,0 +1,261 @@
+/**
+  ******************************************************************************
+  * @file    bench_pwm.c
+  * @brief   Cálculo de PSC/ARR/CKD/DTG de pwm.c conferido de forma
+  *          exaustiva no clock de timer de cada perfil de clock.
+  *
+  *          Frequência: toda frequência inteira de 1 Hz a 20 kHz e, acima,
+  *          passos de 0,1% até o limite (clock / passos mínimos), para
+  *          várias resoluções mínimas. Em cada caso:
+  *           - falha se e só se freq * passos mínimos > clock;
+  *           - PSC e ARR em 16 bits, ARR + 1 >= passos mínimos;
+  *           - frequência e erro em ppm batem com PSC/ARR devolvidos;
+  *           - erro nunca maior que o do maior ARR possível (meio passo).
+  *          Uma amostra é comparada com a busca em todos os 65536 PSCs.
+  *
+  *          Dead time: todo valor em ns de 0 até além do máximo
+  *          codificável (1008 * 4 ciclos de timer). O DTG com a CKD
+  *          escolhida tem de dar o menor dead time >= o pedido entre as
+  *          768 combinações (256 DTGs x CKD 1, 2, 4).
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "host_sim.h"
+#include "clock.h"
+#include "pwm.h"
+
+#define BENCH_LINEAR_MAX_HZ   20000U
+#define BENCH_GEOMETRIC_STEP  1.001
+#define BENCH_GLOBAL_EVERY    97U     // Um caso em N contra a busca completa
+#define BENCH_DT_MAX_TICKS    (1008U * 4U)
+
+static const uint16_t min_steps[] = { 2, 20, 100, 1000, 4096 };
+#define BENCH_RESOLUTIONS (sizeof(min_steps) / sizeof(min_steps[0]))
+
+typedef struct
+{
+    uint64_t cases;
+    uint64_t errors;
+    uint64_t exact;
+    uint64_t global_checked;
+    uint64_t global_optimal;
+    double worst_ppm;
+    double worst_extra_ppm;      // Acima do ótimo global
+    uint64_t cycles;
+    uint64_t worst_cycles;
+} Bench_FreqStats;
+
+// Menor dead time (ciclos de timer) >= T, para T de 0 ao máximo
+static uint32_t dt_best[BENCH_DT_MAX_TICKS + 1U];
+
+static void Bench_BuildDeadTimeTable(void)
+{
+    for (uint32_t t = 0; t <= BENCH_DT_MAX_TICKS; t++)
+    {
+        uint32_t best = UINT32_MAX;
+
+        for (uint32_t ckd = 0; ckd < 3U; ckd++)
+        {
+            for (uint32_t dtg = 0; dtg < 256U; dtg++)
+            {
+                uint32_t ticks = Pwm_DeadTimeTicks((uint8_t)dtg) << ckd;
+
+                if (ticks >= t && ticks < best)
+                    best = ticks;
+            }
+        }
+        dt_best[t] = best;
+    }
+}
+
+// Menor dead time >= T com uma CKD fixa (0 = /1, 1 = /2, 2 = /4)
+static uint32_t Bench_BestForCkd(uint32_t t, uint32_t shift)
+{
+    uint32_t best = UINT32_MAX;
+
+    for (uint32_t dtg = 0; dtg < 256U; dtg++)
+    {
+        uint32_t ticks = Pwm_DeadTimeTicks((uint8_t)dtg) << shift;
+
+        if (ticks >= t && ticks < best)
+            best = ticks;
+    }
+    return best;
+}
+
+static uint32_t Bench_CkdShift(uint32_t ckd)
+{
+    return ckd >> TIM_CR1_CKD_Pos;
+}
+
+// Erro relativo (ppm) do melhor ARR para cada um dos 65536 PSCs
+static double Bench_GlobalBestPpm(uint32_t timer_hz, uint32_t freq, uint16_t steps)
+{
+    double best = INFINITY;
+
+    for (uint32_t p = 1; p <= 65536U; p++)
+    {
+        double a = floor((double)timer_hz / ((double)p * freq) + 0.5);
+        double ppm;
+
+        if (a < steps)
+            break;
+        if (a > 65536.0)
+            continue;
+        ppm = fabs((double)timer_hz / (p * a) - freq) * 1e6 / freq;
+        if (ppm < best)
+            best = ppm;
+    }
+    return best;
+}
+
+static void Bench_Frequency(uint32_t timer_hz, uint32_t freq, uint16_t steps, uint64_t index,
+                            Bench_FreqStats *st)
+{
+    Pwm_Config cfg = { freq, steps, 0 };
+    Pwm_Timing t;
+    uint64_t start = Sim_Cycles(), cycles;
+    HAL_StatusTypeDef status = Pwm_Calculate(&cfg, timer_hz, &t);
+    uint8_t feasible = (uint64_t)freq * steps <= timer_hz;
+    uint64_t n;
+    double ppm, bound;
+
+    cycles = Sim_Cycles() - start;
+    st->cases++;
+    st->cycles += cycles;
+    if (cycles > st->worst_cycles)
+        st->worst_cycles = cycles;
+    if ((status == HAL_OK) != feasible)
+    {
+        st->errors++;
+        return;
+    }
+    if (status != HAL_OK)
+        return;
+
+    n = (uint64_t)(t.psc + 1U) * (t.arr + 1U);
+    ppm = ((double)timer_hz / n - freq) * 1e6 / freq;
+    // Maior ARR: PSC mínimo e ARR arredondado, erro de até meio passo
+    {
+        uint32_t p = (uint32_t)((timer_hz + (uint64_t)freq * 65536U - 1U) / ((uint64_t)freq * 65536U));
+        double a;
+
+        if (p == 0U)
+            p = 1U;
+        a = floor((double)timer_hz / ((double)p * freq) + 0.5);
+        bound = fabs((double)timer_hz / (p * a) - freq) * 1e6 / freq;
+    }
+    if (t.steps != t.arr + 1U || t.steps < steps
+        || t.freq_hz != (uint32_t)((timer_hz + n / 2U) / n)
+        || fabs(ppm - t.freq_error_ppm) > 0.5001 || fabs(ppm) > bound + 1e-9)
+        st->errors++;
+    if (ppm == 0.0)
+        st->exact++;
+    if (fabs(ppm) > st->worst_ppm)
+        st->worst_ppm = fabs(ppm);
+
+    if (index % BENCH_GLOBAL_EVERY == 0U)
+    {
+        double best = Bench_GlobalBestPpm(timer_hz, freq, steps);
+
+        st->global_checked++;
+        if (fabs(ppm) <= best + 1e-9)
+            st->global_optimal++;
+        else if (fabs(ppm) - best > st->worst_extra_ppm)
+            st->worst_extra_ppm = fabs(ppm) - best;
+    }
+}
+
+static uint32_t Bench_DeadTime(uint32_t timer_hz, uint32_t *worst_excess_ns)
+{
+    uint32_t errors = 0;
+    uint64_t max_ns = ((uint64_t)(BENCH_DT_MAX_TICKS + 2U) * 1000000000ULL) / timer_hz;
+
+    *worst_excess_ns = 0;
+    for (uint32_t ns = 0; ns <= max_ns; ns++)
+    {
+        Pwm_Config cfg = { timer_hz / 100U, 2, ns };
+        Pwm_Timing t;
+        uint64_t need = ((uint64_t)ns * timer_hz + 999999999ULL) / 1000000000ULL;
+        HAL_StatusTypeDef status = Pwm_Calculate(&cfg, timer_hz, &t);
+        uint32_t ticks, got_ns, shift;
+
+        if (need > BENCH_DT_MAX_TICKS)
+        {
+            errors += (status == HAL_OK);
+            continue;
+        }
+        if (status != HAL_OK)
+        {
+            errors++;
+            continue;
+        }
+        shift = Bench_CkdShift(t.ckd);
+        ticks = Pwm_DeadTimeTicks(t.dtg) << shift;
+        got_ns = (uint32_t)(((uint64_t)ticks * 1000000000ULL + timer_hz / 2U) / timer_hz);
+        // Mínimo entre as 768 combinações; no empate, a menor CKD
+        if (ticks != dt_best[need] || got_ns != t.deadtime_ns
+            || (shift > 0U && Bench_BestForCkd((uint32_t)need, shift - 1U) == ticks)
+            || (shift > 1U && Bench_BestForCkd((uint32_t)need, 0U) == ticks))
+            errors++;
+        if ((uint64_t)ticks * 1000000000ULL < (uint64_t)ns * timer_hz)
+            errors++; // Mais curto que o pedido
+        if (got_ns > ns && got_ns - ns > *worst_excess_ns)
+            *worst_excess_ns = got_ns - ns;
+    }
+    return errors;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    Sim_Reset();
+    Bench_BuildDeadTimeTable();
+
+    printf("== bench_pwm (PSC/ARR/CKD/DTG por perfil de clock) ==\n");
+    printf("%-9s %6s %9s %6s %7s %11s %10s %13s %12s\n", "perfil", "passos", "casos", "erros",
+           "exatas", "pior (ppm)", "otimo glob", "extra (ppm)", "ciclos med/max");
+    for (uint32_t i = 0; i < CLOCK_PROFILE_COUNT; i++)
+    {
+        uint32_t timer_hz = Clock_Profiles[i].sysclk_hz;
+
+        for (uint32_t r = 0; r < BENCH_RESOLUTIONS; r++)
+        {
+            Bench_FreqStats st = {0};
+            uint32_t top = timer_hz / min_steps[r] + 1U;
+            uint64_t index = 0;
+            double f;
+
+            for (uint32_t freq = 1; freq <= BENCH_LINEAR_MAX_HZ && freq <= top; freq++)
+                Bench_Frequency(timer_hz, freq, min_steps[r], index++, &st);
+            for (f = BENCH_LINEAR_MAX_HZ * BENCH_GEOMETRIC_STEP; f <= top; f *= BENCH_GEOMETRIC_STEP)
+                Bench_Frequency(timer_hz, (uint32_t)f, min_steps[r], index++, &st);
+
+            printf("%-9s %6u %9llu %6llu %6.1f%% %11.2f %9.1f%% %13.2f %6.0f/%llu\n",
+                   Clock_Profiles[i].name, min_steps[r], (unsigned long long)st.cases,
+                   (unsigned long long)st.errors, 100.0 * st.exact / st.cases, st.worst_ppm,
+                   st.global_checked ? 100.0 * st.global_optimal / st.global_checked : 0.0,
+                   st.worst_extra_ppm, (double)st.cycles / st.cases,
+                   (unsigned long long)st.worst_cycles);
+            failed += (st.errors != 0U);
+        }
+    }
+
+    printf("%-9s %12s %6s %18s\n", "perfil", "dead time", "erros", "maior excesso (ns)");
+    for (uint32_t i = 0; i < CLOCK_PROFILE_COUNT; i++)
+    {
+        uint32_t timer_hz = Clock_Profiles[i].sysclk_hz;
+        uint32_t excess;
+        uint32_t errors = Bench_DeadTime(timer_hz, &excess);
+
+        printf("%-9s %9lu ns %6lu %18lu\n", Clock_Profiles[i].name,
+               (unsigned long)(((uint64_t)BENCH_DT_MAX_TICKS * 1000000000ULL) / timer_hz),
+               (unsigned long)errors, (unsigned long)excess);
+        failed += (errors != 0U);
+    }
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/**
+  ******************************************************************************
+  * @file    bench_settings.c
+  * @brief   Log de ajustes de settings.c na flash simulada, sem o resto do
+  *          firmware.
+  *
+  *           - Cortes de energia: milhares de ciclos de gravações
+  *             aleatórias com a energia caindo no meio da n-ésima operação
+  *             de flash (gravação ou apagamento, sorteada). Depois de cada
+  *             corte, Settings_Init() tem de devolver, para cada chave, o
+  *             último valor confirmado ou o que estava sendo gravado, e o
+  *             log tem de continuar aceitando gravações;
+  *           - Desgaste: gravações sem corte; os apagamentos têm de se
+  *             espalhar por igual nas páginas do anel;
+  *           - Boot: custo do Settings_Init() com o log cheio, contra o
+  *             número de registros lidos.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "host_sim.h"
+#include "settings.h"
+
+#define BENCH_CUT_CYCLES     5000U    // Ciclos de liga, grava e corta
+#define BENCH_CUT_WRITES     40U      // Gravações por ciclo
+#define BENCH_CUT_MAX_OPS    160U     // Corte entre a 1ª e esta operação de flash
+#define BENCH_WEAR_WRITES    40000U
+#define BENCH_MAX_US_PER_REC 25.0     // Boot a 16 MHz, por registro lido
+
+// Chaves da aplicação e duas maiores, para registros de várias palavras
+static const uint16_t key_len[] = { 0, 2, 2, 4, 1, 13, 32 };
+#define BENCH_KEYS (sizeof(key_len) / sizeof(key_len[0]))
+
+typedef struct
+{
+    uint8_t valid;
+    uint8_t value[SETTINGS_MAX_LEN];
+} Bench_Value;
+
+static Bench_Value acked[BENCH_KEYS];     // Último valor confirmado por Settings_Write()
+static Bench_Value pending;               // Em gravação quando a energia caiu
+static uint16_t pending_key;
+static jmp_buf power_cut;
+static uint32_t rng = 12345U;
+
+static uint32_t Bench_Random(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void Bench_PowerCut(void)
+{
+    longjmp(power_cut, 1);
+}
+
+// Religa: registradores no reset, flash como ficou
+static HAL_StatusTypeDef Bench_Boot(void)
+{
+    Sim_Reset();
+    return Settings_Init();
+}
+
+// Cada chave tem de bater com o confirmado; a que estava em gravação
+// pode ter ficado com o valor novo, que passa a ser o confirmado
+static uint32_t Bench_Verify(void)
+{
+    uint32_t errors = 0;
+
+    for (uint16_t key = 1; key < BENCH_KEYS; key++)
+    {
+        uint8_t value[SETTINGS_MAX_LEN];
+        HAL_StatusTypeDef status = Settings_Read(key, value, key_len[key]);
+        uint8_t is_acked = acked[key].valid
+                         ? (status == HAL_OK && memcmp(value, acked[key].value, key_len[key]) == 0)
+                         : (status != HAL_OK);
+        uint8_t is_pending = (key == pending_key && status == HAL_OK
+                              && memcmp(value, pending.value, key_len[key]) == 0);
+
+        if (is_pending && !is_acked)
+            acked[key] = pending;
+        else if (!is_acked)
+            errors++;
+    }
+    pending_key = 0;
+    return errors;
+}
+
+static HAL_StatusTypeDef Bench_Write(void)
+{
+    HAL_StatusTypeDef status;
+    uint16_t key = (uint16_t)(1U + Bench_Random() % (BENCH_KEYS - 1U));
+    Bench_Value value = { .valid = 1 };
+
+    for (uint16_t i = 0; i < key_len[key]; i++)
+        value.value[i] = (uint8_t)Bench_Random();
+    // Às vezes o mesmo valor: Settings_Write() não grava de novo
+    if (acked[key].valid && Bench_Random() % 8U == 0U)
+        value = acked[key];
+
+    pending = value;
+    pending_key = key;
+    status = Settings_Write(key, value.value, key_len[key]);
+    if (status == HAL_OK)
+        acked[key] = value;
+    pending_key = 0;
+    return status;
+}
+
+typedef struct
+{
+    uint32_t cycles;
+    uint32_t cuts;
+    uint32_t errors;
+    uint32_t boot_failures;
+    uint32_t write_failures;
+    uint32_t corrupt;
+    uint32_t compactions;
+} Bench_CutStats;
+
+static void Bench_Cuts(Bench_CutStats *st)
+{
+    for (uint32_t c = 0; c < BENCH_CUT_CYCLES; c++)
+    {
+        if (Bench_Boot() != HAL_OK)
+        {
+            st->boot_failures++;
+            continue;
+        }
+        st->errors += Bench_Verify();
+        st->corrupt += Settings_GetStats()->corrupt;
+        st->cycles++;
+
+        if (setjmp(power_cut) == 0)
+        {
+            Sim_FlashPowerCut(1U + Bench_Random() % BENCH_CUT_MAX_OPS, Bench_Random(), Bench_PowerCut);
+            for (uint32_t w = 0; w < BENCH_CUT_WRITES; w++)
+                st->write_failures += (Bench_Write() != HAL_OK);
+            Sim_FlashPowerCut(0, 0, NULL);
+        }
+        else
+        {
+            st->cuts++;
+        }
+        st->compactions += Settings_GetStats()->compactions;
+    }
+}
+
+int main(void)
+{
+    Bench_CutStats cut = {0};
+    uint32_t failed = 0, erases[SETTINGS_PAGES], min_e = UINT32_MAX, max_e = 0;
+    uint32_t wear_errors, cut_failed;
+    const Settings_Stats *st;
+    uint64_t t0, boot_ticks;
+    double boot_us;
+
+    Sim_Reset();
+    Sim_FlashEraseAll();
+
+    Bench_Cuts(&cut);
+    printf("== bench_settings (log de ajustes na flash) ==\n");
+    printf("%-22s %8s %8s %8s %10s %10s %8s  %s\n", "cortes de energia", "ciclos", "cortes",
+           "erros", "interromp.", "compact.", "boot", "");
+    cut_failed = (cut.errors != 0U || cut.boot_failures != 0U || cut.write_failures != 0U || cut.cuts == 0U);
+    printf("%-22s %8lu %8lu %8lu %10lu %10lu %8lu  %s\n", "", (unsigned long)cut.cycles,
+           (unsigned long)cut.cuts, (unsigned long)(cut.errors + cut.write_failures),
+           (unsigned long)cut.corrupt, (unsigned long)cut.compactions,
+           (unsigned long)cut.boot_failures, cut_failed ? "FALHOU" : "ok");
+    failed += cut_failed;
+
+    // Desgaste: só gravações, contando os apagamentos de cada página
+    if (Bench_Boot() != HAL_OK)
+        failed++;
+    wear_errors = Bench_Verify();
+    for (uint32_t p = 0; p < SETTINGS_PAGES; p++)
+        erases[p] = Sim_FlashPageErases(SETTINGS_FIRST_PAGE + p);
+    for (uint32_t i = 0; i < BENCH_WEAR_WRITES; i++)
+        wear_errors += (Bench_Write() != HAL_OK);
+    if (Bench_Boot() != HAL_OK)
+        failed++;
+    wear_errors += Bench_Verify();
+    printf("%-22s", "desgaste (apagamentos)");
+    for (uint32_t p = 0; p < SETTINGS_PAGES; p++)
+    {
+        erases[p] = Sim_FlashPageErases(SETTINGS_FIRST_PAGE + p) - erases[p];
+        if (erases[p] < min_e)
+            min_e = erases[p];
+        if (erases[p] > max_e)
+            max_e = erases[p];
+        printf(" p%lu=%-6lu", (unsigned long)(SETTINGS_FIRST_PAGE + p), (unsigned long)erases[p]);
+    }
+    printf(" %lu gravacoes, %lu erros  %s\n", (unsigned long)BENCH_WEAR_WRITES, (unsigned long)wear_errors,
+           (max_e - min_e > 1U || max_e == 0U || wear_errors) ? "FALHOU" : "ok");
+    failed += (max_e - min_e > 1U || max_e == 0U || wear_errors != 0U);
+
+    // Boot com a página ativa quase cheia: o pior caso da leitura
+    while (Settings_GetStats()->free_bytes > 48U)
+        Bench_Write();
+    Sim_Reset();
+    t0 = Sim_Now();
+    if (Settings_Init() != HAL_OK)
+        failed++;
+    boot_ticks = Sim_Now() - t0;
+    st = Settings_GetStats();
+    boot_us = (double)boot_ticks / Sim_CyclesFromUs(1);
+    printf("%-22s %lu registros em %.0f us a 16 MHz (%.1f us/registro, limite %.0f)  %s\n", "boot",
+           (unsigned long)st->records, boot_us, boot_us / st->records, BENCH_MAX_US_PER_REC,
+           boot_us > BENCH_MAX_US_PER_REC * st->records ? "FALHOU" : "ok");
+    failed += (boot_us > BENCH_MAX_US_PER_REC * st->records);
+    failed += Bench_Verify();
+
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+/**
+  ******************************************************************************
+  * @file    bench_superloop.c
+  * @brief   Benchmark do laço principal sob o relógio virtual.
+  *
+  *          Cenário fixo e determinístico de 30 s após a inicialização:
+  *          temperatura em rampa triangular de 25 a 35 °C (cruza o alarme
+  *          de 30 °C), cliques em UP/DOWN/SCREEN espalhados no tempo.
+  *          Imprime o histograma de latência por iteração (p50/p99/max) e
+  *          o tempo atribuído a cada tarefa. É a linha de base contra a
+  *          qual as otimizações do firmware são medidas.
+  *
+  *          A seguir vem a contabilidade do próprio escalonador: execuções,
+  *          pior tempo, pior atraso de início, prazos perdidos e a fração
+  *          do tempo que a CPU passou dormindo em __WFI.
+  *
+  *          Cada clique repica: o contato oscila por BENCH_BOUNCE_US antes
+  *          de assentar, na pressão e na soltura. O duty cycle final
+  *          confere que o debounce contou cada clique uma única vez.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include "main.h"
+#include "host_sim.h"
+#include "host_prof.h"
+#include "scheduler.h"
+#include "buttons.h"
+
+#define BENCH_BOOT_MS     2500U   // LCD_Init + 2 s de tela de boas-vindas
+#define BENCH_WINDOW_MS  30000U
+#define BENCH_CLICK_MS      80U
+
+// Instantes (µs) das bordas de um repique; o nível final é o último
+static const uint16_t bounce_us[] = { 0, 250, 600, 1100, 1900 };
+
+typedef struct
+{
+    uint16_t pin;
+    uint32_t at_ms;
+} Bench_Click;
+
+static const Bench_Click clicks[] =
+{
+    { BUTTON_UP,      4000 },
+    { BUTTON_UP,      5000 },
+    { BUTTON_UP,      6000 },
+    { BUTTON_SCREEN,  8000 },
+    { BUTTON_DOWN,   12000 },
+    { BUTTON_SCREEN, 16000 },
+    { BUTTON_UP,     20000 },
+    { BUTTON_SCREEN, 24000 },
+    { BUTTON_DOWN,   28000 },
+};
+
+extern uint16_t duty_cycle;
+
+int Firmware_Main(void);
+
+static void Bench_Entry(void)
+{
+    Firmware_Main();
+}
+
+// LM35 em rampa triangular 25..35 °C com período de 20 s
+static uint16_t Bench_Temperature(uint64_t now, void *ctx)
+{
+    uint64_t period = Sim_CyclesFromMs(20000);
+    uint64_t phase = now % period;
+    uint64_t half = period / 2U;
+    double frac = (phase < half) ? (double)phase / (double)half
+                                 : (double)(period - phase) / (double)half;
+    double millivolts = (25.0 + 10.0 * frac) * 10.0;
+
+    (void)ctx;
+    return (uint16_t)(millivolts * 4095.0 / 3300.0 + 0.5);
+}
+
+// Fim da inicialização: as estatísticas cobrem só a janela medida
+static void Bench_StartWindow(void *arg)
+{
+    (void)arg;
+    Prof_Reset();
+    Sched_ResetStats();
+}
+
+static double Bench_Us(uint64_t ticks)
+{
+    return (double)ticks * 1e6 / (double)SIM_CLOCK_HZ;
+}
+
+static void Bench_SchedReport(void)
+{
+    uint64_t window = Sched_ElapsedCycles();
+
+    printf("%-16s %8s %12s %8s %10s %10s %7s\n", "tarefa (sched)", "execucoes", "total (ms)",
+           "% CPU", "pior (us)", "atraso(ms)", "perdas");
+    for (uint8_t i = 0; i < Sched_TaskCount(); i++)
+    {
+        const Sched_Task *t = Sched_GetTask(i);
+        printf("%-16s %8lu %12.2f %7.2f%% %10.1f %10lu %7lu\n", t->name, (unsigned long)t->runs,
+               Bench_Us(t->cycles) / 1000.0, window ? 100.0 * (double)t->cycles / (double)window : 0.0,
+               Bench_Us(t->max_cycles), (unsigned long)t->max_late_ms, (unsigned long)t->misses);
+    }
+    printf("ocioso (__WFI)   : %.2f%%\n",
+           window ? 100.0 * (double)Sched_IdleCycles() / (double)window : 0.0);
+}
+
+static void Bench_Press(void *arg)
+{
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, (uint16_t)(uintptr_t)arg, GPIO_PIN_RESET);
+}
+
+static void Bench_Release(void *arg)
+{
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, (uint16_t)(uintptr_t)arg, GPIO_PIN_SET);
+}
+
+// Transição com repique: alterna o nível e termina em 'press'
+static void Bench_Bounce(uint64_t at, void *pin, int press)
+{
+    size_t n = sizeof(bounce_us) / sizeof(bounce_us[0]);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        int low = ((n - 1U - i) % 2U == 0U) ? press : !press;
+        Sim_Schedule(at + Sim_CyclesFromUs(bounce_us[i]), low ? Bench_Press : Bench_Release, pin);
+    }
+}
+
+int main(void)
+{
+    Sim_Reset();
+    Prof_Reset();
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_UP | BUTTON_DOWN | BUTTON_SCREEN, GPIO_PIN_SET);
+    Sim_SetAnalogSource(ADC_CHANNEL_2, Bench_Temperature, NULL);
+    Sim_Schedule(Sim_CyclesFromMs(BENCH_BOOT_MS), Bench_StartWindow, NULL);
+
+    for (size_t i = 0; i < sizeof(clicks) / sizeof(clicks[0]); i++)
+    {
+        void *pin = (void *)(uintptr_t)clicks[i].pin;
+        uint64_t at = Sim_CyclesFromMs(BENCH_BOOT_MS + clicks[i].at_ms);
+        Bench_Bounce(at, pin, 1);
+        Bench_Bounce(at + Sim_CyclesFromMs(BENCH_CLICK_MS), pin, 0);
+    }
+
+    Sim_Run(Bench_Entry, Sim_CyclesFromMs(BENCH_BOOT_MS + BENCH_WINDOW_MS));
+
+    printf("== bench_superloop (%lu Hz) ==\n", (unsigned long)SystemCoreClock);
+    Prof_Report(stdout);
+    Bench_SchedReport();
+    printf("duty cycle final : %u%%, eventos de botão descartados: %lu\n",
+           duty_cycle, (unsigned long)Buttons_Dropped());
+    return 0;
+}
@@ -0,0 +1,225 @@
+/**
+  ******************************************************************************
+  * @file    bench_telemetry.c
+  * @brief   Telemetria da USART2 (telemetry.c) com o firmware inteiro sob o
+  *          relógio virtual, em laço fechado por um PTY: a USART simulada
+  *          escreve no mestre e um processo leitor abre o escravo como uma
+  *          porta serial e decodifica com o telemetry_dec.c.
+  *
+  *          Três casos, um processo cada (mais o leitor):
+  *           - 115200 baud, amostra a cada 100 ms: o padrão;
+  *           - 115200 baud a cada 10 ms: a linha ainda dá conta;
+  *           - 9600 baud a cada 10 ms: a linha não dá conta, e o buffer
+  *             duplo descarta quadros em vez de segurar a CPU.
+  *          As amostras param BENCH_QUIET_MS antes do fim para a linha
+  *          esvaziar. Conformidade: nenhum erro de CRC ou COBS, todo quadro
+  *          aceito chega e todo descarte aparece como buraco na sequência,
+  *          os bytes do DMA são os do PTY, o texto da partida chega e a
+  *          temperatura bate com o LM35. A pior execução da tarefa tem de
+  *          ficar bem abaixo do tempo de um quadro na linha.
+  ******************************************************************************
+  */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "main.h"
+#include "host_sim.h"
+#include "scheduler.h"
+#include "telemetry_dec.h"
+
+#define BENCH_END_MS        3000U
+#define BENCH_QUIET_MS      500U      // Sem amostras no fim: a 9600 o buffer duplo sai em ~270 ms
+#define BENCH_TEMP_MV       250U      // LM35 a 25 °C
+#define BENCH_TEMP_TOL      50        // Centésimos de °C
+#define BENCH_MAX_CYCLES    8000U     // Pior execução da tarefa (um quadro a 115200 são ~100k)
+#define BENCH_CASES         3U
+
+int Firmware_Main(void);
+
+typedef struct
+{
+    const char *name;
+    uint32_t baud;
+    uint32_t period_ms;
+    uint8_t overload;         // Descartes esperados
+    Telemetry_Stats stats;    // Do firmware, no fim
+    uint64_t line_bytes;      // Saídos da USART simulada
+    uint32_t task_max;        // Pior execução da tarefa Telemetria
+    // Do leitor
+    TelDec_Summary sum;
+    uint8_t got_boot;         // Texto "partida" na sequência 0
+    uint8_t reader_ok;
+    uint32_t disorder;        // Amostras com o tempo voltando
+    int32_t last_temp;
+    uint32_t last_time;
+} Bench_Case;
+
+static Bench_Case *cases;
+
+static void Bench_Entry(void)
+{
+    Firmware_Main();
+}
+
+// Depois do Telemetry_Init() do main, sem ciclos
+static void Bench_Configure(void *arg)
+{
+    Bench_Case *c = arg;
+
+    Telemetry_SetPeriod(c->period_ms);
+    (void)Telemetry_SetBaud(c->baud);
+}
+
+static void Bench_Quiet(void *arg)
+{
+    (void)arg;
+    Telemetry_SetPeriod(0);
+}
+
+static void Bench_Packet(const TelDec_Packet *pkt, void *ctx)
+{
+    Bench_Case *c = ctx;
+
+    if (pkt->type == TELEMETRY_PKT_TEXT)
+    {
+        c->got_boot |= (pkt->seq == 0U && pkt->len == 7U && memcmp(pkt->body, "partida", 7) == 0);
+        return;
+    }
+    if (pkt->type != TELEMETRY_PKT_SAMPLE || pkt->len != TELEMETRY_SAMPLE_SIZE)
+        return;
+    c->disorder += (pkt->sample.time_ms < c->last_time);
+    c->last_time = pkt->sample.time_ms;
+    c->last_temp = pkt->sample.temp_cdeg;
+}
+
+// Leitor: o escravo em modo cru até o EIO do mestre fechado
+static void Bench_Reader(Bench_Case *c, const char *name)
+{
+    uint8_t chunk[256];
+    TelDec dec;
+    ssize_t n;
+    int fd = open(name, O_RDONLY | O_NOCTTY);
+
+    if (fd < 0)
+        exit(1);
+    TelDec_Init(&dec, Bench_Packet, c);
+    for (;;)
+    {
+        n = read(fd, chunk, sizeof(chunk));
+        if (n > 0)
+            TelDec_Feed(&dec, chunk, (uint32_t)n);
+        else if (n == 0 || errno != EINTR)
+            break;
+    }
+    c->sum = dec.sum;
+    c->reader_ok = (n == 0 || errno == EIO);
+    exit(0);
+}
+
+static uint32_t Bench_Run(Bench_Case *c)
+{
+    char name[64];
+    int master, status = 1;
+    pid_t reader;
+
+    master = SimUsart_OpenPty(name, sizeof(name));
+    if (master < 0)
+        return 1;
+    reader = fork();
+    if (reader == 0)
+    {
+        close(master);      // Só o simulador segura o mestre: o fechamento vira EIO
+        Bench_Reader(c, name);
+    }
+    if (reader < 0)
+        return 1;
+
+    Sim_Reset();
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_UP | BUTTON_DOWN | BUTTON_SCREEN, GPIO_PIN_SET);
+    Sim_SetAnalogMillivolts(ADC_CHANNEL_2, BENCH_TEMP_MV);
+    Sim_Schedule(Sim_CyclesFromMs(1), Bench_Configure, c);
+    Sim_Schedule(Sim_CyclesFromMs(BENCH_END_MS - BENCH_QUIET_MS), Bench_Quiet, NULL);
+    Sim_Run(Bench_Entry, Sim_CyclesFromMs(BENCH_END_MS));
+
+    c->stats = *Telemetry_GetStats();
+    c->line_bytes = SimUsart_TxBytes();
+    for (uint8_t i = 0; i < Sched_TaskCount(); i++)
+    {
+        const Sched_Task *t = Sched_GetTask(i);
+
+        if (strcmp(t->name, "Telemetria") == 0)
+            c->task_max = t->max_cycles;
+    }
+    SimUsart_ClosePty();
+    if (waitpid(reader, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        return 1;
+    return 0;
+}
+
+static uint32_t Bench_Fork(Bench_Case *c)
+{
+    int status = 1;
+    pid_t pid;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0)
+        exit(Bench_Run(c) ? 1 : 0);
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        return 1;
+    return 0;
+}
+
+static uint32_t Bench_Report(const Bench_Case *c)
+{
+    const TelDec_Summary *s = &c->sum;
+    uint32_t failed;
+    int32_t temp_err = c->last_temp - (int32_t)BENCH_TEMP_MV * 10;
+
+    failed = (!c->reader_ok || !c->got_boot || s->crc_errors != 0U || s->cobs_errors != 0U || s->oversize != 0U
+              || s->unknown != 0U || c->disorder != 0U || c->stats.dma_errors != 0U);
+    // Todo quadro aceito chega; todo descarte é um buraco na sequência
+    failed += (s->packets != c->stats.frames || s->lost != c->stats.dropped);
+    failed += (s->bytes != c->line_bytes || c->line_bytes != c->stats.bytes);
+    failed += (c->overload ? c->stats.dropped == 0U : c->stats.dropped != 0U);
+    failed += (temp_err > BENCH_TEMP_TOL || temp_err < -BENCH_TEMP_TOL);
+    failed += (c->task_max > BENCH_MAX_CYCLES);
+
+    printf("%-14s %7lu %7lu %7lu %8llu %7.1f%% %5lu %4lu %4lu %8lu %6.2f  %s\n", c->name,
+           (unsigned long)c->stats.frames, (unsigned long)s->packets, (unsigned long)c->stats.dropped,
+           (unsigned long long)s->bytes, 100.0 * c->stats.max_fill / TELEMETRY_BUF_SIZE,
+           (unsigned long)s->lost, (unsigned long)s->crc_errors, (unsigned long)s->cobs_errors,
+           (unsigned long)c->task_max, c->last_temp / 100.0, failed ? "FALHOU" : "ok");
+    return failed;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    cases = mmap(NULL, BENCH_CASES * sizeof(Bench_Case), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1,
+                 0);
+    if (cases == MAP_FAILED)
+        return 1;
+    memset(cases, 0, BENCH_CASES * sizeof(Bench_Case));
+    cases[0] = (Bench_Case){ .name = "115200/100ms", .baud = 115200U, .period_ms = 100U };
+    cases[1] = (Bench_Case){ .name = "115200/10ms", .baud = 115200U, .period_ms = 10U };
+    cases[2] = (Bench_Case){ .name = "9600/10ms", .baud = 9600U, .period_ms = 10U, .overload = 1 };
+
+    // Um processo por caso: o estado do firmware não volta com o Sim_Reset()
+    for (uint32_t i = 0; i < BENCH_CASES; i++)
+        failed += Bench_Fork(&cases[i]);
+
+    printf("== bench_telemetry (%u ms, buffer duplo de 2x%u bytes, PTY) ==\n", BENCH_END_MS, TELEMETRY_BUF_SIZE);
+    printf("%-14s %7s %7s %7s %8s %8s %5s %4s %4s %8s %6s\n", "caso", "quadros", "lidos", "descart", "bytes",
+           "ocupacao", "seq", "crc", "cobs", "ciclos", "temp");
+    for (uint32_t i = 0; i < BENCH_CASES; i++)
+        failed += Bench_Report(&cases[i]);
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/**
+  ******************************************************************************
+  * @file    bench_temperature.c
+  * @brief   Custo por amostra da conversão do LM35: o caminho antigo em
+  *          double, que no Cortex-M0+ (-mfloat-abi=soft) chama as rotinas
+  *          de soft-float da libgcc, contra o de ponto fixo em centésimos
+  *          de °C de temp_sensor.c.
+  *
+  *          O caminho antigo é refeito aqui com o custo modelado das
+  *          rotinas (host_cost.h); o novo é a função do firmware, medida
+  *          pelo relógio virtual. Todas as somas possíveis de um bloco são
+  *          conferidas contra a referência em double: erro máximo e
+  *          decisões do alarme de 30 °C que divergem, nos dois caminhos.
+  *          O antigo partia da média arredondada a 1 LSB (~8 centésimos).
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <math.h>
+#include "host_sim.h"
+#include "temp_sensor.h"
+
+#define BENCH_ALARM_CDEG   3000
+#define BENCH_CMP_CYCLES   3U     // cmp + bge com a constante em registrador
+
+// Conversão e alarme como eram em main.c, com o custo das chamadas à libgcc
+static float Bench_FloatPath(uint16_t raw, uint8_t *alarm)
+{
+    float t = (raw * 330.0) / 4095.0;
+
+    Sim_Consume(SIM_COST_SF_UI2D + SIM_COST_SF_DMUL + SIM_COST_SF_DDIV + SIM_COST_SF_D2F);
+    *alarm = (t >= 30.0);
+    Sim_Consume(SIM_COST_SF_F2D + SIM_COST_SF_DCMPGE);
+    return t;
+}
+
+static int32_t Bench_FixedPath(uint32_t sum, uint8_t *alarm)
+{
+    int32_t cdeg = TempSensor_SumToCentiCelsius(sum);
+
+    *alarm = (cdeg >= BENCH_ALARM_CDEG);
+    Sim_Consume(BENCH_CMP_CYCLES);
+    return cdeg;
+}
+
+int main(void)
+{
+    uint64_t start, float_cycles, fixed_cycles;
+    double float_err = 0.0, fixed_err = 0.0;
+    uint32_t float_miss = 0, fixed_miss = 0;
+    uint32_t samples = TEMP_ADC_FULL_SCALE + 1U;
+    uint32_t sums = TEMP_ADC_FULL_SCALE * TEMP_HALF_LEN + 1U;
+
+    Sim_Reset();
+
+    start = Sim_Cycles();
+    for (uint32_t raw = 0; raw < samples; raw++)
+    {
+        uint8_t alarm;
+        (void)Bench_FloatPath((uint16_t)raw, &alarm);
+    }
+    float_cycles = Sim_Cycles() - start;
+
+    start = Sim_Cycles();
+    for (uint32_t raw = 0; raw < samples; raw++)
+    {
+        uint8_t alarm;
+        (void)Bench_FixedPath(raw * TEMP_HALF_LEN, &alarm);
+    }
+    fixed_cycles = Sim_Cycles() - start;
+
+    // Exatidão: médias com resolução de 1/TEMP_HALF_LEN de LSB
+    for (uint32_t sum = 0; sum < sums; sum++)
+    {
+        double ref = (sum * 33000.0) / (TEMP_ADC_FULL_SCALE * (double)TEMP_HALF_LEN);
+        uint16_t mean = (uint16_t)((sum + TEMP_HALF_LEN / 2U) / TEMP_HALF_LEN);
+        uint8_t ref_alarm = (ref >= BENCH_ALARM_CDEG);
+        uint8_t alarm;
+        double err;
+
+        err = fabs(Bench_FloatPath(mean, &alarm) * 100.0 - ref);
+        float_err = (err > float_err) ? err : float_err;
+        float_miss += (alarm != ref_alarm);
+
+        err = fabs(Bench_FixedPath(sum, &alarm) - ref);
+        fixed_err = (err > fixed_err) ? err : fixed_err;
+        fixed_miss += (alarm != ref_alarm);
+    }
+
+    printf("== bench_temperature (%lu Hz) ==\n", (unsigned long)SystemCoreClock);
+    printf("escala Q%u               : %lu (centésimos de °C por soma de %u amostras)\n",
+           TEMP_SCALE_SHIFT, (unsigned long)TEMP_SCALE_Q16, TEMP_HALF_LEN);
+    printf("%-24s %10s %12s %14s %10s\n", "caminho", "ciclos", "us/amostra", "erro max (c°C)", "alarme !=");
+    printf("%-24s %10.1f %12.3f %14.3f %10lu\n", "double (soft-float)",
+           (double)float_cycles / samples, (double)float_cycles / samples * 1e6 / SystemCoreClock,
+           float_err, (unsigned long)float_miss);
+    printf("%-24s %10.1f %12.3f %14.3f %10lu\n", "ponto fixo (Q16)",
+           (double)fixed_cycles / samples, (double)fixed_cycles / samples * 1e6 / SystemCoreClock,
+           fixed_err, (unsigned long)fixed_miss);
+    printf("ganho                    : %.0fx em %lu somas conferidas\n",
+           (double)float_cycles / (double)fixed_cycles, (unsigned long)sums);
+    return (fixed_err <= float_err && fixed_miss <= float_miss) ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+/**
+  ******************************************************************************
+  * @file    bench_timebase.c
+  * @brief   Base de tempo em us (TIM7, timebase.c) contra o relógio virtual.
+  *
+  *          - Trocas: perfis de clock sorteados com intervalos sorteados; a
+  *            leitura tem de cair entre o antes e o depois no tempo virtual
+  *            (menos a deriva de até 1 us por troca) e nunca voltar;
+  *          - Esperas: Timebase_DelayUs() em cada perfil, curtas (só o CNT)
+  *            e longas (64 bits): nunca menos que o pedido, e o excesso
+  *            limitado a uma leitura no SYSCLK do perfil;
+  *          - STOP: o firmware inteiro até entrar em espera e dormir; a base
+  *            corrigida pelo RTC na saída do STOP contra o tempo virtual,
+  *            perdendo só a fração de us do contador e a saída a cada STOP.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "main.h"
+#include "host_sim.h"
+#include "clock.h"
+#include "power.h"
+#include "timebase.h"
+
+#define BENCH_SWITCHES       2000U
+#define BENCH_MAX_GAP_US     20000U    // Intervalo sorteado entre as trocas
+#define BENCH_DELAY_SLACK_US 2U        // Além da última leitura
+#define BENCH_DELAY_CYCLES   120U      // Chamada e última volta do laço, em ciclos do SYSCLK
+#define BENCH_STOP_END_MS    150000U   // Espera aos 60 s, depois só STOP entre as tarefas
+#define BENCH_STOP_MAX_US    200       // Partida do TIM7 depois do clock
+#define BENCH_STOP_US        2         // Fração de us perdida por STOP, com folga
+
+void SystemClock_Config(void);
+void TIM7_Init(void);
+int Firmware_Main(void);
+
+static const uint32_t delays_us[] = { 1, 5, 10, 37, 100, 1000, 32767, 40000, 100000 };
+
+static uint32_t Bench_Switches(void)
+{
+    uint64_t before, after, last = 0, now;
+    int64_t offset, err, max_err = 0;
+    uint32_t backwards = 0, changes = 0, failed;
+
+    Sim_Reset();
+    HAL_Init();
+    SystemClock_Config();
+    TIM7_Init();
+    srand(7);
+
+    // O TIM7 parte depois do clock: o que ele contou até aqui é a origem
+    offset = (int64_t)Timebase_Micros64() - (int64_t)Sim_Micros();
+    for (uint32_t i = 0; i < BENCH_SWITCHES; i++)
+    {
+        uint8_t profile = (uint8_t)(rand() % CLOCK_PROFILE_COUNT);
+
+        changes += (profile != Clock_GetProfile());
+        Clock_SetProfile(profile);
+        Sim_SpinUntil(Sim_Now() + Sim_CyclesFromUs((uint64_t)(rand() % BENCH_MAX_GAP_US)));
+
+        before = Sim_Micros();
+        now = Timebase_Micros64();
+        after = Sim_Micros();
+        backwards += (now < last);
+        last = now;
+
+        err = (int64_t)now - offset;
+        if (err < (int64_t)before)
+            err -= (int64_t)before;
+        else if (err > (int64_t)after + 1)
+            err -= (int64_t)after + 1;
+        else
+            err = 0;
+        if (llabs(err) > llabs(max_err))
+            max_err = err;
+    }
+
+    failed = (backwards != 0U || llabs(max_err) > (int64_t)changes);
+    printf("trocas      %5lu trocas %8.1f s   maior erro %+5lld us (limite %lu)   voltas atras %lu  %s\n",
+           (unsigned long)changes, (double)Sim_Micros() / 1e6, (long long)max_err,
+           (unsigned long)changes, (unsigned long)backwards, failed ? "FALHOU" : "ok");
+    return failed;
+}
+
+static uint32_t Bench_Delays(void)
+{
+    uint32_t failed = 0;
+
+    for (uint8_t p = 0; p < CLOCK_PROFILE_COUNT; p++)
+    {
+        uint32_t slack = BENCH_DELAY_SLACK_US + BENCH_DELAY_CYCLES / (Clock_Profiles[p].sysclk_hz / 1000000U);
+        int64_t worst = INT64_MIN, least = INT64_MAX;
+        uint32_t bad = 0;
+
+        Clock_SetProfile(p);
+        for (uint32_t i = 0; i < sizeof(delays_us) / sizeof(delays_us[0]); i++)
+        {
+            uint64_t start = Sim_Now();
+            int64_t over;
+
+            Timebase_DelayUs(delays_us[i]);
+            over = (int64_t)((Sim_Now() - start) / Sim_CyclesFromUs(1)) - (int64_t)delays_us[i];
+            bad += (over < 0 || over > (int64_t)slack);
+            worst = (over > worst) ? over : worst;
+            least = (over < least) ? over : least;
+        }
+        printf("espera      %-10s excesso %+4lld a %+4lld us (limite %lu)  %s\n", Clock_Profiles[p].name,
+               (long long)least, (long long)worst, (unsigned long)slack, bad ? "FALHOU" : "ok");
+        failed += bad;
+    }
+    return failed;
+}
+
+static void Bench_Entry(void)
+{
+    Firmware_Main();
+}
+
+static uint32_t Bench_Stop(void)
+{
+    int64_t err, limit;
+    uint32_t stops, failed;
+
+    Sim_Reset();
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_UP | BUTTON_DOWN | BUTTON_SCREEN, GPIO_PIN_SET);
+    Sim_Run(Bench_Entry, Sim_CyclesFromMs(BENCH_STOP_END_MS));
+
+    // Fora do firmware: a leitura cobra ciclos, mas nada mais roda
+    err = (int64_t)Timebase_Micros64() - (int64_t)Sim_Micros();
+    stops = Power_GetStats()->entries[POWER_MODE_STOP];
+    limit = BENCH_STOP_MAX_US + (int64_t)stops * BENCH_STOP_US;
+    failed = (stops == 0U || llabs(err) > limit);
+    printf("STOP        %5lu entradas %5.1f s dormindo   erro %+5lld us (limite %lld)  %s\n",
+           (unsigned long)stops, (double)Sim_StopTicks() / SIM_CLOCK_HZ, (long long)err,
+           (long long)limit, failed ? "FALHOU" : "ok");
+    return failed;
+}
+
+static uint32_t Bench_Fork(uint32_t (*fn)(void))
+{
+    int status = 1;
+    pid_t pid;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0)
+        exit(fn() ? 1 : 0);
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        return 1;
+    return 0;
+}
+
+static uint32_t Bench_SwitchesAndDelays(void)
+{
+    uint32_t failed = Bench_Switches();
+
+    return failed + Bench_Delays();
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    printf("== bench_timebase (TIM7 a 1 MHz estendido a 64 bits) ==\n");
+    // Um processo por cenário: o estado do firmware não volta com o Sim_Reset()
+    failed += Bench_Fork(Bench_SwitchesAndDelays);
+    failed += Bench_Fork(Bench_Stop);
+    return (failed == 0) ? 0 : 1;
+}
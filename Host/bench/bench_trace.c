@@ -0,0 +1,215 @@
+/**
+  ******************************************************************************
+  * @file    bench_trace.c
+  * @brief   Rastro de execução (trace.c) com o firmware inteiro sob o relógio
+  *          virtual, do anel ao JSON do trace_export (trace_dec.c).
+  *
+  *          A mesma execução (PWM subindo pelo UP e uma troca de tela pelo
+  *          SCREEN, no fim) com três máscaras, um processo cada:
+  *           - nenhum tipo: a referência de CPU ocupada;
+  *           - todos: eventos por segundo, janela que o anel cobre e o
+  *             custo por evento, pela CPU ocupada a mais;
+  *           - sem ISRs e ocioso (2 eventos por ms cada, com o SysTick): a
+  *             janela longa, onde cabem todos os tipos da aplicação.
+  *          Conformidade: instantes em ordem e dentro do tempo virtual,
+  *          todo fim com início (menos os cortados pelo anel) e um JSON
+  *          com as chaves e colchetes fechados.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "main.h"
+#include "host_sim.h"
+#include "scheduler.h"
+#include "timebase.h"
+#include "trace_dec.h"
+
+#define BENCH_END_MS         6000U
+#define BENCH_UP_AT_MS       5500U    // Depois da tela de boas-vindas, dentro da janela
+#define BENCH_STEPS          3U
+#define BENCH_SCREEN_AT_MS   5850U
+#define BENCH_MAX_CYCLES     60.0     // Custo por evento, chamada inclusa
+#define BENCH_MIN_WINDOW_MS  500.0    // Janela só com as tarefas e a aplicação
+
+#define BENCH_MASK_SYSTEM    ((1UL << TRACE_ISR_ENTER) | (1UL << TRACE_ISR_EXIT) \
+                              | (1UL << TRACE_IDLE_BEGIN) | (1UL << TRACE_IDLE_END))
+
+int Firmware_Main(void);
+
+typedef struct
+{
+    const char *name;
+    uint32_t mask;
+    uint8_t check;            // Todos os tipos da máscara têm de aparecer no anel
+    uint64_t busy;            // Ciclos de CPU fora do ocioso
+    uint64_t elapsed;
+    uint32_t recorded;        // Eventos gravados (head)
+    TraceDec_Summary sum;
+    uint32_t disorder;        // Instantes fora de ordem ou além do agora
+    uint32_t json_bad;
+} Bench_Case;
+
+static Bench_Case *cases;
+static Bench_Case *current;
+static uint64_t last_us;
+static uint64_t now_us;
+
+static void Bench_Entry(void)
+{
+    Firmware_Main();
+}
+
+static void Bench_Button(void *arg)
+{
+    uint32_t v = (uint32_t)(uintptr_t)arg;
+
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, (uint16_t)(v & 0xFFFFU), (v >> 16) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+static void Bench_Press(uint16_t pin, uint32_t at_ms, uint32_t hold_ms)
+{
+    Sim_Schedule(Sim_CyclesFromMs(at_ms), Bench_Button, (void *)(uintptr_t)(pin | (1UL << 16)));
+    Sim_Schedule(Sim_CyclesFromMs(at_ms + hold_ms), Bench_Button, (void *)(uintptr_t)pin);
+}
+
+// Só escreve a máscara: depois do Trace_Init() do main, sem ciclos
+static void Bench_Mask(void *arg)
+{
+    Trace_SetMask(((Bench_Case *)arg)->mask);
+}
+
+static void Bench_Check(const TraceDec_Event *ev, void *ctx)
+{
+    (void)ctx;
+    current->disorder += (ev->time_us < last_us || ev->time_us > now_us);
+    last_us = ev->time_us;
+}
+
+// Chaves e colchetes fechados na ordem, fora das strings
+static uint32_t Bench_JsonBad(FILE *f)
+{
+    char stack[16];
+    int depth = 0, c, in_str = 0, esc = 0;
+    uint32_t bad = 0;
+
+    rewind(f);
+    while ((c = fgetc(f)) != EOF)
+    {
+        if (in_str)
+        {
+            esc = !esc && c == '\\';
+            in_str = esc || c != '"';
+            continue;
+        }
+        if (c == '"')
+            in_str = 1;
+        else if (c == '{' || c == '[')
+        {
+            if (depth < (int)sizeof(stack))
+                stack[depth] = (char)c;
+            depth++;
+        }
+        else if (c == '}' || c == ']')
+        {
+            depth--;
+            bad += (depth < 0 || stack[depth] != (c == '}' ? '{' : '['));
+        }
+    }
+    return bad + (depth != 0) + (in_str != 0);
+}
+
+static uint32_t Bench_Run(Bench_Case *c)
+{
+    TraceDec_Summary sum;
+    FILE *json;
+
+    current = c;
+    Sim_Reset();
+    Sim_SetPinLevel(BUTTON_GPIO_PORT, BUTTON_UP | BUTTON_DOWN | BUTTON_SCREEN, GPIO_PIN_SET);
+    Sim_SetAnalogMillivolts(ADC_CHANNEL_2, 250U);
+    Sim_Schedule(Sim_CyclesFromMs(1), Bench_Mask, c);
+    for (uint32_t i = 0; i < BENCH_STEPS; i++)
+        Bench_Press(BUTTON_UP, BENCH_UP_AT_MS + i * 100U, 50U);
+    Bench_Press(BUTTON_SCREEN, BENCH_SCREEN_AT_MS, 100U);
+    Sim_Run(Bench_Entry, Sim_CyclesFromMs(BENCH_END_MS));
+
+    c->elapsed = Sched_ElapsedCycles();
+    c->busy = c->elapsed - Sched_IdleCycles();
+    c->recorded = trace_buffer.head;
+    now_us = Timebase_Micros64();
+    last_us = 0;
+    TraceDec_Events(&trace_buffer, Bench_Check, NULL, &c->sum);
+
+    json = tmpfile();
+    if (json == NULL)
+        return 1;
+    TraceDec_WriteJson(json, &trace_buffer, &sum);
+    c->sum.unmatched = sum.unmatched;
+    c->json_bad = Bench_JsonBad(json);
+    fclose(json);
+    return 0;
+}
+
+static uint32_t Bench_Fork(Bench_Case *c)
+{
+    int status = 1;
+    pid_t pid;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0)
+        exit(Bench_Run(c) ? 1 : 0);
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        return 1;
+    return 0;
+}
+
+static uint32_t Bench_Report(const Bench_Case *c, const Bench_Case *ref)
+{
+    double seconds = (double)BENCH_END_MS / 1000.0;
+    double cost = c->recorded ? (double)(c->busy - ref->busy) / c->recorded : 0.0;
+    uint32_t missing = 0, failed;
+
+    for (uint32_t t = 0; t < TRACE_TYPE_COUNT; t++)
+        missing += (c->check && (c->mask & (1UL << t)) != 0U && c->sum.counts[t] == 0U);
+    failed = (c->disorder != 0U || c->json_bad != 0U || missing != 0U || cost > BENCH_MAX_CYCLES);
+    // Fins sem início só no começo do anel: um por trilha aberta no corte
+    failed += (c->sum.unmatched > SCHED_MAX_TASKS + 4U);
+    if (c->check)
+        failed += (c->sum.span_us < BENCH_MIN_WINDOW_MS * 1000.0);
+
+    printf("%-10s %8.0f %9.1f %8.2f%% %8.1f %6lu %6lu %6lu  %s\n", c->name, c->recorded / seconds,
+           c->sum.span_us / 1000.0, 100.0 * (double)(c->busy - ref->busy) / c->elapsed, cost,
+           (unsigned long)missing, (unsigned long)c->sum.unmatched, (unsigned long)c->disorder,
+           failed ? "FALHOU" : "ok");
+    return failed;
+}
+
+int main(void)
+{
+    uint32_t failed = 0;
+
+    cases = mmap(NULL, 3 * sizeof(Bench_Case), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (cases == MAP_FAILED)
+        return 1;
+    memset(cases, 0, 3 * sizeof(Bench_Case));
+    cases[0] = (Bench_Case){ .name = "nenhum", .mask = 0U };
+    cases[1] = (Bench_Case){ .name = "todos", .mask = TRACE_MASK_ALL };
+    cases[2] = (Bench_Case){ .name = "aplicacao", .mask = TRACE_MASK_ALL & ~BENCH_MASK_SYSTEM, .check = 1 };
+
+    // Um processo por máscara: o estado do firmware não volta com o Sim_Reset()
+    for (uint32_t i = 0; i < 3U; i++)
+        failed += Bench_Fork(&cases[i]);
+
+    printf("== bench_trace (anel de %u eventos, %u bytes) ==\n", TRACE_CAPACITY, (unsigned)sizeof(Trace_Buffer));
+    printf("%-10s %8s %9s %9s %8s %6s %6s %6s\n", "mascara", "ev/s", "janela", "CPU", "ciclos", "tipos",
+           "s/par", "ordem");
+    for (uint32_t i = 1; i < 3U; i++)
+        failed += Bench_Report(&cases[i], &cases[0]);
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+/**
+  ******************************************************************************
+  * @file    datalog_dec.c
+  * @brief   Decodificador do registro de campo: valida cada bloco pelo
+  *          CRC-32 (implementação própria, bit a bit, para conferir a do
+  *          firmware), ordena pela sequência e refaz as amostras a partir
+  *          da primeira completa do cabeçalho e dos deltas.
+  ******************************************************************************
+  */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "datalog_dec.h"
+
+typedef struct
+{
+    uint32_t seq;
+    uint32_t offset;
+} LogDec_Block;
+
+static uint32_t LogDec_Crc(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++)
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+    }
+    return crc;
+}
+
+static int LogDec_Valid(const uint8_t *blk)
+{
+    DataLog_Header head;
+    uint32_t crc, stored;
+
+    memcpy(&head, blk, sizeof(head));
+    if (head.magic != DATALOG_MAGIC || head.used > DATALOG_PAYLOAD)
+        return 0;
+    // Deltas primeiro, depois o cabeçalho com o campo do CRC em zero
+    stored = head.crc;
+    head.crc = 0;
+    crc = LogDec_Crc(0xFFFFFFFFU, blk + sizeof(head), head.used);
+    return ~LogDec_Crc(crc, (const uint8_t *)&head, sizeof(head)) == stored;
+}
+
+static int LogDec_Compare(const void *a, const void *b)
+{
+    uint32_t sa = ((const LogDec_Block *)a)->seq, sb = ((const LogDec_Block *)b)->seq;
+
+    return (sa > sb) - (sa < sb);
+}
+
+static int LogDec_Varint(const uint8_t *p, uint32_t len, uint32_t *pos, uint32_t *value)
+{
+    uint32_t v = 0;
+
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t byte;
+
+        if (*pos >= len)
+            return 0;
+        byte = p[(*pos)++];
+        v |= (uint32_t)(byte & 0x7FU) << shift;
+        if ((byte & 0x80U) == 0U)
+        {
+            *value = v;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Refaz as amostras de um bloco válido; 0 se os deltas não fecham
+static int LogDec_Samples(const uint8_t *blk, LogDec_SampleFn fn, void *ctx, uint32_t *samples)
+{
+    DataLog_Header head;
+    const uint8_t *data = blk + sizeof(head);
+    LogDec_Sample s;
+    uint32_t pos = 0;
+
+    memcpy(&head, blk, sizeof(head));
+    s.boot = head.boot;
+    s.seq = head.seq;
+    s.time_ms = head.t0_ms;
+    s.temp_cdeg = head.temp0;
+    s.duty = head.duty0;
+    s.flags = head.flags0;
+    if (fn)
+        fn(&s, ctx);
+    (*samples)++;
+
+    while (pos < head.used)
+    {
+        uint8_t tag = data[pos++];
+
+        if ((tag & DATALOG_TAG_FULL) == 0U)
+        {
+            s.time_ms += head.period_ms;
+            s.temp_cdeg += (int8_t)(uint8_t)(tag << 1) >> 1;
+        }
+        else
+        {
+            uint32_t v;
+
+            if (tag & DATALOG_TAG_TIME)
+            {
+                if (!LogDec_Varint(data, head.used, &pos, &v))
+                    return 0;
+                s.time_ms += v;
+            }
+            else
+                s.time_ms += head.period_ms;
+            if (tag & DATALOG_TAG_TEMP)
+            {
+                if (!LogDec_Varint(data, head.used, &pos, &v))
+                    return 0;
+                s.temp_cdeg += (int32_t)(v >> 1) ^ -(int32_t)(v & 1U);
+            }
+            if (tag & DATALOG_TAG_DUTY)
+            {
+                if (pos >= head.used)
+                    return 0;
+                s.duty = data[pos++];
+            }
+            if (tag & DATALOG_TAG_FLAGS)
+            {
+                if (pos >= head.used)
+                    return 0;
+                s.flags = data[pos++];
+            }
+        }
+        if (fn)
+            fn(&s, ctx);
+        (*samples)++;
+    }
+    return 1;
+}
+
+void LogDec_Image(const uint8_t *image, uint32_t size, LogDec_SampleFn fn, void *ctx, LogDec_Summary *sum)
+{
+    uint32_t slots = size / DATALOG_BLOCK_SIZE, count = 0;
+    LogDec_Block *list = calloc(slots ? slots : 1U, sizeof(*list));
+
+    memset(sum, 0, sizeof(*sum));
+    for (uint32_t i = 0; i < slots; i++)
+    {
+        const uint8_t *blk = image + i * DATALOG_BLOCK_SIZE;
+        uint16_t magic;
+
+        memcpy(&magic, blk, sizeof(magic));
+        if (LogDec_Valid(blk))
+        {
+            memcpy(&list[count].seq, blk + offsetof(DataLog_Header, seq), sizeof(uint32_t));
+            list[count++].offset = i * DATALOG_BLOCK_SIZE;
+        }
+        else if (magic == DATALOG_MAGIC)
+            sum->bad_blocks++;
+    }
+    qsort(list, count, sizeof(*list), LogDec_Compare);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const uint8_t *blk = image + list[i].offset;
+        uint32_t samples = 0;
+        DataLog_Header head;
+
+        if (i > 0 && list[i].seq != list[i - 1U].seq + 1U)
+            sum->gaps++;
+        if (!LogDec_Samples(blk, fn, ctx, &samples))
+        {
+            sum->bad_blocks++;
+            continue;
+        }
+        sum->blocks++;
+        sum->samples += samples;
+        memcpy(&head, blk, sizeof(head));
+        sum->bytes += (uint32_t)((sizeof(head) + head.used + 7U) & ~7U);
+    }
+    free(list);
+}
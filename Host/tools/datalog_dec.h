@@ -0,0 +1,40 @@
+/**
+  ******************************************************************************
+  * @file    datalog_dec.h
+  * @brief   Decodificador do registro de campo (datalog.c) a partir de uma
+  *          imagem crua do anel lida da flash. Não depende do simulador:
+  *          serve ao datalog_decode e aos benchmarks.
+  ******************************************************************************
+  */
+
+#ifndef __DATALOG_DEC_H
+#define __DATALOG_DEC_H
+
+#include <stdint.h>
+#include "datalog.h"
+
+typedef struct
+{
+    uint16_t boot;
+    uint32_t seq;
+    uint32_t time_ms;      // HAL_GetTick() do boot
+    int32_t temp_cdeg;
+    uint8_t duty;
+    uint8_t flags;
+} LogDec_Sample;
+
+typedef struct
+{
+    uint32_t blocks;       // Blocos válidos
+    uint32_t bad_blocks;   // Cabeçalho presente, CRC ou deltas errados
+    uint32_t samples;
+    uint32_t bytes;        // Bytes de flash dos blocos válidos
+    uint32_t gaps;         // Saltos na sequência de blocos
+} LogDec_Summary;
+
+typedef void (*LogDec_SampleFn)(const LogDec_Sample *sample, void *ctx);
+
+// Decodifica todos os blocos válidos de 'image' em ordem de sequência
+void LogDec_Image(const uint8_t *image, uint32_t size, LogDec_SampleFn fn, void *ctx, LogDec_Summary *sum);
+
+#endif /* __DATALOG_DEC_H */
@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+  * @file    datalog_decode.c
+  * @brief   Lê a imagem crua do anel do registro de campo e imprime as
+  *          amostras em CSV, em ordem de gravação.
+  *
+  *          Uso: datalog_decode imagem.bin
+  *          A imagem são os DATALOG_SIZE bytes a partir de DATALOG_ADDR,
+  *          lidos do alvo (p.ex. st-flash read imagem.bin 0x08018000 24576)
+  *          ou gravados pelo host_sim -l. O resumo vai para stderr.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "datalog_dec.h"
+
+static const char *const mode_names[] = { "manual", "auto", "sintonia", "?" };
+
+static void Decode_Print(const LogDec_Sample *s, void *ctx)
+{
+    (void)ctx;
+    printf("%u,%lu,%lu,%.2f,%u,%u,%u,%u,%s\n", s->boot, (unsigned long)s->seq, (unsigned long)s->time_ms,
+           s->temp_cdeg / 100.0, s->duty, (s->flags & DATALOG_FLAG_ALARM) ? 1U : 0U,
+           (s->flags & DATALOG_FLAG_TRIP) ? 1U : 0U, (s->flags & DATALOG_FLAG_STANDBY) ? 1U : 0U,
+           mode_names[(s->flags & DATALOG_FLAG_MODE) >> DATALOG_FLAG_MODE_Pos]);
+}
+
+int main(int argc, char **argv)
+{
+    FILE *f;
+    uint8_t *image;
+    long size;
+    LogDec_Summary sum;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "uso: %s imagem.bin\n", argv[0]);
+        return 2;
+    }
+    f = fopen(argv[1], "rb");
+    if (f == NULL || fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) < 0)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    rewind(f);
+    image = malloc((size_t)size + 1U);
+    if (image == NULL || fread(image, 1, (size_t)size, f) != (size_t)size)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    fclose(f);
+
+    printf("boot,bloco,t_ms,temp_c,duty,alarme,protecao,espera,modo\n");
+    LogDec_Image(image, (uint32_t)size, Decode_Print, NULL, &sum);
+    fprintf(stderr, "%lu blocos (%lu estragados, %lu saltos), %lu amostras, %.2f bytes/amostra\n",
+            (unsigned long)sum.blocks, (unsigned long)sum.bad_blocks, (unsigned long)sum.gaps,
+            (unsigned long)sum.samples, sum.samples ? (double)sum.bytes / sum.samples : 0.0);
+    free(image);
+    return 0;
+}
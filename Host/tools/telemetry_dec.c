@@ -0,0 +1,134 @@
+/**
+  ******************************************************************************
+  * @file    telemetry_dec.c
+  * @brief   Decodificador da telemetria: quadros separados no 0x00, COBS
+  *          desfeito e CRC-32 conferido (implementação própria, bit a bit,
+  *          para conferir a do firmware). Um byte perdido estraga só o
+  *          quadro dele: o próximo zero realinha o fluxo.
+  ******************************************************************************
+  */
+
+#include <stddef.h>
+#include <string.h>
+#include "telemetry_dec.h"
+
+static uint32_t TelDec_Crc(const uint8_t *data, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++)
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+    }
+    return ~crc;
+}
+
+static uint16_t TelDec_Get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t TelDec_Get32(const uint8_t *p)
+{
+    return TelDec_Get16(p) | ((uint32_t)TelDec_Get16(p + 2) << 16);
+}
+
+// Desfaz o COBS de 'len' bytes (sem o zero final); -1 se um código passa
+// do fim do quadro
+static int TelDec_Unstuff(const uint8_t *in, uint16_t len, uint8_t *out)
+{
+    uint16_t i = 0, o = 0;
+
+    while (i < len)
+    {
+        uint8_t code = in[i];
+
+        if (code == 0U || i + code > len)
+            return -1;
+        memcpy(&out[o], &in[i + 1], code - 1U);
+        o += code - 1U;
+        i += code;
+        if (code != 0xFFU && i < len)
+            out[o++] = 0x00U;
+    }
+    return o;
+}
+
+static void TelDec_Frame(TelDec *dec)
+{
+    uint8_t payload[TELEMETRY_FRAME_MAX];
+    TelDec_Packet pkt;
+    int n = TelDec_Unstuff(dec->raw, dec->len, payload);
+
+    if (n < 0)
+    {
+        dec->sum.cobs_errors++;
+        return;
+    }
+    if (n < (int)(TELEMETRY_HEADER + TELEMETRY_CRC)
+        || TelDec_Crc(payload, (uint32_t)n - TELEMETRY_CRC) != TelDec_Get32(&payload[n - TELEMETRY_CRC]))
+    {
+        dec->sum.crc_errors++;
+        return;
+    }
+
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.type = payload[0];
+    pkt.seq = payload[1];
+    pkt.body = &payload[TELEMETRY_HEADER];
+    pkt.len = (uint16_t)(n - TELEMETRY_HEADER - TELEMETRY_CRC);
+    dec->sum.packets++;
+    // Buraco na sequência: quadros descartados no firmware ou perdidos na linha
+    if (dec->have_seq)
+        dec->sum.lost += (uint8_t)(pkt.seq - dec->next_seq);
+    dec->have_seq = 1;
+    dec->next_seq = (uint8_t)(pkt.seq + 1U);
+
+    if (pkt.type == TELEMETRY_PKT_SAMPLE && pkt.len == TELEMETRY_SAMPLE_SIZE)
+    {
+        pkt.sample.time_ms = TelDec_Get32(&pkt.body[0]);
+        pkt.sample.temp_cdeg = (int16_t)TelDec_Get16(&pkt.body[4]);
+        pkt.sample.duty_permille = TelDec_Get16(&pkt.body[6]);
+        pkt.sample.countdown_s = TelDec_Get16(&pkt.body[8]);
+        pkt.sample.flags = pkt.body[10];
+        dec->sum.samples++;
+    }
+    else if (pkt.type == TELEMETRY_PKT_TEXT)
+        dec->sum.texts++;
+    else
+        dec->sum.unknown++;
+    if (dec->fn != NULL)
+        dec->fn(&pkt, dec->ctx);
+}
+
+void TelDec_Init(TelDec *dec, TelDec_PacketFn fn, void *ctx)
+{
+    memset(dec, 0, sizeof(*dec));
+    dec->fn = fn;
+    dec->ctx = ctx;
+}
+
+// Zeros seguidos (quadro vazio) só realinham, sem contar erro
+void TelDec_Feed(TelDec *dec, const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        if (data[i] != 0x00U)
+        {
+            if (dec->len < sizeof(dec->raw))
+                dec->raw[dec->len++] = data[i];
+            else
+                dec->overflow = 1;
+            continue;
+        }
+        if (dec->overflow)
+            dec->sum.oversize++;
+        else if (dec->len != 0U)
+            TelDec_Frame(dec);
+        dec->len = 0;
+        dec->overflow = 0;
+    }
+    dec->sum.bytes += len;
+}
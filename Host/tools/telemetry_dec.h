@@ -0,0 +1,56 @@
+/**
+  ******************************************************************************
+  * @file    telemetry_dec.h
+  * @brief   Decodificador da telemetria da USART2 (telemetry.c) em fluxo:
+  *          recebe os bytes da linha em qualquer picotamento, separa os
+  *          quadros no 0x00, desfaz o COBS e confere o CRC-32. Não depende
+  *          do simulador: serve ao telemetry_decode e aos benchmarks.
+  ******************************************************************************
+  */
+
+#ifndef __TELEMETRY_DEC_H
+#define __TELEMETRY_DEC_H
+
+#include <stdint.h>
+#include "telemetry.h"
+
+typedef struct
+{
+    uint8_t type;                 // Telemetry_PacketType
+    uint8_t seq;
+    const uint8_t *body;
+    uint16_t len;
+    Telemetry_Sample sample;      // Só em TELEMETRY_PKT_SAMPLE
+} TelDec_Packet;
+
+typedef struct
+{
+    uint32_t packets;      // Quadros com o CRC certo
+    uint32_t samples;
+    uint32_t texts;
+    uint32_t unknown;      // Tipo desconhecido ou corpo de tamanho errado
+    uint32_t crc_errors;
+    uint32_t cobs_errors;  // Código COBS além do fim do quadro
+    uint32_t oversize;     // Quadro maior que TELEMETRY_FRAME_MAX
+    uint32_t lost;         // Pacotes que faltam pela sequência
+    uint64_t bytes;
+} TelDec_Summary;
+
+typedef void (*TelDec_PacketFn)(const TelDec_Packet *pkt, void *ctx);
+
+typedef struct
+{
+    uint8_t raw[TELEMETRY_FRAME_MAX];
+    uint16_t len;
+    uint8_t overflow;
+    uint8_t have_seq;
+    uint8_t next_seq;
+    TelDec_PacketFn fn;
+    void *ctx;
+    TelDec_Summary sum;
+} TelDec;
+
+void TelDec_Init(TelDec *dec, TelDec_PacketFn fn, void *ctx);
+void TelDec_Feed(TelDec *dec, const uint8_t *data, uint32_t len);
+
+#endif /* __TELEMETRY_DEC_H */
@@ -0,0 +1,138 @@
+/**
+  ******************************************************************************
+  * @file    telemetry_decode.c
+  * @brief   Lê a telemetria da USART2 e imprime as amostras em CSV, à
+  *          medida que chegam; as linhas de texto vão para stderr.
+  *
+  *          Uso: telemetry_decode [-b baud] [porta|arquivo|-]
+  *          A porta é a VCP do ST-LINK (p.ex. /dev/ttyACM0, posta em modo
+  *          cru a 'baud', padrão 115200) ou o PTY do host_sim -u; sem
+  *          argumento ou com '-', lê stdin. Termina no fim do arquivo, com
+  *          o PTY fechado ou no Ctrl-C, e o resumo vai para stderr.
+  ******************************************************************************
+  */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "telemetry_dec.h"
+#include "datalog.h"
+
+static const char *const mode_names[] = { "manual", "auto", "sintonia", "?" };
+
+static const struct
+{
+    unsigned long baud;
+    speed_t speed;
+} speeds[] = {
+    { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 },
+    { 115200, B115200 }, { 230400, B230400 }, { 460800, B460800 }, { 921600, B921600 },
+};
+
+static volatile sig_atomic_t stop;
+
+static void Decode_Stop(int sig)
+{
+    (void)sig;
+    stop = 1;
+}
+
+static void Decode_Print(const TelDec_Packet *pkt, void *ctx)
+{
+    const Telemetry_Sample *s = &pkt->sample;
+
+    (void)ctx;
+    if (pkt->type == TELEMETRY_PKT_TEXT)
+    {
+        fprintf(stderr, "[%u] %.*s\n", pkt->seq, (int)pkt->len, (const char *)pkt->body);
+        return;
+    }
+    if (pkt->type != TELEMETRY_PKT_SAMPLE || pkt->len != TELEMETRY_SAMPLE_SIZE)
+        return;
+    printf("%u,%lu,%.2f,%.1f,%u,%u,%u,%u,%s\n", pkt->seq, (unsigned long)s->time_ms, s->temp_cdeg / 100.0,
+           s->duty_permille / 10.0, s->countdown_s, (s->flags & DATALOG_FLAG_ALARM) ? 1U : 0U,
+           (s->flags & DATALOG_FLAG_TRIP) ? 1U : 0U, (s->flags & DATALOG_FLAG_STANDBY) ? 1U : 0U,
+           mode_names[(s->flags & DATALOG_FLAG_MODE) >> DATALOG_FLAG_MODE_Pos]);
+    fflush(stdout);
+}
+
+// Porta serial em modo cru; o PTY aceita a velocidade e a ignora
+static int Decode_SetRaw(int fd, unsigned long baud)
+{
+    struct termios tio;
+
+    for (size_t i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++)
+    {
+        if (speeds[i].baud != baud)
+            continue;
+        if (tcgetattr(fd, &tio) != 0)
+            return -1;
+        cfmakeraw(&tio);
+        cfsetspeed(&tio, speeds[i].speed);
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        return tcsetattr(fd, TCSANOW, &tio);
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long baud = 115200;
+    const char *path = "-";
+    struct sigaction sa;
+    uint8_t chunk[256];
+    TelDec dec;
+    int fd, opt;
+    ssize_t n = 0;
+
+    while ((opt = getopt(argc, argv, "b:")) != -1)
+    {
+        if (opt != 'b')
+        {
+            fprintf(stderr, "uso: %s [-b baud] [porta|arquivo|-]\n", argv[0]);
+            return 2;
+        }
+        baud = strtoul(optarg, NULL, 10);
+    }
+    if (optind < argc)
+        path = argv[optind];
+
+    fd = (strcmp(path, "-") == 0) ? STDIN_FILENO : open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0 || (isatty(fd) && Decode_SetRaw(fd, baud) != 0))
+    {
+        perror(path);
+        return 1;
+    }
+    // Sem SA_RESTART: o Ctrl-C interrompe o read() e o resumo sai
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = Decode_Stop;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    TelDec_Init(&dec, Decode_Print, NULL);
+    printf("seq,t_ms,temp_c,duty_pct,contagem_s,alarme,protecao,espera,modo\n");
+    while (!stop)
+    {
+        n = read(fd, chunk, sizeof(chunk));
+        if (n > 0)
+            TelDec_Feed(&dec, chunk, (uint32_t)n);
+        else if (n == 0 || errno != EINTR)
+            break;   // Fim do arquivo; EIO é o PTY fechado pelo host_sim
+    }
+    if (n < 0 && errno != EIO && errno != EINTR)
+        perror(path);
+
+    fprintf(stderr, "%llu bytes, %lu pacotes (%lu amostras, %lu textos, %lu desconhecidos), %lu perdidos pela "
+            "sequencia, %lu erros de CRC, %lu de COBS, %lu grandes demais\n",
+            (unsigned long long)dec.sum.bytes, (unsigned long)dec.sum.packets, (unsigned long)dec.sum.samples,
+            (unsigned long)dec.sum.texts, (unsigned long)dec.sum.unknown, (unsigned long)dec.sum.lost,
+            (unsigned long)dec.sum.crc_errors, (unsigned long)dec.sum.cobs_errors, (unsigned long)dec.sum.oversize);
+    return 0;
+}
@@ -0,0 +1,322 @@
+/**
+  ******************************************************************************
+  * @file    trace_dec.c
+  * @brief   Decodificador do rastro de execução. O JSON usa eventos
+  *          completos ("X") montados no fim de cada trecho, com início e
+  *          duração: fins cujo início o anel já sobrescreveu são contados e
+  *          descartados. Trilhas: tarefas, ISRs (aninhadas), ocioso e o
+  *          motor do LCD; ADC e PWM viram contadores, botões instantâneos.
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "trace_dec.h"
+#include "buttons.h"
+#include "power.h"
+
+#define TRACEDEC_PID        1
+#define TRACEDEC_TID_TASKS  1
+#define TRACEDEC_TID_ISRS   2
+#define TRACEDEC_TID_IDLE   3
+#define TRACEDEC_TID_LCD    4
+#define TRACEDEC_TID_EVENTS 5
+#define TRACEDEC_ISR_DEPTH  8U
+
+typedef struct
+{
+    FILE *out;
+    const Trace_Buffer *tb;
+    TraceDec_Summary *sum;
+    uint8_t first;
+
+    uint8_t task_open[SCHED_MAX_TASKS];
+    uint64_t task_start[SCHED_MAX_TASKS];
+    uint16_t task_late[SCHED_MAX_TASKS];
+    uint8_t isr_id[TRACEDEC_ISR_DEPTH];
+    uint64_t isr_start[TRACEDEC_ISR_DEPTH];
+    uint8_t isr_depth;
+    uint8_t idle_open;
+    uint64_t idle_start;
+    uint8_t lcd_open;
+    uint64_t lcd_start;
+    uint32_t lcd_bytes;
+} TraceDec_Json;
+
+static const char *const button_names[BUTTON_COUNT] = { "UP", "DOWN", "SCREEN" };
+static const char *const button_events[] = { "press", "release", "long", "repeat" };
+static const char *const power_modes[POWER_MODE_COUNT] = { "RUN", "SLEEP", "STOP" };
+
+// Números de exceção do STM32G070 (IRQn + 16)
+const char *TraceDec_IsrName(uint8_t exception)
+{
+    switch (exception)
+    {
+    case 15: return "SysTick";
+    case 18: return "RTC_TAMP";
+    case 21: return "EXTI0_1";
+    case 23: return "EXTI4_15";
+    case 25: return "DMA1_Ch1";
+    case 26: return "DMA1_Ch2_3";
+    case 28: return "ADC1";
+    case 29: return "TIM1_BRK_UP";
+    case 33: return "TIM6";
+    case 34: return "TIM7";
+    case 35: return "TIM14";
+    default: return NULL;
+    }
+}
+
+int TraceDec_Find(const uint8_t *image, uint32_t size, Trace_Buffer *tb)
+{
+    for (uint32_t off = 0; off + sizeof(*tb) <= size; off += 4U)
+    {
+        uint32_t magic;
+
+        memcpy(&magic, image + off, sizeof(magic));
+        if (magic != TRACE_MAGIC)
+            continue;
+        memcpy(tb, image + off, sizeof(*tb));
+        if (tb->version != TRACE_VERSION || tb->capacity != TRACE_CAPACITY)
+            continue;
+        for (uint32_t i = 0; i < SCHED_MAX_TASKS; i++)
+            tb->names[i][TRACE_NAME_LEN - 1U] = '\0';
+        return 1;
+    }
+    return 0;
+}
+
+void TraceDec_Events(const Trace_Buffer *tb, TraceDec_EventFn fn, void *ctx, TraceDec_Summary *sum)
+{
+    uint32_t head = tb->head;
+    uint32_t count = (head < TRACE_CAPACITY) ? head : TRACE_CAPACITY;
+    uint32_t last = 0;
+    uint64_t first = 0;
+    TraceDec_Event ev = { 0 };
+
+    memset(sum, 0, sizeof(*sum));
+    sum->events = count;
+    sum->overwritten = head - count;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const Trace_Event *e = &tb->events[(head - count + i) & (TRACE_CAPACITY - 1U)];
+
+        // Diferenças de 32 bits: só um intervalo de 71 min sem eventos engana
+        ev.time_us = (i == 0U) ? e->time_us : ev.time_us + (uint32_t)(e->time_us - last);
+        last = e->time_us;
+        if (i == 0U)
+            first = ev.time_us;
+        ev.type = e->type;
+        ev.id = e->id;
+        ev.arg = e->arg;
+        if (ev.type < TRACE_TYPE_COUNT)
+            sum->counts[ev.type]++;
+        else
+            sum->unmatched++;
+        if (fn != NULL)
+            fn(&ev, ctx);
+        sum->span_us = ev.time_us - first;
+    }
+}
+
+// --- JSON ---
+
+static void TraceDec_String(FILE *out, const char *s)
+{
+    fputc('"', out);
+    for (; *s != '\0'; s++)
+    {
+        unsigned char c = (unsigned char)*s;
+
+        if (c == '"' || c == '\\')
+            fprintf(out, "\\%c", c);
+        else if (c < 0x20U || c >= 0x7FU)
+            fprintf(out, "\\u%04x", c);
+        else
+            fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+static void TraceDec_Begin(TraceDec_Json *j)
+{
+    fputs(j->first ? "\n  " : ",\n  ", j->out);
+    j->first = 0;
+}
+
+static void TraceDec_Complete(TraceDec_Json *j, const char *name, const char *cat, int tid, uint64_t start, uint64_t end)
+{
+    TraceDec_Begin(j);
+    fputs("{\"name\":", j->out);
+    TraceDec_String(j->out, name);
+    fprintf(j->out, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":%d,\"tid\":%d", cat,
+            (unsigned long long)start, (unsigned long long)(end - start), TRACEDEC_PID, tid);
+}
+
+static void TraceDec_Thread(TraceDec_Json *j, int tid, const char *name)
+{
+    TraceDec_Begin(j);
+    fprintf(j->out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            TRACEDEC_PID, tid, name);
+    TraceDec_Begin(j);
+    fprintf(j->out, "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"sort_index\":%d}}",
+            TRACEDEC_PID, tid, tid);
+}
+
+static void TraceDec_Task(TraceDec_Json *j, const TraceDec_Event *ev)
+{
+    char fallback[16];
+    const char *name;
+
+    if (ev->id >= SCHED_MAX_TASKS)
+    {
+        j->sum->unmatched++;
+        return;
+    }
+    if (ev->type == TRACE_TASK_BEGIN)
+    {
+        j->task_open[ev->id] = 1;
+        j->task_start[ev->id] = ev->time_us;
+        j->task_late[ev->id] = ev->arg;
+        return;
+    }
+    if (!j->task_open[ev->id])
+    {
+        j->sum->unmatched++;
+        return;
+    }
+    j->task_open[ev->id] = 0;
+    name = j->tb->names[ev->id];
+    if (name[0] == '\0')
+    {
+        snprintf(fallback, sizeof(fallback), "tarefa %u", ev->id);
+        name = fallback;
+    }
+    TraceDec_Complete(j, name, "tarefa", TRACEDEC_TID_TASKS, j->task_start[ev->id], ev->time_us);
+    fprintf(j->out, ",\"args\":{\"atraso_ms\":%u}}", j->task_late[ev->id]);
+}
+
+static void TraceDec_Isr(TraceDec_Json *j, const TraceDec_Event *ev)
+{
+    char fallback[16];
+    const char *name = TraceDec_IsrName(ev->id);
+
+    if (ev->type == TRACE_ISR_ENTER)
+    {
+        if (j->isr_depth < TRACEDEC_ISR_DEPTH)
+        {
+            j->isr_id[j->isr_depth] = ev->id;
+            j->isr_start[j->isr_depth] = ev->time_us;
+        }
+        j->isr_depth++;
+        return;
+    }
+    // Saída de uma ISR que entrou antes do evento mais antigo do anel
+    if (j->isr_depth == 0U || j->isr_depth > TRACEDEC_ISR_DEPTH || j->isr_id[j->isr_depth - 1U] != ev->id)
+    {
+        j->sum->unmatched++;
+        if (j->isr_depth != 0U)
+            j->isr_depth--;
+        return;
+    }
+    j->isr_depth--;
+    if (name == NULL)
+    {
+        snprintf(fallback, sizeof(fallback), "exc %u", ev->id);
+        name = fallback;
+    }
+    TraceDec_Complete(j, name, "isr", TRACEDEC_TID_ISRS, j->isr_start[j->isr_depth], ev->time_us);
+    fputs("}", j->out);
+}
+
+static void TraceDec_Counter(TraceDec_Json *j, const char *name, const char *field, uint64_t ts, uint32_t value)
+{
+    TraceDec_Begin(j);
+    fprintf(j->out, "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%llu,\"pid\":%d,\"args\":{\"%s\":%lu}}", name,
+            (unsigned long long)ts, TRACEDEC_PID, field, (unsigned long)value);
+}
+
+static void TraceDec_JsonEvent(const TraceDec_Event *ev, void *ctx)
+{
+    TraceDec_Json *j = ctx;
+
+    switch (ev->type)
+    {
+    case TRACE_TASK_BEGIN:
+    case TRACE_TASK_END:
+        TraceDec_Task(j, ev);
+        break;
+    case TRACE_ISR_ENTER:
+    case TRACE_ISR_EXIT:
+        TraceDec_Isr(j, ev);
+        break;
+    case TRACE_IDLE_BEGIN:
+        j->idle_open = 1;
+        j->idle_start = ev->time_us;
+        break;
+    case TRACE_IDLE_END:
+        if (!j->idle_open)
+        {
+            j->sum->unmatched++;
+            break;
+        }
+        j->idle_open = 0;
+        TraceDec_Complete(j, (ev->arg < POWER_MODE_COUNT) ? power_modes[ev->arg] : "?", "ocioso",
+                          TRACEDEC_TID_IDLE, j->idle_start, ev->time_us);
+        fputs("}", j->out);
+        break;
+    case TRACE_ADC_READY:
+        TraceDec_Counter(j, "ADC", "codigo", ev->time_us, ev->arg);
+        break;
+    case TRACE_PWM_UPDATE:
+        TraceDec_Counter(j, ev->id ? "PWM (rampa)" : "PWM", "ccr", ev->time_us, ev->arg);
+        break;
+    case TRACE_LCD_FLUSH:
+        // Flush com o motor ainda ocupado: o trecho segue até a fila esvaziar
+        if (!j->lcd_open)
+        {
+            j->lcd_open = 1;
+            j->lcd_start = ev->time_us;
+            j->lcd_bytes = 0;
+        }
+        j->lcd_bytes += ev->arg;
+        break;
+    case TRACE_LCD_DONE:
+        // Fila esvaziada sem flush (LCD_Print, LCD_Clear): só o flush vira trecho
+        if (!j->lcd_open)
+            break;
+        j->lcd_open = 0;
+        TraceDec_Complete(j, "LCD_Flush", "lcd", TRACEDEC_TID_LCD, j->lcd_start, ev->time_us);
+        fprintf(j->out, ",\"args\":{\"bytes\":%lu}}", (unsigned long)j->lcd_bytes);
+        break;
+    case TRACE_BUTTON:
+        TraceDec_Begin(j);
+        fprintf(j->out, "{\"name\":\"%s %s\",\"cat\":\"botao\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%llu,\"pid\":%d,\"tid\":%d}",
+                (ev->id < BUTTON_COUNT) ? button_names[ev->id] : "?", (ev->arg < 4U) ? button_events[ev->arg] : "?",
+                (unsigned long long)ev->time_us, TRACEDEC_PID, TRACEDEC_TID_EVENTS);
+        break;
+    default:
+        break;
+    }
+}
+
+void TraceDec_WriteJson(FILE *out, const Trace_Buffer *tb, TraceDec_Summary *sum)
+{
+    TraceDec_Json j;
+
+    memset(&j, 0, sizeof(j));
+    j.out = out;
+    j.tb = tb;
+    j.sum = sum;
+    j.first = 1;
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", out);
+    TraceDec_Begin(&j);
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"STM32G070\"}}", TRACEDEC_PID);
+    TraceDec_Thread(&j, TRACEDEC_TID_TASKS, "Tarefas");
+    TraceDec_Thread(&j, TRACEDEC_TID_ISRS, "ISRs");
+    TraceDec_Thread(&j, TRACEDEC_TID_IDLE, "Ocioso");
+    TraceDec_Thread(&j, TRACEDEC_TID_LCD, "LCD");
+    TraceDec_Thread(&j, TRACEDEC_TID_EVENTS, "Botoes");
+    TraceDec_Events(tb, TraceDec_JsonEvent, &j, sum);
+    fputs("\n]}\n", out);
+}
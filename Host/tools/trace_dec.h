@@ -0,0 +1,50 @@
+/**
+  ******************************************************************************
+  * @file    trace_dec.h
+  * @brief   Decodificador do rastro de execução (trace.c): acha o anel numa
+  *          imagem de memória, percorre os eventos do mais antigo ao mais
+  *          novo com o instante estendido a 64 bits e exporta o JSON do
+  *          Chrome/Perfetto. Não depende do simulador.
+  ******************************************************************************
+  */
+
+#ifndef __TRACE_DEC_H
+#define __TRACE_DEC_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "trace.h"
+
+typedef struct
+{
+    uint64_t time_us;      // Do primeiro evento (32 bits do Timebase), estendido
+    uint8_t type;
+    uint8_t id;
+    uint16_t arg;
+} TraceDec_Event;
+
+typedef struct
+{
+    uint32_t events;       // Eventos no anel
+    uint32_t overwritten;  // Gravados e já sobrescritos
+    uint64_t span_us;      // Do mais antigo ao mais novo
+    uint32_t counts[TRACE_TYPE_COUNT];
+    uint32_t unmatched;    // Fins sem início (cortados pelo anel) ou tipos desconhecidos
+} TraceDec_Summary;
+
+typedef void (*TraceDec_EventFn)(const TraceDec_Event *ev, void *ctx);
+
+// Primeiro anel válido em 'image' (o Trace_Buffer exato ou um dump da RAM).
+// Retorna 0 se não houver.
+int TraceDec_Find(const uint8_t *image, uint32_t size, Trace_Buffer *tb);
+
+// Eventos em ordem de gravação
+void TraceDec_Events(const Trace_Buffer *tb, TraceDec_EventFn fn, void *ctx, TraceDec_Summary *sum);
+
+// JSON do formato de eventos do Chrome (chrome://tracing, ui.perfetto.dev)
+void TraceDec_WriteJson(FILE *out, const Trace_Buffer *tb, TraceDec_Summary *sum);
+
+// Nome da ISR pelo número da exceção
+const char *TraceDec_IsrName(uint8_t exception);
+
+#endif /* __TRACE_DEC_H */
@@ -0,0 +1,74 @@
+/**
+  ******************************************************************************
+  * @file    trace_export.c
+  * @brief   Lê o anel do rastro de execução e grava o JSON do Chrome /
+  *          Perfetto (abrir em ui.perfetto.dev ou chrome://tracing).
+  *
+  *          Uso: trace_export imagem.bin [saida.json]
+  *          A imagem é o Trace_Buffer gravado pelo host_sim -r ou um dump
+  *          da RAM do alvo (p.ex. st-flash read ram.bin 0x20000000 36864):
+  *          o anel é achado pela assinatura. Sem 'saida.json', vai para
+  *          stdout; o resumo vai para stderr.
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "trace_dec.h"
+
+static const char *const type_names[TRACE_TYPE_COUNT] =
+{
+    "tarefa", "fim tarefa", "ISR", "fim ISR", "ocioso", "fim ocioso",
+    "ADC", "PWM", "LCD flush", "LCD livre", "botao",
+};
+
+int main(int argc, char **argv)
+{
+    FILE *f, *out = stdout;
+    uint8_t *image;
+    long size;
+    static Trace_Buffer tb;
+    TraceDec_Summary sum;
+
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "uso: %s imagem.bin [saida.json]\n", argv[0]);
+        return 2;
+    }
+    f = fopen(argv[1], "rb");
+    if (f == NULL || fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) < 0)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    rewind(f);
+    image = malloc((size_t)size + 1U);
+    if (image == NULL || fread(image, 1, (size_t)size, f) != (size_t)size)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    fclose(f);
+
+    if (!TraceDec_Find(image, (uint32_t)size, &tb))
+    {
+        fprintf(stderr, "%s: nenhum anel de rastro (assinatura 0x%08lX, versao %u)\n", argv[1],
+                (unsigned long)TRACE_MAGIC, TRACE_VERSION);
+        return 1;
+    }
+    if (argc == 3 && (out = fopen(argv[2], "w")) == NULL)
+    {
+        perror(argv[2]);
+        return 1;
+    }
+    TraceDec_WriteJson(out, &tb, &sum);
+    if (out != stdout)
+        fclose(out);
+
+    fprintf(stderr, "%lu eventos em %.3f ms (%lu sobrescritos, %lu sem par)\n", (unsigned long)sum.events,
+            sum.span_us / 1000.0, (unsigned long)sum.overwritten, (unsigned long)sum.unmatched);
+    for (int t = 0; t < TRACE_TYPE_COUNT; t++)
+        fprintf(stderr, "  %-11s %6lu\n", type_names[t], (unsigned long)sum.counts[t]);
+    free(image);
+    return 0;
+}